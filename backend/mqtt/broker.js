@@ -3,6 +3,7 @@
 
 const aedes = require("aedes")();
 const net = require("net");
+const { setupTimeService } = require("./timeService");
 
 const setupMQTTBroker = () => {
   // Start MQTT broker on port 1883
@@ -21,7 +22,15 @@ const setupMQTTBroker = () => {
     console.log(`📱 MQTT client disconnected: ${client.id}`);
   });
 
+  // Clock sync for ESP32 modules (smartcamper/time/*)
+  setupTimeService(aedes);
+
   aedes.on("publish", (packet, client) => {
+    // Time sync traffic is frequent and not interesting in the log
+    if (packet.topic.startsWith("smartcamper/time/")) {
+      return;
+    }
+
     if (client) {
       console.log(
         `📨 MQTT publish: ${packet.topic} = ${packet.payload.toString()}`
@@ -0,0 +1,79 @@
+// MQTT Time Service
+// Answers ESP32 clock sync requests (see esp32-modules/*/include/ClockSync.h)
+//
+// Request:  smartcamper/time/request            {"module":"module-2","seq":17}
+// Response: smartcamper/time/response/<module>   {"seq":17,"sec":1735689600,"us":123456}
+//
+// The module measures the round trip itself, so the reply only carries the
+// server's wall-clock time, taken as late as possible before publishing.
+
+const { performance } = require("perf_hooks");
+
+const TIME_REQUEST_TOPIC = "smartcamper/time/request";
+const TIME_RESPONSE_TOPIC_PREFIX = "smartcamper/time/response/";
+const MODULE_ID_PATTERN = /^module-[1-9]\d*$/;
+
+// Sub-millisecond wall-clock time split into seconds + microseconds
+// (keeps the values exact for ArduinoJson on the ESP32)
+const nowEpoch = (offsetMs = 0) => {
+  const ms = performance.timeOrigin + performance.now() + offsetMs;
+  const sec = Math.floor(ms / 1000);
+  const us = Math.min(999999, Math.round((ms - sec * 1000) * 1000));
+  return { sec, us };
+};
+
+/**
+ * Attach the time service to an Aedes instance.
+ * @param {object} aedes - Aedes broker
+ * @param {object} [options]
+ * @param {number} [options.offsetMs=0] - Added to the reported time (testing)
+ * @param {() => number} [options.delayMs] - Reply delay in ms (testing RTT compensation)
+ */
+const setupTimeService = (aedes, options = {}) => {
+  const offsetMs = options.offsetMs || 0;
+  const delayMs = options.delayMs || (() => 0);
+
+  aedes.on("publish", (packet, client) => {
+    if (!client || packet.topic !== TIME_REQUEST_TOPIC) {
+      return;
+    }
+
+    let request;
+    try {
+      request = JSON.parse(packet.payload.toString());
+    } catch (error) {
+      return;
+    }
+
+    if (!request || !MODULE_ID_PATTERN.test(request.module)) {
+      return;
+    }
+
+    const reply = () => {
+      const { sec, us } = nowEpoch(offsetMs);
+      aedes.publish(
+        {
+          topic: TIME_RESPONSE_TOPIC_PREFIX + request.module,
+          payload: JSON.stringify({ seq: request.seq, sec, us }),
+          qos: 0,
+          retain: false,
+        },
+        () => {}
+      );
+    };
+
+    const delay = delayMs();
+    if (delay > 0) {
+      setTimeout(reply, delay);
+    } else {
+      setImmediate(reply);
+    }
+  });
+};
+
+module.exports = {
+  setupTimeService,
+  nowEpoch,
+  TIME_REQUEST_TOPIC,
+  TIME_RESPONSE_TOPIC_PREFIX,
+};
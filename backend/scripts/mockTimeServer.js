@@ -0,0 +1,72 @@
+/**
+ * Standalone MQTT broker with only the time service, for testing ESP32 clock
+ * sync without the full backend (or on a laptop instead of the Pi).
+ *
+ * Run from repo root:
+ *   cd backend && node scripts/mockTimeServer.js
+ *
+ * Point a module's MQTT_SERVER at this machine, then watch the heartbeat
+ * "clock" block (rttUs, errorUs, driftPpm) and the "ts" field in status payloads.
+ *
+ * MOCK_MQTT_PORT      — broker port (default 1883)
+ * MOCK_TIME_OFFSET_MS — shift the reported time; module "ts" should follow it
+ * MOCK_TIME_DELAY_MS  — fixed reply delay; offset must stay unchanged (RTT compensation)
+ * MOCK_TIME_JITTER_MS — random extra delay 0..N ms; min-RTT sample selection should hide it
+ */
+
+const net = require("net");
+const aedes = require("aedes")();
+const {
+  setupTimeService,
+  nowEpoch,
+  TIME_REQUEST_TOPIC,
+} = require("../mqtt/timeService");
+
+const PORT = Number(process.env.MOCK_MQTT_PORT || 1883);
+const OFFSET_MS = Number(process.env.MOCK_TIME_OFFSET_MS || 0);
+const DELAY_MS = Number(process.env.MOCK_TIME_DELAY_MS || 0);
+const JITTER_MS = Number(process.env.MOCK_TIME_JITTER_MS || 0);
+
+setupTimeService(aedes, {
+  offsetMs: OFFSET_MS,
+  delayMs: () => DELAY_MS + Math.random() * JITTER_MS,
+});
+
+aedes.on("client", (client) => {
+  console.log(`📱 MQTT client connected: ${client.id}`);
+});
+
+aedes.on("publish", (packet, client) => {
+  if (!client) return;
+
+  if (packet.topic === TIME_REQUEST_TOPIC) {
+    console.log(`🕒 Time request: ${packet.payload.toString()}`);
+    return;
+  }
+
+  // Compare module timestamps against our own clock
+  if (packet.topic.startsWith("smartcamper/")) {
+    try {
+      const data = JSON.parse(packet.payload.toString());
+      if (typeof data.ts === "number") {
+        const { sec, us } = nowEpoch(OFFSET_MS);
+        const serverMs = sec * 1000 + us / 1000;
+        console.log(
+          `📨 ${packet.topic} ts=${data.ts} (module - server: ${(data.ts - serverMs).toFixed(1)} ms)`
+        );
+      }
+      if (data.clock) {
+        console.log(`💓 ${packet.topic} clock=${JSON.stringify(data.clock)}`);
+      }
+    } catch (error) {
+      // Plain-value topic
+    }
+  }
+});
+
+net.createServer(aedes.handle).listen(PORT, () => {
+  console.log(`🕒 Mock time server (MQTT) on port ${PORT}`);
+  console.log(
+    `   offset ${OFFSET_MS} ms, delay ${DELAY_MS} ms, jitter ${JITTER_MS} ms`
+  );
+});
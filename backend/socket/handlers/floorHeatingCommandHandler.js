@@ -31,6 +31,14 @@ const floorHeatingCommandHandler = (socket, aedes, data) => {
     if (data.value !== undefined) {
       mqttPayload = JSON.stringify({ value: data.value });
     }
+  } else if (data.type === "control" && data.params) {
+    // Control algorithm / PI parameters: control
+    mqttTopic = `smartcamper/commands/${moduleId}/control`;
+    mqttPayload = JSON.stringify(data.params);
+  } else if (data.type === "preheat" && data.params) {
+    // Warm by a time: preheat ({at, in, circles, tz, cancel, resetModel})
+    mqttTopic = `smartcamper/commands/${moduleId}/preheat`;
+    mqttPayload = JSON.stringify(data.params);
   } else {
     console.log("❌ Invalid floor heating command:", data);
     return;
@@ -66,8 +66,53 @@ const sendForceUpdateToAllOnline = async (aedes, moduleRegistry) => {
   return successCount;
 };
 
+const VICTRON_HISTORY_RESOLUTIONS = ["1s", "1m", "1h"];
+
+/**
+ * Ask module-6 for stored Victron history (answer streams on smartcamper/sensors/module-6/history)
+ * @param {Object} aedes - Aedes MQTT broker instance
+ * @param {Object} query - { res: "1s" | "1m" | "1h", last?: seconds, from?: s, to?: s, id?: string }
+ * @returns {Promise<boolean>} True if the query was sent
+ */
+const sendVictronHistoryQuery = (aedes, query) => {
+  return new Promise((resolve) => {
+    const res = query && typeof query.res === "string" ? query.res : "1m";
+    if (!VICTRON_HISTORY_RESOLUTIONS.includes(res)) {
+      resolve(false);
+      return;
+    }
+
+    const payload = { res };
+    for (const key of ["last", "from", "to"]) {
+      if (Number.isInteger(query?.[key]) && query[key] >= 0) {
+        payload[key] = query[key];
+      }
+    }
+    if (typeof query?.id === "string" && query.id.length > 0) {
+      payload.id = query.id.slice(0, 23);
+    }
+
+    aedes.publish(
+      {
+        topic: "smartcamper/commands/module-6/history/query",
+        payload: Buffer.from(JSON.stringify(payload)),
+        qos: 0,
+      },
+      (err) => {
+        if (err) {
+          console.log(`❌ Failed to send Victron history query: ${err.message}`);
+          resolve(false);
+        } else {
+          resolve(true);
+        }
+      }
+    );
+  });
+};
+
 module.exports = {
   sendForceUpdate,
   sendForceUpdateToAllOnline,
+  sendVictronHistoryQuery,
 };
 
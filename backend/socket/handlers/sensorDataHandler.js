@@ -460,8 +460,71 @@ function handleAppliance(io, topicParts, message) {
 /**
  * Handle Victron energy status data
  * Format: smartcamper/sensors/module-6/status (JSON)
+ *         smartcamper/sensors/module-6/analytics (JSON, on-device energy totals + forecast)
+ *         smartcamper/sensors/module-6/history (JSON chunks answering a history/query command)
+ *         smartcamper/sensors/module-6/diagnostics (JSON, per-device BLE reception stats)
  */
 function handleVictron(io, topicParts, message) {
+  if (topicParts.length >= 4 && topicParts[3] === "history") {
+    try {
+      const chunk = JSON.parse(message);
+
+      if (!chunk || typeof chunk !== "object" || !Array.isArray(chunk.t)) {
+        console.log("❌ Invalid Victron history JSON: expected object with t[]");
+        return true;
+      }
+
+      io.emit("victronHistoryChunk", {
+        data: chunk,
+        timestamp: new Date().toISOString(),
+      });
+      return true;
+    } catch (error) {
+      console.log(`❌ Failed to parse Victron history JSON: ${error.message}`);
+      return true;
+    }
+  }
+
+  if (topicParts.length >= 4 && topicParts[3] === "diagnostics") {
+    try {
+      const diagnostics = JSON.parse(message);
+
+      if (!diagnostics || typeof diagnostics !== "object" || Array.isArray(diagnostics)) {
+        console.log("❌ Invalid Victron diagnostics JSON: expected object");
+        return true;
+      }
+
+      io.emit("victronDiagnosticsUpdate", {
+        data: diagnostics,
+        timestamp: new Date().toISOString(),
+      });
+      return true;
+    } catch (error) {
+      console.log(`❌ Failed to parse Victron diagnostics JSON: ${error.message}`);
+      return true;
+    }
+  }
+
+  if (topicParts.length >= 4 && topicParts[3] === "analytics") {
+    try {
+      const analytics = JSON.parse(message);
+
+      if (!analytics || typeof analytics !== "object" || Array.isArray(analytics)) {
+        console.log("❌ Invalid Victron analytics JSON: expected object");
+        return true;
+      }
+
+      io.emit("victronAnalyticsUpdate", {
+        data: analytics,
+        timestamp: new Date().toISOString(),
+      });
+      return true;
+    } catch (error) {
+      console.log(`❌ Failed to parse Victron analytics JSON: ${error.message}`);
+      return true;
+    }
+  }
+
   if (topicParts.length >= 4 && topicParts[3] === "status") {
     try {
       const statusData = JSON.parse(message);
@@ -16,6 +16,7 @@ const applianceCommandHandler = require("./handlers/applianceCommandHandler");
 const {
   sendForceUpdateToAllOnline,
   sendForceUpdate,
+  sendVictronHistoryQuery,
 } = require("./handlers/moduleCommandHandler");
 
 const FORCE_MODULE_ID_PATTERN = /^module-[1-9]\d*$/;
@@ -122,6 +123,13 @@ const setupSocketIO = (io, aedes) => {
       });
     });
 
+    // Victron history from module-6 RAM (chunks come back as victronHistoryChunk)
+    socket.on("victronHistoryRequest", (data) => {
+      sendVictronHistoryQuery(aedes, data || {}).catch((err) => {
+        console.log(`❌ victronHistoryRequest failed: ${err.message}`);
+      });
+    });
+
     // When frontend disconnects
     socket.on("disconnect", () => {
       console.log("❌ Frontend disconnected");
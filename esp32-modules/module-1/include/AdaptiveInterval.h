@@ -0,0 +1,74 @@
+// Adaptive Interval
+// Sample interval that follows the rate of change of a reading. A reading that
+// moved stableDelta or more from the reference (the reading at the last move)
+// drops the interval to minInterval; each reading that did not doubles it, up to
+// maxInterval. A steady drift therefore settles at about stableDelta / rate, and
+// a value that does not move is sampled every maxInterval.
+// The interval also stays at minInterval while the reading is stableDelta or more
+// away from the consumer's filtered value (average, mode): after a step the filter
+// window refills at the fast rate.
+// A reading taken after a slow interval goes into the filter weight() times, once for
+// every minInterval it covers, as the fixed rate would have filled it. A step seen
+// after the slowest interval therefore moves the filter as far as it would have
+// moved by then at minInterval, and the filter reacts no later than before as long
+// as maxInterval is not longer than the consumer's own period (average interval).
+
+#ifndef ADAPTIVE_INTERVAL_H
+#define ADAPTIVE_INTERVAL_H
+
+#include <Arduino.h>
+#include <math.h>
+
+class AdaptiveInterval {
+private:
+  unsigned long minInterval;
+  unsigned long maxInterval;
+  float stableDelta;
+
+  unsigned long interval;
+  float reference;  // NAN = no reading yet
+
+public:
+  AdaptiveInterval(unsigned long minInterval, unsigned long maxInterval, float stableDelta) {
+    this->minInterval = minInterval;
+    this->maxInterval = maxInterval;
+    this->stableDelta = stableDelta;
+    this->interval = minInterval;
+    this->reference = NAN;
+  }
+
+  // Feed every reading (NAN = failed read, interval unchanged) with the filtered
+  // value it feeds into (NAN = none yet); returns the new interval
+  unsigned long update(float value, float filtered) {
+    if (isnan(value)) {
+      return interval;
+    }
+    bool filterBehind = !isnan(filtered) && fabs(value - filtered) >= stableDelta;
+    if (isnan(reference) || fabs(value - reference) >= stableDelta || filterBehind) {
+      reference = value;
+      interval = minInterval;
+    } else {
+      interval = (interval >= maxInterval / 2) ? maxInterval : interval * 2;
+    }
+    return interval;
+  }
+
+  // Filter weight of a reading taken elapsed ms after the previous one: the readings
+  // minInterval would have taken, 1 .. maxInterval / minInterval (rounded up)
+  uint8_t weight(unsigned long elapsed) const {
+    unsigned long limit = (maxInterval + minInterval - 1) / minInterval;
+    unsigned long n = elapsed / minInterval;
+    if (n > limit) {
+      n = limit;
+    }
+    return n < 1 ? 1 : (n > 255 ? 255 : (uint8_t)n);
+  }
+
+  // Back to the fastest rate (force update, reconnect)
+  void speedUp() { interval = minInterval; }
+
+  unsigned long get() const { return interval; }
+  bool isFast() const { return interval == minInterval; }
+};
+
+#endif
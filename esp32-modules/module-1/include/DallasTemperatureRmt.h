@@ -0,0 +1,66 @@
+// Dallas Temperature RMT
+// DS18B20 access on OneWireRmt with the DallasTemperature library's calls, so the
+// sensor classes keep their code. Differences:
+// - ROM codes are enumerated once in begin(); getAddress()/getTempCByIndex() do not
+//   search the bus again (the library did, on every read)
+// - getTempC() waits with interrupts enabled; beginReadTempC() + isReadComplete()
+//   is the asynchronous form used by the sensors' loop()
+// - requestTemperatures() never drives a strong pull-up (VDD-powered sensors only)
+
+#ifndef DALLAS_TEMPERATURE_RMT_H
+#define DALLAS_TEMPERATURE_RMT_H
+
+#include "OneWireRmt.h"
+
+typedef uint8_t DeviceAddress[8];
+
+#define DEVICE_DISCONNECTED_C -127
+#define DALLAS_RMT_MAX_DEVICES 8
+
+class DallasTemperatureRmt {
+private:
+  OneWireRmt* bus;  // Not owned
+  DeviceAddress addresses[DALLAS_RMT_MAX_DEVICES];
+  uint8_t deviceCount;
+  bool parasite;
+  bool waitForConversion;
+  uint8_t resolution;
+
+  // Async scratchpad read
+  bool readPending;
+  float readTemperature;
+
+  bool startScratchPadRead(const uint8_t* deviceAddress);
+  float decodeScratchPad(const uint8_t* scratchPad) const;
+  bool readScratchPad(const uint8_t* deviceAddress, uint8_t* scratchPad);
+
+public:
+  DallasTemperatureRmt(OneWireRmt* bus);
+
+  // Enumerate the bus (also call again to pick up added sensors)
+  void begin();
+
+  uint8_t getDeviceCount() const { return deviceCount; }
+  bool getAddress(uint8_t* deviceAddress, uint8_t index) const;
+  bool isParasitePowerMode() const { return parasite; }
+  bool isConnected(const uint8_t* deviceAddress);
+
+  void setResolution(uint8_t bits);  // All enumerated devices
+  bool setResolution(const uint8_t* deviceAddress, uint8_t bits);
+  void setWaitForConversion(bool wait) { waitForConversion = wait; }
+
+  // Skip ROM + Convert T: every sensor on the bus starts converting
+  bool requestTemperatures();
+
+  // Blocking reads (DEVICE_DISCONNECTED_C on missing device or CRC error)
+  float getTempC(const uint8_t* deviceAddress);
+  float getTempCByIndex(uint8_t index);
+
+  // Async read: start, then poll isReadComplete() from loop() and take getReadTempC()
+  void beginReadTempC(const uint8_t* deviceAddress);
+  void beginReadTempCByIndex(uint8_t index);
+  bool isReadComplete();
+  float getReadTempC() const { return readTemperature; }
+};
+
+#endif
@@ -0,0 +1,69 @@
+// DHT RMT
+// DHT22/AM2301 (and DHT11) reader on the ESP32 RMT peripheral (replaces the Adafruit
+// DHT library, which masks interrupts for the ~5 ms of every read and times the
+// bits in software). startRead() pulls the data line low; isReadComplete(), called
+// from loop(), releases it once the start pulse is long enough and collects the
+// pulse train that the RMT RX channel recorded in the background, then decodes
+// and checksums it. Interrupts stay enabled throughout.
+// Like the Adafruit library, a read within DHT_MIN_INTERVAL_MS of the previous
+// transaction returns the previous result (the sensor samples every 2 seconds).
+
+#ifndef DHT_RMT_H
+#define DHT_RMT_H
+
+#include "Config.h"
+#include <Arduino.h>
+
+// Sensor types (same values as the Adafruit library)
+#define DHT11 11
+#define DHT21 21
+#define DHT22 22
+#define AM2301 21
+
+#define DHT_MIN_INTERVAL_MS 2000
+
+class DhtRmt {
+private:
+  enum State { IDLE, START_PULSE, RECEIVING };
+
+  uint8_t pin;
+  uint8_t type;
+  State state;
+  unsigned long startPulseUs;    // Start pulse began (micros)
+  unsigned long receiveStartMs;  // Line released, RX running
+  unsigned long lastTransactionMs;
+  bool hasTransaction;
+
+  bool lastOk;
+  float temperature;
+  float humidity;
+
+  // Statistics (since boot)
+  uint32_t readCount;
+  uint32_t checksumErrors;
+  uint32_t framingErrors;  // Wrong pulse count or pulse widths out of spec
+  uint32_t timeouts;       // No answer
+
+  bool decode(const void* items, size_t itemCount);
+
+public:
+  DhtRmt(uint8_t pin, uint8_t type);
+
+  void begin();
+
+  // Async read: start, then poll isReadComplete() from loop()
+  void startRead();
+  bool isReadComplete();
+
+  // Result of the last completed read (NAN if it failed)
+  bool isLastReadOk() const { return lastOk; }
+  float getTemperature() const { return lastOk ? temperature : NAN; }
+  float getHumidity() const { return lastOk ? humidity : NAN; }
+
+  uint32_t getReadCount() const { return readCount; }
+  uint32_t getChecksumErrors() const { return checksumErrors; }
+  uint32_t getFramingErrors() const { return framingErrors; }
+  uint32_t getTimeouts() const { return timeouts; }
+};
+
+#endif
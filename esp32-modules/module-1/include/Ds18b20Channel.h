@@ -0,0 +1,73 @@
+// DS18B20 Channel
+// Acquisition state machine for one DS18B20 on its own OneWire pin:
+// Convert T -> wait conversionMs -> scratchpad read, all without blocking loop().
+// Every bus shares the one RMT channel pair (OneWireRmt), and a transaction started
+// while another bus holds it waits for it. So channels take turns: a channel that
+// needs the RMT (Convert T or scratchpad read) queues, and the RMT goes round-robin
+// to the next queued channel after the previous holder. Only the transactions take
+// turns - the conversions themselves (750 ms) still run on all buses at once.
+
+#ifndef DS18B20_CHANNEL_H
+#define DS18B20_CHANNEL_H
+
+#include "Config.h"
+#include "DallasTemperatureRmt.h"
+
+#define DS18B20_MAX_CHANNELS 8
+
+class Ds18b20Channel {
+private:
+  enum State {
+    IDLE,
+    CONVERT_QUEUED,   // Waiting for the RMT
+    CONVERT_SENDING,  // Convert T on the wire
+    CONVERTING,       // RMT released, sensor converting
+    READ_QUEUED,      // Waiting for the RMT
+    READING           // Scratchpad read on the wire
+  };
+
+  OneWireRmt oneWire;
+  DallasTemperatureRmt sensors;
+  unsigned long conversionMs;
+
+  State state;
+  unsigned long conversionStartTime;
+  float temperature;  // Last completed reading (NAN = failed)
+
+  // Round-robin turn-taking (all channels of the module)
+  int8_t slot;        // -1 = not registered yet (begin())
+  bool queued;
+  uint32_t turnWaits;  // loop() passes spent queued (statistics)
+
+  static Ds18b20Channel* channels[DS18B20_MAX_CHANNELS];
+  static uint8_t channelCount;
+  static int8_t holder;      // Slot holding the RMT (-1 = free)
+  static int8_t lastHolder;
+
+  bool takeTurn();
+  void endTurn();
+
+public:
+  Ds18b20Channel(uint8_t pin, unsigned long conversionMs);
+
+  // Enumerate, set resolution, register for turns
+  void begin(uint8_t resolution);
+
+  uint8_t getDeviceCount() const { return sensors.getDeviceCount(); }
+  uint8_t getPin() const { return oneWire.getPin(); }
+
+  // Start an acquisition (ignored unless idle)
+  void startConversion();
+  bool isIdle() const { return state == IDLE; }
+
+  // Advance the state machine; true once per completed acquisition
+  bool poll(unsigned long currentTime);
+  float getTemperature() const { return temperature; }
+
+  // Drop the running acquisition (EMI, circle turned off, sensor gone)
+  void cancel();
+
+  uint32_t getTurnWaits() const { return turnWaits; }
+};
+
+#endif
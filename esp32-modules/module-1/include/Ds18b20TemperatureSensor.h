@@ -0,0 +1,208 @@
+// DS18B20 Temperature Sensor
+// Generic single-DS18B20 sensor: Ds18b20Channel (acquisition, round-robin with the
+// other buses) -> TemperaturePipeline (outlier gate, average, change threshold) ->
+// MQTT. The concrete sensors (water, outdoor) are a TemperatureSensorConfig each.
+// The read interval adapts (AdaptiveInterval): readIntervalMin while the temperature
+// moves, an outlier is being checked or an update was forced, up to readIntervalMax
+// while it is stable. A slower reading counts in the average for the readings it
+// replaced, and readIntervalMax leaves one reading per average interval, so a step
+// is published no later than at the fixed readIntervalMin rate.
+
+#ifndef DS18B20_TEMPERATURE_SENSOR_H
+#define DS18B20_TEMPERATURE_SENSOR_H
+
+#include "Config.h"
+#include "MQTTManager.h"
+#include "Ds18b20Channel.h"
+#include "TemperaturePipeline.h"
+#include "AdaptiveInterval.h"
+#include <Arduino.h>
+
+struct TemperatureSensorConfig {
+  const char* name;         // For logs ("Water", "Outdoor")
+  const char* sensorType;   // MQTT: smartcamper/sensors/<sensorType>
+  uint8_t pin;
+  unsigned long readIntervalMin;
+  unsigned long readIntervalMax;
+  float stableDelta;        // °C since the last move that still counts as stable
+  unsigned long averageInterval;
+  float publishThreshold;   // °C
+  float maxDelta;           // Outlier gate, °C per reading (0 = off)
+  float expectedMin;        // Outside = warning (still published)
+  float expectedMax;
+};
+
+template <uint8_t AVERAGE_COUNT>
+class Ds18b20TemperatureSensor {
+private:
+  MQTTManager* mqttManager;  // Reference to MQTT manager (not owned)
+  TemperatureSensorConfig config;
+  Ds18b20Channel channel;
+  TemperaturePipeline<AVERAGE_COUNT> pipeline;
+  AdaptiveInterval sampling;
+
+  unsigned long lastSensorRead;
+  unsigned long lastDataSent;
+  float lastTemperature;
+  bool forceUpdateRequested;
+  bool lastMQTTState;  // Previous MQTT connection state (for detecting reconnects)
+
+  void processReading(float temperature, unsigned long currentTime, bool isForceUpdate, uint8_t weight) {
+    typename TemperaturePipeline<AVERAGE_COUNT>::Result result = pipeline.add(temperature, currentTime, isForceUpdate, weight);
+
+    if (result == TemperaturePipeline<AVERAGE_COUNT>::INVALID) {
+      sampling.speedUp();  // Retry soon
+      if (DEBUG_SERIAL) {
+        Serial.println("❌ Invalid " + String(config.name) + " temperature reading!");
+      }
+      forceUpdateRequested = false;
+      return;
+    }
+    if (result == TemperaturePipeline<AVERAGE_COUNT>::OUTLIER) {
+      sampling.speedUp();  // Spike or real step - the next readings tell
+      if (DEBUG_SERIAL) {
+        Serial.println("⏭️ " + String(config.name) + " temperature outlier ignored: " + String(temperature, 1) +
+                       "°C (last: " + String(pipeline.getLastAccepted(), 1) + "°C)");
+      }
+      return;  // A forced update goes out with the next good reading
+    }
+
+    lastTemperature = temperature;
+    sampling.update(temperature, pipeline.getAverage());
+    if (result == TemperaturePipeline<AVERAGE_COUNT>::AVERAGE_DUE) {
+      publishIfNeeded(pipeline.getAverage(), currentTime, isForceUpdate);
+      forceUpdateRequested = false;
+    } else if (isForceUpdate) {
+      // Not enough measurements yet - publish the current value
+      publishIfNeeded(temperature, currentTime, true);
+      forceUpdateRequested = false;
+    }
+  }
+
+  void publishIfNeeded(float temperature, unsigned long currentTime, bool forcePublish) {
+    if (temperature < config.expectedMin || temperature > config.expectedMax) {
+      if (DEBUG_SERIAL) {
+        Serial.println("⚠️ WARNING: " + String(config.name) + " temperature out of expected range: " + String(temperature) + "°C");
+      }
+      // Still publish but log warning
+    }
+
+    // Round to 1 decimal place (0.1°C precision)
+    temperature = round(temperature * 10) / 10;
+
+    if (!forcePublish && !pipeline.hasChanged(temperature)) {
+      return;
+    }
+
+    mqttManager->publishSensorData(config.sensorType, temperature);
+    if (DEBUG_SERIAL && !forcePublish) {
+      Serial.println("Published: smartcamper/sensors/" + String(config.sensorType) + " = " + String(temperature, 1));
+    }
+    pipeline.markPublished(temperature);
+    lastDataSent = currentTime;
+  }
+
+public:
+  Ds18b20TemperatureSensor(MQTTManager* mqtt, const TemperatureSensorConfig& sensorConfig)
+    : config(sensorConfig),
+      channel(sensorConfig.pin, DS18B20_CONVERSION_MS),
+      pipeline(sensorConfig.maxDelta, sensorConfig.publishThreshold, sensorConfig.averageInterval),
+      sampling(sensorConfig.readIntervalMin, sensorConfig.readIntervalMax, sensorConfig.stableDelta) {
+    // Validate input parameters
+    if (mqtt == nullptr) {
+      if (DEBUG_SERIAL) {
+        Serial.println("❌ ERROR: " + String(sensorConfig.name) + " temperature sensor: mqttManager cannot be nullptr!");
+      }
+    }
+
+    this->mqttManager = mqtt;
+    this->lastSensorRead = 0;
+    this->lastDataSent = 0;
+    this->lastTemperature = 0.0;
+    this->forceUpdateRequested = false;
+    this->lastMQTTState = false;  // Initialize as disconnected
+  }
+
+  // Initialization
+  void begin() {
+    // 12 bits (0.0625°C) - enough for 0.1°C publishing
+    channel.begin(12);
+
+    if (DEBUG_SERIAL) {
+      Serial.println("🌡️ DS18B20 " + String(config.name) + " Temperature Sensor initialized");
+      Serial.println("   GPIO pin: " + String(config.pin));
+      int deviceCount = channel.getDeviceCount();
+      Serial.println("   Found " + String(deviceCount) + " DS18B20 device(s)");
+      if (deviceCount == 0) {
+        Serial.println("⚠️ WARNING: No DS18B20 sensors found on pin " + String(config.pin));
+      }
+    }
+  }
+
+  // Main loop - call this in your main loop()
+  void loop() {
+    if (mqttManager == nullptr) {
+      return;  // Cannot proceed without MQTT manager
+    }
+
+    bool mqttConnected = mqttManager->isMQTTConnected();
+
+    // Detect MQTT reconnection (transition from disconnected to connected)
+    if (mqttConnected && !lastMQTTState) {
+      if (DEBUG_SERIAL) {
+        Serial.println("🔄 MQTT reconnected - will send " + String(config.name) + " temperature data immediately");
+      }
+      forceUpdate();
+    }
+    lastMQTTState = mqttConnected;
+
+    if (!mqttConnected) {
+      channel.cancel();  // Do not keep the RMT turn while paused
+      return;
+    }
+
+    // No sensor found - nothing to schedule
+    if (channel.getDeviceCount() == 0) {
+      channel.cancel();
+      return;
+    }
+
+    unsigned long currentTime = millis();
+    bool isForceUpdate = forceUpdateRequested;
+
+    if (channel.isIdle() && (currentTime - lastSensorRead > sampling.get() || isForceUpdate)) {
+      channel.startConversion();
+    }
+    if (channel.poll(currentTime)) {
+      uint8_t weight = lastSensorRead == 0 ? 1 : sampling.weight(currentTime - lastSensorRead);
+      lastSensorRead = currentTime;
+      processReading(channel.getTemperature(), currentTime, isForceUpdate, weight);
+    }
+  }
+
+  // Force update
+  void forceUpdate() {
+    forceUpdateRequested = true;
+    sampling.speedUp();
+  }
+
+  // Status (const methods)
+  float getLastTemperature() const { return lastTemperature; }
+  unsigned long getLastDataSent() const { return lastDataSent; }
+  bool isForceUpdateRequested() const { return forceUpdateRequested; }
+
+  void printStatus() const {
+    if (DEBUG_SERIAL) {
+      Serial.println("📊 " + String(config.name) + " Temperature Sensor Status:");
+      Serial.println("  Last Temperature: " + String(lastTemperature) + "°C");
+      Serial.println("  Last Data Sent: " + String((millis() - lastDataSent) / 1000) + " seconds ago");
+      Serial.println("  Force Update Requested: " + String(forceUpdateRequested ? "Yes" : "No"));
+      Serial.println("  Read Interval: " + String(sampling.get() / 1000.0, 1) + " s");
+      Serial.println("  Measurement Count: " + String(pipeline.getCount()) + "/" + String(AVERAGE_COUNT));
+      Serial.println("  Outliers Ignored: " + String(pipeline.getOutlierCount()));
+      Serial.println("  OneWire Turn Waits: " + String(channel.getTurnWaits()));
+    }
+  }
+};
+
+#endif
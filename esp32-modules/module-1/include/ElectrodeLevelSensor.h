@@ -0,0 +1,173 @@
+// Electrode Level Sensor
+// Conductivity electrodes in a tank (bottom to top, tank body/GND electrode below):
+// an electrode under water pulls its input LOW through the water, a dry one reads
+// HIGH through the internal pull-up. The level is the highest covered electrode.
+//
+// Non-blocking: start() begins a scan, poll() does at most one step per call and
+// returns true when the level is ready. Pull-ups are switched and inputs read
+// through the GPIO registers (one load covers every electrode below GPIO 32).
+//
+// Serial scan (default): one electrode pulled up at a time, top to bottom, stops at
+// the first covered one - several pulled-up electrodes raise the water potential
+// and less current flows through each electrode. One settle time per electrode.
+// Parallel scan: all electrodes pulled up, one settle time, one register read.
+
+#ifndef ELECTRODE_LEVEL_SENSOR_H
+#define ELECTRODE_LEVEL_SENSOR_H
+
+#include <Arduino.h>
+#include "driver/gpio.h"
+#include "soc/gpio_struct.h"
+
+template <uint8_t N>
+class ElectrodeLevelSensor {
+private:
+  enum State {
+    IDLE,
+    SETTLING  // Pull-up(s) on, waiting settleUs before the read
+  };
+
+  const uint8_t* pins;      // N electrodes, bottom to top (static table)
+  const uint8_t* percents;  // Level of each electrode in %
+  unsigned long settleUs;
+  bool parallel;
+
+  uint32_t mask;   // Electrodes on GPIO 0-31
+  uint32_t mask1;  // Electrodes on GPIO 32-39
+
+  State state;
+  int8_t current;  // Electrode under test (serial scan)
+  unsigned long stepStart;
+  int8_t level;    // -1 = no electrode covered
+  unsigned long scanCount;
+
+  static bool isHigh(uint8_t pin, uint32_t in, uint32_t in1) {
+    return pin < 32 ? (in >> pin) & 1 : (in1 >> (pin - 32)) & 1;
+  }
+
+  static void pullUp(uint8_t pin, bool on) {
+    if (on) {
+      gpio_pullup_en((gpio_num_t)pin);
+    } else {
+      gpio_pullup_dis((gpio_num_t)pin);
+    }
+  }
+
+  void releaseAll() {
+    for (uint8_t i = 0; i < N; i++) {
+      pullUp(pins[i], false);
+    }
+  }
+
+  void finish(int8_t result) {
+    level = result;
+    state = IDLE;
+    scanCount++;
+  }
+
+public:
+  ElectrodeLevelSensor(const uint8_t (&pinTable)[N], const uint8_t (&percentTable)[N],
+                       unsigned long settleUs, bool parallel) {
+    this->pins = pinTable;
+    this->percents = percentTable;
+    this->settleUs = settleUs;
+    this->parallel = parallel;
+    this->mask = 0;
+    this->mask1 = 0;
+    for (uint8_t i = 0; i < N; i++) {
+      if (pinTable[i] < 32) {
+        this->mask |= (1UL << pinTable[i]);
+      } else {
+        this->mask1 |= (1UL << (pinTable[i] - 32));
+      }
+    }
+    this->state = IDLE;
+    this->current = -1;
+    this->stepStart = 0;
+    this->level = -1;
+    this->scanCount = 0;
+  }
+
+  // All electrodes INPUT without pull-up (no current between scans)
+  void begin() {
+    for (uint8_t i = 0; i < N; i++) {
+      pinMode(pins[i], INPUT);
+    }
+    releaseAll();
+  }
+
+  void start(unsigned long nowUs) {
+    if (state != IDLE) {
+      return;
+    }
+    if (parallel) {
+      for (uint8_t i = 0; i < N; i++) {
+        pullUp(pins[i], true);
+      }
+    } else {
+      current = N - 1;  // Top electrode first
+      pullUp(pins[current], true);
+    }
+    stepStart = nowUs;
+    state = SETTLING;
+  }
+
+  // One step; true when a new level is ready (getLevel)
+  bool poll(unsigned long nowUs) {
+    if (state == IDLE || nowUs - stepStart < settleUs) {
+      return false;
+    }
+
+    uint32_t in = GPIO.in & mask;
+    uint32_t in1 = GPIO.in1.data & mask1;
+
+    if (parallel) {
+      releaseAll();
+      for (int8_t i = N - 1; i >= 0; i--) {
+        if (!isHigh(pins[i], in, in1)) {
+          finish(i);
+          return true;
+        }
+      }
+      finish(-1);
+      return true;
+    }
+
+    pullUp(pins[current], false);
+    if (!isHigh(pins[current], in, in1)) {
+      finish(current);  // Highest covered electrode
+      return true;
+    }
+    if (current == 0) {
+      finish(-1);  // No electrode covered = 0%
+      return true;
+    }
+    current--;
+    pullUp(pins[current], true);
+    stepStart = nowUs;
+    return false;
+  }
+
+  // Abort a scan (MQTT lost) and release the pull-ups
+  void cancel() {
+    releaseAll();
+    state = IDLE;
+  }
+
+  bool isIdle() const { return state == IDLE; }
+  int8_t getLevel() const { return level; }
+  unsigned long getScanCount() const { return scanCount; }
+
+  // Level index -> % (-1 or out of range = 0%)
+  float levelToPercent(int index) const {
+    if (index < 0 || index >= N) {
+      return 0.0;
+    }
+    return (float)percents[index];
+  }
+
+  uint8_t getPin(uint8_t index) const { return pins[index]; }
+  static uint8_t size() { return N; }
+};
+
+#endif
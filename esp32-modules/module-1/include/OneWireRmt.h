@@ -0,0 +1,76 @@
+// OneWire RMT
+// OneWire bus master on the ESP32 RMT peripheral (replaces the bit-banged OneWire library).
+// The OneWire library masks interrupts for every bit slot and reset (up to 70 µs each)
+// and busy-waits through the rest of the slot. Here the RMT TX channel generates the
+// slots, the RX channel records the bus on the same open-drain pin, and the CPU only
+// encodes and decodes - interrupts stay enabled and loop() does not wait.
+// One TX/RX channel pair (ONEWIRE_RMT_TX_CHANNEL / ONEWIRE_RMT_RX_CHANNEL) serves every
+// bus: a transaction routes it to its pin. The ESP32 RMT has no DMA, so a transaction
+// longer than the RX memory runs as several segments (the bus idles high in between,
+// which OneWire allows).
+// No strong pull-up: sensors must be VDD-powered (parasite power is not supported).
+
+#ifndef ONEWIRE_RMT_H
+#define ONEWIRE_RMT_H
+
+#include "Config.h"
+#include <Arduino.h>
+
+#define ONEWIRE_RMT_MAX_WRITE 16  // Bytes written per transaction (match ROM + command + scratchpad)
+#define ONEWIRE_RMT_MAX_READ 9    // Bytes read per transaction (scratchpad)
+
+class OneWireRmt {
+private:
+  uint8_t pin;
+
+  // Current transaction: [reset] + writeBits + readBits, LSB first
+  bool busy;
+  bool ok;        // All slots decoded
+  bool presence;  // A device answered the reset
+  bool withReset;
+  uint8_t writeData[ONEWIRE_RMT_MAX_WRITE];
+  uint16_t writeBits;
+  uint8_t readData[ONEWIRE_RMT_MAX_READ];
+  uint16_t readBits;
+  uint16_t nextSlot;      // First slot of the running segment
+  uint16_t segmentSlots;  // Slots in the running segment
+  unsigned long segmentStartTime;
+
+  // ROM search state (same algorithm as the OneWire library)
+  uint8_t searchRom[8];
+  uint8_t lastDiscrepancy;
+  bool lastDeviceFlag;
+
+  uint16_t slotCount() const;
+  void startSegment();
+  bool decodeSegment(const void* items, size_t itemCount);
+  void finish(bool success);
+  void poll(bool wait);
+  bool runBlocking(bool reset, const uint8_t* data, uint16_t bitsToWrite, uint16_t bitsToRead);
+
+public:
+  OneWireRmt(uint8_t pin);
+
+  // Installs the shared RMT channels on the first call
+  bool begin();
+
+  // Async transaction. Returns immediately (after waiting for another bus's running
+  // transaction, if any); isBusy() advances it - call it from loop() until false.
+  bool startTransaction(bool reset, const uint8_t* data, uint16_t bitsToWrite, uint16_t bitsToRead);
+  bool isBusy();
+  bool waitForCompletion();  // Blocks this task only; returns transactionOk()
+  bool transactionOk() const { return ok; }
+  bool devicePresent() const { return presence; }
+  const uint8_t* getReadData() const { return readData; }
+
+  // Blocking OneWire-library style calls (interrupts stay enabled; for enumeration/setup)
+  uint8_t reset();
+  void reset_search();
+  bool search(uint8_t* newAddr);
+
+  uint8_t getPin() const { return pin; }
+
+  static uint8_t crc8(const uint8_t* addr, uint8_t len);
+};
+
+#endif
@@ -1,64 +1,28 @@
 // Outdoor Temperature Sensor
-// Specific sensor logic for DS18B20 sensor (OneWire)
-// Handles: Reading, averaging, change detection, publishing
+// Outdoor DS18B20 - configuration of Ds18b20TemperatureSensor
 
 #ifndef OUTDOOR_TEMPERATURE_SENSOR_H
 #define OUTDOOR_TEMPERATURE_SENSOR_H
 
-#include "Config.h"
-#include "MQTTManager.h"
-#include <OneWire.h>
-#include <DallasTemperature.h>
+#include "Ds18b20TemperatureSensor.h"
 
-class OutdoorTemperatureSensor {
-private:
-  MQTTManager* mqttManager;  // Reference to MQTT manager (not owned)
-  OneWire oneWire;
-  DallasTemperature sensors;
-  
-  unsigned long lastSensorRead;
-  unsigned long lastDataSent;
-  float lastTemperature;
-  bool forceUpdateRequested;
-  bool lastMQTTState;  // Previous MQTT connection state (for detecting reconnects)
-  
-  // Async temperature reading state machine
-  bool conversionStarted;  // True if we've started a temperature conversion
-  unsigned long conversionStartTime;  // When we started the conversion
-  
-  // Temperature averaging
-  float temperatureReadings[OUTDOOR_TEMP_AVERAGE_COUNT];
-  int temperatureIndex;
-  int temperatureCount;
-  unsigned long lastAverageTime;
-  
-  // Sensor reading functions
-  float readTemperature();
-  
-  // Averaging functions
-  float calculateAverageTemperature();
-  
-  // Publishing logic
-  void publishIfNeeded(float temperature, unsigned long currentTime, bool forcePublish = false);
+static const TemperatureSensorConfig OUTDOOR_TEMPERATURE_CONFIG = {
+  "Outdoor",
+  "outdoor-temperature",
+  OUTDOOR_TEMP_PIN,
+  OUTDOOR_TEMP_READ_INTERVAL_MIN,
+  OUTDOOR_TEMP_READ_INTERVAL_MAX,
+  OUTDOOR_TEMP_STABLE_DELTA,
+  OUTDOOR_TEMP_AVERAGE_INTERVAL,
+  OUTDOOR_TEMP_THRESHOLD,
+  OUTDOOR_TEMP_MAX_DELTA,
+  -50.0, 70.0  // Expected range (DS18B20 does -55 to 125°C)
+};
 
+class OutdoorTemperatureSensor : public Ds18b20TemperatureSensor<OUTDOOR_TEMP_AVERAGE_COUNT> {
 public:
-  OutdoorTemperatureSensor(MQTTManager* mqtt);
-  
-  // Initialization
-  void begin();
-  
-  // Main loop - call this in your main loop()
-  void loop();
-  
-  // Force update
-  void forceUpdate();
-  
-  // Status (const methods)
-  float getLastTemperature() const { return lastTemperature; }
-  unsigned long getLastDataSent() const { return lastDataSent; }
-  bool isForceUpdateRequested() const { return forceUpdateRequested; }
-  void printStatus() const;
+  OutdoorTemperatureSensor(MQTTManager* mqtt)
+    : Ds18b20TemperatureSensor<OUTDOOR_TEMP_AVERAGE_COUNT>(mqtt, OUTDOOR_TEMPERATURE_CONFIG) {}
 };
 
 #endif
-
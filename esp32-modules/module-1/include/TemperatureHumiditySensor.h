@@ -7,12 +7,14 @@
 
 #include "Config.h"
 #include "MQTTManager.h"
-#include "DHT.h"
+#include "DhtRmt.h"
+#include "RunningAverage.h"
 
 class TemperatureHumiditySensor {
 private:
   MQTTManager* mqttManager;  // Reference to MQTT manager (not owned)
-  DHT dht;
+  DhtRmt dht;
+  bool readStarted;  // DHT transaction in progress
   
   unsigned long lastSensorRead;
   unsigned long lastDataSent;
@@ -22,18 +24,13 @@ private:
   bool lastMQTTState;  // Previous MQTT connection state (for detecting reconnects)
   
   // Temperature averaging
-  float temperatureReadings[TEMP_AVERAGE_COUNT];
-  int temperatureIndex;
-  int temperatureCount;
+  RunningAverage<TEMP_AVERAGE_COUNT> temperatureAverage;
   unsigned long lastAverageTime;
   
   // Sensor reading functions
   float readTemperature();
   float readHumidity();
   
-  // Averaging functions
-  float calculateAverageTemperature();
-  
   // Publishing logic
   void publishIfNeeded(float temperature, float humidity, unsigned long currentTime, bool forcePublish = false);
 
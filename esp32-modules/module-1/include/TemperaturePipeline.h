@@ -0,0 +1,97 @@
+// Temperature Pipeline
+// Processing shared by the temperature sensors, after acquisition:
+// 1. Outlier gate - a reading more than maxDelta from the last accepted one is
+//    dropped; TEMP_OUTLIER_REBASE_COUNT outliers in a row are a real step and the
+//    gate accepts the new level (maxDelta 0 = gate off)
+// 2. Moving average over N readings (RunningAverage, O(1) per reading); a reading
+//    can count several times (weight), e.g. for the slots a slower read interval skipped
+// 3. Average due - once the window is full, every averageInterval or on force
+// 4. Change threshold - hasChanged() against the last published value
+
+#ifndef TEMPERATURE_PIPELINE_H
+#define TEMPERATURE_PIPELINE_H
+
+#include "Config.h"
+#include "RunningAverage.h"
+#include <math.h>
+
+template <uint8_t N>
+class TemperaturePipeline {
+private:
+  RunningAverage<N> average;
+  float maxDelta;
+  float publishThreshold;
+  unsigned long averageInterval;
+
+  float lastAccepted;      // NAN = no baseline yet
+  uint8_t outlierRun;      // Consecutive outliers
+  unsigned long lastAverageTime;
+  float lastPublished;     // NAN = nothing published yet
+
+  uint32_t outlierCount;   // Statistics (since boot)
+
+public:
+  enum Result {
+    INVALID,      // NAN - sensor error
+    OUTLIER,      // Dropped by the gate
+    ACCEPTED,     // Added to the average
+    AVERAGE_DUE   // Added, and getAverage() should be used now
+  };
+
+  TemperaturePipeline(float maxDelta, float publishThreshold, unsigned long averageInterval) {
+    this->maxDelta = maxDelta;
+    this->publishThreshold = publishThreshold;
+    this->averageInterval = averageInterval;
+    this->lastAccepted = NAN;
+    this->outlierRun = 0;
+    this->lastAverageTime = 0;
+    this->lastPublished = NAN;
+    this->outlierCount = 0;
+  }
+
+  Result add(float temperature, unsigned long currentTime, bool force, uint8_t weight = 1) {
+    if (isnan(temperature)) {
+      return INVALID;
+    }
+
+    if (maxDelta > 0 && !isnan(lastAccepted) && fabs(temperature - lastAccepted) > maxDelta) {
+      outlierCount++;
+      outlierRun++;
+      if (outlierRun < TEMP_OUTLIER_REBASE_COUNT) {
+        return OUTLIER;
+      }
+      average.reset();  // Old level would drag the average for a whole window
+    }
+    outlierRun = 0;
+    lastAccepted = temperature;
+    for (uint8_t i = 0; i < weight && i < N; i++) {
+      average.add(temperature);
+    }
+
+    if (average.isFull() && (currentTime - lastAverageTime >= averageInterval || force)) {
+      lastAverageTime = currentTime;
+      return AVERAGE_DUE;
+    }
+    return ACCEPTED;
+  }
+
+  // Forget the gate baseline (e.g. after a disturbance); the average is kept
+  void resetBaseline() {
+    lastAccepted = NAN;
+    outlierRun = 0;
+  }
+
+  float getAverage() const { return average.getAverage(); }
+  uint8_t getCount() const { return average.getCount(); }
+  float getLastAccepted() const { return lastAccepted; }
+
+  bool hasChanged(float value) const {
+    return isnan(lastPublished) || fabs(value - lastPublished) >= publishThreshold;
+  }
+  void markPublished(float value) { lastPublished = value; }
+  float getLastPublished() const { return lastPublished; }
+
+  uint32_t getOutlierCount() const { return outlierCount; }
+};
+
+#endif
@@ -7,39 +7,31 @@
 
 #include "Config.h"
 #include "MQTTManager.h"
+#include "AdaptiveInterval.h"
+#include "ElectrodeLevelSensor.h"
+#include "RollingMode.h"
 
 class WaterLevelSensor {
 private:
   MQTTManager* mqttManager;  // Reference to MQTT manager (not owned)
   
-  // GPIO pins array (from bottom to top)
-  int levelPins[NUM_LEVEL_PINS];
-  int levelPercentages[NUM_LEVEL_PINS];
+  ElectrodeLevelSensor<NUM_LEVEL_PINS> electrodes;  // Non-blocking electrode scan
   
   // Timing
   unsigned long lastSensorRead;
+  AdaptiveInterval sampling;  // Fast while the level moves, slower (less electrode current) while stable
   unsigned long lastDataSent;
   
   // Measurement data
-  int levelIndices[WATER_LEVEL_MODE_SAMPLE_COUNT];  // Rolling window for mode (level indices)
-  int measurementIndex;
-  int measurementCount;
+  RollingMode<WATER_LEVEL_MODE_SAMPLE_COUNT, NUM_LEVEL_PINS> levelMode;  // Rolling window for mode (level indices)
   
   // Last published value
   float lastPublishedLevel;
   bool forceUpdateRequested;
   bool lastMQTTState;  // Previous MQTT connection state (for detecting reconnects)
   
-  // Sensor reading functions
-  int readWaterLevel();  // Returns level index (0-6) or -1 if empty
-  float levelToPercent(int level);  // Converts level index to percentage
-  void setupPins();  // Configure pins as INPUT (no pull-up initially)
-  void setPinsLow();  // Set all pins to LOW after measurement (corrosion prevention)
-  
-  // Statistics functions
-  int findMode(int* values, int count);  // Find most frequent value in array
-  
-  // Publishing logic
+  // Measurement processing and publishing logic
+  void processLevel(int level, unsigned long currentTime, bool isForceUpdate, uint8_t weight);
   void publishIfNeeded(float modePercent, unsigned long currentTime, bool forcePublish = false);
 
 public:
@@ -1,64 +1,28 @@
 // Water Temperature Sensor
-// Specific sensor logic for DS18B20 sensor (OneWire)
-// Handles: Reading, averaging, change detection, publishing
+// Gray water tank DS18B20 - configuration of Ds18b20TemperatureSensor
 
 #ifndef WATER_TEMPERATURE_SENSOR_H
 #define WATER_TEMPERATURE_SENSOR_H
 
-#include "Config.h"
-#include "MQTTManager.h"
-#include <OneWire.h>
-#include <DallasTemperature.h>
+#include "Ds18b20TemperatureSensor.h"
 
-class WaterTemperatureSensor {
-private:
-  MQTTManager* mqttManager;  // Reference to MQTT manager (not owned)
-  OneWire oneWire;
-  DallasTemperature sensors;
-  
-  unsigned long lastSensorRead;
-  unsigned long lastDataSent;
-  float lastTemperature;
-  bool forceUpdateRequested;
-  bool lastMQTTState;  // Previous MQTT connection state (for detecting reconnects)
-  
-  // Async temperature reading state machine
-  bool conversionStarted;  // True if we've started a temperature conversion
-  unsigned long conversionStartTime;  // When we started the conversion
-  
-  // Temperature averaging
-  float temperatureReadings[WATER_TEMP_AVERAGE_COUNT];
-  int temperatureIndex;
-  int temperatureCount;
-  unsigned long lastAverageTime;
-  
-  // Sensor reading functions
-  float readTemperature();
-  
-  // Averaging functions
-  float calculateAverageTemperature();
-  
-  // Publishing logic
-  void publishIfNeeded(float temperature, unsigned long currentTime, bool forcePublish = false);
+static const TemperatureSensorConfig WATER_TEMPERATURE_CONFIG = {
+  "Water",
+  "gray-water-temperature",
+  WATER_TEMP_PIN,
+  WATER_TEMP_READ_INTERVAL_MIN,
+  WATER_TEMP_READ_INTERVAL_MAX,
+  WATER_TEMP_STABLE_DELTA,
+  WATER_TEMP_AVERAGE_INTERVAL,
+  WATER_TEMP_THRESHOLD,
+  WATER_TEMP_MAX_DELTA,
+  -10.0, 60.0  // Expected range (DS18B20 does -55 to 125°C)
+};
 
+class WaterTemperatureSensor : public Ds18b20TemperatureSensor<WATER_TEMP_AVERAGE_COUNT> {
 public:
-  WaterTemperatureSensor(MQTTManager* mqtt);
-  
-  // Initialization
-  void begin();
-  
-  // Main loop - call this in your main loop()
-  void loop();
-  
-  // Force update
-  void forceUpdate();
-  
-  // Status (const methods)
-  float getLastTemperature() const { return lastTemperature; }
-  unsigned long getLastDataSent() const { return lastDataSent; }
-  bool isForceUpdateRequested() const { return forceUpdateRequested; }
-  void printStatus() const;
+  WaterTemperatureSensor(MQTTManager* mqtt)
+    : Ds18b20TemperatureSensor<WATER_TEMP_AVERAGE_COUNT>(mqtt, WATER_TEMPERATURE_CONFIG) {}
 };
 
 #endif
-
@@ -2,6 +2,7 @@
 // Handle commands from Backend
 
 #include "CommandHandler.h"
+#include "LogStreamer.h"
 #include "SensorManager.h"
 #include <Arduino.h>
 
@@ -97,6 +98,13 @@ void CommandHandler::handleMQTTMessage(char* topic, byte* payload, unsigned int
     
     // Call force update function
     forceUpdate();
+    // The forced DHT publish (first of the forced readings) closes the round trip
+    mqttManager->expectStatus(String(MQTT_TOPIC_SENSORS) + "indoor-temperature");
+  }
+  
+  // Runtime log stream level (e.g. {"level":"debug"})
+  if (topicStr.endsWith("/logs/level")) {
+    LogStreamer::handleLevelCommand(message);
   }
 }
 
@@ -58,29 +58,70 @@
 #define LEVEL_PERCENT_7 100
 
 // Water level sensor timing
-#define WATER_LEVEL_READ_INTERVAL 30000   // 30 seconds - measurement interval (electrode-friendly)
-#define WATER_LEVEL_MODE_SAMPLE_COUNT 10  // rolling window: 10 x 30s ~= 5 min; mode of these samples
+#define WATER_LEVEL_READ_INTERVAL_MIN 30000   // 30 seconds - interval while the level moves (electrode-friendly)
+#define WATER_LEVEL_READ_INTERVAL_MAX 60000   // 60 seconds - interval once the level is stable (a reading counts twice in the mode)
+#define WATER_LEVEL_MODE_SAMPLE_COUNT 10  // rolling window: 10 x 30s ~= 5 min while moving; mode of these samples
 #define WATER_LEVEL_THRESHOLD 1.0         // 1% change threshold for publishing
 
+// Electrode scan (ElectrodeLevelSensor) - non-blocking, one step per loop()
+#define ELECTRODE_SETTLE_US 5000       // Pull-up settle time before an electrode is read
+#define ELECTRODE_PARALLEL_SCAN false  // true = all electrodes pulled up and read at once (one settle time)
+
 // Water Temperature Sensor Configuration (DS18B20 - Module 1 specific)
 #define WATER_TEMP_PIN 26            // GPIO pin for DS18B20 sensor (OneWire)
-#define WATER_TEMP_READ_INTERVAL 1000   // 1 second - measurement interval
+#define WATER_TEMP_READ_INTERVAL_MIN 1000   // 1 second - interval while the temperature moves
+#define WATER_TEMP_READ_INTERVAL_MAX (WATER_TEMP_AVERAGE_INTERVAL - DS18B20_CONVERSION_MS)  // 4.2 seconds - one reading per average interval once stable
+#define WATER_TEMP_STABLE_DELTA 0.2         // Less change than this since the last move = stable (°C)
 #define WATER_TEMP_AVERAGE_INTERVAL 5000 // 5 seconds - average calculation interval
 #define WATER_TEMP_THRESHOLD 0.1        // 0.1°C change threshold for publishing
 #define WATER_TEMP_AVERAGE_COUNT 5      // Number of measurements to average
+#define WATER_TEMP_MAX_DELTA 5.0        // Outlier gate: max jump between readings (°C)
 
 // Outdoor Temperature Sensor Configuration (DS18B20 - Module 1 specific)
 #define OUTDOOR_TEMP_PIN 27            // GPIO pin for DS18B20 sensor (OneWire)
-#define OUTDOOR_TEMP_READ_INTERVAL 1000   // 1 second - measurement interval
+#define OUTDOOR_TEMP_READ_INTERVAL_MIN 1000   // 1 second - interval while the temperature moves
+#define OUTDOOR_TEMP_READ_INTERVAL_MAX (OUTDOOR_TEMP_AVERAGE_INTERVAL - DS18B20_CONVERSION_MS)  // 4.2 seconds - one reading per average interval once stable
+#define OUTDOOR_TEMP_STABLE_DELTA 0.2         // Less change than this since the last move = stable (°C)
 #define OUTDOOR_TEMP_AVERAGE_INTERVAL 5000 // 5 seconds - average calculation interval
 #define OUTDOOR_TEMP_THRESHOLD 0.1        // 0.1°C change threshold for publishing
 #define OUTDOOR_TEMP_AVERAGE_COUNT 5      // Number of measurements to average
+#define OUTDOOR_TEMP_MAX_DELTA 3.0        // Outlier gate: max jump between readings (°C)
+
+// Shared by the DS18B20 sensors
+#define DS18B20_CONVERSION_MS 800    // Wait after Convert T (12-bit needs 750 ms + safety margin)
+#define TEMP_OUTLIER_REBASE_COUNT 3  // This many outliers in a row = real step, gate accepts it
+
+// OneWire bus driver (DS18B20) - RMT peripheral instead of bit-banging, shared by all OneWire pins
+#define ONEWIRE_RMT_TX_CHANNEL 0  // Generates the slots (1 memory block)
+#define ONEWIRE_RMT_RX_CHANNEL 1  // Records the bus (2 memory blocks - channel 2 is taken too)
+
+// DHT driver - RMT receive channel that records the sensor answer
+#define DHT_RMT_CHANNEL 3  // 1 memory block (OneWire uses channels 0-2)
 
 // Debug settings
 #define DEBUG_SERIAL true   // Enable serial debug output
 #define DEBUG_MQTT true     // Enable MQTT debug output
 #define DEBUG_VERBOSE false  // Enable verbose debug output (set to true for detailed logging)
 
+// Logging (see Logger.h) - levels above LOG_LEVEL are compiled out
+// 0=NONE, 1=ERROR, 2=WARN, 3=INFO, 4=DEBUG, 5=VERBOSE
+#define LOG_LEVEL LOG_LEVEL_INFO
+#define LOG_QUEUE_DEPTH 32  // Ring buffer line slots (power of two)
+#define LOG_LINE_MAX 128    // Max characters per log line
+#define LOG_STREAM_LEVEL LOG_LEVEL_WARN  // Initial level mirrored to smartcamper/logs/{module} (runtime: logs/level command)
+#define LOG_STREAM_INTERVAL_MS 1000       // Min time between log batch publishes
+#define LOG_STREAM_BATCH_BYTES 768        // Max payload bytes per log batch
+#define LOG_STREAM_BUFFER_SIZE 2048       // Log bytes buffered while waiting to publish
+
+// Command tracking (see CommandTracker.h) - optional "id" in command payloads
+#define COMMAND_ACK_TIMEOUT_MS 2000  // Ack without publish time if no status publish follows
+#define COMMAND_DEDUP_SIZE 16        // Recent command ids remembered for duplicate detection
+
+// Clock sync with the backend (see ClockSync.h) - adds "ts" (epoch ms) to JSON payloads
+#define CLOCK_SYNC_INTERVAL_MS 60000  // Time between sync bursts
+#define CLOCK_SYNC_SAMPLES 4          // Requests per burst (lowest round trip is used)
+#define CLOCK_SYNC_MAX_RTT_MS 250     // Discard samples with a slower round trip
+
 // Watchdog settings (optional - for production stability)
 // #define ENABLE_WATCHDOG true
 // #define WATCHDOG_TIMEOUT 30  // seconds
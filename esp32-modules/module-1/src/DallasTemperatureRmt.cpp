@@ -0,0 +1,184 @@
+// Dallas Temperature RMT Implementation
+
+#include "DallasTemperatureRmt.h"
+
+// DS18B20 function commands
+static const uint8_t CMD_MATCH_ROM = 0x55;
+static const uint8_t CMD_SKIP_ROM = 0xCC;
+static const uint8_t CMD_CONVERT_T = 0x44;
+static const uint8_t CMD_READ_SCRATCHPAD = 0xBE;
+static const uint8_t CMD_WRITE_SCRATCHPAD = 0x4E;
+static const uint8_t CMD_READ_POWER_SUPPLY = 0xB4;
+
+static const uint8_t SCRATCHPAD_SIZE = 9;
+static const uint8_t SCRATCHPAD_CONFIG = 4;
+static const uint16_t MAX_CONVERSION_MS = 750;  // 12-bit
+
+// CRC over the first 8 bytes; an absent device reads all ones (bad CRC), a shorted
+// bus all zeros (CRC 0 matches, so checked separately)
+static bool isValidScratchPad(const uint8_t* scratchPad) {
+  bool allZeros = true;
+  for (uint8_t i = 0; i < SCRATCHPAD_SIZE; i++) {
+    if (scratchPad[i] != 0) {
+      allZeros = false;
+    }
+  }
+  return !allZeros && OneWireRmt::crc8(scratchPad, 8) == scratchPad[8];
+}
+
+DallasTemperatureRmt::DallasTemperatureRmt(OneWireRmt* bus) {
+  this->bus = bus;
+  this->deviceCount = 0;
+  this->parasite = false;
+  this->waitForConversion = true;
+  this->resolution = 12;
+  this->readPending = false;
+  this->readTemperature = DEVICE_DISCONNECTED_C;
+  memset(addresses, 0, sizeof(addresses));
+}
+
+void DallasTemperatureRmt::begin() {
+  deviceCount = 0;
+  parasite = false;
+  if (!bus->begin()) {
+    return;
+  }
+
+  DeviceAddress rom;
+  bus->reset_search();
+  while (deviceCount < DALLAS_RMT_MAX_DEVICES && bus->search(rom)) {
+    if (OneWireRmt::crc8(rom, 7) == rom[7]) {
+      memcpy(addresses[deviceCount++], rom, sizeof(DeviceAddress));
+    }
+  }
+
+  // Read Power Supply: a parasite-powered device pulls the read slot low
+  uint8_t command[2] = {CMD_SKIP_ROM, CMD_READ_POWER_SUPPLY};
+  if (deviceCount > 0 && bus->startTransaction(true, command, 16, 1) && bus->waitForCompletion()) {
+    parasite = (bus->getReadData()[0] & 1) == 0;
+  }
+}
+
+bool DallasTemperatureRmt::getAddress(uint8_t* deviceAddress, uint8_t index) const {
+  if (index >= deviceCount) {
+    return false;
+  }
+  memcpy(deviceAddress, addresses[index], sizeof(DeviceAddress));
+  return true;
+}
+
+bool DallasTemperatureRmt::startScratchPadRead(const uint8_t* deviceAddress) {
+  // Reset, Match ROM, Read Scratchpad, 9 bytes back - one transaction
+  uint8_t command[10];
+  command[0] = CMD_MATCH_ROM;
+  memcpy(&command[1], deviceAddress, sizeof(DeviceAddress));
+  command[9] = CMD_READ_SCRATCHPAD;
+  return bus->startTransaction(true, command, sizeof(command) * 8, SCRATCHPAD_SIZE * 8);
+}
+
+bool DallasTemperatureRmt::readScratchPad(const uint8_t* deviceAddress, uint8_t* scratchPad) {
+  if (!startScratchPadRead(deviceAddress) || !bus->waitForCompletion()) {
+    return false;
+  }
+  memcpy(scratchPad, bus->getReadData(), SCRATCHPAD_SIZE);
+  return isValidScratchPad(scratchPad);
+}
+
+float DallasTemperatureRmt::decodeScratchPad(const uint8_t* scratchPad) const {
+  int16_t raw = (int16_t)((scratchPad[1] << 8) | scratchPad[0]);
+  // Undefined low bits at lower resolutions
+  uint8_t bits = 9 + ((scratchPad[SCRATCHPAD_CONFIG] >> 5) & 0x03);
+  raw &= (int16_t)~((1 << (12 - bits)) - 1);
+  return raw / 16.0;
+}
+
+bool DallasTemperatureRmt::isConnected(const uint8_t* deviceAddress) {
+  uint8_t scratchPad[SCRATCHPAD_SIZE];
+  return readScratchPad(deviceAddress, scratchPad);
+}
+
+bool DallasTemperatureRmt::setResolution(const uint8_t* deviceAddress, uint8_t bits) {
+  uint8_t scratchPad[SCRATCHPAD_SIZE];
+  if (!readScratchPad(deviceAddress, scratchPad)) {
+    return false;
+  }
+
+  uint8_t config = (uint8_t)(((constrain(bits, 9, 12) - 9) << 5) | 0x1F);
+  if (scratchPad[SCRATCHPAD_CONFIG] == config) {
+    return true;  // Already set - no write
+  }
+
+  // Write Scratchpad: TH, TL, config (RAM only; begin() sets it again after power-up)
+  uint8_t command[13];
+  command[0] = CMD_MATCH_ROM;
+  memcpy(&command[1], deviceAddress, sizeof(DeviceAddress));
+  command[9] = CMD_WRITE_SCRATCHPAD;
+  command[10] = scratchPad[2];
+  command[11] = scratchPad[3];
+  command[12] = config;
+  return bus->startTransaction(true, command, sizeof(command) * 8, 0) && bus->waitForCompletion();
+}
+
+void DallasTemperatureRmt::setResolution(uint8_t bits) {
+  resolution = constrain(bits, 9, 12);
+  for (uint8_t i = 0; i < deviceCount; i++) {
+    setResolution(addresses[i], resolution);
+  }
+}
+
+bool DallasTemperatureRmt::requestTemperatures() {
+  uint8_t command[2] = {CMD_SKIP_ROM, CMD_CONVERT_T};
+  if (!bus->startTransaction(true, command, 16, 0)) {
+    return false;
+  }
+  if (waitForConversion) {
+    bus->waitForCompletion();
+    delay(MAX_CONVERSION_MS >> (12 - resolution));
+  }
+  return true;
+}
+
+float DallasTemperatureRmt::getTempC(const uint8_t* deviceAddress) {
+  uint8_t scratchPad[SCRATCHPAD_SIZE];
+  if (!readScratchPad(deviceAddress, scratchPad)) {
+    return DEVICE_DISCONNECTED_C;
+  }
+  return decodeScratchPad(scratchPad);
+}
+
+float DallasTemperatureRmt::getTempCByIndex(uint8_t index) {
+  if (index >= deviceCount) {
+    return DEVICE_DISCONNECTED_C;
+  }
+  return getTempC(addresses[index]);
+}
+
+void DallasTemperatureRmt::beginReadTempC(const uint8_t* deviceAddress) {
+  readTemperature = DEVICE_DISCONNECTED_C;
+  readPending = startScratchPadRead(deviceAddress);
+}
+
+void DallasTemperatureRmt::beginReadTempCByIndex(uint8_t index) {
+  if (index >= deviceCount) {
+    readTemperature = DEVICE_DISCONNECTED_C;
+    readPending = false;  // Completes at once with the error value
+    return;
+  }
+  beginReadTempC(addresses[index]);
+}
+
+bool DallasTemperatureRmt::isReadComplete() {
+  if (!readPending) {
+    return true;
+  }
+  if (bus->isBusy()) {
+    return false;
+  }
+
+  readPending = false;
+  const uint8_t* scratchPad = bus->getReadData();
+  if (bus->transactionOk() && isValidScratchPad(scratchPad)) {
+    readTemperature = decodeScratchPad(scratchPad);
+  }
+  return true;
+}
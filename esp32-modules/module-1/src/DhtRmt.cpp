@@ -0,0 +1,199 @@
+// DHT RMT Implementation
+// Answer as recorded by RX (µs): response low ~80, response high ~80, then 40 bits
+// of low ~50 + high 26-28 (0) or ~70 (1), MSB first, then a final low ~50 and idle.
+
+#include "DhtRmt.h"
+#include "Logger.h"
+#include "driver/gpio.h"
+#include "driver/rmt.h"
+#include "freertos/ringbuf.h"
+#include "soc/gpio_sig_map.h"
+
+static const rmt_channel_t RX_CHANNEL = (rmt_channel_t)DHT_RMT_CHANNEL;
+static const uint16_t RX_IDLE_US = 200;              // Longer than any pulse of the answer: ends the frame
+static const unsigned long RECEIVE_TIMEOUT_MS = 20;  // The answer takes ~5 ms
+static const unsigned long START_PULSE_US = 1100;    // DHT22 / AM2301 (datasheet: at least 1 ms)
+static const unsigned long START_PULSE_DHT11_US = 20000;
+
+static const uint8_t DATA_BITS = 40;
+static const uint16_t BIT_LOW_MIN_US = 30;
+static const uint16_t BIT_LOW_MAX_US = 85;
+static const uint16_t BIT_HIGH_MIN_US = 15;
+static const uint16_t BIT_HIGH_MAX_US = 95;
+static const uint16_t BIT_ONE_MIN_US = 48;  // 0 = 26-28 µs high, 1 = 70 µs
+static const uint8_t MIN_ANSWER_PULSES = 8;  // Fewer = the sensor did not answer
+
+static RingbufHandle_t rxRingbuf = nullptr;
+
+DhtRmt::DhtRmt(uint8_t pin, uint8_t type) {
+  this->pin = pin;
+  this->type = type;
+  this->state = IDLE;
+  this->startPulseUs = 0;
+  this->receiveStartMs = 0;
+  this->lastTransactionMs = 0;
+  this->hasTransaction = false;
+  this->lastOk = false;
+  this->temperature = NAN;
+  this->humidity = NAN;
+  this->readCount = 0;
+  this->checksumErrors = 0;
+  this->framingErrors = 0;
+  this->timeouts = 0;
+}
+
+void DhtRmt::begin() {
+  rmt_config_t rx = RMT_DEFAULT_CONFIG_RX((gpio_num_t)pin, RX_CHANNEL);
+  rx.clk_div = 80;       // 1 µs ticks
+  rx.mem_block_num = 1;  // 64 items; the answer is 43
+  rx.rx_config.filter_en = true;
+  rx.rx_config.filter_ticks_thresh = 100;  // APB ticks: ignore glitches shorter than 1.25 µs
+  rx.rx_config.idle_threshold = RX_IDLE_US;
+
+  if (rmt_config(&rx) != ESP_OK || rmt_driver_install(RX_CHANNEL, 512, 0) != ESP_OK ||
+      rmt_get_ringbuf_handle(RX_CHANNEL, &rxRingbuf) != ESP_OK) {
+    LOG_ERROR("❌ DHT: RMT channel %d unavailable", DHT_RMT_CHANNEL);
+    rxRingbuf = nullptr;
+    return;
+  }
+
+  // Open drain with pull-up, released between reads. rmt_config() left the pad
+  // input-only, so attach the RX signal again after enabling the output.
+  gpio_set_direction((gpio_num_t)pin, GPIO_MODE_INPUT_OUTPUT_OD);
+  gpio_set_pull_mode((gpio_num_t)pin, GPIO_PULLUP_ONLY);
+  gpio_set_level((gpio_num_t)pin, 1);
+  pinMatrixInAttach(pin, RMT_SIG_IN0_IDX + DHT_RMT_CHANNEL, false);
+}
+
+void DhtRmt::startRead() {
+  if (state != IDLE) {
+    return;  // Already running
+  }
+  if (hasTransaction && millis() - lastTransactionMs < DHT_MIN_INTERVAL_MS) {
+    return;  // Too soon for the sensor - previous result stands
+  }
+  if (rxRingbuf == nullptr) {
+    lastOk = false;
+    return;
+  }
+
+  gpio_set_level((gpio_num_t)pin, 0);  // Start pulse
+  startPulseUs = micros();
+  state = START_PULSE;
+}
+
+bool DhtRmt::isReadComplete() {
+  if (state == IDLE) {
+    return true;
+  }
+
+  if (state == START_PULSE) {
+    unsigned long startPulseLength = (type == DHT11) ? START_PULSE_DHT11_US : START_PULSE_US;
+    if (micros() - startPulseUs < startPulseLength) {
+      return false;
+    }
+
+    // Drop leftovers and listen, then release: the sensor answers 20-40 µs later
+    size_t length = 0;
+    void* stale;
+    while ((stale = xRingbufferReceive(rxRingbuf, &length, 0)) != nullptr) {
+      vRingbufferReturnItem(rxRingbuf, stale);
+    }
+    rmt_rx_start(RX_CHANNEL, true);
+    gpio_set_level((gpio_num_t)pin, 1);
+    receiveStartMs = millis();
+    state = RECEIVING;
+    return false;
+  }
+
+  size_t length = 0;
+  void* items = xRingbufferReceive(rxRingbuf, &length, 0);
+  if (items == nullptr) {
+    if (millis() - receiveStartMs < RECEIVE_TIMEOUT_MS) {
+      return false;
+    }
+    timeouts++;
+    lastOk = false;
+  } else {
+    lastOk = decode(items, length / sizeof(rmt_item32_t));
+    vRingbufferReturnItem(rxRingbuf, items);
+  }
+  rmt_rx_stop(RX_CHANNEL);
+
+  readCount++;
+  hasTransaction = true;
+  lastTransactionMs = millis();
+  state = IDLE;
+  return true;
+}
+
+// The data bits are the 40 low/high pairs before the final low pulse, so whatever
+// the recording holds before the answer (release edge, response) does not matter
+bool DhtRmt::decode(const void* data, size_t itemCount) {
+  const rmt_item32_t* items = (const rmt_item32_t*)data;
+  uint16_t durations[128];
+  uint8_t levels[128];
+  uint16_t pulseCount = 0;
+
+  for (size_t i = 0; i < itemCount * 2 && pulseCount < 128; i++) {
+    const rmt_item32_t& item = items[i / 2];
+    uint16_t duration = (i % 2 == 0) ? item.duration0 : item.duration1;
+    if (duration == 0) {
+      break;  // End of frame
+    }
+    durations[pulseCount] = duration;
+    levels[pulseCount] = (i % 2 == 0) ? item.level0 : item.level1;
+    pulseCount++;
+  }
+
+  if (pulseCount < MIN_ANSWER_PULSES) {
+    timeouts++;  // Only our own release edge: no sensor
+    return false;
+  }
+
+  int lastLow = pulseCount - 1;
+  while (lastLow >= 0 && levels[lastLow] != 0) {
+    lastLow--;
+  }
+  if (lastLow < DATA_BITS * 2) {
+    framingErrors++;
+    return false;
+  }
+
+  uint8_t bytes[5] = {0, 0, 0, 0, 0};
+  int firstBit = lastLow - DATA_BITS * 2;
+  for (uint8_t bit = 0; bit < DATA_BITS; bit++) {
+    int low = firstBit + bit * 2;
+    int high = low + 1;
+    if (levels[low] != 0 || levels[high] != 1 ||
+        durations[low] < BIT_LOW_MIN_US || durations[low] > BIT_LOW_MAX_US ||
+        durations[high] < BIT_HIGH_MIN_US || durations[high] > BIT_HIGH_MAX_US) {
+      framingErrors++;
+      return false;
+    }
+    if (durations[high] >= BIT_ONE_MIN_US) {
+      bytes[bit / 8] |= (uint8_t)(0x80 >> (bit % 8));
+    }
+  }
+
+  if (bytes[4] != (uint8_t)(bytes[0] + bytes[1] + bytes[2] + bytes[3])) {
+    checksumErrors++;
+    return false;
+  }
+
+  if (type == DHT11) {
+    humidity = bytes[0] + bytes[1] * 0.1;
+    temperature = bytes[2];
+    if (bytes[3] & 0x80) {
+      temperature = -1 - temperature;
+    }
+    temperature += (bytes[3] & 0x0F) * 0.1;
+  } else {
+    humidity = ((bytes[0] << 8) | bytes[1]) * 0.1;
+    temperature = (((bytes[2] & 0x7F) << 8) | bytes[3]) * 0.1;
+    if (bytes[2] & 0x80) {
+      temperature = -temperature;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,359 @@
+// OneWire RMT Implementation
+// TX items: one per slot (low, then released). RX records the whole line, so a read
+// slot's low pulse is our 6 µs plus however long the device held the bus low.
+
+#include "OneWireRmt.h"
+#include "Logger.h"
+#include "driver/rmt.h"
+#include "freertos/ringbuf.h"
+#include "soc/gpio_struct.h"
+#include "soc/gpio_periph.h"
+#include "soc/io_mux_reg.h"
+
+// Slot timing in µs (RMT clock 1 MHz)
+static const uint16_t RESET_LOW_US = 480;
+static const uint16_t RESET_WAIT_US = 480;       // Presence pulse happens in here
+static const uint16_t PRESENCE_WINDOW_US = 300;  // Low pulse starting this soon after release = presence
+static const uint16_t SLOT_US = 70;              // Slot + recovery
+static const uint16_t WRITE_1_LOW_US = 6;
+static const uint16_t WRITE_0_LOW_US = 60;
+static const uint16_t READ_LOW_US = 6;
+static const uint16_t READ_1_MAX_LOW_US = 15;    // Longer = the device pulled a 0
+
+static const uint16_t RX_IDLE_US = 1000;  // Longer than any pulse in a segment: ends the RX frame
+static const uint8_t RX_MEM_BLOCKS = 2;   // 128 items
+static const uint16_t SEGMENT_MAX_SLOTS = 64 * RX_MEM_BLOCKS - 8;  // Reset uses 2 RX items, keep a margin
+static const unsigned long SEGMENT_TIMEOUT_MS = 50;
+
+static const rmt_channel_t TX_CHANNEL = (rmt_channel_t)ONEWIRE_RMT_TX_CHANNEL;
+static const rmt_channel_t RX_CHANNEL = (rmt_channel_t)ONEWIRE_RMT_RX_CHANNEL;
+
+// Shared by all buses
+static bool rmtInstalled = false;
+static RingbufHandle_t rxRingbuf = nullptr;
+static OneWireRmt* owner = nullptr;  // Bus the channels are routed to
+static rmt_item32_t txItems[SEGMENT_MAX_SLOTS];
+
+static void routeTo(uint8_t pin) {
+  // RX first: rmt_set_gpio(RX) sets the pad to input and would drop the TX signal
+  rmt_set_gpio(RX_CHANNEL, RMT_MODE_RX, (gpio_num_t)pin, false);
+  rmt_set_gpio(TX_CHANNEL, RMT_MODE_TX, (gpio_num_t)pin, false);
+  PIN_INPUT_ENABLE(GPIO_PIN_MUX_REG[pin]);  // RX listens to the pad we drive
+  GPIO.pin[pin].pad_driver = 1;              // Open drain: RMT pulls low, the 4.7kΩ pull-up releases
+}
+
+static void release(uint8_t pin) {
+  pinMatrixOutDetach(pin, false, false);
+  pinMode(pin, INPUT);  // Bus idles high on its pull-up
+}
+
+OneWireRmt::OneWireRmt(uint8_t pin) {
+  this->pin = pin;
+  this->busy = false;
+  this->ok = false;
+  this->presence = false;
+  this->withReset = false;
+  this->writeBits = 0;
+  this->readBits = 0;
+  this->nextSlot = 0;
+  this->segmentSlots = 0;
+  this->segmentStartTime = 0;
+  memset(writeData, 0, sizeof(writeData));
+  memset(readData, 0, sizeof(readData));
+  reset_search();
+}
+
+bool OneWireRmt::begin() {
+  if (rmtInstalled) {
+    if (owner != this) {
+      pinMode(pin, INPUT);
+    }
+    return true;
+  }
+
+  rmt_config_t tx = RMT_DEFAULT_CONFIG_TX((gpio_num_t)pin, TX_CHANNEL);
+  tx.clk_div = 80;  // 1 µs ticks
+  tx.mem_block_num = 1;
+  tx.tx_config.idle_output_en = true;
+  tx.tx_config.idle_level = RMT_IDLE_LEVEL_HIGH;
+
+  rmt_config_t rx = RMT_DEFAULT_CONFIG_RX((gpio_num_t)pin, RX_CHANNEL);
+  rx.clk_div = 80;
+  rx.mem_block_num = RX_MEM_BLOCKS;
+  rx.rx_config.filter_en = true;
+  rx.rx_config.filter_ticks_thresh = 100;  // APB ticks: ignore glitches shorter than 1.25 µs
+  rx.rx_config.idle_threshold = RX_IDLE_US;
+
+  if (rmt_config(&rx) != ESP_OK || rmt_config(&tx) != ESP_OK ||
+      rmt_driver_install(RX_CHANNEL, 1024, 0) != ESP_OK ||
+      rmt_driver_install(TX_CHANNEL, 0, 0) != ESP_OK ||
+      rmt_get_ringbuf_handle(RX_CHANNEL, &rxRingbuf) != ESP_OK) {
+    LOG_ERROR("❌ OneWire: RMT channels %d/%d unavailable", ONEWIRE_RMT_TX_CHANNEL, ONEWIRE_RMT_RX_CHANNEL);
+    return false;
+  }
+
+  rmtInstalled = true;
+  owner = this;
+  routeTo(pin);
+  return true;
+}
+
+uint16_t OneWireRmt::slotCount() const {
+  return (withReset ? 1 : 0) + writeBits + readBits;
+}
+
+bool OneWireRmt::startTransaction(bool reset, const uint8_t* data, uint16_t bitsToWrite, uint16_t bitsToRead) {
+  if (!rmtInstalled || bitsToWrite > ONEWIRE_RMT_MAX_WRITE * 8 || bitsToRead > ONEWIRE_RMT_MAX_READ * 8) {
+    return false;
+  }
+
+  // One transaction at a time on the shared channels
+  while (owner != nullptr && owner->busy) {
+    owner->poll(true);
+  }
+  if (owner != this) {
+    if (owner != nullptr) {
+      release(owner->pin);
+    }
+    routeTo(pin);
+    owner = this;
+  }
+
+  withReset = reset;
+  writeBits = bitsToWrite;
+  readBits = bitsToRead;
+  if (bitsToWrite > 0) {
+    memcpy(writeData, data, (bitsToWrite + 7) / 8);
+  }
+  memset(readData, 0, sizeof(readData));
+  nextSlot = 0;
+  ok = false;
+  presence = false;
+  busy = true;
+
+  startSegment();
+  return true;
+}
+
+void OneWireRmt::startSegment() {
+  uint16_t remaining = slotCount() - nextSlot;
+  segmentSlots = remaining < SEGMENT_MAX_SLOTS ? remaining : SEGMENT_MAX_SLOTS;
+  uint16_t firstBitSlot = withReset ? 1 : 0;
+
+  for (uint16_t i = 0; i < segmentSlots; i++) {
+    uint16_t slot = nextSlot + i;
+    rmt_item32_t& item = txItems[i];
+    item.level0 = 0;  // Pull low
+    item.level1 = 1;  // Release
+
+    if (slot < firstBitSlot) {
+      item.duration0 = RESET_LOW_US;
+      item.duration1 = RESET_WAIT_US;
+      continue;
+    }
+
+    uint16_t bit = slot - firstBitSlot;
+    uint16_t low = READ_LOW_US;
+    if (bit < writeBits) {
+      low = ((writeData[bit / 8] >> (bit % 8)) & 1) ? WRITE_1_LOW_US : WRITE_0_LOW_US;
+    }
+    item.duration0 = low;
+    item.duration1 = SLOT_US - low;
+  }
+
+  // Drop leftovers, then listen before transmitting
+  size_t length = 0;
+  void* stale;
+  while ((stale = xRingbufferReceive(rxRingbuf, &length, 0)) != nullptr) {
+    vRingbufferReturnItem(rxRingbuf, stale);
+  }
+  rmt_rx_start(RX_CHANNEL, true);
+  rmt_write_items(TX_CHANNEL, txItems, segmentSlots, false);  // Returns at once; driver ISR refills
+  segmentStartTime = millis();
+}
+
+// Walk the recorded low pulses in order: our reset, the device's presence pulse,
+// then one low pulse per slot. Returns false if slots are missing.
+bool OneWireRmt::decodeSegment(const void* data, size_t itemCount) {
+  const rmt_item32_t* items = (const rmt_item32_t*)data;
+  uint16_t slot = nextSlot;
+  uint16_t endSlot = nextSlot + segmentSlots;
+  uint16_t firstBitSlot = withReset ? 1 : 0;
+  uint32_t time = 0;  // µs since the first edge
+  bool resetSeen = false;
+  uint32_t resetReleaseTime = 0;
+  bool valid = true;
+
+  for (size_t i = 0; i < itemCount * 2; i++) {
+    const rmt_item32_t& item = items[i / 2];
+    uint32_t duration = (i % 2 == 0) ? item.duration0 : item.duration1;
+    uint32_t level = (i % 2 == 0) ? item.level0 : item.level1;
+    if (duration == 0) {
+      break;  // End of frame
+    }
+
+    if (level == 0) {
+      if (resetSeen && time - resetReleaseTime < PRESENCE_WINDOW_US) {
+        presence = true;
+      } else if (slot < endSlot) {
+        if (slot < firstBitSlot) {
+          resetSeen = true;
+          resetReleaseTime = time + duration;
+          valid = valid && duration >= RESET_LOW_US / 2;
+        } else {
+          uint16_t bit = slot - firstBitSlot;
+          if (bit >= writeBits && duration < READ_1_MAX_LOW_US) {
+            uint16_t readBit = bit - writeBits;
+            readData[readBit / 8] |= (uint8_t)(1 << (readBit % 8));
+          }
+        }
+        slot++;
+      }
+    }
+    time += duration;
+  }
+
+  return valid && slot == endSlot;
+}
+
+void OneWireRmt::finish(bool success) {
+  ok = success;
+  busy = false;
+}
+
+void OneWireRmt::poll(bool wait) {
+  if (!busy) {
+    return;
+  }
+
+  size_t length = 0;
+  void* items = xRingbufferReceive(rxRingbuf, &length, wait ? pdMS_TO_TICKS(SEGMENT_TIMEOUT_MS) : 0);
+  if (items == nullptr) {
+    if (wait || millis() - segmentStartTime > SEGMENT_TIMEOUT_MS) {
+      rmt_rx_stop(RX_CHANNEL);
+      finish(false);  // Bus stuck low or no RX frame
+    }
+    return;
+  }
+
+  bool segmentOk = decodeSegment(items, length / sizeof(rmt_item32_t));
+  vRingbufferReturnItem(rxRingbuf, items);
+  rmt_rx_stop(RX_CHANNEL);
+
+  bool resetInSegment = withReset && nextSlot == 0;
+  nextSlot += segmentSlots;
+  if (!segmentOk || (resetInSegment && !presence)) {
+    finish(false);  // Nobody on the bus - skip the remaining slots
+  } else if (nextSlot >= slotCount()) {
+    finish(true);
+  } else {
+    startSegment();
+  }
+}
+
+bool OneWireRmt::isBusy() {
+  poll(false);
+  return busy;
+}
+
+bool OneWireRmt::runBlocking(bool reset, const uint8_t* data, uint16_t bitsToWrite, uint16_t bitsToRead) {
+  return startTransaction(reset, data, bitsToWrite, bitsToRead) && waitForCompletion();
+}
+
+bool OneWireRmt::waitForCompletion() {
+  while (busy) {
+    poll(true);  // Blocks this task only; interrupts and other tasks keep running
+  }
+  return ok;
+}
+
+uint8_t OneWireRmt::reset() {
+  runBlocking(true, nullptr, 0, 0);
+  return presence ? 1 : 0;
+}
+
+void OneWireRmt::reset_search() {
+  lastDiscrepancy = 0;
+  lastDeviceFlag = false;
+  memset(searchRom, 0, sizeof(searchRom));
+}
+
+// Search ROM (0xF0), one device per call. Each step writes the chosen branch and
+// reads the next bit pair in a single transaction.
+bool OneWireRmt::search(uint8_t* newAddr) {
+  if (lastDeviceFlag) {
+    reset_search();
+    return false;
+  }
+
+  uint8_t command = 0xF0;
+  if (!runBlocking(true, &command, 8, 2)) {
+    reset_search();  // No presence
+    return false;
+  }
+
+  uint8_t lastZero = 0;
+  for (uint8_t bitNumber = 1; bitNumber <= 64; bitNumber++) {
+    uint8_t idBit = readData[0] & 1;
+    uint8_t complementBit = (readData[0] >> 1) & 1;
+    if (idBit && complementBit) {
+      reset_search();  // No device left on this branch
+      return false;
+    }
+
+    uint8_t byteIndex = (bitNumber - 1) / 8;
+    uint8_t mask = (uint8_t)(1 << ((bitNumber - 1) % 8));
+    uint8_t direction;
+    if (idBit != complementBit) {
+      direction = idBit;
+    } else {
+      // Discrepancy: repeat the previous path up to the last one, then take the 1 branch there
+      if (bitNumber < lastDiscrepancy) {
+        direction = (searchRom[byteIndex] & mask) ? 1 : 0;
+      } else {
+        direction = (bitNumber == lastDiscrepancy) ? 1 : 0;
+      }
+      if (direction == 0) {
+        lastZero = bitNumber;
+      }
+    }
+
+    if (direction) {
+      searchRom[byteIndex] |= mask;
+    } else {
+      searchRom[byteIndex] &= (uint8_t)~mask;
+    }
+
+    if (!runBlocking(false, &direction, 1, bitNumber < 64 ? 2 : 0)) {
+      reset_search();
+      return false;
+    }
+  }
+
+  lastDiscrepancy = lastZero;
+  lastDeviceFlag = (lastDiscrepancy == 0);
+  if (searchRom[0] == 0) {
+    reset_search();
+    return false;
+  }
+
+  memcpy(newAddr, searchRom, sizeof(searchRom));
+  return true;
+}
+
+// Dallas/Maxim CRC-8 (x^8 + x^5 + x^4 + 1)
+uint8_t OneWireRmt::crc8(const uint8_t* addr, uint8_t len) {
+  uint8_t crc = 0;
+  while (len--) {
+    uint8_t inbyte = *addr++;
+    for (uint8_t i = 8; i; i--) {
+      uint8_t mix = (crc ^ inbyte) & 0x01;
+      crc >>= 1;
+      if (mix) {
+        crc ^= 0x8C;
+      }
+      inbyte >>= 1;
+    }
+  }
+  return crc;
+}
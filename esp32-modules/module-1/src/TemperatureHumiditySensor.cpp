@@ -21,14 +21,10 @@ TemperatureHumiditySensor::TemperatureHumiditySensor(MQTTManager* mqtt, uint8_t
   this->lastHumidity = 0.0;
   this->forceUpdateRequested = false;
   this->lastMQTTState = false;  // Initialize as disconnected
+  this->readStarted = false;
   
   // Initialize temperature averaging
-  this->temperatureIndex = 0;
-  this->temperatureCount = 0;
   this->lastAverageTime = 0;
-  for (int i = 0; i < TEMP_AVERAGE_COUNT; i++) {
-    this->temperatureReadings[i] = 0.0;
-  }
 }
 
 void TemperatureHumiditySensor::begin() {
@@ -67,8 +63,14 @@ void TemperatureHumiditySensor::loop() {
   // Read sensors at intervals OR on force update
   unsigned long currentTime = millis();
   bool isForceUpdate = forceUpdateRequested;
-  if (currentTime - lastSensorRead > SENSOR_READ_INTERVAL || isForceUpdate) {
+  if (!readStarted && (currentTime - lastSensorRead > SENSOR_READ_INTERVAL || isForceUpdate)) {
     lastSensorRead = currentTime;
+    dht.startRead();  // Answer is captured by RMT in the background
+    readStarted = true;
+  }
+  
+  if (readStarted && dht.isReadComplete()) {
+    readStarted = false;
     
     // Read data from sensor
     float temperature = readTemperature();
@@ -77,16 +79,12 @@ void TemperatureHumiditySensor::loop() {
     // Publish if valid and needed
     if (!isnan(temperature) && !isnan(humidity)) {
       // Store temperature reading for averaging
-      temperatureReadings[temperatureIndex] = temperature;
-      temperatureIndex = (temperatureIndex + 1) % TEMP_AVERAGE_COUNT;
-      if (temperatureCount < TEMP_AVERAGE_COUNT) {
-        temperatureCount++;
-      }
+      temperatureAverage.add(temperature);
       
       // Calculate average temperature every 5 seconds OR on force update
-      if (temperatureCount >= TEMP_AVERAGE_COUNT && 
+      if (temperatureAverage.isFull() && 
           (currentTime - lastAverageTime >= TEMP_AVERAGE_INTERVAL || isForceUpdate)) {
-        float averageTemperature = calculateAverageTemperature();
+        float averageTemperature = temperatureAverage.getAverage();
         publishIfNeeded(averageTemperature, humidity, currentTime, isForceUpdate);
         lastAverageTime = currentTime;
         forceUpdateRequested = false;
@@ -105,7 +103,7 @@ void TemperatureHumiditySensor::loop() {
 }
 
 float TemperatureHumiditySensor::readTemperature() {
-  float temp = dht.readTemperature();
+  float temp = dht.getTemperature();
   
   if (isnan(temp)) {
     if (DEBUG_SERIAL) {
@@ -118,7 +116,7 @@ float TemperatureHumiditySensor::readTemperature() {
 }
 
 float TemperatureHumiditySensor::readHumidity() {
-  float humidity = dht.readHumidity();
+  float humidity = dht.getHumidity();
   
   if (isnan(humidity)) {
     if (DEBUG_SERIAL) {
@@ -130,14 +128,6 @@ float TemperatureHumiditySensor::readHumidity() {
   return humidity;
 }
 
-float TemperatureHumiditySensor::calculateAverageTemperature() {
-  float sum = 0.0;
-  for (int i = 0; i < TEMP_AVERAGE_COUNT; i++) {
-    sum += temperatureReadings[i];
-  }
-  return sum / TEMP_AVERAGE_COUNT;
-}
-
 void TemperatureHumiditySensor::publishIfNeeded(float temperature, float humidity, unsigned long currentTime, bool forcePublish) {
   // Validate mqttManager pointer
   if (mqttManager == nullptr) {
@@ -219,6 +209,10 @@ void TemperatureHumiditySensor::printStatus() const {
     Serial.println("  Last Humidity: " + String(lastHumidity) + "%");
     Serial.println("  Last Data Sent: " + String((millis() - lastDataSent) / 1000) + " seconds ago");
     Serial.println("  Force Update Requested: " + String(forceUpdateRequested ? "Yes" : "No"));
+    Serial.println("  DHT Reads: " + String(dht.getReadCount()) +
+                   " (checksum errors: " + String(dht.getChecksumErrors()) +
+                   ", framing errors: " + String(dht.getFramingErrors()) +
+                   ", no answer: " + String(dht.getTimeouts()) + ")");
   }
 }
 
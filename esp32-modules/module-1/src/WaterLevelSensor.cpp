@@ -4,7 +4,19 @@
 #include "WaterLevelSensor.h"
 #include <Arduino.h>
 
-WaterLevelSensor::WaterLevelSensor(MQTTManager* mqtt) {
+// Electrodes from bottom to top
+static constexpr uint8_t LEVEL_PINS[NUM_LEVEL_PINS] = {
+  WATER_LEVEL_PIN_1, WATER_LEVEL_PIN_2, WATER_LEVEL_PIN_3, WATER_LEVEL_PIN_4,
+  WATER_LEVEL_PIN_5, WATER_LEVEL_PIN_6, WATER_LEVEL_PIN_7
+};
+static constexpr uint8_t LEVEL_PERCENTS[NUM_LEVEL_PINS] = {
+  LEVEL_PERCENT_1, LEVEL_PERCENT_2, LEVEL_PERCENT_3, LEVEL_PERCENT_4,
+  LEVEL_PERCENT_5, LEVEL_PERCENT_6, LEVEL_PERCENT_7
+};
+
+WaterLevelSensor::WaterLevelSensor(MQTTManager* mqtt)
+  : electrodes(LEVEL_PINS, LEVEL_PERCENTS, ELECTRODE_SETTLE_US, ELECTRODE_PARALLEL_SCAN),
+    sampling(WATER_LEVEL_READ_INTERVAL_MIN, WATER_LEVEL_READ_INTERVAL_MAX, 1) {  // Any level step is a move
   // Validate input parameters
   if (mqtt == nullptr) {
     if (DEBUG_SERIAL) {
@@ -14,35 +26,10 @@ WaterLevelSensor::WaterLevelSensor(MQTTManager* mqtt) {
   
   this->mqttManager = mqtt;
   
-  // Initialize GPIO pins array (from bottom to top)
-  levelPins[0] = WATER_LEVEL_PIN_1;
-  levelPins[1] = WATER_LEVEL_PIN_2;
-  levelPins[2] = WATER_LEVEL_PIN_3;
-  levelPins[3] = WATER_LEVEL_PIN_4;
-  levelPins[4] = WATER_LEVEL_PIN_5;
-  levelPins[5] = WATER_LEVEL_PIN_6;
-  levelPins[6] = WATER_LEVEL_PIN_7;
-  
-  // Initialize level percentages array
-  levelPercentages[0] = LEVEL_PERCENT_1;
-  levelPercentages[1] = LEVEL_PERCENT_2;
-  levelPercentages[2] = LEVEL_PERCENT_3;
-  levelPercentages[3] = LEVEL_PERCENT_4;
-  levelPercentages[4] = LEVEL_PERCENT_5;
-  levelPercentages[5] = LEVEL_PERCENT_6;
-  levelPercentages[6] = LEVEL_PERCENT_7;
-  
   // Initialize timing
   lastSensorRead = 0;
   lastDataSent = 0;
   
-  // Initialize measurement data
-  measurementIndex = 0;
-  measurementCount = 0;
-  for (int i = 0; i < WATER_LEVEL_MODE_SAMPLE_COUNT; i++) {
-    levelIndices[i] = -1;  // -1 means empty/0%
-  }
-  
   // Initialize last published value
   lastPublishedLevel = -1.0;  // -1 means no value published yet
   forceUpdateRequested = false;
@@ -50,8 +37,8 @@ WaterLevelSensor::WaterLevelSensor(MQTTManager* mqtt) {
 }
 
 void WaterLevelSensor::begin() {
-  // Setup GPIO pins
-  setupPins();
+  // All electrodes INPUT without pull-up between scans
+  electrodes.begin();
   
   if (DEBUG_SERIAL) {
     Serial.println("💧 Water Level Sensor initialized");
@@ -62,23 +49,6 @@ void WaterLevelSensor::begin() {
   }
 }
 
-void WaterLevelSensor::setupPins() {
-  // Set all pins to INPUT (no pull-up) initially
-  for (int i = 0; i < NUM_LEVEL_PINS; i++) {
-    pinMode(levelPins[i], INPUT);
-    digitalWrite(levelPins[i], LOW);
-  }
-}
-
-void WaterLevelSensor::setPinsLow() {
-  // Set all pins to LOW (INPUT mode, no pull-up) to minimize current
-  // This prevents corrosion by minimizing current flow through water
-  for (int i = 0; i < NUM_LEVEL_PINS; i++) {
-    pinMode(levelPins[i], INPUT);
-    digitalWrite(levelPins[i], LOW);
-  }
-}
-
 void WaterLevelSensor::loop() {
   // Validate mqttManager pointer
   if (mqttManager == nullptr) {
@@ -94,7 +64,7 @@ void WaterLevelSensor::loop() {
       Serial.println("🔄 MQTT reconnected - will send water level data immediately");
     }
     // Force a sensor read and publish on next iteration
-    forceUpdateRequested = true;
+    forceUpdate();
   }
   
   // Update last known MQTT state
@@ -102,119 +72,49 @@ void WaterLevelSensor::loop() {
   
   // Check if MQTT is connected
   if (!mqttConnected) {
+    electrodes.cancel();  // No pull-up left on while paused
     return;
   }
   
-  // Read sensors at intervals OR on force update
+  // Start a scan at intervals OR on force update; poll() advances it one step per loop
   unsigned long currentTime = millis();
   bool isForceUpdate = forceUpdateRequested;
-  if (currentTime - lastSensorRead > WATER_LEVEL_READ_INTERVAL || isForceUpdate) {
+  if (electrodes.isIdle() && (currentTime - lastSensorRead > sampling.get() || isForceUpdate)) {
+    electrodes.start(micros());
+  }
+  if (electrodes.poll(micros())) {
+    uint8_t weight = lastSensorRead == 0 ? 1 : sampling.weight(currentTime - lastSensorRead);
     lastSensorRead = currentTime;
-    
-    // Setup all pins to INPUT first (no pull-up)
-    setupPins();
-    
-    // Read water level (returns level index 0-6, or -1 for 0%)
-    // This function measures one pin at a time from top to bottom
-    int level = readWaterLevel();
-    
-    // Set all pins to LOW after measurement to minimize current
-    setPinsLow();
-    
-    // Convert level to percentage (handles -1 as 0%)
-    float percent = levelToPercent(level);
-    
-    // Store level index for mode (not percentage)
-    levelIndices[measurementIndex] = level;
-    measurementIndex = (measurementIndex + 1) % WATER_LEVEL_MODE_SAMPLE_COUNT;
-    if (measurementCount < WATER_LEVEL_MODE_SAMPLE_COUNT) {
-      measurementCount++;
-    }
-
-    if (measurementCount >= WATER_LEVEL_MODE_SAMPLE_COUNT) {
-      int modeLevelIndex = findMode(levelIndices, WATER_LEVEL_MODE_SAMPLE_COUNT);
-      float modePercent = levelToPercent(modeLevelIndex);
-      // Force: publish latest single reading (no mode). Normal: mode over rolling window.
-      float publishPercent = isForceUpdate ? percent : modePercent;
-      publishIfNeeded(publishPercent, currentTime, isForceUpdate);
-      forceUpdateRequested = false;
-    } else if (isForceUpdate) {
-      publishIfNeeded(percent, currentTime, true);
-      forceUpdateRequested = false;
-    }
+    // Level index 0-6, or -1 for 0%
+    processLevel(electrodes.getLevel(), currentTime, isForceUpdate, weight);
   }
 }
 
-int WaterLevelSensor::readWaterLevel() {
-  // Measure one pin at a time from top to bottom
-  // This prevents all pins being PULLUP simultaneously which makes water more positive
-  // Strategy: Set one pin to PULLUP, measure, if LOW (covered) -> return that level
-  //           If HIGH (not covered), set it to INPUT and check next pin
-  
-  // Start from top (pin 7, index 6, 100%) and go down
-  for (int i = NUM_LEVEL_PINS - 1; i >= 0; i--) {
-    // Set only this pin to INPUT_PULLUP
-    pinMode(levelPins[i], INPUT_PULLUP);
-    delay(5);  // Small delay for pull-up to stabilize
-    
-    // Read this pin
-    int pinState = digitalRead(levelPins[i]);
-    
-    // If pin is LOW, it's covered by water (connected to GND through water)
-    if (pinState == LOW) {
-      // This is the highest covered pin - return its index
-      // Set this pin back to INPUT before returning
-      pinMode(levelPins[i], INPUT);
-      digitalWrite(levelPins[i], LOW);
-      return i;  // Return level index (0-6)
-    }
-    
-    // Pin is HIGH (not covered), set it back to INPUT and check next pin
-    pinMode(levelPins[i], INPUT);
-    digitalWrite(levelPins[i], LOW);
-  }
+void WaterLevelSensor::processLevel(int level, unsigned long currentTime, bool isForceUpdate, uint8_t weight) {
+  // Convert level to percentage (handles -1 as 0%)
+  float percent = electrodes.levelToPercent(level);
   
-  // No pins covered = 0%
-  return -1;  // Returns -1 if no pins covered
-}
-
-float WaterLevelSensor::levelToPercent(int level) {
-  // level = -1 means 0%
-  if (level < 0 || level >= NUM_LEVEL_PINS) {
-    return 0.0;
+  // Store level index for mode (not percentage), once per 30 s slot the reading covers
+  for (uint8_t i = 0; i < weight; i++) {
+    levelMode.add(level);
   }
-  
-  // Return percentage for this level
-  return (float)levelPercentages[level];
-}
 
-int WaterLevelSensor::findMode(int* values, int count) {
-  // Find the most frequent value (mode) in the array
-  // If there's a tie, return the higher value (more conservative)
-  
-  int maxCount = 0;
-  int modeValue = values[0];  // Default to first value
-  
-  // Count frequency of each value
-  for (int i = 0; i < count; i++) {
-    int currentValue = values[i];
-    int currentCount = 0;
-    
-    // Count how many times this value appears
-    for (int j = 0; j < count; j++) {
-      if (values[j] == currentValue) {
-        currentCount++;
-      }
-    }
-    
-    // If this value appears more often, or same count but higher value
-    if (currentCount > maxCount || (currentCount == maxCount && currentValue > modeValue)) {
-      maxCount = currentCount;
-      modeValue = currentValue;
+  if (levelMode.isFull()) {
+    int modeLevelIndex = levelMode.getMode();
+    // Fast while the level moves or the mode has not caught up with it yet
+    sampling.update(level, modeLevelIndex);
+    float modePercent = electrodes.levelToPercent(modeLevelIndex);
+    // Force: publish latest single reading (no mode). Normal: mode over rolling window.
+    float publishPercent = isForceUpdate ? percent : modePercent;
+    publishIfNeeded(publishPercent, currentTime, isForceUpdate);
+    forceUpdateRequested = false;
+  } else {
+    sampling.update(level, NAN);
+    if (isForceUpdate) {
+      publishIfNeeded(percent, currentTime, true);
+      forceUpdateRequested = false;
     }
   }
-  
-  return modeValue;
 }
 
 void WaterLevelSensor::publishIfNeeded(float averagePercent, unsigned long currentTime, bool forcePublish) {
@@ -269,13 +169,16 @@ void WaterLevelSensor::publishIfNeeded(float averagePercent, unsigned long curre
 
 void WaterLevelSensor::forceUpdate() {
   forceUpdateRequested = true;
+  sampling.speedUp();
 }
 
 void WaterLevelSensor::printStatus() const {
   if (DEBUG_SERIAL) {
     Serial.println("📊 Water Level Sensor Status:");
     Serial.println("  Last Level: " + String(lastPublishedLevel >= 0 ? String(lastPublishedLevel, 1) + "%" : "N/A"));
-    Serial.println("  Measurement Count: " + String(measurementCount) + "/" + String(WATER_LEVEL_MODE_SAMPLE_COUNT));
+    Serial.println("  Measurement Count: " + String(levelMode.getCount()) + "/" + String(WATER_LEVEL_MODE_SAMPLE_COUNT));
+    Serial.println("  Read Interval: " + String(sampling.get() / 1000) + " s");
+    Serial.println("  Electrode Scans: " + String(electrodes.getScanCount()));
     Serial.println("  Last Data Sent: " + String((millis() - lastDataSent) / 1000) + " seconds ago");
     Serial.println("  Force Update Requested: " + String(forceUpdateRequested ? "Yes" : "No"));
   }
@@ -0,0 +1,11 @@
+// Host build shim for module-1 tools (not used by the firmware build)
+// Provides just enough of the Arduino headers for the header-only helpers
+// (RollingMode) to compile on Linux.
+
+#ifndef HOST_ARDUINO_SHIM_H
+#define HOST_ARDUINO_SHIM_H
+
+#include <cstddef>
+#include <cstdint>
+
+#endif
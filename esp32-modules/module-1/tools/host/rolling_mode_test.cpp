@@ -0,0 +1,216 @@
+/**
+ * Host test for RollingMode (electrode level mode, shared with module-5 and module-7).
+ *
+ * Runs the previous O(n^2) findMode() over the same ring of level indices the sensors
+ * kept before RollingMode, side by side with RollingMode<WINDOW, LEVELS>::getMode():
+ * - random level walks (mostly +-1 steps, some jumps; -1..LEVELS-1 as the scanner reports),
+ * - explicit ties (two or more levels with the same count, including -1),
+ * - windows 1, 4, 10 and 360 with 2 and 7 levels,
+ * - every sample of the window filling up (partial window: findMode over the samples
+ *   added so far, which start at ring slot 0) and every sample after it is full.
+ * Exits non-zero on the first mismatch.
+ *
+ * Build and run (Linux):
+ *   cd esp32-modules/module-1
+ *   g++ -std=gnu++17 -O2 -Wall -Itools/host -Iinclude \
+ *       tools/host/rolling_mode_test.cpp -o /tmp/rolling_mode_test
+ *   /tmp/rolling_mode_test
+ */
+
+#include "RollingMode.h"
+
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Reference (previous WaterLevelSensor / UrineLevelSensor / CleanWaterLevelSensor code)
+// ---------------------------------------------------------------------------
+
+static int findMode(int *values, int count) {
+  // Find the most frequent value (mode) in the array
+  // If there's a tie, return the higher value (more conservative)
+
+  int maxCount = 0;
+  int modeValue = values[0];  // Default to first value
+
+  // Count frequency of each value
+  for (int i = 0; i < count; i++) {
+    int currentValue = values[i];
+    int currentCount = 0;
+
+    // Count how many times this value appears
+    for (int j = 0; j < count; j++) {
+      if (values[j] == currentValue) {
+        currentCount++;
+      }
+    }
+
+    // If this value appears more often, or same count but higher value
+    if (currentCount > maxCount || (currentCount == maxCount && currentValue > modeValue)) {
+      maxCount = currentCount;
+      modeValue = currentValue;
+    }
+  }
+
+  return modeValue;
+}
+
+// Previous rolling window: level indices, -1 = empty, written round-robin
+template <int WINDOW, int LEVELS>
+class ReferenceWindow {
+ public:
+  ReferenceWindow() {
+    for (int i = 0; i < WINDOW; i++) {
+      levelIndices[i] = -1;
+    }
+  }
+
+  void add(int level) {
+    levelIndices[measurementIndex] = level;
+    measurementIndex = (measurementIndex + 1) % WINDOW;
+    if (measurementCount < WINDOW) {
+      measurementCount++;
+    }
+  }
+
+  int getMode() { return findMode(levelIndices, measurementCount); }
+  int getCount() const { return measurementCount; }
+
+ private:
+  int levelIndices[WINDOW];
+  int measurementIndex = 0;
+  int measurementCount = 0;
+};
+
+// ---------------------------------------------------------------------------
+// Side-by-side runs
+// ---------------------------------------------------------------------------
+
+static int failures = 0;
+static long comparisons = 0;
+
+template <int WINDOW, int LEVELS>
+static bool compare(const char *name, const std::vector<int> &levels) {
+  ReferenceWindow<WINDOW, LEVELS> reference;
+  RollingMode<WINDOW, LEVELS> rolling;
+
+  for (size_t i = 0; i < levels.size(); i++) {
+    reference.add(levels[i]);
+    rolling.add(levels[i]);
+    comparisons++;
+
+    if ((int)rolling.getCount() != reference.getCount() || rolling.isFull() != (reference.getCount() >= WINDOW)) {
+      printf("FAIL %s W=%d L=%d sample %zu: count %u, expected %d\n", name, WINDOW, LEVELS, i, rolling.getCount(),
+             reference.getCount());
+      failures++;
+      return false;
+    }
+    int expected = reference.getMode();
+    int actual = rolling.getMode();
+    if (actual != expected) {
+      printf("FAIL %s W=%d L=%d sample %zu (%s window): mode %d, expected %d\n", name, WINDOW, LEVELS, i,
+             reference.getCount() < WINDOW ? "partial" : "full", actual, expected);
+      failures++;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Mostly small steps like a filling/draining tank with sloshing, plus jumps
+static std::vector<int> randomWalk(std::mt19937 &rng, int levels, size_t length) {
+  std::uniform_int_distribution<int> step(0, 99);
+  std::uniform_int_distribution<int> any(-1, levels - 1);
+  std::vector<int> walk;
+  int level = any(rng);
+  for (size_t i = 0; i < length; i++) {
+    int r = step(rng);
+    if (r < 30) {
+      level = level > -1 ? level - 1 : level;
+    } else if (r < 60) {
+      level = level < levels - 1 ? level + 1 : level;
+    } else if (r < 95) {
+      // Unchanged
+    } else {
+      level = any(rng);
+    }
+    walk.push_back(level);
+  }
+  return walk;
+}
+
+// Blocks of equal length for each level in turn, so full windows hold exact ties
+static std::vector<int> tieBlocks(int window, int levels, const std::vector<int> &order) {
+  std::vector<int> samples;
+  int block = window / (int)order.size();
+  if (block < 1) {
+    block = 1;
+  }
+  for (int repeat = 0; repeat < 3; repeat++) {
+    for (int level : order) {
+      if (level >= levels) {
+        continue;
+      }
+      for (int i = 0; i < block; i++) {
+        samples.push_back(level);
+      }
+    }
+  }
+  return samples;
+}
+
+// Alternating levels: every other full window of even size is a tie
+static std::vector<int> alternating(int a, int b, size_t length) {
+  std::vector<int> samples;
+  for (size_t i = 0; i < length; i++) {
+    samples.push_back(i % 2 ? a : b);
+  }
+  return samples;
+}
+
+template <int WINDOW, int LEVELS>
+static void run(std::mt19937 &rng) {
+  int failuresBefore = failures;
+  for (int walk = 0; walk < 50; walk++) {
+    compare<WINDOW, LEVELS>("random walk", randomWalk(rng, LEVELS, WINDOW * 5 + 50));
+  }
+
+  // Ties between low and high levels, in both orders, with and without -1
+  compare<WINDOW, LEVELS>("tie low-high", tieBlocks(WINDOW, LEVELS, {0, LEVELS - 1}));
+  compare<WINDOW, LEVELS>("tie high-low", tieBlocks(WINDOW, LEVELS, {LEVELS - 1, 0}));
+  compare<WINDOW, LEVELS>("tie empty-top", tieBlocks(WINDOW, LEVELS, {-1, LEVELS - 1}));
+  compare<WINDOW, LEVELS>("tie top-empty", tieBlocks(WINDOW, LEVELS, {LEVELS - 1, -1}));
+  compare<WINDOW, LEVELS>("tie three", tieBlocks(WINDOW, LEVELS, {1, -1, 0}));
+  compare<WINDOW, LEVELS>("alternating", alternating(-1, LEVELS - 1, WINDOW * 3 + 1));
+  compare<WINDOW, LEVELS>("alternating mid", alternating(LEVELS / 2, 0, WINDOW * 3 + 1));
+
+  // Constant level and a single step (mode must follow after half a window)
+  compare<WINDOW, LEVELS>("constant", std::vector<int>(WINDOW * 2, LEVELS - 1));
+  std::vector<int> step(WINDOW, 0);
+  step.insert(step.end(), WINDOW * 2, LEVELS - 1);
+  compare<WINDOW, LEVELS>("step", step);
+
+  printf("  window %3d, %d levels: %s\n", WINDOW, LEVELS, failures == failuresBefore ? "ok" : "MISMATCH");
+}
+
+int main() {
+  std::mt19937 rng(47);
+
+  printf("RollingMode vs findMode (random walks, ties, partial and full windows)\n");
+  run<1, 2>(rng);
+  run<1, 7>(rng);
+  run<4, 2>(rng);
+  run<4, 7>(rng);
+  run<10, 2>(rng);
+  run<10, 7>(rng);
+  run<360, 2>(rng);
+  run<360, 7>(rng);
+
+  if (failures > 0) {
+    printf("%d mismatching run(s)\n", failures);
+    return 1;
+  }
+  printf("%ld modes compared, all equal\n", comparisons);
+  return 0;
+}
@@ -41,6 +41,10 @@ private:
     bool lastRawReading;
     unsigned long lastDebounceTime;
     bool debouncedState;
+    
+    // Input-to-photon tracing
+    bool edgePending;        // Raw reading differs from debounced state
+    uint32_t edgeMicros;     // micros() of the first raw change of that edge
   };
   
   ButtonStateMachine buttons[NUM_BUTTONS];
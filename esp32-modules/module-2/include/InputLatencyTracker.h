@@ -0,0 +1,87 @@
+// Input Latency Tracker
+// Input-to-photon latency for buttons and PIR (module-2)
+// A trace starts at the input edge (first raw reading change seen by the poll loop)
+// and is stamped at each pipeline stage until the transition's final Show():
+//   edge -> dispatch (debounce/poll done, controller called)
+//        -> relay    (power relay settled - POWER_RELAY_ON_DELAY, or immediate if already on)
+//        -> start    (transition started)
+//        -> first    (first frame shown - first photon)
+//        -> done     (last transition frame shown)
+// Per input source: average/max per stage and log2 histograms of edge->first and edge->done.
+// Published on demand via commands/module-2/metrics/latency.
+// Owned by LEDStripController (marks render stages), fed by ButtonHandler / PIRSensorHandler.
+
+#ifndef INPUT_LATENCY_TRACKER_H
+#define INPUT_LATENCY_TRACKER_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+// Forward declaration
+class MQTTManager;
+
+// Sources: button index 0..NUM_BUTTONS-1, then PIR
+#define INPUT_SOURCE_PIR NUM_BUTTONS
+#define INPUT_SOURCE_COUNT (NUM_BUTTONS + 1)
+
+#ifndef INPUT_LATENCY_TIMEOUT_MS
+#define INPUT_LATENCY_TIMEOUT_MS 5000  // Drop traces that never reach "done" (e.g. strip already on)
+#endif
+
+#define PHOTON_BUCKET_COUNT 13  // <1ms, <2ms, ... <2048ms, >=2048ms (powers of two)
+
+enum LatencyStage {
+  LATENCY_STAGE_DISPATCH,
+  LATENCY_STAGE_RELAY,
+  LATENCY_STAGE_START,
+  LATENCY_STAGE_FIRST,
+  LATENCY_STAGE_DONE,
+  LATENCY_STAGE_COUNT
+};
+
+class InputLatencyTracker {
+private:
+  struct Trace {
+    bool active;
+    uint8_t source;
+    uint32_t edgeMicros;
+    uint32_t stageMicros[LATENCY_STAGE_COUNT];
+    uint8_t stagesSeen;  // Bit per LatencyStage
+  };
+
+  struct SourceStats {
+    uint32_t count;
+    uint32_t dropped;    // Timed out or replaced by a newer input before "done"
+    uint64_t sumMicros[LATENCY_STAGE_COUNT];  // edge -> stage
+    uint32_t maxMicros[LATENCY_STAGE_COUNT];
+    uint16_t firstHist[PHOTON_BUCKET_COUNT];
+    uint16_t doneHist[PHOTON_BUCKET_COUNT];
+  };
+
+  Trace traces[NUM_STRIPS];  // One in-flight trace per strip
+  SourceStats stats[INPUT_SOURCE_COUNT];
+  bool publishRequested;
+
+  void complete(Trace& trace);
+  static uint8_t bucketFor(uint32_t micros);
+  static String sourceName(uint8_t source);
+  static const char* stageName(uint8_t stage);
+
+public:
+  InputLatencyTracker();
+
+  // Input handlers: edge time is micros() when the raw reading first changed
+  void beginTrace(uint8_t source, uint8_t stripIndex, uint32_t edgeMicros);
+
+  // LEDStripController: stamp a stage (first stamp wins, ignored without a trace)
+  void markStage(uint8_t stripIndex, LatencyStage stage);
+  bool isTracing(uint8_t stripIndex) const { return stripIndex < NUM_STRIPS && traces[stripIndex].active; }
+
+  // Publishing (requested from the MQTT callback, sent from loop())
+  void requestPublish() { publishRequested = true; }
+  void loop(MQTTManager* mqtt);
+
+  void printStatus() const;
+};
+
+#endif
@@ -6,6 +6,7 @@
 
 #include "Config.h"
 #include "StripState.h"
+#include "InputLatencyTracker.h"
 #include <NeoPixelBus.h>
 #include <Arduino.h>
 
@@ -95,6 +96,9 @@ private:
   
   // Callback for strip state changes (for status publishing)
   StripStateChangeCallback stripStateChangeCallback;
+  
+  // Input-to-photon latency (stages stamped from the render path)
+  InputLatencyTracker latencyTracker;
 
 public:
   LEDStripController(ModuleManager* moduleMgr);
@@ -122,6 +126,8 @@ public:
   bool isStripOn(uint8_t stripIndex) const;
   uint8_t getBrightness(uint8_t stripIndex) const;
   
+  InputLatencyTracker& getLatencyTracker() { return latencyTracker; }
+  
   // Strip configuration getter
   static const StripConfig* getStripConfigs() { return stripConfigs; }
   
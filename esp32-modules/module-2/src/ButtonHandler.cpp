@@ -5,6 +5,7 @@
 #include "RelayController.h"
 #include "LEDManager.h"
 #include "Config.h"
+#include "Logger.h"
 
 ButtonHandler::ButtonHandler(LEDStripController* ledCtrl, RelayController* relayCtrl) 
   : ledController(ledCtrl), relayController(relayCtrl), ledManager(nullptr) {
@@ -17,6 +18,8 @@ ButtonHandler::ButtonHandler(LEDStripController* ledCtrl, RelayController* relay
     buttons[i].lastRawReading = false;
     buttons[i].lastDebounceTime = 0;
     buttons[i].debouncedState = false;
+    buttons[i].edgePending = false;
+    buttons[i].edgeMicros = 0;
   }
 }
 
@@ -59,10 +62,17 @@ void ButtonHandler::processButton(uint8_t btnIndex, unsigned long currentTime) {
   
   if (rawButtonReading != btn.lastRawReading) {
     btn.lastDebounceTime = currentTime;
+    
+    // Latency is measured from the first bounce, not the debounced edge
+    if (!btn.edgePending && rawButtonReading != btn.debouncedState) {
+      btn.edgePending = true;
+      btn.edgeMicros = micros();
+    }
   }
   
   if (currentTime - btn.lastDebounceTime > DEBOUNCE_DELAY) {
     btn.debouncedState = rawButtonReading;
+    btn.edgePending = false;
   }
   
   btn.lastRawReading = rawButtonReading;
@@ -74,7 +84,7 @@ void ButtonHandler::processButton(uint8_t btnIndex, unsigned long currentTime) {
       if (debouncedButtonState) {
         btn.state = BUTTON_PRESSED;
         btn.pressTime = currentTime;
-        Serial.println("🔘 Button " + String(btnIndex) + " pressed (IDLE -> PRESSED)");
+        LOG_DEBUG("🔘 Button %d pressed (IDLE -> PRESSED)", btnIndex);
       }
       break;
       
@@ -91,8 +101,7 @@ void ButtonHandler::processButton(uint8_t btnIndex, unsigned long currentTime) {
         btn.state = BUTTON_IDLE;
         if (isRelayButton) {
           // Toggle relay
-          Serial.println("🔘 Button " + String(btnIndex) + " released - toggling relay");
-          Serial.flush();
+          LOG_INFO("🔘 Button %d released - toggling relay", btnIndex);
           if (relayController) {
             relayController->toggleRelay(0);
             // Publish relay status update
@@ -102,9 +111,9 @@ void ButtonHandler::processButton(uint8_t btnIndex, unsigned long currentTime) {
           }
         } else {
           // Toggle strip
-          Serial.println("🔘 Button " + String(btnIndex) + " released - toggling strip " + String(stripIndex));
-          Serial.flush();
+          LOG_INFO("🔘 Button %d released - toggling strip %d", btnIndex, stripIndex);
           if (ledController) {
+            ledController->getLatencyTracker().beginTrace(btnIndex, stripIndex, btn.edgeMicros);
             ledController->toggleStrip(stripIndex);
             // Status will be published via callback from LEDStripController
           }
@@ -2,6 +2,7 @@
 // Handle commands from Backend
 
 #include "CommandHandler.h"
+#include "LogStreamer.h"
 #include <Arduino.h>
 
 // For module-2, include LEDManager
@@ -100,6 +101,11 @@ void CommandHandler::handleMQTTMessage(char* topic, byte* payload, unsigned int
     // Call force update function
     forceUpdate();
   }
+  
+  // Runtime log stream level (e.g. {"level":"debug"})
+  if (topicStr.endsWith("/logs/level")) {
+    LogStreamer::handleLevelCommand(message);
+  }
   // Other commands are handled by LEDManager::handleMQTTMessage
 }
 
@@ -0,0 +1,172 @@
+// Input Latency Tracker Implementation
+// Per-strip input-to-photon traces, per-source stage stats and histograms
+
+#include "InputLatencyTracker.h"
+#include "MQTTManager.h"
+#include "ClockSync.h"
+#include "Logger.h"
+#include <ArduinoJson.h>
+
+#define INPUT_LATENCY_TOPIC_SUFFIX "/latency"
+
+InputLatencyTracker::InputLatencyTracker() {
+  memset(traces, 0, sizeof(traces));
+  memset(stats, 0, sizeof(stats));
+  this->publishRequested = false;
+}
+
+void InputLatencyTracker::beginTrace(uint8_t source, uint8_t stripIndex, uint32_t edgeMicros) {
+  if (source >= INPUT_SOURCE_COUNT || stripIndex >= NUM_STRIPS) {
+    return;
+  }
+
+  Trace& trace = traces[stripIndex];
+  if (trace.active) {
+    stats[trace.source].dropped++;  // Newer input before the previous one finished
+  }
+
+  memset(&trace, 0, sizeof(Trace));
+  trace.active = true;
+  trace.source = source;
+  trace.edgeMicros = edgeMicros;
+  markStage(stripIndex, LATENCY_STAGE_DISPATCH);
+}
+
+void InputLatencyTracker::markStage(uint8_t stripIndex, LatencyStage stage) {
+  if (stripIndex >= NUM_STRIPS) {
+    return;
+  }
+
+  Trace& trace = traces[stripIndex];
+  if (!trace.active || (trace.stagesSeen & (1 << stage))) {
+    return;
+  }
+  // "first" is the first frame of the transition, not an earlier forced clear
+  if (stage == LATENCY_STAGE_FIRST && !(trace.stagesSeen & (1 << LATENCY_STAGE_START))) {
+    return;
+  }
+
+  trace.stageMicros[stage] = micros();
+  trace.stagesSeen |= (1 << stage);
+
+  if (stage == LATENCY_STAGE_DONE) {
+    complete(trace);
+  }
+}
+
+void InputLatencyTracker::complete(Trace& trace) {
+  SourceStats& s = stats[trace.source];
+  s.count++;
+
+  // Stages that were skipped (no relay wait) take the time of the next stage
+  uint32_t next = trace.stageMicros[LATENCY_STAGE_DONE];
+  uint32_t latency[LATENCY_STAGE_COUNT];
+  for (int stage = LATENCY_STAGE_COUNT - 1; stage >= 0; stage--) {
+    if (trace.stagesSeen & (1 << stage)) {
+      next = trace.stageMicros[stage];
+    }
+    latency[stage] = next - trace.edgeMicros;
+  }
+
+  for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+    s.sumMicros[stage] += latency[stage];
+    if (latency[stage] > s.maxMicros[stage]) {
+      s.maxMicros[stage] = latency[stage];
+    }
+  }
+  s.firstHist[bucketFor(latency[LATENCY_STAGE_FIRST])]++;
+  s.doneHist[bucketFor(latency[LATENCY_STAGE_DONE])]++;
+
+  LOG_DEBUG("⏱️ %s: first light %lu us, done %lu us", sourceName(trace.source).c_str(),
+            (unsigned long)latency[LATENCY_STAGE_FIRST], (unsigned long)latency[LATENCY_STAGE_DONE]);
+
+  trace.active = false;
+}
+
+void InputLatencyTracker::loop(MQTTManager* mqtt) {
+  // Expire traces whose input had no visible effect
+  uint32_t now = micros();
+  for (int i = 0; i < NUM_STRIPS; i++) {
+    Trace& trace = traces[i];
+    if (trace.active && now - trace.edgeMicros >= (uint32_t)INPUT_LATENCY_TIMEOUT_MS * 1000UL) {
+      stats[trace.source].dropped++;
+      trace.active = false;
+    }
+  }
+
+  if (!publishRequested || mqtt == nullptr || !mqtt->isMQTTConnected()) {
+    return;
+  }
+  publishRequested = false;
+
+  // One message per source keeps each payload well under the MQTT buffer
+  String topic = String(MQTT_TOPIC_PREFIX) + "metrics/" + MODULE_ID + INPUT_LATENCY_TOPIC_SUFFIX;
+  for (int src = 0; src < INPUT_SOURCE_COUNT; src++) {
+    const SourceStats& s = stats[src];
+    if (s.count == 0 && s.dropped == 0) {
+      continue;
+    }
+
+    StaticJsonDocument<1024> doc;
+    doc["source"] = sourceName(src);
+    doc["count"] = s.count;
+    doc["dropped"] = s.dropped;
+    JsonObject avg = doc.createNestedObject("avgUs");
+    JsonObject max = doc.createNestedObject("maxUs");
+    for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+      avg[stageName(stage)] = s.count > 0 ? (uint32_t)(s.sumMicros[stage] / s.count) : 0;
+      max[stageName(stage)] = s.maxMicros[stage];
+    }
+    doc["bucketBaseUs"] = 1000;  // hist[i] = latencies below 1ms << i, last = the rest
+    JsonArray firstHist = doc.createNestedArray("firstHist");
+    JsonArray doneHist = doc.createNestedArray("doneHist");
+    for (int b = 0; b < PHOTON_BUCKET_COUNT; b++) {
+      firstHist.add(s.firstHist[b]);
+      doneHist.add(s.doneHist[b]);
+    }
+    ClockSync::addTimestamp(doc);
+
+    String payload;
+    serializeJson(doc, payload);
+    mqtt->publishRaw(topic, payload);
+  }
+}
+
+uint8_t InputLatencyTracker::bucketFor(uint32_t micros) {
+  uint32_t ms = micros / 1000;
+  if (ms == 0) {
+    return 0;
+  }
+  uint8_t bucket = 32 - __builtin_clz(ms);  // ms in [2^(b-1), 2^b) -> bucket b
+  return bucket < PHOTON_BUCKET_COUNT ? bucket : PHOTON_BUCKET_COUNT - 1;
+}
+
+String InputLatencyTracker::sourceName(uint8_t source) {
+  return source == INPUT_SOURCE_PIR ? String("pir") : "button-" + String(source);
+}
+
+const char* InputLatencyTracker::stageName(uint8_t stage) {
+  switch (stage) {
+    case LATENCY_STAGE_DISPATCH: return "dispatch";
+    case LATENCY_STAGE_RELAY: return "relay";
+    case LATENCY_STAGE_START: return "start";
+    case LATENCY_STAGE_FIRST: return "first";
+    case LATENCY_STAGE_DONE: return "done";
+    default: return "?";
+  }
+}
+
+void InputLatencyTracker::printStatus() const {
+  if (DEBUG_SERIAL) {
+    Serial.println("⏱️ Input Latency Status:");
+    for (int src = 0; src < INPUT_SOURCE_COUNT; src++) {
+      const SourceStats& s = stats[src];
+      if (s.count == 0) {
+        continue;
+      }
+      Serial.println("  " + sourceName(src) + ": " + String(s.count) + " inputs, first light avg " +
+                     String((uint32_t)(s.sumMicros[LATENCY_STAGE_FIRST] / s.count) / 1000) + " ms (max " +
+                     String(s.maxMicros[LATENCY_STAGE_FIRST] / 1000) + " ms), " + String(s.dropped) + " dropped");
+    }
+  }
+}
@@ -4,6 +4,7 @@
 #include "LEDManager.h"
 #include "Config.h"
 #include "MQTTManager.h"
+#include "ClockSync.h"
 #include <ArduinoJson.h>
 
 // Static pointer to current instance
@@ -83,6 +84,11 @@ void LEDManager::loop() {
     pendingStatusUpdate = false;
     publishFullStatus();
   }
+  
+  // Expire stale latency traces, publish stats if requested
+  if (moduleManager) {
+    ledStripController.getLatencyTracker().loop(&moduleManager->getMQTTManager());
+  }
 }
 
 void LEDManager::handleForceUpdate() {
@@ -100,14 +106,27 @@ void LEDManager::handleMQTTMessageStatic(char* topic, byte* payload, unsigned in
 
 // Process MQTT message (instance method)
 void LEDManager::processMQTTMessage(char* topic, byte* payload, unsigned int length) {
-  // First try force_update command (handled by CommandHandler)
+  // First try infrastructure commands: force_update, logs/level (handled by CommandHandler)
   String topicStr = String(topic);
-  if (topicStr.endsWith("/force_update")) {
+  if (topicStr.endsWith("/force_update") || topicStr.endsWith("/logs/level")) {
     commandHandler.handleMQTTMessage(topic, payload, length);
+    if (topicStr.endsWith("/force_update") && moduleManager) {
+      // Full status goes out from loop() - its publish closes the command's round trip
+      moduleManager->getMQTTManager().expectStatus(String(MQTT_TOPIC_SENSORS) + MODULE_ID + "/status");
+    }
+    return;
+  }
+  
+  // Input-to-photon latency stats (published from loop())
+  if (topicStr.endsWith("/metrics/latency")) {
+    ledStripController.getLatencyTracker().requestPublish();
     return;
   }
   
-  // Handle LED-specific commands
+  // Handle LED-specific commands (status published at once or from the strip callbacks)
+  if (moduleManager) {
+    moduleManager->getMQTTManager().expectStatus(String(MQTT_TOPIC_SENSORS) + MODULE_ID + "/status");
+  }
   processLEDCommand(topic, payload, length);
 }
 
@@ -399,6 +418,9 @@ void LEDManager::publishFullStatus() {
     relay["state"] = relayController.getRelayState(i) ? "ON" : "OFF";
   }
   
+  // Wall-clock time (epoch ms) once synced
+  ClockSync::addTimestamp(doc);
+  
   // Serialize JSON
   String jsonString;
   serializeJson(doc, jsonString);
@@ -3,6 +3,7 @@
 
 #include "LEDStripController.h"
 #include "ModuleManager.h"
+#include "Logger.h"
 #include "Config.h"
 #include <Arduino.h>
 
@@ -289,6 +290,7 @@ void LEDStripController::showStrip(uint8_t stripIndex) {
     case 4: ((LedStrip4*)state.strip)->Show(); break;
     case 5: ((LedStrip5*)state.strip)->Show(); break;
   }
+  latencyTracker.markStage(stripIndex, LATENCY_STAGE_FIRST);
 }
 
 // Extension strip sync (kitchen 0→2, bedroom 4→5)
@@ -356,9 +358,7 @@ void LEDStripController::prepareExtensionForTurnOn(uint8_t mainStripIndex) {
   extState.effect = state.effect;
   extState.mode = state.mode;
 
-  if (DEBUG_VERBOSE) {
-    Serial.println("   Syncing extension (Strip " + String(extIndex) + ", pin " + String(stripConfigs[extIndex].pin) + ")");
-  }
+  LOG_VERBOSE("   Syncing extension (Strip %d, pin %d)", extIndex, stripConfigs[extIndex].pin);
 }
 
 void LEDStripController::prepareExtensionForTurnOff(uint8_t mainStripIndex) {
@@ -709,6 +709,7 @@ void LEDStripController::startTransition(uint8_t stripIndex, bool turningOn) {
   trans.targetBrightness = state.brightness;
   trans.randomOrder = nullptr;
   trans.randomIndex = 0;
+  latencyTracker.markStage(stripIndex, LATENCY_STAGE_START);
   
   if (turningOn) {
     // Avoid TRANSITION_NONE: if we pick 0 here, updateTransition() can end up
@@ -717,11 +718,11 @@ void LEDStripController::startTransition(uint8_t stripIndex, bool turningOn) {
     // ON-side switch are 1..(NUM_ON_TRANSITIONS-1).
     int index = random(1, NUM_ON_TRANSITIONS);
     trans.type = (TransitionType)index;
-    Serial.println("✨ Strip " + String(stripIndex) + " ON transition " + String(index));
+    LOG_DEBUG("✨ Strip %u ON transition %d", stripIndex, index);
   } else {
     int index = random(0, NUM_OFF_TRANSITIONS);
     trans.type = (TransitionType)(NUM_ON_TRANSITIONS + index);
-    Serial.println("✨ Strip " + String(stripIndex) + " OFF transition " + String(index));
+    LOG_DEBUG("✨ Strip %u OFF transition %d", stripIndex, index);
   }
 }
 
@@ -789,12 +790,13 @@ void LEDStripController::updateTransition(uint8_t stripIndex) {
   if (!trans.active) {
     if (trans.type < NUM_ON_TRANSITIONS) {
       updateStrip(stripIndex);
-      Serial.println("✅ Strip " + String(stripIndex) + " ON transition completed");
+      LOG_DEBUG("✅ Strip %u ON transition completed", stripIndex);
     } else {
       clearStrip(stripIndex, RgbwColor(0, 0, 0, 0));
       showStrip(stripIndex);
-      Serial.println("✅ Strip " + String(stripIndex) + " OFF transition completed");
+      LOG_DEBUG("✅ Strip %u OFF transition completed", stripIndex);
     }
+    latencyTracker.markStage(stripIndex, LATENCY_STAGE_DONE);
   }
 }
 
@@ -889,10 +891,10 @@ void LEDStripController::updateDimming(uint8_t stripIndex) {
       state.blinkActive = true;
       state.blinkStartTime = millis();
       state.savedBrightnessForBlink = newBrightness;
-      Serial.println("✨ Strip " + String(stripIndex) + " reached MAX brightness - blinking");
+      LOG_DEBUG("✨ Strip %u reached MAX brightness - blinking", stripIndex);
     } else {
       // When decreasing to MIN - no blinking
-      Serial.println("✨ Strip " + String(stripIndex) + " reached MIN brightness");
+      LOG_DEBUG("✨ Strip %u reached MIN brightness", stripIndex);
     }
     
     state.brightness = newBrightness;
@@ -966,9 +968,7 @@ void LEDStripController::turnOnStrip(uint8_t stripIndex) {
   
   StripState& state = stripStates[stripIndex];
   if (state.on) {
-    if (DEBUG_VERBOSE) {
-      Serial.println("⚠️ turnOnStrip called for strip " + String(stripIndex) + " but it's already ON");
-    }
+    LOG_VERBOSE("⚠️ turnOnStrip called for strip %u but it's already ON", stripIndex);
     return;  // Already on
   }
   
@@ -977,6 +977,7 @@ void LEDStripController::turnOnStrip(uint8_t stripIndex) {
   
   // If relay is already ON and not waiting for delay, turn on strip normally
   if (powerRelayOn && !waitingForPowerRelayDelay) {
+    latencyTracker.markStage(stripIndex, LATENCY_STAGE_RELAY);  // No relay wait
     state.on = true;
     if (stripIndex != MOTION_STRIP_INDEX) {
       state.mode = STRIP_MODE_ON;
@@ -987,11 +988,11 @@ void LEDStripController::turnOnStrip(uint8_t stripIndex) {
     startTransition(stripIndex, true);
     copyTransitionToExtension(stripIndex);
     
-    if (DEBUG_VERBOSE && extensionStripForMain(stripIndex) >= 0) {
-      Serial.println("💡 Extension (Strip " + String(extensionStripForMain(stripIndex)) + "): Turning ON with same transition");
+    if (extensionStripForMain(stripIndex) >= 0) {
+      LOG_VERBOSE("💡 Extension (Strip %d): Turning ON with same transition", extensionStripForMain(stripIndex));
     }
     
-    Serial.println("💡 Strip " + String(stripIndex) + " ON (brightness: " + String(state.brightness) + ")");
+    LOG_INFO("💡 Strip %u ON (brightness: %u)", stripIndex, state.brightness);
     
     // Call callback to notify that strip state changed (for status publishing)
     if (stripStateChangeCallback) {
@@ -1006,9 +1007,7 @@ void LEDStripController::turnOffStrip(uint8_t stripIndex) {
   
   StripState& state = stripStates[stripIndex];
   if (!state.on) {
-    if (DEBUG_SERIAL) {
-      Serial.println("⚠️ turnOffStrip: Strip " + String(stripIndex) + " is already OFF");
-    }
+    LOG_DEBUG("⚠️ turnOffStrip: Strip %u is already OFF", stripIndex);
     return;  // Already off
   }
   
@@ -1040,11 +1039,11 @@ void LEDStripController::turnOffStrip(uint8_t stripIndex) {
   startTransition(stripIndex, false);
   copyTransitionToExtension(stripIndex);
 
-  if (DEBUG_VERBOSE && extensionStripForMain(stripIndex) >= 0) {
-    Serial.println("💡 Extension (Strip " + String(extensionStripForMain(stripIndex)) + "): Turning OFF with same transition");
+  if (extensionStripForMain(stripIndex) >= 0) {
+    LOG_VERBOSE("💡 Extension (Strip %d): Turning OFF with same transition", extensionStripForMain(stripIndex));
   }
   
-  Serial.println("💡 Strip " + String(stripIndex) + " OFF (brightness: " + String(state.brightness) + ")");
+  LOG_INFO("💡 Strip %u OFF (brightness: %u)", stripIndex, state.brightness);
   
   // Call callback to notify that strip state changed (for status publishing)
   if (stripStateChangeCallback) {
@@ -1054,14 +1053,12 @@ void LEDStripController::turnOffStrip(uint8_t stripIndex) {
 
 void LEDStripController::toggleStrip(uint8_t stripIndex) {
   if (stripIndex >= NUM_STRIPS) {
-    Serial.println("ERROR: toggleStrip called with invalid stripIndex: " + String(stripIndex));
+    LOG_ERROR("toggleStrip called with invalid stripIndex: %u", stripIndex);
     return;
   }
   
   StripState& state = stripStates[stripIndex];
-  if (DEBUG_VERBOSE) {
-    Serial.println("🔄 toggleStrip(" + String(stripIndex) + ") - current state: " + String(state.on ? "ON" : "OFF"));
-  }
+  LOG_VERBOSE("🔄 toggleStrip(%u) - current state: %s", stripIndex, state.on ? "ON" : "OFF");
   
   if (state.on) {
     turnOffStrip(stripIndex);
@@ -1075,9 +1072,7 @@ void LEDStripController::setStripMode(uint8_t stripIndex, StripMode mode) {
   
   if (stripIndex != MOTION_STRIP_INDEX && mode == STRIP_MODE_AUTO) {
     mode = STRIP_MODE_OFF;
-    if (DEBUG_SERIAL) {
-      Serial.println("⚠️ AUTO mode only for bathroom strip — treating as OFF");
-    }
+    LOG_WARN("⚠️ AUTO mode only for bathroom strip — treating as OFF");
   }
   
   StripState& state = stripStates[stripIndex];
@@ -1088,13 +1083,13 @@ void LEDStripController::setStripMode(uint8_t stripIndex, StripMode mode) {
     if (state.on) {
       turnOffStrip(stripIndex);
     }
-    Serial.println("🔧 Strip " + String(stripIndex) + " mode: OFF");
+    LOG_INFO("🔧 Strip %u mode: OFF", stripIndex);
   } else if (mode == STRIP_MODE_ON) {
     // Turn on the strip with current brightness
     if (!state.on) {
       turnOnStrip(stripIndex);
     }
-    Serial.println("🔧 Strip " + String(stripIndex) + " mode: ON");
+    LOG_INFO("🔧 Strip %u mode: ON", stripIndex);
   } else if (mode == STRIP_MODE_AUTO) {
     // AUTO mode - remember current brightness if strip is on
     if (state.on) {
@@ -1104,7 +1099,7 @@ void LEDStripController::setStripMode(uint8_t stripIndex, StripMode mode) {
     if (state.on) {
       turnOffStrip(stripIndex);
     }
-    Serial.println("🔧 Strip " + String(stripIndex) + " mode: AUTO (brightness: " + String(state.lastAutoBrightness) + ")");
+    LOG_INFO("🔧 Strip %u mode: AUTO (brightness: %u)", stripIndex, state.lastAutoBrightness);
   }
 }
 
@@ -1137,8 +1132,8 @@ void LEDStripController::startDimming(uint8_t stripIndex) {
   uint8_t distance = abs((int)targetBrightness - (int)state.dimmingStartBrightness);
   state.dimmingDuration = (distance * 1000) / DIMMING_SPEED;  // time in milliseconds
   
-  Serial.println("🔆 Strip " + String(stripIndex) + " dimming: " + String(state.dimmingDirection ? "Increasing" : "Decreasing") + 
-                 " (distance: " + String(distance) + ", time: " + String(state.dimmingDuration) + "ms)");
+  LOG_DEBUG("🔆 Strip %u dimming: %s (distance: %u, time: %lums)", stripIndex,
+            state.dimmingDirection ? "Increasing" : "Decreasing", distance, (unsigned long)state.dimmingDuration);
   
   // Kitchen: synchronize extension strip
   syncExtensionStrip(stripIndex);
@@ -1149,7 +1144,7 @@ void LEDStripController::stopDimming(uint8_t stripIndex) {
   
   StripState& state = stripStates[stripIndex];
   state.dimmingActive = false;
-  Serial.println("🔆 Strip " + String(stripIndex) + " dimming stopped (Brightness: " + String(state.brightness) + ")");
+  LOG_DEBUG("🔆 Strip %u dimming stopped (Brightness: %u)", stripIndex, state.brightness);
   
   // Kitchen: synchronize extension strip
   syncExtensionStrip(stripIndex);
@@ -1200,9 +1195,8 @@ void LEDStripController::setBrightnessSmooth(uint8_t stripIndex, uint8_t targetB
   if (state.dimmingDuration < 200) state.dimmingDuration = 200;  // Minimum 200ms
   if (state.dimmingDuration > 2000) state.dimmingDuration = 2000;  // Maximum 2 seconds
   
-  Serial.println("🔆 Strip " + String(stripIndex) + " smooth brightness change: " + 
-                 String(startBrightness) + " → " + String(targetBrightness) + 
-                 " (duration: " + String(state.dimmingDuration) + "ms)");
+  LOG_DEBUG("🔆 Strip %u smooth brightness change: %u → %u (duration: %lums)", stripIndex,
+            startBrightness, targetBrightness, (unsigned long)state.dimmingDuration);
   
   int8_t extIndex = extensionStripForMain(stripIndex);
   if (extIndex >= 0) {
@@ -1230,9 +1224,7 @@ void LEDStripController::ensurePowerRelayOn(uint8_t stripIndex) {
     waitingForPowerRelayDelay = true;
     pendingTurnOnStripIndex = stripIndex;
     // Don't turn on strip yet - will be turned on in loop() after 100ms
-    if (DEBUG_SERIAL) {
-      Serial.println("🔌 Power relay ON (waiting 100ms for stabilization)");
-    }
+    LOG_INFO("🔌 Power relay ON (waiting %dms for stabilization)", POWER_RELAY_ON_DELAY);
   } else if (!waitingForPowerRelayDelay) {
     // Relay is already ON and not waiting for delay - strip can be turned on immediately
     // This function only ensures relay is ON, doesn't turn on the strip
@@ -1256,9 +1248,7 @@ void LEDStripController::checkAndTurnOffPowerRelay() {
   if (allStripsOff && powerRelayOn) {
     powerRelayOn = false;
     digitalWrite(POWER_RELAY_PIN, LOW);
-    if (DEBUG_SERIAL) {
-      Serial.println("🔌 Power relay OFF (all strips are OFF)");
-    }
+    LOG_INFO("🔌 Power relay OFF (all strips are OFF)");
   }
 }
 
@@ -1271,6 +1261,8 @@ void LEDStripController::turnOnStripAfterDelay(uint8_t stripIndex) {
     return;
   }
   
+  latencyTracker.markStage(stripIndex, LATENCY_STAGE_RELAY);
+  
   // Turn on strip normally (but WITHOUT checking relay again)
   state.on = true;
   if (stripIndex != MOTION_STRIP_INDEX) {
@@ -1282,11 +1274,11 @@ void LEDStripController::turnOnStripAfterDelay(uint8_t stripIndex) {
   startTransition(stripIndex, true);
   copyTransitionToExtension(stripIndex);
 
-  if (DEBUG_VERBOSE && extensionStripForMain(stripIndex) >= 0) {
-    Serial.println("💡 Extension (Strip " + String(extensionStripForMain(stripIndex)) + "): Turning ON with same transition");
+  if (extensionStripForMain(stripIndex) >= 0) {
+    LOG_VERBOSE("💡 Extension (Strip %d): Turning ON with same transition", extensionStripForMain(stripIndex));
   }
   
-  Serial.println("💡 Strip " + String(stripIndex) + " ON (brightness: " + String(state.brightness) + ")");
+  LOG_INFO("💡 Strip %u ON (brightness: %u)", stripIndex, state.brightness);
   
   if (stripStateChangeCallback) {
     stripStateChangeCallback(stripIndex);
@@ -1338,6 +1330,7 @@ void LEDStripController::printStatus() const {
                      ", Dimming: " + String(state.dimmingActive ? "Active" : "Inactive") +
                      ", Transition: " + String(state.transition.active ? "Active" : "Inactive"));
     }
+    latencyTracker.printStatus();
   }
 }
 
@@ -3,6 +3,7 @@
 #include "PIRSensorHandler.h"
 #include "LEDStripController.h"
 #include "Config.h"
+#include "Logger.h"
 
 PIRSensorHandler::PIRSensorHandler(LEDStripController* ledCtrl) 
   : ledController(ledCtrl), lastMotionTime(0), lastPirState(false) {
@@ -42,10 +43,9 @@ void PIRSensorHandler::loop() {
         // Turn on only Strip 3 (Bathroom) if not already on
         // Use lastAutoBrightness for brightness
         motionState.brightness = motionState.lastAutoBrightness;
-        Serial.println("🏃 Motion detected - turning ON strip " + String(MOTION_STRIP_INDEX) + " (Bathroom, pin " + String(PIR_SENSOR_PIN) + ")");
-        if (DEBUG_VERBOSE) {
-          Serial.println("   Kitchen strip 2 (pin 19) should remain OFF");
-        }
+        LOG_INFO("🏃 Motion detected - turning ON strip %d (Bathroom, pin %d)", MOTION_STRIP_INDEX, PIR_SENSOR_PIN);
+        LOG_VERBOSE("   Kitchen strip 2 (pin 19) should remain OFF");
+        ledController->getLatencyTracker().beginTrace(INPUT_SOURCE_PIR, MOTION_STRIP_INDEX, micros());
         ledController->turnOnStrip(MOTION_STRIP_INDEX);
       } else {
         // Update last motion time
@@ -56,7 +56,7 @@ void PIRSensorHandler::loop() {
     // Check if we need to turn off the strip after timeout
     if (motionState.on && !motionState.transition.active) {
       if (currentTime - lastMotionTime >= PIR_MOTION_TIMEOUT && lastMotionTime > 0) {
-        Serial.println("⏱️ Motion timeout (" + String(PIR_MOTION_TIMEOUT / 1000) + "s) - turning OFF strip " + String(MOTION_STRIP_INDEX) + " (Bathroom)");
+        LOG_INFO("⏱️ Motion timeout (%ds) - turning OFF strip %d (Bathroom)", PIR_MOTION_TIMEOUT / 1000, MOTION_STRIP_INDEX);
         ledController->turnOffStrip(MOTION_STRIP_INDEX);
         lastMotionTime = 0;  // Reset
       }
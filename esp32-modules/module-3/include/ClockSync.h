@@ -0,0 +1,101 @@
+// Clock Sync
+// Lightweight time sync against the broker host (backend time beacon)
+// Request/response over MQTT, NTP-style: the module stamps the request with its
+// monotonic clock (t0), the backend answers with its epoch time, the module
+// stamps the reply (t3) and assumes the server time sits at (t0 + t3) / 2.
+// A short burst is sent each sync and only the lowest-RTT sample is used.
+// Drift between syncs is estimated and applied, so time stays accurate between bursts.
+//
+// Shared clock API (static, usable by any publisher):
+//   ClockSync::monotonicMicros()  - 64-bit microseconds since boot (never wraps)
+//   ClockSync::epochMillis()      - Unix time in ms (0 until first sync)
+//   ClockSync::addTimestamp(doc)  - adds "ts" (epoch ms) to a JSON payload if synced
+
+#ifndef CLOCK_SYNC_H
+#define CLOCK_SYNC_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "Config.h"
+
+// Forward declaration
+class MQTTManager;
+
+// MQTT topics (backend: backend/mqtt/timeService.js)
+#define CLOCK_SYNC_REQUEST_TOPIC "smartcamper/time/request"
+#define CLOCK_SYNC_RESPONSE_TOPIC_PREFIX "smartcamper/time/response/"
+
+// Defaults if a module's Config.h does not set them
+#ifndef CLOCK_SYNC_INTERVAL_MS
+#define CLOCK_SYNC_INTERVAL_MS 60000   // Time between sync bursts
+#endif
+#ifndef CLOCK_SYNC_SAMPLES
+#define CLOCK_SYNC_SAMPLES 4           // Requests per burst (lowest RTT wins)
+#endif
+#ifndef CLOCK_SYNC_TIMEOUT_MS
+#define CLOCK_SYNC_TIMEOUT_MS 500      // Give up on a single request after this
+#endif
+#ifndef CLOCK_SYNC_MAX_RTT_MS
+#define CLOCK_SYNC_MAX_RTT_MS 250      // Samples slower than this are discarded
+#endif
+
+class ClockSync {
+private:
+  MQTTManager* mqttManager;  // Reference to MQTT manager (not owned)
+  String moduleId;
+  String responseTopic;
+  bool isSubscribed;
+
+  // Burst state
+  unsigned long lastBurstTime;
+  bool burstActive;
+  uint8_t samplesRemaining;
+  bool requestInFlight;
+  uint16_t requestSeq;
+  uint64_t requestSentMicros;
+  bool burstHasSample;
+  int64_t burstBestOffset;    // epoch - monotonic (us) of best sample
+  uint64_t burstBestMono;     // monotonic time of best sample
+  uint32_t burstBestRtt;
+
+  // Shared clock state (written from loop() only)
+  static bool synced;
+  static int64_t offsetMicros;     // epoch - monotonic at syncMonoMicros
+  static uint64_t syncMonoMicros;  // monotonic time of last sync
+  static float driftPpm;           // local clock rate error (+ = local runs slow)
+  static int32_t lastErrorMicros;  // correction applied at last sync
+  static uint32_t lastRttMicros;
+  static uint32_t syncCount;
+
+  void sendRequest();
+  void finishBurst();
+  void applySample(int64_t measuredOffset, uint64_t mono, uint32_t rtt);
+
+public:
+  ClockSync(MQTTManager* mqtt, String moduleId);
+
+  void begin();
+  void loop();
+  void requestSync();  // Start a burst now (e.g. after reconnect)
+
+  // MQTTManager hook - returns true if the message was a time response
+  bool handleMessage(const char* topic, const byte* payload, unsigned int length);
+
+  // Shared clock API
+  static uint64_t monotonicMicros();
+  static bool isSynced() { return synced; }
+  static uint64_t epochMicros();
+  static uint64_t epochMillis() { return epochMicros() / 1000ULL; }
+  static void addTimestamp(JsonDocument& doc);
+
+  // Sync quality (reported in heartbeat)
+  static float getDriftPpm() { return driftPpm; }
+  static int32_t getLastErrorMicros() { return lastErrorMicros; }
+  static uint32_t getLastRttMicros() { return lastRttMicros; }
+  static uint32_t getSyncCount() { return syncCount; }
+  static uint32_t getSecondsSinceSync();
+
+  void printStatus() const;
+};
+
+#endif
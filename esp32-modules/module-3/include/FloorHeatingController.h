@@ -1,11 +1,21 @@
 // Floor Heating Controller
 // Manages relay control and temperature-based automatic control for heating circles
+// Algorithm (runtime, kept in NVS): on/off hysteresis or PI with time-proportioned
+// relay (HeatingPiController per circle)
+// Preheating: OFF circles with a "warm by" time are turned on at the latest start
+// the learned warm-up model allows (HeatingPreheat)
+// Relays: requested states are switched in staggered slots between sensor
+// conversions (RelayScheduler)
 
 #ifndef FLOOR_HEATING_CONTROLLER_H
 #define FLOOR_HEATING_CONTROLLER_H
 
 #include "Config.h"
+#include "HeatingPiController.h"
+#include "HeatingPreheat.h"
+#include "RelayScheduler.h"
 #include <Arduino.h>
+#include <Preferences.h>
 
 // Forward declaration
 class FloorHeatingSensor;
@@ -28,9 +38,26 @@ private:
   
   unsigned long lastControlCheck[NUM_HEATING_CIRCLES];  // Last time we checked temperature for each circle
   
+  // Control algorithm
+  HeatingControlParams controlParams;
+  HeatingPiController piControllers[NUM_HEATING_CIRCLES];
+  unsigned long relayCycles[NUM_HEATING_CIRCLES];  // OFF -> ON switches since boot
+  Preferences preferences;  // Control parameters in flash
+  
+  // Predictive preheating (learned warm-up/cool-down, scheduled start)
+  HeatingPreheat preheat;
+  
+  // Relay outputs (switching slots, EMI settle window)
+  RelayScheduler relays;
+  
   // Control functions
   void updateCircleControl(uint8_t circleIndex);
+  void updateHysteresisControl(uint8_t circleIndex, float currentTemp);
+  void updateRelayTiming(uint8_t circleIndex, unsigned long currentTime);  // PI: relay on/off inside the cycle
+  void updatePreheat(uint8_t circleIndex, unsigned long currentTime);  // Start an OFF circle when due
   void setRelayState(uint8_t circleIndex, bool state);
+  void loadControlParams();
+  void saveControlParams();
   
 public:
   FloorHeatingController();
@@ -52,7 +79,8 @@ public:
   void toggleCircleMode(uint8_t circleIndex);  // Toggle between OFF and TEMP_CONTROL
   
   // Get state
-  bool getCircleState(uint8_t circleIndex) const;  // Get relay state (ON/OFF)
+  bool getCircleState(uint8_t circleIndex) const;  // Get relay state (ON/OFF) - requested, output follows at the next slot
+  bool getRelayOutput(uint8_t circleIndex) const { return relays.getOutput(circleIndex); }  // Relay pin right now
   CircleMode getCircleMode(uint8_t circleIndex) const;  // Get circle mode (OFF/TEMP_CONTROL)
   
   // Reset last check time (for immediate temperature check)
@@ -61,6 +89,18 @@ public:
   // Future: Temperature configuration (for future implementation)
   void setTargetTemperature(float temp);  // Set target temperature (future feature)
   float getTargetTemperature() const { return targetTemperature; }
+  float getSetpoint() const { return (turnOnTemperature + turnOffTemperature) / 2; }  // PI: middle of the hysteresis band
+  
+  // Control algorithm (false = invalid parameters, nothing changed)
+  bool setControlParams(const HeatingControlParams& params);
+  const HeatingControlParams& getControlParams() const { return controlParams; }
+  float getCircleDuty(uint8_t circleIndex) const;
+  unsigned long getRelayCycles(uint8_t circleIndex) const;
+  
+  // Preheating ("warm by" schedule, learned model, outdoor temperature)
+  HeatingPreheat& getPreheat() { return preheat; }
+  const HeatingPreheat& getPreheat() const { return preheat; }
+  float getWarmTemperature() const { return turnOnTemperature; }  // "Warm" = inside the control band
   
   // Status
   void printStatus() const;
@@ -8,6 +8,7 @@
 #include "ModuleManager.h"
 #include "FloorHeatingController.h"
 #include "FloorHeatingSensor.h"
+#include "FloorHeatingSensorBus.h"
 #include "FloorHeatingButtonHandler.h"
 #include "LevelingSensor.h"
 #include "CommandHandler.h"
@@ -19,11 +20,15 @@ private:
   ModuleManager* moduleManager;
   FloorHeatingController controller;
   FloorHeatingSensor sensors[NUM_HEATING_CIRCLES];
+#if HEATING_TEMP_MULTIDROP
+  FloorHeatingSensorBus sensorBus;  // Shared DS18B20 bus (converts for all circles)
+#endif
   FloorHeatingButtonHandler buttonHandler;
   LevelingSensor levelingSensor;
   CommandHandler commandHandler;
   
   bool pendingStatusUpdate;  // Flag for deferred status publishing
+  bool outdoorSubscribed;    // Module 1 outdoor temperature (preheat ambient)
   
   // Static pointer for MQTT callback
   static FloorHeatingManager* currentInstance;
@@ -34,6 +39,9 @@ private:
   
   // Command processing
   void handleCircleCommand(uint8_t circleIndex, String action, String payload);
+  void handleSensorCommand(String action, String payload);
+  void handleControlCommand(String payload);
+  void handlePreheatCommand(String payload);
   
 public:
   FloorHeatingManager(ModuleManager* moduleMgr);
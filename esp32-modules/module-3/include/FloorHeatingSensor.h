@@ -7,54 +7,39 @@
 
 #include "Config.h"  // For CircleMode enum
 #include "MQTTManager.h"
-#include <OneWire.h>
-#include <DallasTemperature.h>
+#include "Ds18b20Channel.h"
+#include "TemperaturePipeline.h"
 
 // Forward declaration
 class FloorHeatingController;
 class FloorHeatingManager;
+class FloorHeatingSensorBus;
 
 class FloorHeatingSensor {
 private:
   MQTTManager* mqttManager;  // Reference to MQTT manager (not owned)
   uint8_t circleIndex;        // Which heating circle this sensor belongs to (0-3)
   uint8_t pin;                // GPIO pin for the sensor
-  OneWire oneWire;
-  DallasTemperature sensors;
+  Ds18b20Channel channel;     // Own-pin acquisition (unused in multi-drop mode)
+  TemperaturePipeline<HEATING_TEMP_AVERAGE_COUNT> pipeline;  // Spike filter, averaging, last published value
   
   unsigned long lastSensorRead;
   unsigned long lastDataSent;
   float lastTemperature;
-  float lastAcceptedTemperature;   // Last reading passed spike filter (NAN = no baseline yet)
-  float lastPublishedTemperature;  // Last temperature value that was published to backend
   bool forceUpdateRequested;
   bool lastMQTTState;  // Previous MQTT connection state (for detecting reconnects)
   
-  // Async temperature reading state machine
-  bool conversionStarted;  // True if we've started a temperature conversion
-  unsigned long conversionStartTime;  // When we started the conversion
-  
   // Error handling
   int failedReadCount;  // Counter for failed readings (3 failures = error)
   bool hasError;  // True if sensor has error (3 consecutive failures)
   
-  // Temperature averaging
-  float temperatureReadings[HEATING_TEMP_AVERAGE_COUNT];
-  int temperatureIndex;
-  int temperatureCount;
-  unsigned long lastAverageTime;
-  
   FloorHeatingController* controller;  // Reference to controller to check mode
   FloorHeatingManager* manager;  // Reference to manager for publishing status
-
-  static unsigned long globalRelaySettleUntil;  // Shared across all circles after any relay change
-  static bool isGlobalRelaySettling();
+  FloorHeatingSensorBus* bus;    // Multi-drop bus doing the conversions (nullptr = own pin)
   
   // Sensor reading functions
-  float readTemperature();
-  
-  // Averaging functions
-  float calculateAverageTemperature();
+  void processReading(float temperature, unsigned long currentTime, bool isForceUpdate, bool circleJustTurnedOn);
+  void reportSensorMissing();
   
   // Publishing logic
   void publishIfNeeded(float temperature, unsigned long currentTime, bool forcePublish = false);
@@ -74,7 +59,15 @@ public:
   // Called when any heating relay toggles — reset local read state for EMI recovery
   void onRelayChanged();
 
+  // Global EMI settle window - shared across all circles (RelayScheduler)
   static void beginGlobalRelaySettle();
+  static bool isGlobalRelaySettling();
+
+  // Multi-drop mode: the bus converts all circles at once and hands each its reading
+  void setBus(FloorHeatingSensorBus* sensorBus) { bus = sensorBus; }
+  bool isEnabled() const;  // Circle is measured (not OFF)
+  bool wantsBusReading(unsigned long currentTime) const;
+  void onBusReading(float temperature, bool present, unsigned long currentTime);
   
   // Set controller reference (to check if circle is in TEMP_CONTROL mode)
   void setController(FloorHeatingController* ctrl);
@@ -84,7 +77,8 @@ public:
   
   // Status (const methods)
   float getLastTemperature() const { return lastTemperature; }
-  float getLastPublishedTemperature() const { return lastPublishedTemperature; }
+  unsigned long getLastReadTime() const { return lastSensorRead; }  // millis() of the last reading (0 = none since turn-on)
+  float getLastPublishedTemperature() const { return pipeline.getLastPublished(); }
   unsigned long getLastDataSent() const { return lastDataSent; }
   bool isForceUpdateRequested() const { return forceUpdateRequested; }
   bool hasSensorError() const { return hasError; }
@@ -92,7 +86,7 @@ public:
   void printStatus() const;
   
   // Update last published temperature (called by FloorHeatingManager after publishing)
-  void setLastPublishedTemperature(float temp) { lastPublishedTemperature = temp; }
+  void setLastPublishedTemperature(float temp) { pipeline.markPublished(temp); }
 };
 
 #endif
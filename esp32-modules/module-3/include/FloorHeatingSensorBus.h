@@ -0,0 +1,72 @@
+// Floor Heating Sensor Bus
+// Multi-drop mode (HEATING_TEMP_MULTIDROP): all circle DS18B20 sensors share one OneWire bus
+// on HEATING_TEMP_BUS_PIN. One skip-ROM Convert T starts every sensor at once, so all
+// circles are sampled in a single 750 ms conversion; each sensor is then read by ROM code.
+// The circle -> ROM map is kept in NVS (Preferences "heatbus"). Sensors found on the bus
+// but not in the map are assigned to free circles in search order at boot; fix the
+// assignment with the sensors/assign command (see README).
+// Use 3-wire (VDD) sensors: in parasite mode all sensors converting together can pull
+// more current than the pull-up delivers.
+
+#ifndef FLOOR_HEATING_SENSOR_BUS_H
+#define FLOOR_HEATING_SENSOR_BUS_H
+
+#include "Config.h"
+#include "MQTTManager.h"
+#include "DallasTemperatureRmt.h"
+#include <Preferences.h>
+
+class FloorHeatingSensor;
+
+class FloorHeatingSensorBus {
+private:
+  MQTTManager* mqttManager;  // Reference to MQTT manager (not owned)
+  uint8_t pin;
+  OneWireRmt oneWire;
+  DallasTemperatureRmt dallas;
+  Preferences preferences;  // ROM map in flash
+
+  FloorHeatingSensor* sensors[NUM_HEATING_CIRCLES];
+  DeviceAddress roms[NUM_HEATING_CIRCLES];  // All zero = circle has no sensor assigned
+
+  bool conversionStarted;
+  unsigned long conversionStartTime;
+  unsigned long lastConversionTime;
+  uint32_t conversionCount;
+  int8_t readingCircle;  // Circle whose scratchpad is being read (-1 = none)
+  bool scanPending;      // Rescan waiting for the bus to be idle (search would clobber a read)
+
+  bool isAssigned(uint8_t circleIndex) const;
+  int findCircle(const DeviceAddress rom) const;
+  void loadRomMap();
+  void saveRomMap();
+  void assignNewSensors();
+  void startNextRead(uint8_t firstCircle);
+  void deliverReading(uint8_t circleIndex, unsigned long currentTime);
+  void publishScan();
+
+public:
+  FloorHeatingSensorBus(MQTTManager* mqtt, uint8_t pin);
+
+  void setSensor(uint8_t circleIndex, FloorHeatingSensor* sensor);
+
+  // Initialization (after the sensors are linked)
+  void begin();
+
+  // Main loop - call this in your main loop()
+  void loop();
+
+  // Any heating relay toggled: drop the running conversion (EMI)
+  void onRelayChanged();
+
+  // ROM map maintenance (commands sensors/scan and sensors/assign)
+  bool assignRom(uint8_t circleIndex, const char* romHex);  // nullptr / "" clears the circle
+  void requestScan();  // Rescan and publish from loop() once no conversion or read is running
+
+  static void formatRom(const DeviceAddress rom, char* out);  // 16 hex chars + NUL
+  static bool parseRom(const char* hex, DeviceAddress rom);
+
+  void printStatus() const;
+};
+
+#endif
@@ -0,0 +1,59 @@
+// Heating PI Controller
+// PI control of one heating circle through its relay. The PI output is a duty
+// (0..1) that is turned into relay time inside a fixed window (time-proportioning):
+// on for duty x cycleMs, then off. Pulses shorter than minOnMs are skipped and
+// gaps shorter than minOffMs are filled, and the relay never switches before it
+// has been on for minOnMs / off for minOffMs.
+// Anti-windup: the integral is kept within 0..1 and does not grow while the
+// output is already saturated in the direction of the error.
+
+#ifndef HEATING_PI_CONTROLLER_H
+#define HEATING_PI_CONTROLLER_H
+
+#include "Config.h"
+#include <Arduino.h>
+
+enum HeatingAlgorithm {
+  HEATING_ALGORITHM_HYSTERESIS = 0,  // Relay on below turn-on, off at turn-off temperature
+  HEATING_ALGORITHM_PI = 1           // HeatingPiController per circle
+};
+
+// Shared by all circles; set over MQTT (commands/module-3/control) and kept in NVS
+struct HeatingControlParams {
+  uint8_t algorithm;        // HeatingAlgorithm
+  float kp;                 // Duty per °C below the setpoint
+  float tiSeconds;          // Integral time (0 = P only)
+  unsigned long cycleMs;    // Time-proportioning window
+  unsigned long minOnMs;
+  unsigned long minOffMs;
+};
+
+class HeatingPiController {
+private:
+  float integral;  // Duty part from the integral term (0..1)
+  float duty;      // Last output (0..1)
+  unsigned long lastUpdate;
+  bool hasUpdate;
+  unsigned long cycleStart;
+  unsigned long lastSwitch;
+  bool hasSwitched;
+
+public:
+  HeatingPiController();
+
+  // Start over (circle turned on, parameters changed)
+  void reset(unsigned long now);
+
+  // New temperature reading; returns the new duty
+  float update(float temperature, float setpoint, unsigned long now, const HeatingControlParams& params);
+
+  // Relay state the duty asks for at this time, after the minimum on/off times
+  bool relayWanted(bool relayOn, unsigned long now, const HeatingControlParams& params);
+
+  // The relay was switched (by this controller or a safety cut-off)
+  void onRelaySwitched(unsigned long now);
+
+  float getDuty() const { return duty; }
+};
+
+#endif
@@ -0,0 +1,126 @@
+// Heating Preheat
+// Learns how fast each circle warms up and cools down and starts a circle just in
+// time to be warm at a requested time ("warm by 06:30").
+//
+// Model per circle (first order, relay fully on or off):
+//   dT/dt = gain * relay - loss * (T - ambient)      (T in °C, t in hours)
+// Ambient is module-1's outdoor temperature when a recent value is known.
+// Samples come from the circle's own readings while it is in TEMP_CONTROL, in chunks
+// of HEATING_LEARN_CHUNK_MS with the relay steady (after the dead time):
+//   - loss: how much the rate slows from one chunk to the next (r1 / r2 = e^(loss * t)),
+//     which does not depend on the ambient; and the whole OFF period between turning
+//     a circle off and on again, if the floor is still well above ambient
+//   - gain: the rate of each relay ON chunk with the loss known
+// Each sample moves loss/gain by an EWMA step; only the model (a few floats per
+// circle) is kept in NVS, no history.
+//
+// While a circle is OFF its floor temperature is predicted from the last reading
+// and the cool-down rate; the latest start is the warm-up time from there to the
+// warm temperature (HEATING_TURN_ON_TEMP), stretched by a safety factor and margin.
+
+#ifndef HEATING_PREHEAT_H
+#define HEATING_PREHEAT_H
+
+#include "Config.h"
+#include <Arduino.h>
+#include <Preferences.h>
+
+// Learned model of one circle (NVS layout - change = relearn)
+struct HeatingCircleModel {
+  float lossPerHour;     // Cool-down rate per °C above ambient (1/h)
+  float gainPerHour;     // Warm-up rate at full power with the floor at ambient (°C/h)
+  uint16_t lossSamples;
+  uint16_t gainSamples;
+};
+
+class HeatingPreheat {
+private:
+  struct CircleState {
+    // Learning: stretch of one relay state, split into chunks
+    bool segmentActive;
+    bool segmentRelayOn;
+    unsigned long segmentStart;
+    bool chunkActive;
+    unsigned long chunkTime;
+    float chunkTemp;
+    float chunkAmbient;
+    bool hasPrevChunk;
+    float prevChunkRate;         // °C/h
+    unsigned long prevChunkMid;
+
+    // Circle on/off: cool-down over an OFF period, predicted temperature while OFF
+    bool circleOn;
+    unsigned long circleOnTime;
+    bool hasLast;
+    float lastTemp;
+    unsigned long lastTime;
+    float lastAmbient;
+    bool offSamplePending;  // Turned off after lastTemp - first reading after on is a sample
+
+    // Schedule (millis based - the manager converts wall-clock times)
+    bool scheduled;
+    unsigned long scheduledAt;
+    unsigned long warmInMs;
+    unsigned long lastCheck;
+    unsigned long leadMs;  // Last computed warm-up lead
+  };
+
+  HeatingCircleModel models[NUM_HEATING_CIRCLES];
+  CircleState states[NUM_HEATING_CIRCLES];
+
+  float outdoorTemp;
+  unsigned long outdoorTime;
+  bool hasOutdoor;
+
+  Preferences preferences;  // Learned models in flash
+  bool modelsDirty;
+  unsigned long lastSave;
+
+  void learnCoolDown(uint8_t circleIndex, float fromTemp, float toTemp, float ambient, unsigned long durationMs);
+  void learnChunk(uint8_t circleIndex, CircleState& s, float toTemp, float ambient, unsigned long now);
+  void addLossSample(uint8_t circleIndex, float sample, const String& source);
+  void learnGain(uint8_t circleIndex, float fromTemp, float toTemp, float ambient, unsigned long durationMs);
+  static float ewma(float value, float sample, uint16_t& samples);
+  void loadModels();
+  void saveModels();
+
+public:
+  HeatingPreheat();
+
+  // Initialization (loads the learned models)
+  void begin();
+
+  // Main loop - writes learned models to NVS (throttled)
+  void loop(unsigned long now);
+
+  // Ambient for the model (outdoor temperature from module-1, else HEATING_PREHEAT_AMBIENT)
+  void setOutdoorTemperature(float temperature, unsigned long now);
+  float getAmbient(unsigned long now) const;
+  bool hasRecentOutdoor(unsigned long now) const;
+
+  // Learning hooks (FloorHeatingController)
+  void onReading(uint8_t circleIndex, float temperature, unsigned long readTime, bool relayOn, unsigned long now);
+  void onRelaySwitched(uint8_t circleIndex, bool relayOn, unsigned long now);
+  void onCircleOn(uint8_t circleIndex, unsigned long now);  // Also drops the schedule
+  void onCircleOff(uint8_t circleIndex);
+
+  // Schedule: be at warmTemp within warmInMs from now
+  void schedule(uint8_t circleIndex, unsigned long warmInMs, unsigned long now);
+  void cancel(uint8_t circleIndex);
+  bool isScheduled(uint8_t circleIndex) const;
+  // True once the latest start time is reached (checked every HEATING_PREHEAT_CHECK_MS)
+  bool isStartDue(uint8_t circleIndex, float warmTemp, unsigned long now);
+  unsigned long getWarmInMs(uint8_t circleIndex, unsigned long now) const;  // 0 when due / not scheduled
+  unsigned long getStartInMs(uint8_t circleIndex, unsigned long now) const;
+
+  // Model
+  float predictTemperature(uint8_t circleIndex, unsigned long now) const;  // Floor temperature while OFF
+  // Warm-up time from fromTemp to warmTemp at full power, with HEATING_PREHEAT_LEAD_FACTOR and margin
+  unsigned long predictLeadMs(uint8_t circleIndex, float fromTemp, float warmTemp, unsigned long now) const;
+  const HeatingCircleModel& getModel(uint8_t circleIndex) const { return models[circleIndex]; }
+  void resetModels();
+
+  void printStatus() const;
+};
+
+#endif
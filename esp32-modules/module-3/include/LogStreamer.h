@@ -0,0 +1,76 @@
+// Log Streamer
+// Mirrors Logger output to MQTT (smartcamper/logs/{module}) for field debugging
+// Lines are copied from the log drain task into a byte ring and published from
+// loop() in batches: at most one publish per LOG_STREAM_INTERVAL_MS and at most
+// LOG_STREAM_BATCH_BYTES per publish, so airtime stays bounded at any log level.
+// Payload: "# dropped ring=<n> stream=<m>" (totals since boot), then one line per
+// log entry, "<seq> <millis> <level> <text>". <seq> is the stream's own counter and
+// only counts lines at or above the stream level, so a gap means the stream buffer
+// was full. Lines lost earlier (Logger ring full) never reach the stream and only
+// show up in ring=<n>.
+
+#ifndef LOG_STREAMER_H
+#define LOG_STREAMER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "Config.h"
+#include "Logger.h"
+#include "MQTTManager.h"
+
+// MQTT topic prefix for log streaming
+#define LOG_STREAM_TOPIC_PREFIX "smartcamper/logs/"
+
+// Defaults if a module's Config.h does not set them
+#ifndef LOG_STREAM_LEVEL
+#define LOG_STREAM_LEVEL LOG_LEVEL_WARN
+#endif
+#ifndef LOG_STREAM_INTERVAL_MS
+#define LOG_STREAM_INTERVAL_MS 1000
+#endif
+#ifndef LOG_STREAM_BATCH_BYTES
+#define LOG_STREAM_BATCH_BYTES 768
+#endif
+#ifndef LOG_STREAM_BUFFER_SIZE
+#define LOG_STREAM_BUFFER_SIZE 2048
+#endif
+
+class LogStreamer {
+private:
+  MQTTManager* mqttManager;  // Reference to MQTT manager (not owned)
+  String topic;
+  unsigned long lastPublishTime;
+
+  // Byte ring: written by the log drain task, read by loop()
+  static char buffer[LOG_STREAM_BUFFER_SIZE];
+  static std::atomic<uint32_t> head;       // Write index (drain task)
+  static std::atomic<uint32_t> tail;       // Read index (loop)
+  static std::atomic<uint8_t> level;       // Runtime stream level
+  static std::atomic<uint32_t> droppedLines;
+  static uint32_t streamSeq;               // Lines accepted by the level filter (drain task only)
+
+  static void onLogLine(const LogLine& line);  // Logger sink (drain task context)
+  size_t readBatch(char* out, size_t maxLen);   // Copy whole lines, returns length
+
+public:
+  LogStreamer(MQTTManager* mqtt, String moduleId);
+
+  void begin();
+  void loop();
+
+  // Runtime level (clamped to compile-time LOG_LEVEL; LOG_LEVEL_NONE disables streaming)
+  static void setLevel(uint8_t newLevel);
+  static uint8_t getLevel() { return level.load(std::memory_order_relaxed); }
+
+  // Parse "off"/"error"/"warn"/"info"/"debug"/"verbose" or "0".."5"; returns -1 if invalid
+  static int parseLevel(String value);
+
+  // Handle logs/level command payload: {"level":"debug"} or plain "debug"
+  static bool handleLevelCommand(String message);
+
+  static uint32_t getDroppedLines() { return droppedLines.load(std::memory_order_relaxed); }
+
+  void printStatus() const;
+};
+
+#endif
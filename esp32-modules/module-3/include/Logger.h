@@ -0,0 +1,91 @@
+// Logger
+// Non-blocking printf-style logging shared by all ESP32 modules
+// Log calls format into a fixed lock-free ring of line slots; a low-priority
+// FreeRTOS task on the core not running loop() drains the ring to Serial, so
+// callers never wait on the UART.
+// Levels above LOG_LEVEL (Config.h) are removed by the compiler - their
+// arguments are not even evaluated.
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "Config.h"
+
+// Log levels (lower = more important)
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+#define LOG_LEVEL_VERBOSE 5
+
+// Defaults if a module's Config.h does not set them
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+#ifndef LOG_QUEUE_DEPTH
+#define LOG_QUEUE_DEPTH 32  // Number of line slots (must be a power of two)
+#endif
+#ifndef LOG_LINE_MAX
+#define LOG_LINE_MAX 128    // Max characters per line (longer lines are truncated)
+#endif
+
+// One formatted log line
+struct LogLine {
+  uint32_t seq;        // Sequence number (gaps = dropped lines)
+  uint32_t timestamp;  // millis() when the line was logged
+  uint8_t level;
+  char text[LOG_LINE_MAX];
+};
+
+class Logger {
+private:
+  // Ring slot: sequence field tells producers/consumer who owns the slot
+  struct Slot {
+    std::atomic<uint32_t> turn;
+    LogLine line;
+  };
+
+  static Slot slots[LOG_QUEUE_DEPTH];
+  static std::atomic<uint32_t> writePos;   // Next slot to claim (producers)
+  static uint32_t readPos;                 // Next slot to drain (drain task only)
+  static std::atomic<uint32_t> nextSeq;    // Line sequence counter
+  static std::atomic<uint32_t> dropped;    // Lines lost because the ring was full
+  static TaskHandle_t drainTask;
+  static void (*sink)(const LogLine& line);  // Optional second consumer (e.g. LogStreamer)
+
+  static void drainTaskFn(void* arg);
+  static void writeToSerial(const LogLine& line);
+
+public:
+  // Start the drain task (call after Serial.begin)
+  static void begin();
+
+  // Format and enqueue a line - never blocks, drops the line if the ring is full
+  static void write(uint8_t level, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+  // Pop the oldest line (drain task only); returns false if the ring is empty
+  static bool pop(LogLine& out);
+
+  // Extra consumer called from the drain task for every line after Serial output.
+  // Must not block or touch non-thread-safe objects (e.g. PubSubClient).
+  static void setSink(void (*lineSink)(const LogLine& line)) { sink = lineSink; }
+
+  // Status
+  static uint32_t getDroppedCount() { return dropped.load(std::memory_order_relaxed); }
+  static const char* levelName(uint8_t level);
+};
+
+// Logging macros - disabled levels compile to nothing
+#define LOG_AT(level, format, ...) \
+  do { if (LOG_LEVEL >= (level)) { Logger::write((level), format, ##__VA_ARGS__); } } while (0)
+
+#define LOG_ERROR(format, ...) LOG_AT(LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
+#define LOG_WARN(format, ...) LOG_AT(LOG_LEVEL_WARN, format, ##__VA_ARGS__)
+#define LOG_INFO(format, ...) LOG_AT(LOG_LEVEL_INFO, format, ##__VA_ARGS__)
+#define LOG_DEBUG(format, ...) LOG_AT(LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
+#define LOG_VERBOSE(format, ...) LOG_AT(LOG_LEVEL_VERBOSE, format, ##__VA_ARGS__)
+
+#endif
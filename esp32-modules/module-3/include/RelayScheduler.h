@@ -0,0 +1,84 @@
+// Relay Scheduler
+// Owns the heating relay outputs. The controller only requests a relay state; the
+// change is applied in the next switching slot, and changes requested before the slot
+// share it. Inside a slot the relays switch one by one, HEATING_RELAY_STAGGER_MS apart
+// (no common inrush), and one EMI settle window covers them all.
+//
+// Slots are aligned to the DS18B20 conversions (every HEATING_TEMP_READ_INTERVAL): a
+// slot opens at once in a quiet gap, waits for a running conversion to finish, and
+// when the next conversion is due before the settle window would end it goes right
+// after that conversion. While a slot is pending no conversion starts that could not
+// finish before it, so conversions are no longer thrown away by a relay switch, and
+// after the settle window all circles convert together, which keeps the gaps aligned.
+// HEATING_RELAY_SCHEDULER false switches at once (previous behaviour), with the same
+// counters, for comparison.
+//
+// Shared read-window API (static, used by FloorHeatingSensor / FloorHeatingSensorBus):
+//   RelayScheduler::canStartConversion(now)  - no settle window and no slot before the reading is done
+//   RelayScheduler::onConversionStarted(now) - a conversion runs; a new slot waits for it
+//   RelayScheduler::onConversionAborted()    - a conversion was dropped by a relay switch
+//   RelayScheduler::beginSettle(now) / isSettling(now) - global EMI settle window
+
+#ifndef RELAY_SCHEDULER_H
+#define RELAY_SCHEDULER_H
+
+#include "Config.h"
+#include <Arduino.h>
+
+// Counters since boot (read availability = conversions that delivered a reading)
+struct RelaySchedulerStats {
+  uint32_t switches;       // Relay outputs changed
+  uint32_t slots;          // Switching slots used (all changes in a slot share one settle window)
+  uint32_t settleWindows;  // Separate EMI settle windows
+  uint32_t settleMs;       // Time sensor reads were blanked after relay switching
+  uint32_t conversions;    // Conversions started
+  uint32_t aborted;        // Conversions dropped by a relay switch
+};
+
+class RelayScheduler {
+private:
+  uint8_t relayPins[NUM_HEATING_CIRCLES];
+  bool outputs[NUM_HEATING_CIRCLES];   // Current relay output
+  bool pending[NUM_HEATING_CIRCLES];   // Output differs from the requested state
+  bool slotStarted;                    // First relay of the slot switched
+  unsigned long lastSwitch;
+
+  // Shared read-window state (written from loop() only)
+  static bool slotPending;
+  static unsigned long slotTime;
+  static unsigned long busyUntil;      // Running conversion done by then
+  static unsigned long nextConversion; // Next conversion expected (one read interval after the last start)
+  static unsigned long settleUntil;
+  static RelaySchedulerStats stats;
+
+  bool hasPending() const;
+  void planSlot(unsigned long now);
+
+public:
+  RelayScheduler();
+
+  // Initialization (all relays OFF)
+  void begin(const uint8_t* pins);
+
+  // Requested relay state - applied at the next slot (dropped if it returns to the output)
+  void request(uint8_t circleIndex, bool state, unsigned long now);
+
+  // Main loop - switches due relays, returns how many switched in this call
+  uint8_t loop(unsigned long now);
+
+  bool getOutput(uint8_t circleIndex) const;
+  bool isPending(uint8_t circleIndex) const;
+
+  // Shared read window
+  static bool canStartConversion(unsigned long now);
+  static void onConversionStarted(unsigned long now);
+  static void onConversionAborted();
+  static void beginSettle(unsigned long now);
+  static bool isSettling(unsigned long now);
+  static const RelaySchedulerStats& getStats() { return stats; }
+  static float getReadAvailability();  // %, since boot
+
+  void printStatus() const;
+};
+
+#endif
@@ -0,0 +1,56 @@
+// Running Average
+// Moving average over the last N samples in O(1) per sample: the ring keeps the
+// samples, a running sum drops the oldest and adds the newest. The sum is
+// recomputed from the ring once per wrap, so float rounding cannot accumulate.
+
+#ifndef RUNNING_AVERAGE_H
+#define RUNNING_AVERAGE_H
+
+#include <Arduino.h>
+
+template <uint8_t N>
+class RunningAverage {
+private:
+  float samples[N];
+  float sum;
+  uint8_t index;  // Next slot to write
+  uint8_t count;
+
+public:
+  RunningAverage() { reset(); }
+
+  void reset() {
+    for (uint8_t i = 0; i < N; i++) {
+      samples[i] = 0.0;
+    }
+    sum = 0.0;
+    index = 0;
+    count = 0;
+  }
+
+  void add(float value) {
+    if (count < N) {
+      count++;
+    } else {
+      sum -= samples[index];  // Oldest sample leaves the window
+    }
+    samples[index] = value;
+    sum += value;
+
+    index++;
+    if (index >= N) {
+      index = 0;
+      sum = 0.0;
+      for (uint8_t i = 0; i < N; i++) {
+        sum += samples[i];
+      }
+    }
+  }
+
+  float getAverage() const { return count > 0 ? sum / count : NAN; }
+  uint8_t getCount() const { return count; }
+  bool isFull() const { return count >= N; }
+  static uint8_t capacity() { return N; }
+};
+
+#endif
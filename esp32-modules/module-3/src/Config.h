@@ -43,6 +43,15 @@
 #define HEATING_TEMP_PIN_2 27 // GPIO pin for Circle 2 temperature sensor
 #define HEATING_TEMP_PIN_3 33 // GPIO pin for Circle 3 temperature sensor
 
+// Multi-drop mode: all DS18B20 on one bus, converted together (see FloorHeatingSensorBus.h)
+// HEATING_TEMP_PIN_1..3 are unused (free GPIOs) when enabled
+#define HEATING_TEMP_MULTIDROP false          // true = single shared bus on HEATING_TEMP_BUS_PIN
+#define HEATING_TEMP_BUS_PIN HEATING_TEMP_PIN_0
+
+// OneWire bus driver (DS18B20) - RMT peripheral instead of bit-banging, shared by all OneWire pins
+#define ONEWIRE_RMT_TX_CHANNEL 0  // Generates the slots (1 memory block)
+#define ONEWIRE_RMT_RX_CHANNEL 1  // Records the bus (2 memory blocks - channel 2 is taken too)
+
 // Relay pins (for controlling heating circles)
 #define HEATING_RELAY_PIN_0 4  // GPIO pin for Circle 0 relay
 #define HEATING_RELAY_PIN_1 5  // GPIO pin for Circle 1 relay
@@ -62,13 +71,46 @@
 #define HEATING_TURN_ON_TEMP 32.0      // Turn on relay when temperature drops below this
 #define HEATING_MEASURE_INTERVAL 30000 // 30 seconds - temperature measurement interval
 
+// Control algorithm defaults (runtime: commands/module-3/control, kept in NVS)
+#define HEATING_CONTROL_PI true          // false = on/off hysteresis between HEATING_TURN_ON_TEMP and HEATING_TURN_OFF_TEMP
+#define HEATING_PI_KP 0.5                // Duty per °C below the setpoint (middle of the hysteresis band)
+#define HEATING_PI_TI 1800               // Integral time, seconds
+#define HEATING_PI_CYCLE_MS 1200000      // 20 minutes - relay time-proportioning window (at most 3 relay cycles/hour)
+#define HEATING_PI_MIN_ON_MS 120000      // 2 minutes - shortest relay ON
+#define HEATING_PI_MIN_OFF_MS 120000     // 2 minutes - shortest relay OFF
+#define HEATING_PI_OVERTEMP 1.0          // Relay off at once this far above HEATING_TURN_OFF_TEMP (°C)
+
+// Predictive preheating (see HeatingPreheat.h) - commands/module-3/preheat {"at":"HH:MM"}
+#define HEATING_OUTDOOR_TOPIC "smartcamper/sensors/outdoor-temperature"  // Module 1 outdoor DS18B20 (plain °C value)
+#define HEATING_OUTDOOR_MAX_AGE_MS 7200000  // 2 hours - older outdoor value is not used
+#define HEATING_PREHEAT_AMBIENT 15.0        // Ambient assumed without a recent outdoor value (°C)
+#define HEATING_PREHEAT_TZ_OFFSET_MIN 120   // Local time = UTC + this (minutes), unless the command sends "tz"
+#define HEATING_PREHEAT_CHECK_MS 60000      // 1 minute - latest start time recomputed this often
+#define HEATING_PREHEAT_LEAD_FACTOR 1.2     // Predicted warm-up time x this ...
+#define HEATING_PREHEAT_MARGIN_MS 900000    // ... + 15 minutes (dead time, slow approach near the setpoint)
+#define HEATING_PREHEAT_MAX_LEAD_MS 21600000  // 6 hours - never start earlier than this
+#define HEATING_LEARN_LOSS_DEFAULT 0.5      // Cool-down rate per °C above ambient before anything is learned (1/h)
+#define HEATING_LEARN_GAIN_DEFAULT 10.0     // Warm-up rate at full power, floor at ambient, before anything is learned (°C/h)
+#define HEATING_LEARN_ALPHA 0.2             // EWMA weight of a new sample (first samples weigh 1/n)
+#define HEATING_LEARN_SKIP_MS 300000        // 5 minutes - no learning right after a relay switch (dead time)
+#define HEATING_LEARN_CHUNK_MS 900000       // 15 minutes - one rate sample per this much steady relay state
+#define HEATING_LEARN_OFF_MIN_MS 3600000    // 1 hour - shortest OFF period used as a cool-down sample
+#define HEATING_LEARN_MIN_EXCESS 3.0        // OFF period sample: floor still this far above ambient at the end (°C)
+#define HEATING_LEARN_MIN_CHANGE 0.5        // Temperature change a sample needs (°C, DS18B20 steps are 0.0625)
+#define HEATING_LEARN_SAVE_MS 3600000       // 1 hour - learned model written to NVS at most this often
+
 // Temperature sensor settings (DS18B20)
 #define HEATING_TEMP_READ_INTERVAL 5000    // 5 seconds - measurement interval
 #define HEATING_TEMP_AVERAGE_INTERVAL 30000 // 30 seconds - average calculation interval
 #define HEATING_TEMP_THRESHOLD 0.1         // 0.1°C change threshold for publishing
 #define HEATING_TEMP_AVERAGE_COUNT 6       // Number of measurements to average (6 measurements = 30 seconds)
+#define HEATING_TEMP_CONVERSION_MS 800     // Wait after Convert T (12-bit needs 750 ms + safety margin)
 #define HEATING_RELAY_SETTLE_MS 1000       // Ignore sensor reads after any relay ON/OFF (global EMI settle)
+#define HEATING_RELAY_SCHEDULER true       // Relay changes switched in slots between conversions (see RelayScheduler.h); false = at once
+#define HEATING_RELAY_STAGGER_MS 100       // Gap between relays switched in the same slot (inrush)
+#define HEATING_RELAY_READ_WINDOW_MS 1200  // Conversion start to reading done (RMT turn + Convert T + scratchpad) - no slot inside
 #define HEATING_TEMP_MAX_DELTA 1.0         // Reject readings that jump more than this vs last accepted value (°C)
+#define TEMP_OUTLIER_REBASE_COUNT 3        // This many rejected jumps in a row = real step, accept the new level
 
 // Leveling Sensor Configuration (Module 3 specific - GY-521 MPU6050)
 #define LEVELING_I2C_SDA 21      // GPIO pin for I²C SDA (Wire interface)
@@ -91,6 +133,25 @@ enum CircleMode
 #define DEBUG_MQTT true     // Enable MQTT debug output
 #define DEBUG_VERBOSE false // Enable verbose debug output (set to true for detailed logging)
 
+// Logging (see Logger.h) - levels above LOG_LEVEL are compiled out
+// 0=NONE, 1=ERROR, 2=WARN, 3=INFO, 4=DEBUG, 5=VERBOSE
+#define LOG_LEVEL LOG_LEVEL_INFO
+#define LOG_QUEUE_DEPTH 32  // Ring buffer line slots (power of two)
+#define LOG_LINE_MAX 128    // Max characters per log line
+#define LOG_STREAM_LEVEL LOG_LEVEL_WARN  // Initial level mirrored to smartcamper/logs/{module} (runtime: logs/level command)
+#define LOG_STREAM_INTERVAL_MS 1000       // Min time between log batch publishes
+#define LOG_STREAM_BATCH_BYTES 768        // Max payload bytes per log batch
+#define LOG_STREAM_BUFFER_SIZE 2048       // Log bytes buffered while waiting to publish
+
+// Command tracking (see CommandTracker.h) - optional "id" in command payloads
+#define COMMAND_ACK_TIMEOUT_MS 2000  // Ack without publish time if no status publish follows
+#define COMMAND_DEDUP_SIZE 16        // Recent command ids remembered for duplicate detection
+
+// Clock sync with the backend (see ClockSync.h) - adds "ts" (epoch ms) to JSON payloads
+#define CLOCK_SYNC_INTERVAL_MS 60000  // Time between sync bursts
+#define CLOCK_SYNC_SAMPLES 4          // Requests per burst (lowest round trip is used)
+#define CLOCK_SYNC_MAX_RTT_MS 250     // Discard samples with a slower round trip
+
 // Watchdog settings (optional - for production stability)
 // #define ENABLE_WATCHDOG true
 // #define WATCHDOG_TIMEOUT 30  // seconds
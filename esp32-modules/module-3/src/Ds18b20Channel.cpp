@@ -0,0 +1,133 @@
+// DS18B20 Channel Implementation
+
+#include "Ds18b20Channel.h"
+
+Ds18b20Channel* Ds18b20Channel::channels[DS18B20_MAX_CHANNELS];
+uint8_t Ds18b20Channel::channelCount = 0;
+int8_t Ds18b20Channel::holder = -1;
+int8_t Ds18b20Channel::lastHolder = -1;
+
+Ds18b20Channel::Ds18b20Channel(uint8_t pin, unsigned long conversionMs)
+  : oneWire(pin), sensors(&oneWire) {
+  this->conversionMs = conversionMs;
+  this->state = IDLE;
+  this->conversionStartTime = 0;
+  this->temperature = NAN;
+  this->slot = -1;
+  this->queued = false;
+  this->turnWaits = 0;
+}
+
+void Ds18b20Channel::begin(uint8_t resolution) {
+  // Registered here, not in the constructor: the object is in its final place now
+  if (slot < 0 && channelCount < DS18B20_MAX_CHANNELS) {
+    slot = channelCount;
+    channels[channelCount++] = this;
+  }
+
+  sensors.begin();
+  sensors.setResolution(resolution);
+  // requestTemperatures() returns immediately; poll() waits for the conversion
+  sensors.setWaitForConversion(false);
+}
+
+// The RMT goes to the first queued slot after the previous holder
+bool Ds18b20Channel::takeTurn() {
+  if (slot < 0 || holder == slot) {
+    return true;  // Unregistered channels do not take turns
+  }
+
+  queued = true;
+  if (holder >= 0) {
+    turnWaits++;
+    return false;
+  }
+
+  for (uint8_t n = 1; n <= channelCount; n++) {
+    uint8_t candidate = (uint8_t)((lastHolder + n + channelCount) % channelCount);
+    if (channels[candidate]->queued) {
+      if (candidate != slot) {
+        turnWaits++;
+        return false;  // Another channel's turn
+      }
+      break;
+    }
+  }
+
+  queued = false;
+  holder = slot;
+  lastHolder = slot;
+  return true;
+}
+
+void Ds18b20Channel::endTurn() {
+  queued = false;
+  if (slot >= 0 && holder == slot) {
+    holder = -1;
+  }
+}
+
+void Ds18b20Channel::startConversion() {
+  if (state == IDLE) {
+    state = CONVERT_QUEUED;
+  }
+}
+
+bool Ds18b20Channel::poll(unsigned long currentTime) {
+  switch (state) {
+    case IDLE:
+      return false;
+
+    case CONVERT_QUEUED:
+      if (!takeTurn()) {
+        return false;
+      }
+      sensors.requestTemperatures();  // Skip ROM + Convert T (non-blocking)
+      conversionStartTime = currentTime;
+      state = CONVERT_SENDING;
+      return false;
+
+    case CONVERT_SENDING:
+      if (oneWire.isBusy()) {
+        return false;
+      }
+      endTurn();
+      state = CONVERTING;
+      return false;
+
+    case CONVERTING:
+      if (currentTime - conversionStartTime < conversionMs) {
+        return false;
+      }
+      state = READ_QUEUED;
+      // Fall through - read in this pass if it is our turn
+
+    case READ_QUEUED:
+      if (!takeTurn()) {
+        return false;
+      }
+      sensors.beginReadTempCByIndex(0);  // First sensor on the pin
+      state = READING;
+      return false;
+
+    case READING:
+      if (!sensors.isReadComplete()) {
+        return false;
+      }
+      endTurn();
+      state = IDLE;
+      temperature = sensors.getReadTempC();
+      if (temperature == DEVICE_DISCONNECTED_C) {
+        temperature = NAN;
+      }
+      return true;
+  }
+  return false;
+}
+
+// A transaction already on the wire finishes by itself; the next holder's
+// startTransaction() waits for it
+void Ds18b20Channel::cancel() {
+  endTurn();
+  state = IDLE;
+}
@@ -18,6 +18,7 @@ FloorHeatingController::FloorHeatingController() {
     circleModes[i] = CIRCLE_MODE_OFF;  // Start with all circles OFF
     sensors[i] = nullptr;
     lastControlCheck[i] = 0;
+    relayCycles[i] = 0;
   }
   
   manager = nullptr;
@@ -26,6 +27,14 @@ FloorHeatingController::FloorHeatingController() {
   targetTemperature = HEATING_TARGET_TEMP;
   turnOffTemperature = HEATING_TURN_OFF_TEMP;
   turnOnTemperature = HEATING_TURN_ON_TEMP;
+  
+  // Control algorithm defaults (NVS values are loaded in begin())
+  controlParams.algorithm = HEATING_CONTROL_PI ? HEATING_ALGORITHM_PI : HEATING_ALGORITHM_HYSTERESIS;
+  controlParams.kp = HEATING_PI_KP;
+  controlParams.tiSeconds = HEATING_PI_TI;
+  controlParams.cycleMs = HEATING_PI_CYCLE_MS;
+  controlParams.minOnMs = HEATING_PI_MIN_ON_MS;
+  controlParams.minOffMs = HEATING_PI_MIN_OFF_MS;
 }
 
 void FloorHeatingController::begin() {
@@ -33,10 +42,13 @@ void FloorHeatingController::begin() {
     Serial.println("🔥 Floor Heating Controller Starting...");
   }
   
-  // Initialize relay pins
+  preferences.begin("heatctl", false);  // false = read-write mode
+  loadControlParams();
+  preheat.begin();
+  
+  // Initialize relay pins (all OFF)
+  relays.begin(relayPins);
   for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
-    pinMode(relayPins[i], OUTPUT);
-    digitalWrite(relayPins[i], LOW);  // Start with relay OFF
     relayStates[i] = false;
     
     if (DEBUG_SERIAL) {
@@ -49,6 +61,12 @@ void FloorHeatingController::begin() {
     Serial.println("   Target Temperature: " + String(targetTemperature) + "°C");
     Serial.println("   Turn Off Temperature: " + String(turnOffTemperature) + "°C");
     Serial.println("   Turn On Temperature: " + String(turnOnTemperature) + "°C");
+    if (controlParams.algorithm == HEATING_ALGORITHM_PI) {
+      Serial.println("   Control: PI (setpoint " + String(getSetpoint(), 1) + "°C, Kp " + String(controlParams.kp, 2) +
+                     ", Ti " + String(controlParams.tiSeconds, 0) + " s, cycle " + String(controlParams.cycleMs / 1000) + " s)");
+    } else {
+      Serial.println("   Control: hysteresis");
+    }
   }
 }
 
@@ -76,6 +94,11 @@ void FloorHeatingController::loop() {
   
   // Check each circle for temperature control (only if in TEMP_CONTROL mode)
   for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
+    // OFF circle with a "warm by" time - turns to TEMP_CONTROL once the start is due
+    if (circleModes[i] == CIRCLE_MODE_OFF) {
+      updatePreheat(i, currentTime);
+    }
+    
     // Only check if circle is in TEMP_CONTROL mode
     if (circleModes[i] == CIRCLE_MODE_TEMP_CONTROL) {
       // Check temperature every HEATING_MEASURE_INTERVAL (30 seconds)
@@ -84,8 +107,33 @@ void FloorHeatingController::loop() {
         lastControlCheck[i] = currentTime;
         updateCircleControl(i);
       }
+      // PI: the relay follows the duty inside the cycle, between readings too
+      if (controlParams.algorithm == HEATING_ALGORITHM_PI) {
+        updateRelayTiming(i, currentTime);
+      }
     }
   }
+  
+  preheat.loop(currentTime);
+  
+  // Requested relay changes are switched in the next slot - sensors settle after each switch
+  if (relays.loop(currentTime) > 0 && manager != nullptr) {
+    manager->onRelayChanged();
+  }
+}
+
+void FloorHeatingController::updatePreheat(uint8_t circleIndex, unsigned long currentTime) {
+  if (!preheat.isStartDue(circleIndex, turnOnTemperature, currentTime)) {
+    return;
+  }
+  
+  if (DEBUG_SERIAL) {
+    Serial.println("🔥 Circle " + String(circleIndex) + " preheat start - warm in " +
+                   String(preheat.getWarmInMs(circleIndex, currentTime) / 60000) + " min (floor ~" +
+                   String(preheat.predictTemperature(circleIndex, currentTime), 1) + "°C, ambient " +
+                   String(preheat.getAmbient(currentTime), 1) + "°C)");
+  }
+  setCircleMode(circleIndex, CIRCLE_MODE_TEMP_CONTROL);  // Drops the schedule, publishes the new mode
 }
 
 void FloorHeatingController::updateCircleControl(uint8_t circleIndex) {
@@ -113,6 +161,21 @@ void FloorHeatingController::updateCircleControl(uint8_t circleIndex) {
     return;
   }
   
+  // Learn warm-up / cool-down rates from this circle's own readings
+  preheat.onReading(circleIndex, currentTemp, sensors[circleIndex]->getLastReadTime(), relayStates[circleIndex], millis());
+  
+  if (controlParams.algorithm == HEATING_ALGORITHM_PI) {
+    float duty = piControllers[circleIndex].update(currentTemp, getSetpoint(), millis(), controlParams);
+    if (DEBUG_VERBOSE) {
+      Serial.println("🔥 Circle " + String(circleIndex) + " PI duty " + String(duty * 100, 0) + "% (temp: " + String(currentTemp, 1) + "°C)");
+    }
+    return;  // Relay switching happens in updateRelayTiming()
+  }
+  
+  updateHysteresisControl(circleIndex, currentTemp);
+}
+
+void FloorHeatingController::updateHysteresisControl(uint8_t circleIndex, float currentTemp) {
   // Automatic control logic with hysteresis
   bool stateChanged = false;
   if (relayStates[circleIndex]) {
@@ -144,6 +207,31 @@ void FloorHeatingController::updateCircleControl(uint8_t circleIndex) {
   }
 }
 
+void FloorHeatingController::updateRelayTiming(uint8_t circleIndex, unsigned long currentTime) {
+  bool wanted = piControllers[circleIndex].relayWanted(relayStates[circleIndex], currentTime, controlParams);
+  
+  // Safety cut-off: too hot is off at once, whatever the duty and minimum on time
+  float currentTemp = (sensors[circleIndex] != nullptr) ? sensors[circleIndex]->getLastTemperature() : NAN;
+  if (wanted && !isnan(currentTemp) && currentTemp >= turnOffTemperature + HEATING_PI_OVERTEMP) {
+    wanted = false;
+  }
+  
+  if (wanted == relayStates[circleIndex]) {
+    return;
+  }
+  
+  setRelayState(circleIndex, wanted);
+  if (DEBUG_SERIAL) {
+    Serial.println("🔥 Circle " + String(circleIndex) + " " + String(wanted ? "ON" : "OFF") +
+                   " (PI duty " + String(piControllers[circleIndex].getDuty() * 100, 0) + "%, temp: " + String(currentTemp, 1) + "°C)");
+  }
+  
+  // Force publish because relay state changed, not just temperature
+  if (manager != nullptr) {
+    manager->publishCircleStatus(circleIndex, true);
+  }
+}
+
 void FloorHeatingController::setRelayState(uint8_t circleIndex, bool state) {
   if (circleIndex >= NUM_HEATING_CIRCLES) {
     return;
@@ -151,10 +239,11 @@ void FloorHeatingController::setRelayState(uint8_t circleIndex, bool state) {
   
   if (relayStates[circleIndex] != state) {
     relayStates[circleIndex] = state;
-    digitalWrite(relayPins[circleIndex], state ? HIGH : LOW);
-    
-    if (manager != nullptr) {
-      manager->onRelayChanged();
+    relays.request(circleIndex, state, millis());  // Pin switches in the next relay slot
+    piControllers[circleIndex].onRelaySwitched(millis());
+    preheat.onRelaySwitched(circleIndex, state, millis());
+    if (state) {
+      relayCycles[circleIndex]++;
     }
     
     if (DEBUG_SERIAL) {
@@ -171,10 +260,12 @@ void FloorHeatingController::setCircleMode(uint8_t circleIndex, CircleMode mode)
   
   if (circleModes[circleIndex] != mode) {
     circleModes[circleIndex] = mode;
+    piControllers[circleIndex].reset(millis());  // No integral carried over from an earlier run
     
     // If switching to OFF mode, turn off relay
     if (mode == CIRCLE_MODE_OFF) {
       setRelayState(circleIndex, false);
+      preheat.onCircleOff(circleIndex);
     }
     // If switching to TEMP_CONTROL mode, reset last check time
     // This will trigger immediate check in next loop() iteration
@@ -183,6 +274,7 @@ void FloorHeatingController::setCircleMode(uint8_t circleIndex, CircleMode mode)
     else if (mode == CIRCLE_MODE_TEMP_CONTROL) {
       // Reset last check time to force immediate check in next loop()
       lastControlCheck[circleIndex] = 0;
+      preheat.onCircleOn(circleIndex, millis());
     }
     
     if (DEBUG_SERIAL) {
@@ -244,15 +336,75 @@ void FloorHeatingController::setTargetTemperature(float temp) {
   }
 }
 
+bool FloorHeatingController::setControlParams(const HeatingControlParams& params) {
+  bool valid = params.algorithm <= HEATING_ALGORITHM_PI &&
+               params.kp > 0 && params.kp <= 10 &&
+               params.tiSeconds >= 0 && params.tiSeconds <= 86400 &&
+               params.cycleMs >= 60000 && params.cycleMs <= 3600000 &&
+               params.minOnMs + params.minOffMs <= params.cycleMs;
+  if (!valid) {
+    if (DEBUG_SERIAL) {
+      Serial.println("❌ Invalid heating control parameters - unchanged");
+    }
+    return false;
+  }
+  
+  controlParams = params;
+  unsigned long currentTime = millis();
+  for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
+    piControllers[i].reset(currentTime);
+    lastControlCheck[i] = 0;  // Recompute with the new parameters on the next loop()
+  }
+  saveControlParams();
+  
+  if (DEBUG_SERIAL) {
+    Serial.println("🔥 Heating control: " + String(params.algorithm == HEATING_ALGORITHM_PI ? "PI" : "hysteresis") +
+                   " (Kp " + String(params.kp, 2) + ", Ti " + String(params.tiSeconds, 0) + " s, cycle " +
+                   String(params.cycleMs / 1000) + " s, min on/off " + String(params.minOnMs / 1000) + "/" +
+                   String(params.minOffMs / 1000) + " s)");
+  }
+  return true;
+}
+
+void FloorHeatingController::loadControlParams() {
+  HeatingControlParams stored;
+  if (preferences.getBytes("params", &stored, sizeof(stored)) != sizeof(stored)) {
+    return;  // Nothing saved yet (or older layout) - keep Config.h defaults
+  }
+  controlParams = stored;
+}
+
+void FloorHeatingController::saveControlParams() {
+  preferences.putBytes("params", &controlParams, sizeof(controlParams));
+}
+
+float FloorHeatingController::getCircleDuty(uint8_t circleIndex) const {
+  if (circleIndex >= NUM_HEATING_CIRCLES) {
+    return 0.0;
+  }
+  return piControllers[circleIndex].getDuty();
+}
+
+unsigned long FloorHeatingController::getRelayCycles(uint8_t circleIndex) const {
+  if (circleIndex >= NUM_HEATING_CIRCLES) {
+    return 0;
+  }
+  return relayCycles[circleIndex];
+}
+
 void FloorHeatingController::printStatus() const {
   if (DEBUG_SERIAL) {
     Serial.println("📊 Floor Heating Controller Status:");
+    Serial.println("  Control: " + String(controlParams.algorithm == HEATING_ALGORITHM_PI ? "PI" : "hysteresis"));
     for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
       String modeStr = (circleModes[i] == CIRCLE_MODE_OFF) ? "OFF" : "TEMP_CONTROL";
       float temp = (sensors[i] != nullptr) ? sensors[i]->getLastTemperature() : 0.0;
       Serial.println("  Circle " + String(i) + ": " + String(relayStates[i] ? "ON" : "OFF") + 
-                     " (" + modeStr + ") - Temp: " + String(temp, 1) + "°C (Pin " + String(relayPins[i]) + ")");
+                     " (" + modeStr + ") - Temp: " + String(temp, 1) + "°C (Pin " + String(relayPins[i]) + ")" +
+                     " - Duty: " + String(piControllers[i].getDuty() * 100, 0) + "% - Cycles: " + String(relayCycles[i]));
     }
+    relays.printStatus();
+    preheat.printStatus();
   }
 }
 
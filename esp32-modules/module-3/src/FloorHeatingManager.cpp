@@ -5,18 +5,29 @@
 #include "FloorHeatingButtonHandler.h"  // Include here to avoid circular dependency
 #include "LevelingSensor.h"
 #include "Config.h"
+#include "ClockSync.h"
 #include <ArduinoJson.h>
 
 // Static pointer to current instance
 FloorHeatingManager* FloorHeatingManager::currentInstance = nullptr;
 
 // Temperature sensor pins
+#if HEATING_TEMP_MULTIDROP
+// All circles on the shared bus (sensors do not drive it themselves)
+const uint8_t tempPins[NUM_HEATING_CIRCLES] = {
+  HEATING_TEMP_BUS_PIN,
+  HEATING_TEMP_BUS_PIN,
+  HEATING_TEMP_BUS_PIN,
+  HEATING_TEMP_BUS_PIN
+};
+#else
 const uint8_t tempPins[NUM_HEATING_CIRCLES] = {
   HEATING_TEMP_PIN_0,
   HEATING_TEMP_PIN_1,
   HEATING_TEMP_PIN_2,
   HEATING_TEMP_PIN_3
 };
+#endif
 
 FloorHeatingManager::FloorHeatingManager(ModuleManager* moduleMgr) 
   : moduleManager(moduleMgr),
@@ -27,10 +38,14 @@ FloorHeatingManager::FloorHeatingManager(ModuleManager* moduleMgr)
       FloorHeatingSensor(moduleMgr ? &moduleMgr->getMQTTManager() : nullptr, 2, tempPins[2]),
       FloorHeatingSensor(moduleMgr ? &moduleMgr->getMQTTManager() : nullptr, 3, tempPins[3])
     },
+#if HEATING_TEMP_MULTIDROP
+    sensorBus(moduleMgr ? &moduleMgr->getMQTTManager() : nullptr, HEATING_TEMP_BUS_PIN),
+#endif
     buttonHandler(&controller),
     levelingSensor(moduleMgr ? &moduleMgr->getMQTTManager() : nullptr),
     commandHandler(moduleMgr ? &moduleMgr->getMQTTManager() : nullptr, this, MODULE_ID),
-    pendingStatusUpdate(false) {
+    pendingStatusUpdate(false),
+    outdoorSubscribed(false) {
   
   // Validate input parameter
   if (moduleMgr == nullptr) {
@@ -49,6 +64,11 @@ FloorHeatingManager::FloorHeatingManager(ModuleManager* moduleMgr)
     sensors[i].setController(&controller);
     // Link manager to sensors (for publishing status)
     sensors[i].setManager(this);
+#if HEATING_TEMP_MULTIDROP
+    // Sensor readings come from the shared bus
+    sensors[i].setBus(&sensorBus);
+    sensorBus.setSensor(i, &sensors[i]);
+#endif
   }
   
   // Link manager to controller (for status publishing callbacks)
@@ -67,6 +87,9 @@ void FloorHeatingManager::begin() {
   for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
     sensors[i].begin();
   }
+#if HEATING_TEMP_MULTIDROP
+  sensorBus.begin();
+#endif
   
   // Initialize button handler
   buttonHandler.setController(&controller);
@@ -94,9 +117,17 @@ void FloorHeatingManager::onRelayChanged() {
   for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
     sensors[i].onRelayChanged();
   }
+#if HEATING_TEMP_MULTIDROP
+  sensorBus.onRelayChanged();
+#endif
 }
 
 void FloorHeatingManager::loop() {
+#if HEATING_TEMP_MULTIDROP
+  // One conversion for all circles; readings are handed to the sensors below
+  sensorBus.loop();
+#endif
+
   // Update sensors (read temperature - works offline, only if circle is in TEMP_CONTROL mode)
   for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
     sensors[i].loop();
@@ -119,7 +150,17 @@ void FloorHeatingManager::loop() {
     // 3. Sensor error occurs or recovers (handled above)
   }
   
-  // Update controller (automatic temperature control - works offline)
+  // Outdoor temperature for preheating (resubscribe after reconnect)
+  if (moduleManager) {
+    MQTTManager& mqtt = moduleManager->getMQTTManager();
+    if (!mqtt.isMQTTConnected()) {
+      outdoorSubscribed = false;
+    } else if (!outdoorSubscribed) {
+      outdoorSubscribed = mqtt.subscribeTopic(HEATING_OUTDOOR_TOPIC);
+    }
+  }
+  
+  // Update controller (automatic temperature control, preheat starts - works offline)
   controller.loop();
   
   // Update button handler (toggle mode - works offline)
@@ -158,14 +199,27 @@ void FloorHeatingManager::handleMQTTMessageStatic(char* topic, byte* payload, un
 void FloorHeatingManager::processMQTTMessage(char* topic, byte* payload, unsigned int length) {
   String topicStr = String(topic);
   
+  // Module 1 outdoor temperature (plain value) - preheat ambient, not a command
+  if (topicStr == HEATING_OUTDOOR_TOPIC) {
+    char value[16];
+    unsigned int valueLength = length < sizeof(value) - 1 ? length : sizeof(value) - 1;
+    memcpy(value, payload, valueLength);
+    value[valueLength] = '\0';
+    controller.getPreheat().setOutdoorTemperature(atof(value), millis());
+    return;
+  }
+  
   if (DEBUG_SERIAL) {
     Serial.println("📨 FloorHeatingManager received MQTT message:");
     Serial.println("  Topic: " + topicStr);
   }
   
-  // First try force_update command (handled by CommandHandler)
-  if (topicStr.endsWith("/force_update")) {
+  // First try infrastructure commands: force_update, logs/level (handled by CommandHandler)
+  if (topicStr.endsWith("/force_update") || topicStr.endsWith("/logs/level")) {
     commandHandler.handleMQTTMessage(topic, payload, length);
+    if (topicStr.endsWith("/force_update")) {
+      moduleManager->getMQTTManager().expectStatus("smartcamper/sensors/" + String(MODULE_ID) + "/status");
+    }
     return;
   }
   
@@ -191,12 +245,41 @@ void FloorHeatingManager::processMQTTMessage(char* topic, byte* payload, unsigne
     Serial.println("  Command path: " + commandPath);
   }
   
+  // Status topic whose next publish closes the command's round trip (published from loop())
+  String statusTopic = "smartcamper/sensors/" + String(MODULE_ID);
+  if (commandPath.startsWith("leveling/")) {
+    statusTopic += "/leveling";
+  } else if (commandPath.startsWith("sensors/")) {
+    statusTopic += "/sensors";
+  } else {
+    statusTopic += "/status";
+  }
+  moduleManager->getMQTTManager().expectStatus(statusTopic);
+  
     // Handle leveling commands: leveling/start
     if (commandPath == "leveling/start") {
       handleLevelingStart();
       return;
     }
     
+    // Handle sensor bus commands: sensors/scan, sensors/assign
+    if (commandPath.startsWith("sensors/")) {
+      handleSensorCommand(commandPath.substring(8), message);
+      return;
+    }
+    
+    // Handle control algorithm command: control (JSON parameters)
+    if (commandPath == "control") {
+      handleControlCommand(message);
+      return;
+    }
+    
+    // Handle preheat command: preheat (JSON "warm by" time)
+    if (commandPath == "preheat") {
+      handlePreheatCommand(message);
+      return;
+    }
+    
     // Handle circle commands: circle/{index}/{action}
     if (commandPath.startsWith("circle/")) {
     String circleCommand = commandPath.substring(7);  // Remove "circle/"
@@ -289,8 +372,54 @@ void FloorHeatingManager::publishFullStatus() {
       }
     }
     circle["error"] = hasError;
+    circle["duty"] = (int)round(controller.getCircleDuty(i) * 100);  // PI output, %
+    
+    // Preheat schedule (seconds from now) and learned model
+    const HeatingPreheat& preheat = controller.getPreheat();
+    unsigned long now = millis();
+    if (preheat.isScheduled(i)) {
+      JsonObject schedule = circle.createNestedObject("preheat");
+      schedule["warmIn"] = preheat.getWarmInMs(i, now) / 1000;
+      schedule["startIn"] = preheat.getStartInMs(i, now) / 1000;
+    } else {
+      circle["preheat"] = nullptr;  // JSON null
+    }
+    const HeatingCircleModel& model = preheat.getModel(i);
+    JsonObject learned = circle.createNestedObject("model");
+    learned["loss"] = model.lossPerHour;
+    learned["gain"] = model.gainPerHour;
+    learned["lossSamples"] = model.lossSamples;
+    learned["gainSamples"] = model.gainSamples;
   }
   
+  // Ambient used by the preheat model
+  data["ambient"] = controller.getPreheat().getAmbient(millis());
+  data["ambientOutdoor"] = controller.getPreheat().hasRecentOutdoor(millis());
+  
+  // Active control algorithm and parameters (times in seconds, as in the control command)
+  const HeatingControlParams& params = controller.getControlParams();
+  JsonObject control = data.createNestedObject("control");
+  control["algorithm"] = (params.algorithm == HEATING_ALGORITHM_PI) ? "pi" : "hysteresis";
+  control["setpoint"] = controller.getSetpoint();
+  control["kp"] = params.kp;
+  control["ti"] = params.tiSeconds;
+  control["cycle"] = params.cycleMs / 1000;
+  control["minOn"] = params.minOnMs / 1000;
+  control["minOff"] = params.minOffMs / 1000;
+  
+  // Relay slots and sensor read availability (counters since boot, times in seconds)
+  const RelaySchedulerStats& relayStats = RelayScheduler::getStats();
+  JsonObject relays = data.createNestedObject("relays");
+  relays["switches"] = relayStats.switches;
+  relays["slots"] = relayStats.slots;
+  relays["settleWindows"] = relayStats.settleWindows;
+  relays["blanked"] = relayStats.settleMs / 1000;
+  relays["conversions"] = relayStats.conversions;
+  relays["aborted"] = relayStats.aborted;
+  relays["readAvailability"] = RelayScheduler::getReadAvailability();  // % of conversions with a reading
+  
+  ClockSync::addTimestamp(doc);  // Epoch ms once synced
+  
   String payload;
   serializeJson(doc, payload);
   
@@ -360,6 +489,7 @@ void FloorHeatingManager::publishCircleStatus(uint8_t circleIndex, bool forcePub
     }
   }
   doc["error"] = hasError;
+  ClockSync::addTimestamp(doc);  // Epoch ms once synced
   
   String payload;
   serializeJson(doc, payload);
@@ -376,6 +506,196 @@ void FloorHeatingManager::handleLevelingStart() {
   levelingSensor.start();
 }
 
+// Multi-drop bus maintenance
+// sensors/scan   - publish ROM codes found on the bus and the circle map
+// sensors/assign - {"circle":2,"rom":"28FF641E8216034C"} (rom null/empty clears the circle)
+void FloorHeatingManager::handleSensorCommand(String action, String payload) {
+#if HEATING_TEMP_MULTIDROP
+  if (action == "scan") {
+    sensorBus.requestScan();
+    return;
+  }
+  
+  if (action == "assign") {
+    StaticJsonDocument<128> doc;
+    DeserializationError error = deserializeJson(doc, payload);
+    if (error || !doc.containsKey("circle")) {
+      if (DEBUG_SERIAL) {
+        Serial.println("❌ sensors/assign: expected {\"circle\":n,\"rom\":\"...\"}");
+      }
+      return;
+    }
+    
+    uint8_t circleIndex = doc["circle"];
+    const char* rom = doc["rom"];  // nullptr if missing or null
+    if (sensorBus.assignRom(circleIndex, rom)) {
+      sensorBus.requestScan();  // Confirm the new map
+    }
+    return;
+  }
+  
+  if (DEBUG_SERIAL) {
+    Serial.println("  ⚠️ Unknown sensors command: " + action);
+  }
+#else
+  if (DEBUG_SERIAL) {
+    Serial.println("  ⚠️ sensors/" + action + " ignored - HEATING_TEMP_MULTIDROP is disabled");
+  }
+#endif
+}
+
+// Control algorithm - any subset of the fields, times in seconds:
+// {"algorithm":"pi","kp":0.5,"ti":1800,"cycle":600,"minOn":120,"minOff":120}
+// {"algorithm":"hysteresis"}
+void FloorHeatingManager::handleControlCommand(String payload) {
+  StaticJsonDocument<256> doc;
+  DeserializationError error = deserializeJson(doc, payload);
+  if (error) {
+    if (DEBUG_SERIAL) {
+      Serial.println("❌ control: invalid JSON");
+    }
+    return;
+  }
+  
+  HeatingControlParams params = controller.getControlParams();
+  if (doc.containsKey("algorithm")) {
+    String algorithm = doc["algorithm"].as<String>();
+    if (algorithm == "pi") {
+      params.algorithm = HEATING_ALGORITHM_PI;
+    } else if (algorithm == "hysteresis") {
+      params.algorithm = HEATING_ALGORITHM_HYSTERESIS;
+    } else {
+      if (DEBUG_SERIAL) {
+        Serial.println("❌ control: unknown algorithm " + algorithm);
+      }
+      return;
+    }
+  }
+  if (doc.containsKey("kp")) {
+    params.kp = doc["kp"];
+  }
+  if (doc.containsKey("ti")) {
+    params.tiSeconds = doc["ti"];
+  }
+  if (doc.containsKey("cycle")) {
+    params.cycleMs = doc["cycle"].as<unsigned long>() * 1000UL;
+  }
+  if (doc.containsKey("minOn")) {
+    params.minOnMs = doc["minOn"].as<unsigned long>() * 1000UL;
+  }
+  if (doc.containsKey("minOff")) {
+    params.minOffMs = doc["minOff"].as<unsigned long>() * 1000UL;
+  }
+  
+  controller.setControlParams(params);
+  // Confirm the active parameters (deferred, don't publish during MQTT callback)
+  pendingStatusUpdate = true;
+}
+
+// Preheat - be warm (HEATING_TURN_ON_TEMP) at a local time, circles default to all:
+// {"at":"06:30","circles":[0,1],"tz":180}  local time = UTC + tz minutes (needs clock sync)
+// {"in":90}                                 in minutes, no clock needed
+// {"cancel":true}                            drop the schedule
+// {"resetModel":true}                        forget the learned warm-up/cool-down rates
+void FloorHeatingManager::handlePreheatCommand(String payload) {
+  StaticJsonDocument<256> doc;
+  DeserializationError error = deserializeJson(doc, payload);
+  if (error) {
+    if (DEBUG_SERIAL) {
+      Serial.println("❌ preheat: invalid JSON");
+    }
+    return;
+  }
+  
+  HeatingPreheat& preheat = controller.getPreheat();
+  bool selected[NUM_HEATING_CIRCLES];
+  for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
+    selected[i] = !doc.containsKey("circles");
+  }
+  JsonArray circles = doc["circles"].as<JsonArray>();
+  for (JsonVariant circle : circles) {
+    int circleIndex = circle.as<int>();
+    if (circleIndex >= 0 && circleIndex < NUM_HEATING_CIRCLES) {
+      selected[circleIndex] = true;
+    }
+  }
+  
+  if (doc["resetModel"] | false) {
+    preheat.resetModels();
+    pendingStatusUpdate = true;
+    return;
+  }
+  
+  if (doc["cancel"] | false) {
+    for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
+      if (selected[i]) {
+        preheat.cancel(i);
+      }
+    }
+    pendingStatusUpdate = true;
+    return;
+  }
+  
+  unsigned long warmInMs = 0;
+  if (doc.containsKey("in")) {
+    long minutes = doc["in"];
+    if (minutes <= 0 || minutes > 1440) {
+      if (DEBUG_SERIAL) {
+        Serial.println("❌ preheat: \"in\" must be 1..1440 minutes");
+      }
+      return;
+    }
+    warmInMs = (unsigned long)minutes * 60000UL;
+  } else if (doc.containsKey("at")) {
+    String at = doc["at"].as<String>();
+    int colon = at.indexOf(':');
+    int hours = at.substring(0, colon).toInt();
+    int minutes = at.substring(colon + 1).toInt();
+    if (colon < 1 || hours < 0 || hours > 23 || minutes < 0 || minutes > 59) {
+      if (DEBUG_SERIAL) {
+        Serial.println("❌ preheat: \"at\" must be HH:MM");
+      }
+      return;
+    }
+    if (!ClockSync::isSynced()) {
+      if (DEBUG_SERIAL) {
+        Serial.println("❌ preheat: clock not synced yet - use \"in\" (minutes)");
+      }
+      return;
+    }
+    
+    // Next occurrence of HH:MM in local time
+    long tzMinutes = doc["tz"] | HEATING_PREHEAT_TZ_OFFSET_MIN;
+    long localSeconds = (long)((ClockSync::epochMillis() / 1000ULL + tzMinutes * 60) % 86400ULL);
+    long warmInSeconds = (long)hours * 3600 + minutes * 60 - localSeconds;
+    if (warmInSeconds <= 0) {
+      warmInSeconds += 86400;  // Tomorrow
+    }
+    warmInMs = (unsigned long)warmInSeconds * 1000UL;
+  } else {
+    if (DEBUG_SERIAL) {
+      Serial.println("❌ preheat: expected \"at\", \"in\", \"cancel\" or \"resetModel\"");
+    }
+    return;
+  }
+  
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
+    if (!selected[i]) {
+      continue;
+    }
+    if (controller.getCircleMode(i) != CIRCLE_MODE_OFF) {
+      continue;  // Already heating
+    }
+    preheat.schedule(i, warmInMs, now);
+    if (DEBUG_SERIAL) {
+      Serial.println("🔥 Circle " + String(i) + " preheat: warm in " + String(warmInMs / 60000) + " min");
+    }
+  }
+  // Confirm the schedule (deferred, don't publish during MQTT callback)
+  pendingStatusUpdate = true;
+}
+
 void FloorHeatingManager::printStatus() const {
   if (DEBUG_SERIAL) {
     Serial.println("📊 Floor Heating Manager Status:");
@@ -383,6 +703,9 @@ void FloorHeatingManager::printStatus() const {
     for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
       sensors[i].printStatus();
     }
+#if HEATING_TEMP_MULTIDROP
+    sensorBus.printStatus();
+#endif
     buttonHandler.printStatus();
     levelingSensor.printStatus();
   }
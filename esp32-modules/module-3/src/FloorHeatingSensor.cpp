@@ -4,13 +4,14 @@
 #include "FloorHeatingSensor.h"
 #include "FloorHeatingController.h"
 #include "FloorHeatingManager.h"
+#include "RelayScheduler.h"
 #include <Arduino.h>
 #include <math.h>
 
-unsigned long FloorHeatingSensor::globalRelaySettleUntil = 0;
-
 FloorHeatingSensor::FloorHeatingSensor(MQTTManager* mqtt, uint8_t circleIndex, uint8_t pin) 
-  : oneWire(pin), sensors(&oneWire) {
+  : channel(pin, HEATING_TEMP_CONVERSION_MS),
+    // Published values are whole degrees, so any change passes HEATING_TEMP_THRESHOLD
+    pipeline(HEATING_TEMP_MAX_DELTA, HEATING_TEMP_THRESHOLD, HEATING_TEMP_AVERAGE_INTERVAL) {
   // Validate input parameters
   if (mqtt == nullptr) {
     if (DEBUG_SERIAL) {
@@ -30,52 +31,34 @@ FloorHeatingSensor::FloorHeatingSensor(MQTTManager* mqtt, uint8_t circleIndex, u
   this->lastSensorRead = 0;
   this->lastDataSent = 0;
   this->lastTemperature = 0.0;
-  this->lastAcceptedTemperature = NAN;
-  this->lastPublishedTemperature = NAN;  // Initialize as NAN to force first publish
   this->forceUpdateRequested = false;
   this->lastMQTTState = false;  // Initialize as disconnected
   
-  // Initialize async reading state
-  this->conversionStarted = false;
-  this->conversionStartTime = 0;
-  
-  // Initialize async reading state
-  this->conversionStarted = false;
-  this->conversionStartTime = 0;
-  
   // Initialize error handling
   this->failedReadCount = 0;
   this->hasError = false;
   this->controller = nullptr;
   this->manager = nullptr;
-  
-  // Initialize temperature averaging
-  this->temperatureIndex = 0;
-  this->temperatureCount = 0;
-  this->lastAverageTime = 0;
-  for (int i = 0; i < HEATING_TEMP_AVERAGE_COUNT; i++) {
-    this->temperatureReadings[i] = 0.0;
-  }
+  this->bus = nullptr;
 }
 
 void FloorHeatingSensor::begin() {
-  sensors.begin();
-  
-  // Set resolution to 12 bits (0.0625°C precision, default)
-  // This gives us 0.1°C accuracy which is sufficient
-  sensors.setResolution(12);
-  
-  // CRITICAL: Disable blocking wait for conversion
-  // This allows requestTemperatures() to return immediately and conversion happens in background
-  // We must wait for conversion to complete before reading (handled in readTemperature with yield)
-  sensors.setWaitForConversion(false);
+  if (bus != nullptr) {
+    if (DEBUG_SERIAL) {
+      Serial.println("🌡️ Floor Heating Sensor " + String(circleIndex) + " on the shared DS18B20 bus");
+    }
+    return;  // FloorHeatingSensorBus owns the OneWire bus
+  }
+
+  // 12 bits (0.0625°C precision) - conversions take turns with the other circles' buses
+  channel.begin(12);
   
   if (DEBUG_SERIAL) {
     Serial.println("🌡️ DS18B20 Floor Heating Sensor " + String(circleIndex) + " initialized");
     Serial.println("   GPIO pin: " + String(pin));
     
     // Count sensors
-    int deviceCount = sensors.getDeviceCount();
+    int deviceCount = channel.getDeviceCount();
     Serial.println("   Found " + String(deviceCount) + " DS18B20 device(s)");
     
     if (deviceCount == 0) {
@@ -93,16 +76,40 @@ void FloorHeatingSensor::setManager(FloorHeatingManager* mgr) {
 }
 
 bool FloorHeatingSensor::isGlobalRelaySettling() {
-  return millis() < globalRelaySettleUntil;
+  return RelayScheduler::isSettling(millis());
 }
 
 void FloorHeatingSensor::beginGlobalRelaySettle() {
-  globalRelaySettleUntil = millis() + HEATING_RELAY_SETTLE_MS;
+  RelayScheduler::beginSettle(millis());
 }
 
 void FloorHeatingSensor::onRelayChanged() {
-  conversionStarted = false;
-  lastAcceptedTemperature = NAN;
+  if (!channel.isIdle()) {
+    RelayScheduler::onConversionAborted();  // Caught by the switch (slot could not wait)
+  }
+  channel.cancel();
+  pipeline.resetBaseline();
+}
+
+bool FloorHeatingSensor::isEnabled() const {
+  return controller == nullptr || controller->getCircleMode(circleIndex) != CIRCLE_MODE_OFF;
+}
+
+bool FloorHeatingSensor::wantsBusReading(unsigned long currentTime) const {
+  if (!isEnabled()) {
+    return false;
+  }
+  // First measurement (boot / circle just turned on) starts immediately
+  return lastSensorRead == 0 || currentTime - lastSensorRead >= HEATING_TEMP_READ_INTERVAL;
+}
+
+void FloorHeatingSensor::onBusReading(float temperature, bool present, unsigned long currentTime) {
+  if (!present) {
+    reportSensorMissing();
+    return;
+  }
+  lastSensorRead = currentTime;
+  processReading(temperature, currentTime, forceUpdateRequested, false);
 }
 
 void FloorHeatingSensor::loop() {
@@ -140,19 +147,18 @@ void FloorHeatingSensor::loop() {
         hasError = false;
         failedReadCount = 0;
       }
-      // Reset conversion state when turning off
-      if (conversionStarted) {
-        conversionStarted = false;
-      }
+      // Drop a running conversion when turning off
+      channel.cancel();
       return;
     }
   }
 
   // Global EMI settle after any relay toggle — skip reads on all circles
   if (isGlobalRelaySettling()) {
-    if (conversionStarted) {
-      conversionStarted = false;
+    if (!channel.isIdle()) {
+      RelayScheduler::onConversionAborted();
     }
+    channel.cancel();
     return;
   }
   
@@ -166,44 +172,33 @@ void FloorHeatingSensor::loop() {
     }
     // Force a sensor read and publish on next iteration
     // But only if we're not already in the middle of a conversion
-    if (!conversionStarted) {
+    if (channel.isIdle()) {
       forceUpdateRequested = true;
     }
   }
   
   // Update last known MQTT state
   lastMQTTState = mqttConnected;
+
+  // Multi-drop mode: FloorHeatingSensorBus converts and calls onBusReading()
+  if (bus != nullptr) {
+    return;
+  }
   
   // Async temperature reading state machine (non-blocking)
   unsigned long currentTime = millis();
   bool isForceUpdate = forceUpdateRequested;
   
   // Check if sensor is available before attempting to read
-  int deviceCount = sensors.getDeviceCount();
+  int deviceCount = channel.getDeviceCount();
   if (deviceCount == 0) {
-    // No sensor found - report error but don't exit early
-    // This allows error handling to work properly
-    if (conversionStarted) {
-      conversionStarted = false;  // Reset state
-    }
-    // Report error if we haven't already
-    if (!hasError && failedReadCount < 3) {
-      failedReadCount = 3;  // Trigger error immediately
-      hasError = true;
-      if (DEBUG_SERIAL) {
-        Serial.println("❌ ERROR: Circle " + String(circleIndex) + " sensor not found");
-      }
-      // Publish error
-      if (mqttManager != nullptr && mqttManager->isMQTTConnected()) {
-        String errorTopic = "smartcamper/errors/module-3/circle/" + String(circleIndex);
-        String errorPayload = "{\"error\":true,\"type\":\"sensor_disconnected\",\"message\":\"Temperature sensor not found\",\"timestamp\":" + String(millis() / 1000) + "}";
-        mqttManager->publishRaw(errorTopic, errorPayload);
-      }
-    }
+    // No sensor found - report error
+    channel.cancel();
+    reportSensorMissing();
     return;  // Exit early if no sensor
   }
   
-  if (!conversionStarted) {
+  if (channel.isIdle()) {
     // Start a new conversion ONLY if interval has passed (5 seconds)
     // This ensures we don't start new conversion immediately after previous one
     bool intervalPassed = (currentTime - lastSensorRead >= HEATING_TEMP_READ_INTERVAL);
@@ -213,153 +208,130 @@ void FloorHeatingSensor::loop() {
     // NOTE: Do NOT use isForceUpdate or circleJustTurnedOn here - they cause continuous conversions
     bool isFirstMeasurement = (lastSensorRead == 0);
     
-    if (intervalPassed || isFirstMeasurement) {
-      sensors.requestTemperatures();  // Start conversion (non-blocking)
-      conversionStarted = true;
-      conversionStartTime = currentTime;
+    // Not while a relay slot is coming up - the conversion waits for the gap after it
+    if ((intervalPassed || isFirstMeasurement) && RelayScheduler::canStartConversion(currentTime)) {
+      channel.startConversion();  // Convert T, wait, scratchpad read - in later loop() passes
+      RelayScheduler::onConversionStarted(currentTime);
     }
-  } else {
-    // Check if conversion is complete (non-blocking check)
-    // For 12-bit resolution, conversion takes ~750ms
-    // Wait at least 800ms to ensure conversion is complete (safety margin)
-    unsigned long elapsed = currentTime - conversionStartTime;
-    if (elapsed >= 800) {  // Minimum time for 12-bit conversion + safety margin
-      // Conversion should be complete - read temperature
-      lastSensorRead = currentTime;
-      conversionStarted = false;
-      
-      // Read data from sensor
-      float temperature = readTemperature();
-      
-      // Process if valid
-      if (!isnan(temperature) && temperature != -127.0) {  // -127.0 is DallasTemperature error value
-      // Spike filter — floor temp cannot jump more than HEATING_TEMP_MAX_DELTA at once
-      if (!isnan(lastAcceptedTemperature) &&
-          fabs(temperature - lastAcceptedTemperature) > HEATING_TEMP_MAX_DELTA) {
-        if (DEBUG_SERIAL) {
-          Serial.println("⏭️ Circle " + String(circleIndex) + " spike ignored: " +
-                         String(temperature, 1) + "°C (last: " + String(lastAcceptedTemperature, 1) + "°C)");
-        }
-        forceUpdateRequested = false;
-      } else {
-      lastAcceptedTemperature = temperature;
+  }
+  
+  if (channel.poll(currentTime)) {
+    lastSensorRead = currentTime;
+    processReading(channel.getTemperature(), currentTime, isForceUpdate, circleJustTurnedOn && circleJustTurnedOnFlag);
+  }
+}
 
-      // Valid reading - reset error counter
-      if (failedReadCount > 0) {
-        failedReadCount = 0;
-      }
-      
-      // If we had an error and now have valid reading, recover
-      if (hasError) {
-        hasError = false;
-        failedReadCount = 0;  // Reset error counter
-        if (DEBUG_SERIAL) {
-          Serial.println("✅ Circle " + String(circleIndex) + " sensor recovered - temperature: " + String(temperature, 1) + "°C");
-        }
-        // Don't publish here - wait for averaging
-      }
-      
-      // Store temperature reading for averaging
-      temperatureReadings[temperatureIndex] = temperature;
-      temperatureIndex = (temperatureIndex + 1) % HEATING_TEMP_AVERAGE_COUNT;
-      if (temperatureCount < HEATING_TEMP_AVERAGE_COUNT) {
-        temperatureCount++;
-      }
-      
-      // Calculate average temperature on every 6th measurement (30 seconds)
-      // ONLY publish when we have averaged temperature
-      if (temperatureCount >= HEATING_TEMP_AVERAGE_COUNT && 
-          (currentTime - lastAverageTime >= HEATING_TEMP_AVERAGE_INTERVAL || isForceUpdate)) {
-        float averageTemperature = calculateAverageTemperature();
-        
-        // CRITICAL: Update last temperature with averaged value for local control
-        // This ensures the controller uses the averaged temperature for automatic control
-        lastTemperature = averageTemperature;
-        
-        // If circle is in TEMP_CONTROL mode, immediately trigger controller update
-        // This ensures relay turns on/off based on averaged temperature
-        if (controller != nullptr) {
-          CircleMode currentMode = controller->getCircleMode(circleIndex);
-          if (currentMode == CIRCLE_MODE_TEMP_CONTROL) {
-            controller->resetLastCheckTime(circleIndex);
-          }
-        }
-        
-        // ONLY publish when we have averaged temperature (every 6th measurement or 30 seconds)
-        // publishIfNeeded will check if temperature has changed and publish only if different
-        publishIfNeeded(averageTemperature, currentTime, isForceUpdate);
-        lastAverageTime = currentTime;
-        forceUpdateRequested = false;
-      } else {
-        // Don't have enough measurements yet - store temperature for control but don't publish
-        // Use current temperature for control (controller needs it immediately)
-        lastTemperature = temperature;
-        
-        // If circle just turned on, trigger controller update immediately
-        if (circleJustTurnedOn && circleJustTurnedOnFlag) {
-          circleJustTurnedOnFlag = false;
-          if (controller != nullptr) {
-            CircleMode currentMode = controller->getCircleMode(circleIndex);
-            if (currentMode == CIRCLE_MODE_TEMP_CONTROL) {
-              controller->resetLastCheckTime(circleIndex);
-            }
-          }
-        }
-        
-        // DO NOT publish here - wait for averaging (every 6th measurement or 30 seconds)
+// No DS18B20 answering for this circle - error immediately (no 3-read grace)
+void FloorHeatingSensor::reportSensorMissing() {
+  // Report error if we haven't already
+  if (!hasError && failedReadCount < 3) {
+    failedReadCount = 3;  // Trigger error immediately
+    hasError = true;
+    if (DEBUG_SERIAL) {
+      Serial.println("❌ ERROR: Circle " + String(circleIndex) + " sensor not found");
+    }
+    // Publish error
+    if (mqttManager != nullptr && mqttManager->isMQTTConnected()) {
+      String errorTopic = "smartcamper/errors/module-3/circle/" + String(circleIndex);
+      String errorPayload = "{\"error\":true,\"type\":\"sensor_disconnected\",\"message\":\"Temperature sensor not found\",\"timestamp\":" + String(millis() / 1000) + "}";
+      mqttManager->publishRaw(errorTopic, errorPayload);
+    }
+  }
+}
+
+// Spike filter, averaging and publishing for one completed conversion
+void FloorHeatingSensor::processReading(float temperature, unsigned long currentTime, bool isForceUpdate, bool circleJustTurnedOn) {
+  TemperaturePipeline<HEATING_TEMP_AVERAGE_COUNT>::Result result = pipeline.add(temperature, currentTime, isForceUpdate);
+
+  if (result == TemperaturePipeline<HEATING_TEMP_AVERAGE_COUNT>::INVALID) {  // NAN - no answer or CRC error
+    // Invalid reading - increment error counter
+    failedReadCount++;
+    if (DEBUG_SERIAL) {
+      Serial.println("❌ Invalid floor heating temperature reading for circle " + String(circleIndex) + "! (Failed: " + String(failedReadCount) + "/3)");
+    }
+    
+    // If 3 consecutive failures, trigger error
+    if (failedReadCount >= 3 && !hasError) {
+      hasError = true;
+      if (DEBUG_SERIAL) {
+        Serial.println("❌ ERROR: Circle " + String(circleIndex) + " sensor disconnected (3 failed readings)");
       }
-      }  // spike filter accepted
-      } else {
-        // Invalid reading - increment error counter
-        failedReadCount++;
-        if (DEBUG_SERIAL) {
-          Serial.println("❌ Invalid floor heating temperature reading for circle " + String(circleIndex) + "! (Failed: " + String(failedReadCount) + "/3)");
-        }
-        
-        // If 3 consecutive failures, trigger error
-        if (failedReadCount >= 3 && !hasError) {
-          hasError = true;
-          if (DEBUG_SERIAL) {
-            Serial.println("❌ ERROR: Circle " + String(circleIndex) + " sensor disconnected (3 failed readings)");
-          }
-          // Publish error and disable circle (via manager callback)
-          if (mqttManager != nullptr && mqttManager->isMQTTConnected()) {
-            String errorTopic = "smartcamper/errors/module-3/circle/" + String(circleIndex);
-            String errorPayload = "{\"error\":true,\"type\":\"sensor_disconnected\",\"message\":\"Temperature sensor disconnected\",\"timestamp\":" + String(millis() / 1000) + "}";
-            mqttManager->publishRaw(errorTopic, errorPayload);
-          }
-          // Disable circle (set to OFF mode) - need manager reference for this
-          // Will be handled in FloorHeatingManager
-        }
-        
-        forceUpdateRequested = false;
+      // Publish error and disable circle (via manager callback)
+      if (mqttManager != nullptr && mqttManager->isMQTTConnected()) {
+        String errorTopic = "smartcamper/errors/module-3/circle/" + String(circleIndex);
+        String errorPayload = "{\"error\":true,\"type\":\"sensor_disconnected\",\"message\":\"Temperature sensor disconnected\",\"timestamp\":" + String(millis() / 1000) + "}";
+        mqttManager->publishRaw(errorTopic, errorPayload);
       }
+      // Disable circle (set to OFF mode) - need manager reference for this
+      // Will be handled in FloorHeatingManager
+    }
+    
+    forceUpdateRequested = false;
+    return;
+  }
+
+  // Spike filter — floor temp cannot jump more than HEATING_TEMP_MAX_DELTA at once
+  if (result == TemperaturePipeline<HEATING_TEMP_AVERAGE_COUNT>::OUTLIER) {
+    if (DEBUG_SERIAL) {
+      Serial.println("⏭️ Circle " + String(circleIndex) + " spike ignored: " +
+                     String(temperature, 1) + "°C (last: " + String(pipeline.getLastAccepted(), 1) + "°C)");
     }
+    forceUpdateRequested = false;
+    return;
   }
-}
 
-float FloorHeatingSensor::readTemperature() {
-  // Read temperature from first sensor (index 0)
-  // Conversion should already be complete when this is called
-  float temp = sensors.getTempCByIndex(0);
+  // Valid reading - reset error counter
+  if (failedReadCount > 0) {
+    failedReadCount = 0;
+  }
   
-  // Check for errors (DallasTemperature returns -127.0 on error)
-  if (temp == -127.0 || isnan(temp)) {
+  // If we had an error and now have valid reading, recover
+  if (hasError) {
+    hasError = false;
+    failedReadCount = 0;  // Reset error counter
     if (DEBUG_SERIAL) {
-      Serial.println("❌ Failed to read temperature from DS18B20 for circle " + String(circleIndex));
+      Serial.println("✅ Circle " + String(circleIndex) + " sensor recovered - temperature: " + String(temperature, 1) + "°C");
     }
-    return NAN;
+    // Don't publish here - wait for averaging
   }
   
-  return temp;
-}
-
-float FloorHeatingSensor::calculateAverageTemperature() {
-  float sum = 0.0;
-  for (int i = 0; i < HEATING_TEMP_AVERAGE_COUNT; i++) {
-    sum += temperatureReadings[i];
+  // Average is due on every 6th measurement (30 seconds) or on force update
+  // ONLY publish when we have averaged temperature
+  if (result == TemperaturePipeline<HEATING_TEMP_AVERAGE_COUNT>::AVERAGE_DUE) {
+    float averageTemperature = pipeline.getAverage();
+    
+    // CRITICAL: Update last temperature with averaged value for local control
+    // This ensures the controller uses the averaged temperature for automatic control
+    lastTemperature = averageTemperature;
+    
+    // If circle is in TEMP_CONTROL mode, immediately trigger controller update
+    // This ensures relay turns on/off based on averaged temperature
+    if (controller != nullptr) {
+      CircleMode currentMode = controller->getCircleMode(circleIndex);
+      if (currentMode == CIRCLE_MODE_TEMP_CONTROL) {
+        controller->resetLastCheckTime(circleIndex);
+      }
+    }
+    
+    // ONLY publish when we have averaged temperature (every 6th measurement or 30 seconds)
+    // publishIfNeeded will check if temperature has changed and publish only if different
+    publishIfNeeded(averageTemperature, currentTime, isForceUpdate);
+    forceUpdateRequested = false;
+  } else {
+    // Don't have enough measurements yet - store temperature for control but don't publish
+    // Use current temperature for control (controller needs it immediately)
+    lastTemperature = temperature;
+    
+    // If circle just turned on, trigger controller update immediately
+    if (circleJustTurnedOn && controller != nullptr) {
+      CircleMode currentMode = controller->getCircleMode(circleIndex);
+      if (currentMode == CIRCLE_MODE_TEMP_CONTROL) {
+        controller->resetLastCheckTime(circleIndex);
+      }
+    }
+    
+    // DO NOT publish here - wait for averaging (every 6th measurement or 30 seconds)
   }
-  return sum / HEATING_TEMP_AVERAGE_COUNT;
 }
 
 void FloorHeatingSensor::publishIfNeeded(float temperature, unsigned long currentTime, bool forcePublish) {
@@ -396,8 +368,7 @@ void FloorHeatingSensor::publishIfNeeded(float temperature, unsigned long curren
   
   // Check if temperature has changed before publishing (only if not forcing)
   if (!forcePublish) {
-    float lastPublishedTemp = lastPublishedTemperature;
-    if (!isnan(lastPublishedTemp) && roundedTemp == lastPublishedTemp) {
+    if (!pipeline.hasChanged(roundedTemp)) {
       // Temperature hasn't changed, don't publish
       if (DEBUG_MQTT) {
         Serial.println("⏭️ FloorHeatingSensor: Skipping publish for circle " + String(circleIndex) + " - temperature unchanged: " + String(roundedTemp) + "°C");
@@ -426,7 +397,8 @@ void FloorHeatingSensor::printStatus() const {
     Serial.println("  Last Temperature: " + String(lastTemperature) + "°C");
     Serial.println("  Last Data Sent: " + String((millis() - lastDataSent) / 1000) + " seconds ago");
     Serial.println("  Force Update Requested: " + String(forceUpdateRequested ? "Yes" : "No"));
-    Serial.println("  Measurement Count: " + String(temperatureCount) + "/" + String(HEATING_TEMP_AVERAGE_COUNT));
+    Serial.println("  Measurement Count: " + String(pipeline.getCount()) + "/" + String(HEATING_TEMP_AVERAGE_COUNT));
+    Serial.println("  Spikes Ignored: " + String(pipeline.getOutlierCount()));
   }
 }
 
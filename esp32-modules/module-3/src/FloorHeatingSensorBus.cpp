@@ -0,0 +1,336 @@
+// Floor Heating Sensor Bus Implementation
+// One OneWire bus, simultaneous conversion, ROM-addressed reads
+
+#include "FloorHeatingSensorBus.h"
+#include "FloorHeatingSensor.h"
+#include "RelayScheduler.h"
+#include "Logger.h"
+#include <ArduinoJson.h>
+#include <Arduino.h>
+
+static const char* ROM_MAP_KEY = "roms";
+
+FloorHeatingSensorBus::FloorHeatingSensorBus(MQTTManager* mqtt, uint8_t pin)
+  : oneWire(pin), dallas(&oneWire) {
+  this->mqttManager = mqtt;
+  this->pin = pin;
+  this->conversionStarted = false;
+  this->conversionStartTime = 0;
+  this->lastConversionTime = 0;
+  this->conversionCount = 0;
+  this->readingCircle = -1;
+  this->scanPending = false;
+
+  for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
+    sensors[i] = nullptr;
+    memset(roms[i], 0, sizeof(DeviceAddress));
+  }
+}
+
+void FloorHeatingSensorBus::setSensor(uint8_t circleIndex, FloorHeatingSensor* sensor) {
+  if (circleIndex < NUM_HEATING_CIRCLES) {
+    sensors[circleIndex] = sensor;
+  }
+}
+
+void FloorHeatingSensorBus::begin() {
+  preferences.begin("heatbus", false);  // false = read-write mode
+
+  dallas.begin();
+  dallas.setResolution(12);  // All sensors on the bus
+  // requestTemperatures() returns immediately; loop() waits for the conversion
+  dallas.setWaitForConversion(false);
+
+  loadRomMap();
+  assignNewSensors();
+
+  if (DEBUG_SERIAL) {
+    Serial.println("🌡️ DS18B20 multi-drop bus initialized");
+    Serial.println("   GPIO pin: " + String(pin));
+    Serial.println("   Found " + String(dallas.getDeviceCount()) + " DS18B20 device(s)");
+    if (dallas.isParasitePowerMode()) {
+      Serial.println("⚠️ WARNING: Parasite-powered sensor on the bus - use VDD for simultaneous conversion");
+    }
+  }
+
+  for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
+    char hex[17];
+    formatRom(roms[i], hex);
+    if (!isAssigned(i)) {
+      LOG_WARN("⚠️ Circle %d has no DS18B20 assigned on the bus", i);
+    } else if (!dallas.isConnected(roms[i])) {
+      LOG_WARN("⚠️ Circle %d sensor %s not found on the bus", i, hex);
+    } else {
+      LOG_INFO("🌡️ Circle %d sensor %s", i, hex);
+    }
+  }
+}
+
+bool FloorHeatingSensorBus::isAssigned(uint8_t circleIndex) const {
+  for (uint8_t b = 0; b < 8; b++) {
+    if (roms[circleIndex][b] != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int FloorHeatingSensorBus::findCircle(const DeviceAddress rom) const {
+  for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
+    if (memcmp(roms[i], rom, sizeof(DeviceAddress)) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void FloorHeatingSensorBus::loadRomMap() {
+  if (preferences.getBytes(ROM_MAP_KEY, roms, sizeof(roms)) != sizeof(roms)) {
+    memset(roms, 0, sizeof(roms));  // Nothing stored yet (or a different circle count)
+  }
+}
+
+void FloorHeatingSensorBus::saveRomMap() {
+  preferences.putBytes(ROM_MAP_KEY, roms, sizeof(roms));
+}
+
+// Sensors not in the map go to free circles in search order (stored, so the
+// assignment does not change when another sensor is added later)
+void FloorHeatingSensorBus::assignNewSensors() {
+  bool changed = false;
+  uint8_t deviceCount = dallas.getDeviceCount();
+
+  for (uint8_t d = 0; d < deviceCount; d++) {
+    DeviceAddress rom;
+    if (!dallas.getAddress(rom, d) || findCircle(rom) >= 0) {
+      continue;
+    }
+    for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
+      if (!isAssigned(i)) {
+        memcpy(roms[i], rom, sizeof(DeviceAddress));
+        changed = true;
+        char hex[17];
+        formatRom(rom, hex);
+        LOG_INFO("🌡️ New sensor %s assigned to circle %d (change with sensors/assign)", hex, i);
+        break;
+      }
+    }
+  }
+
+  if (changed) {
+    saveRomMap();
+  }
+}
+
+void FloorHeatingSensorBus::onRelayChanged() {
+  if (conversionStarted || readingCircle >= 0) {
+    RelayScheduler::onConversionAborted();
+  }
+  conversionStarted = false;
+  readingCircle = -1;  // Drop the rest of the disturbed conversion
+}
+
+void FloorHeatingSensorBus::loop() {
+  unsigned long currentTime = millis();
+
+  if (readingCircle >= 0) {
+    // Scratchpads are read one circle at a time, each in the background on the RMT
+    if (dallas.isReadComplete()) {
+      deliverReading(readingCircle, currentTime);
+      startNextRead(readingCircle + 1);
+    }
+    return;
+  }
+
+  if (!conversionStarted) {
+    // Bus idle between cycles: the blocking ROM search cannot disturb a reading here
+    if (scanPending) {
+      scanPending = false;
+      publishScan();
+    }
+
+    // Global EMI settle after any relay toggle, or a relay slot before the reading is done
+    if (!RelayScheduler::canStartConversion(currentTime)) {
+      return;
+    }
+
+    bool wanted = false;
+    for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
+      if (sensors[i] != nullptr && sensors[i]->wantsBusReading(currentTime)) {
+        wanted = true;
+      }
+    }
+    if (!wanted) {
+      return;
+    }
+
+    // Skip ROM + Convert T: every sensor on the bus converts at once (non-blocking)
+    dallas.requestTemperatures();
+    conversionStarted = true;
+    conversionStartTime = currentTime;
+    RelayScheduler::onConversionStarted(currentTime);
+  } else if (currentTime - conversionStartTime >= HEATING_TEMP_CONVERSION_MS) {
+    conversionStarted = false;
+    lastConversionTime = currentTime;
+    conversionCount++;
+    startNextRead(0);
+  }
+}
+
+// Every active circle gets a reading from the shared conversion, so their
+// read intervals stay aligned and the next conversion again serves all of them
+void FloorHeatingSensorBus::startNextRead(uint8_t firstCircle) {
+  readingCircle = -1;
+  for (uint8_t i = firstCircle; i < NUM_HEATING_CIRCLES; i++) {
+    if (sensors[i] == nullptr || !sensors[i]->isEnabled()) {
+      continue;
+    }
+    if (!isAssigned(i)) {
+      sensors[i]->onBusReading(NAN, false, millis());
+      continue;
+    }
+
+    dallas.beginReadTempC(roms[i]);  // Match ROM + scratchpad read
+    readingCircle = i;
+    return;
+  }
+}
+
+void FloorHeatingSensorBus::deliverReading(uint8_t circleIndex, unsigned long currentTime) {
+  if (sensors[circleIndex] == nullptr || !sensors[circleIndex]->isEnabled()) {
+    return;  // Turned off while reading
+  }
+
+  float temperature = dallas.getReadTempC();
+  if (temperature == DEVICE_DISCONNECTED_C) {
+    temperature = NAN;
+  }
+  sensors[circleIndex]->onBusReading(temperature, true, currentTime);
+}
+
+bool FloorHeatingSensorBus::assignRom(uint8_t circleIndex, const char* romHex) {
+  if (circleIndex >= NUM_HEATING_CIRCLES) {
+    return false;
+  }
+
+  if (romHex == nullptr || romHex[0] == '\0') {
+    memset(roms[circleIndex], 0, sizeof(DeviceAddress));
+    saveRomMap();
+    LOG_INFO("🌡️ Circle %d sensor cleared", circleIndex);
+    return true;
+  }
+
+  DeviceAddress rom;
+  if (!parseRom(romHex, rom)) {
+    LOG_WARN("⚠️ sensors/assign: invalid ROM code %s", romHex);
+    return false;
+  }
+
+  // A sensor belongs to one circle only
+  int previous = findCircle(rom);
+  if (previous >= 0) {
+    memset(roms[previous], 0, sizeof(DeviceAddress));
+  }
+  memcpy(roms[circleIndex], rom, sizeof(DeviceAddress));
+  saveRomMap();  // Resolution is set by the rescan that confirms the map
+
+  LOG_INFO("🌡️ Circle %d sensor set to %s", circleIndex, romHex);
+  return true;
+}
+
+void FloorHeatingSensorBus::requestScan() {
+  scanPending = true;
+}
+
+// Rescan the bus and publish found ROM codes next to the circle map (bus idle, from loop())
+void FloorHeatingSensorBus::publishScan() {
+  if (mqttManager == nullptr || !mqttManager->isMQTTConnected()) {
+    return;
+  }
+
+  dallas.begin();  // Re-enumerate (sensors may have been added)
+  dallas.setResolution(12);  // Including sensors added after boot
+
+  StaticJsonDocument<768> doc;
+  doc["bus"] = pin;
+  doc["parasite"] = dallas.isParasitePowerMode();
+
+  JsonArray found = doc.createNestedArray("found");
+  uint8_t deviceCount = dallas.getDeviceCount();
+  for (uint8_t d = 0; d < deviceCount; d++) {
+    DeviceAddress rom;
+    if (dallas.getAddress(rom, d)) {
+      char hex[17];
+      formatRom(rom, hex);
+      found.add(String(hex));
+    }
+  }
+
+  JsonArray circles = doc.createNestedArray("circles");
+  for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
+    if (isAssigned(i)) {
+      char hex[17];
+      formatRom(roms[i], hex);
+      circles.add(String(hex));
+    } else {
+      circles.add(nullptr);
+    }
+  }
+
+  String payload;
+  serializeJson(doc, payload);
+  String topic = String(MQTT_TOPIC_SENSORS) + MODULE_ID + "/sensors";
+  mqttManager->publishRaw(topic, payload);
+}
+
+void FloorHeatingSensorBus::formatRom(const DeviceAddress rom, char* out) {
+  static const char HEX_DIGITS[] = "0123456789ABCDEF";
+  for (uint8_t b = 0; b < 8; b++) {
+    out[b * 2] = HEX_DIGITS[rom[b] >> 4];
+    out[b * 2 + 1] = HEX_DIGITS[rom[b] & 0x0F];
+  }
+  out[16] = '\0';
+}
+
+// 16 hex digits (separators ':' or '-' allowed), family code first, CRC checked
+bool FloorHeatingSensorBus::parseRom(const char* hex, DeviceAddress rom) {
+  uint8_t digits = 0;
+  for (const char* c = hex; *c != '\0'; c++) {
+    if (*c == ':' || *c == '-') {
+      continue;
+    }
+    int value;
+    if (*c >= '0' && *c <= '9') {
+      value = *c - '0';
+    } else if (*c >= 'a' && *c <= 'f') {
+      value = *c - 'a' + 10;
+    } else if (*c >= 'A' && *c <= 'F') {
+      value = *c - 'A' + 10;
+    } else {
+      return false;
+    }
+    if (digits >= 16) {
+      return false;
+    }
+    if (digits % 2 == 0) {
+      rom[digits / 2] = (uint8_t)(value << 4);
+    } else {
+      rom[digits / 2] |= (uint8_t)value;
+    }
+    digits++;
+  }
+  return digits == 16 && OneWireRmt::crc8(rom, 7) == rom[7];
+}
+
+void FloorHeatingSensorBus::printStatus() const {
+  if (DEBUG_SERIAL) {
+    Serial.println("📊 Floor Heating Sensor Bus (GPIO " + String(pin) + "):");
+    Serial.println("  Conversions: " + String(conversionCount) + ", last " +
+                   String((millis() - lastConversionTime) / 1000) + " seconds ago");
+    for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
+      char hex[17];
+      formatRom(roms[i], hex);
+      Serial.println("  Circle " + String(i) + ": " + (isAssigned(i) ? String(hex) : String("-")));
+    }
+  }
+}
@@ -0,0 +1,73 @@
+// Heating PI Controller Implementation
+
+#include "HeatingPiController.h"
+
+HeatingPiController::HeatingPiController() {
+  reset(0);
+}
+
+void HeatingPiController::reset(unsigned long now) {
+  integral = 0.0;
+  duty = 0.0;
+  lastUpdate = now;
+  hasUpdate = false;
+  cycleStart = now;
+  lastSwitch = now;
+  hasSwitched = false;
+}
+
+float HeatingPiController::update(float temperature, float setpoint, unsigned long now, const HeatingControlParams& params) {
+  float error = setpoint - temperature;
+
+  // Seconds since the previous reading; capped so a pause (sensor settle, missed
+  // readings) does not integrate as one big step
+  float dt = 0.0;
+  if (hasUpdate) {
+    unsigned long elapsed = now - lastUpdate;
+    if (elapsed > 2UL * HEATING_MEASURE_INTERVAL) {
+      elapsed = 2UL * HEATING_MEASURE_INTERVAL;
+    }
+    dt = elapsed / 1000.0;
+  }
+  lastUpdate = now;
+  hasUpdate = true;
+
+  float proportional = params.kp * error;
+  float output = proportional + integral;
+  bool saturatedHigh = output >= 1.0 && error > 0;
+  bool saturatedLow = output <= 0.0 && error < 0;
+  if (params.tiSeconds > 0 && !saturatedHigh && !saturatedLow) {
+    integral += params.kp * error * dt / params.tiSeconds;
+    integral = constrain(integral, 0.0f, 1.0f);
+  }
+
+  duty = constrain(proportional + integral, 0.0f, 1.0f);
+  return duty;
+}
+
+bool HeatingPiController::relayWanted(bool relayOn, unsigned long now, const HeatingControlParams& params) {
+  if (now - cycleStart >= params.cycleMs) {
+    cycleStart += (now - cycleStart) / params.cycleMs * params.cycleMs;
+  }
+
+  unsigned long onMs = (unsigned long)(duty * params.cycleMs);
+  if (onMs < params.minOnMs) {
+    onMs = 0;  // Too short to be worth a relay cycle
+  } else if (params.cycleMs - onMs < params.minOffMs) {
+    onMs = params.cycleMs;  // Gap too short - stay on
+  }
+
+  bool wanted = (now - cycleStart) < onMs;
+  if (wanted != relayOn && hasSwitched) {
+    unsigned long dwell = relayOn ? params.minOnMs : params.minOffMs;
+    if (now - lastSwitch < dwell) {
+      wanted = relayOn;
+    }
+  }
+  return wanted;
+}
+
+void HeatingPiController::onRelaySwitched(unsigned long now) {
+  lastSwitch = now;
+  hasSwitched = true;
+}
@@ -0,0 +1,401 @@
+// Heating Preheat Implementation
+
+#include "HeatingPreheat.h"
+#include <math.h>
+
+#define HEATING_LEARN_LOSS_MIN 0.02   // 1/h - sample limits (sensor glitches, a door left open)
+#define HEATING_LEARN_LOSS_MAX 5.0
+#define HEATING_LEARN_GAIN_MIN 1.0    // °C/h
+#define HEATING_LEARN_GAIN_MAX 100.0
+
+HeatingPreheat::HeatingPreheat() {
+  for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
+    models[i].lossPerHour = HEATING_LEARN_LOSS_DEFAULT;
+    models[i].gainPerHour = HEATING_LEARN_GAIN_DEFAULT;
+    models[i].lossSamples = 0;
+    models[i].gainSamples = 0;
+
+    CircleState& s = states[i];
+    s.segmentActive = false;
+    s.segmentRelayOn = false;
+    s.segmentStart = 0;
+    s.chunkActive = false;
+    s.chunkTime = 0;
+    s.chunkTemp = 0.0;
+    s.chunkAmbient = 0.0;
+    s.hasPrevChunk = false;
+    s.prevChunkRate = 0.0;
+    s.prevChunkMid = 0;
+    s.circleOn = false;
+    s.circleOnTime = 0;
+    s.hasLast = false;
+    s.lastTemp = 0.0;
+    s.lastTime = 0;
+    s.lastAmbient = 0.0;
+    s.offSamplePending = false;
+    s.scheduled = false;
+    s.scheduledAt = 0;
+    s.warmInMs = 0;
+    s.lastCheck = 0;
+    s.leadMs = 0;
+  }
+
+  outdoorTemp = NAN;
+  outdoorTime = 0;
+  hasOutdoor = false;
+  modelsDirty = false;
+  lastSave = 0;
+}
+
+void HeatingPreheat::begin() {
+  preferences.begin("heatlearn", false);  // false = read-write mode
+  loadModels();
+
+  if (DEBUG_SERIAL) {
+    for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
+      Serial.println("   Circle " + String(i) + " model: cool-down " + String(models[i].lossPerHour, 2) + "/h (" +
+                     String(models[i].lossSamples) + " samples), warm-up " + String(models[i].gainPerHour, 1) + "°C/h (" +
+                     String(models[i].gainSamples) + " samples)");
+    }
+  }
+}
+
+void HeatingPreheat::loop(unsigned long now) {
+  // Flash wear: learned values go to NVS at most once per HEATING_LEARN_SAVE_MS
+  if (modelsDirty && now - lastSave >= HEATING_LEARN_SAVE_MS) {
+    saveModels();
+    lastSave = now;
+  }
+}
+
+void HeatingPreheat::setOutdoorTemperature(float temperature, unsigned long now) {
+  if (isnan(temperature) || temperature < -50.0 || temperature > 70.0) {
+    return;  // Module 1 range check - anything else is not a reading
+  }
+  outdoorTemp = temperature;
+  outdoorTime = now;
+  hasOutdoor = true;
+}
+
+bool HeatingPreheat::hasRecentOutdoor(unsigned long now) const {
+  return hasOutdoor && now - outdoorTime < HEATING_OUTDOOR_MAX_AGE_MS;
+}
+
+float HeatingPreheat::getAmbient(unsigned long now) const {
+  return hasRecentOutdoor(now) ? outdoorTemp : HEATING_PREHEAT_AMBIENT;
+}
+
+void HeatingPreheat::onReading(uint8_t circleIndex, float temperature, unsigned long readTime, bool relayOn, unsigned long now) {
+  if (circleIndex >= NUM_HEATING_CIRCLES) {
+    return;
+  }
+  CircleState& s = states[circleIndex];
+
+  // Only readings taken since the circle was turned on (the sensor keeps its last value while OFF)
+  if (!s.circleOn || readTime == 0 || (long)(readTime - s.circleOnTime) < 0) {
+    return;
+  }
+
+  float ambient = getAmbient(now);
+
+  // Cool-down over the OFF period: last reading before off -> first reading after on
+  if (s.offSamplePending) {
+    s.offSamplePending = false;
+    unsigned long offMs = now - s.lastTime;
+    if (offMs >= HEATING_LEARN_OFF_MIN_MS) {
+      learnCoolDown(circleIndex, s.lastTemp, temperature, (s.lastAmbient + ambient) / 2, offMs);
+    }
+  }
+  s.hasLast = true;
+  s.lastTemp = temperature;
+  s.lastTime = now;
+  s.lastAmbient = ambient;
+
+  if (!s.segmentActive || s.segmentRelayOn != relayOn) {
+    onRelaySwitched(circleIndex, relayOn, now);
+    return;
+  }
+
+  if (!s.chunkActive) {
+    // The floor answers a switch only after the dead time
+    if (now - s.segmentStart < HEATING_LEARN_SKIP_MS) {
+      return;
+    }
+    s.chunkActive = true;
+    s.chunkTime = now;
+    s.chunkTemp = temperature;
+    s.chunkAmbient = ambient;
+    return;
+  }
+
+  if (now - s.chunkTime >= HEATING_LEARN_CHUNK_MS) {
+    learnChunk(circleIndex, s, temperature, ambient, now);
+  }
+}
+
+// One chunk of steady relay state is complete
+void HeatingPreheat::learnChunk(uint8_t circleIndex, CircleState& s, float toTemp, float ambient, unsigned long now) {
+  unsigned long chunkMs = now - s.chunkTime;
+  float hours = chunkMs / 3600000.0;
+  float rate = (toTemp - s.chunkTemp) / hours;
+  unsigned long mid = s.chunkTime + chunkMs / 2;
+
+  // Same relay state: the rate decays as e^(-loss * t) whatever the ambient is
+  if (s.hasPrevChunk && fabsf(toTemp - s.chunkTemp) >= HEATING_LEARN_MIN_CHANGE) {
+    float ratio = s.prevChunkRate / rate;  // > 1 = same direction and slowing down
+    float gapHours = (mid - s.prevChunkMid) / 3600000.0;
+    if (ratio > 1.0) {
+      addLossSample(circleIndex, logf(ratio) / gapHours, String(s.segmentRelayOn ? "warm-up" : "cool-down") + " slowing " +
+                    String(s.prevChunkRate, 1) + " -> " + String(rate, 1) + "°C/h");
+    }
+  }
+  s.hasPrevChunk = true;
+  s.prevChunkRate = rate;
+  s.prevChunkMid = mid;
+
+  if (s.segmentRelayOn) {
+    learnGain(circleIndex, s.chunkTemp, toTemp, (s.chunkAmbient + ambient) / 2, chunkMs);
+  }
+
+  s.chunkTime = now;
+  s.chunkTemp = toTemp;
+  s.chunkAmbient = ambient;
+}
+
+void HeatingPreheat::onRelaySwitched(uint8_t circleIndex, bool relayOn, unsigned long now) {
+  if (circleIndex >= NUM_HEATING_CIRCLES) {
+    return;
+  }
+  CircleState& s = states[circleIndex];
+  s.segmentActive = true;
+  s.segmentRelayOn = relayOn;
+  s.segmentStart = now;
+  s.chunkActive = false;
+  s.hasPrevChunk = false;
+}
+
+void HeatingPreheat::onCircleOn(uint8_t circleIndex, unsigned long now) {
+  if (circleIndex >= NUM_HEATING_CIRCLES) {
+    return;
+  }
+  CircleState& s = states[circleIndex];
+  s.circleOn = true;
+  s.circleOnTime = now;
+  s.segmentActive = false;
+  s.chunkActive = false;
+  s.scheduled = false;  // On now - by schedule, button or command
+}
+
+void HeatingPreheat::onCircleOff(uint8_t circleIndex) {
+  if (circleIndex >= NUM_HEATING_CIRCLES) {
+    return;
+  }
+  CircleState& s = states[circleIndex];
+  s.circleOn = false;
+  s.segmentActive = false;
+  s.chunkActive = false;
+  s.offSamplePending = s.hasLast;
+}
+
+// Whole OFF period (circle off, then on again)
+void HeatingPreheat::learnCoolDown(uint8_t circleIndex, float fromTemp, float toTemp, float ambient, unsigned long durationMs) {
+  float fromExcess = fromTemp - ambient;
+  float toExcess = toTemp - ambient;
+  // Near ambient the log blows up the sensor and ambient error; too little change is quantisation
+  if (toExcess < HEATING_LEARN_MIN_EXCESS || fromTemp - toTemp < HEATING_LEARN_MIN_CHANGE) {
+    return;
+  }
+
+  float hours = durationMs / 3600000.0;
+  addLossSample(circleIndex, logf(fromExcess / toExcess) / hours, "OFF " + String(durationMs / 60000) + " min, " +
+                String(fromTemp, 1) + " -> " + String(toTemp, 1) + "°C, ambient " + String(ambient, 1) + "°C");
+}
+
+void HeatingPreheat::addLossSample(uint8_t circleIndex, float sample, const String& source) {
+  sample = constrain(sample, (float)HEATING_LEARN_LOSS_MIN, (float)HEATING_LEARN_LOSS_MAX);
+
+  HeatingCircleModel& model = models[circleIndex];
+  model.lossPerHour = ewma(model.lossPerHour, sample, model.lossSamples);
+  modelsDirty = true;
+
+  if (DEBUG_SERIAL) {
+    Serial.println("📉 Circle " + String(circleIndex) + " cool-down sample " + String(sample, 2) + "/h (" + source +
+                   ") - model " + String(model.lossPerHour, 2) + "/h");
+  }
+}
+
+void HeatingPreheat::learnGain(uint8_t circleIndex, float fromTemp, float toTemp, float ambient, unsigned long durationMs) {
+  if (toTemp - fromTemp < HEATING_LEARN_MIN_CHANGE) {
+    return;
+  }
+
+  // Solve the model for the temperature the floor is heading to, then for the gain
+  HeatingCircleModel& model = models[circleIndex];
+  float hours = durationMs / 3600000.0;
+  float decay = expf(-model.lossPerHour * hours);
+  float equilibrium = (toTemp - fromTemp * decay) / (1.0 - decay);
+  float sample = model.lossPerHour * (equilibrium - ambient);
+  sample = constrain(sample, (float)HEATING_LEARN_GAIN_MIN, (float)HEATING_LEARN_GAIN_MAX);
+
+  model.gainPerHour = ewma(model.gainPerHour, sample, model.gainSamples);
+  modelsDirty = true;
+
+  if (DEBUG_SERIAL) {
+    Serial.println("📈 Circle " + String(circleIndex) + " warm-up sample " + String(sample, 1) + "°C/h (" +
+                   String(fromTemp, 1) + " -> " + String(toTemp, 1) + "°C in " + String(durationMs / 60000) +
+                   " min, ambient " + String(ambient, 1) + "°C) - model " + String(model.gainPerHour, 1) + "°C/h");
+  }
+}
+
+// Exponentially weighted: the first samples average (1/n) so the default is
+// forgotten quickly, later ones move the value by HEATING_LEARN_ALPHA
+float HeatingPreheat::ewma(float value, float sample, uint16_t& samples) {
+  if (samples < 0xFFFF) {
+    samples++;
+  }
+  float alpha = 1.0 / samples;
+  if (alpha < HEATING_LEARN_ALPHA) {
+    alpha = HEATING_LEARN_ALPHA;
+  }
+  return value + alpha * (sample - value);
+}
+
+void HeatingPreheat::schedule(uint8_t circleIndex, unsigned long warmInMs, unsigned long now) {
+  if (circleIndex >= NUM_HEATING_CIRCLES) {
+    return;
+  }
+  CircleState& s = states[circleIndex];
+  s.scheduled = true;
+  s.scheduledAt = now;
+  s.warmInMs = warmInMs;
+  s.lastCheck = now - HEATING_PREHEAT_CHECK_MS;  // Compute the start time on the next check
+  s.leadMs = 0;
+}
+
+void HeatingPreheat::cancel(uint8_t circleIndex) {
+  if (circleIndex >= NUM_HEATING_CIRCLES) {
+    return;
+  }
+  states[circleIndex].scheduled = false;
+}
+
+bool HeatingPreheat::isScheduled(uint8_t circleIndex) const {
+  return circleIndex < NUM_HEATING_CIRCLES && states[circleIndex].scheduled;
+}
+
+bool HeatingPreheat::isStartDue(uint8_t circleIndex, float warmTemp, unsigned long now) {
+  if (!isScheduled(circleIndex)) {
+    return false;
+  }
+  CircleState& s = states[circleIndex];
+
+  unsigned long elapsed = now - s.scheduledAt;
+  if (elapsed >= s.warmInMs) {
+    return true;  // Asked for too late (or the start was missed) - warm up now
+  }
+  if (now - s.lastCheck < HEATING_PREHEAT_CHECK_MS) {
+    return false;
+  }
+  s.lastCheck = now;
+
+  // The floor keeps cooling and the outdoor temperature changes - recompute each check
+  s.leadMs = predictLeadMs(circleIndex, predictTemperature(circleIndex, now), warmTemp, now);
+  return s.warmInMs - elapsed <= s.leadMs;
+}
+
+unsigned long HeatingPreheat::getWarmInMs(uint8_t circleIndex, unsigned long now) const {
+  if (!isScheduled(circleIndex)) {
+    return 0;
+  }
+  const CircleState& s = states[circleIndex];
+  unsigned long elapsed = now - s.scheduledAt;
+  return elapsed < s.warmInMs ? s.warmInMs - elapsed : 0;
+}
+
+unsigned long HeatingPreheat::getStartInMs(uint8_t circleIndex, unsigned long now) const {
+  unsigned long warmIn = getWarmInMs(circleIndex, now);
+  unsigned long lead = states[circleIndex].leadMs;
+  return warmIn > lead ? warmIn - lead : 0;
+}
+
+float HeatingPreheat::predictTemperature(uint8_t circleIndex, unsigned long now) const {
+  float ambient = getAmbient(now);
+  const CircleState& s = states[circleIndex];
+  if (!s.hasLast) {
+    return ambient;  // Nothing read since boot - assume a cold floor (earliest start)
+  }
+  if (s.circleOn) {
+    return s.lastTemp;
+  }
+  float hours = (now - s.lastTime) / 3600000.0;
+  return ambient + (s.lastTemp - ambient) * expf(-models[circleIndex].lossPerHour * hours);
+}
+
+unsigned long HeatingPreheat::predictLeadMs(uint8_t circleIndex, float fromTemp, float warmTemp, unsigned long now) const {
+  if (fromTemp >= warmTemp) {
+    return 0;
+  }
+  const HeatingCircleModel& model = models[circleIndex];
+  float equilibrium = getAmbient(now) + model.gainPerHour / model.lossPerHour;
+  if (warmTemp >= equilibrium - HEATING_LEARN_MIN_CHANGE) {
+    return HEATING_PREHEAT_MAX_LEAD_MS;  // Barely reachable at this ambient - as early as allowed
+  }
+
+  float hours = logf((equilibrium - fromTemp) / (equilibrium - warmTemp)) / model.lossPerHour;
+  float leadMs = hours * 3600000.0 * HEATING_PREHEAT_LEAD_FACTOR + HEATING_PREHEAT_MARGIN_MS;
+  if (leadMs > HEATING_PREHEAT_MAX_LEAD_MS) {
+    return HEATING_PREHEAT_MAX_LEAD_MS;
+  }
+  return (unsigned long)leadMs;
+}
+
+void HeatingPreheat::resetModels() {
+  for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
+    models[i].lossPerHour = HEATING_LEARN_LOSS_DEFAULT;
+    models[i].gainPerHour = HEATING_LEARN_GAIN_DEFAULT;
+    models[i].lossSamples = 0;
+    models[i].gainSamples = 0;
+  }
+  saveModels();
+  modelsDirty = false;
+
+  if (DEBUG_SERIAL) {
+    Serial.println("🔥 Preheat models reset to defaults");
+  }
+}
+
+void HeatingPreheat::loadModels() {
+  HeatingCircleModel stored[NUM_HEATING_CIRCLES];
+  if (preferences.getBytes("models", stored, sizeof(stored)) != sizeof(stored)) {
+    return;  // Nothing learned yet (or older layout) - keep Config.h defaults
+  }
+  for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
+    bool valid = stored[i].lossPerHour >= HEATING_LEARN_LOSS_MIN && stored[i].lossPerHour <= HEATING_LEARN_LOSS_MAX &&
+                 stored[i].gainPerHour >= HEATING_LEARN_GAIN_MIN && stored[i].gainPerHour <= HEATING_LEARN_GAIN_MAX;
+    if (valid) {
+      models[i] = stored[i];
+    }
+  }
+}
+
+void HeatingPreheat::saveModels() {
+  preferences.putBytes("models", models, sizeof(models));
+  modelsDirty = false;
+}
+
+void HeatingPreheat::printStatus() const {
+  if (DEBUG_SERIAL) {
+    unsigned long now = millis();
+    Serial.println("  Ambient: " + String(getAmbient(now), 1) + "°C" + (hasRecentOutdoor(now) ? " (outdoor)" : " (default)"));
+    for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
+      const HeatingCircleModel& model = models[i];
+      String line = "  Circle " + String(i) + " model: cool-down " + String(model.lossPerHour, 2) + "/h (" +
+                    String(model.lossSamples) + "), warm-up " + String(model.gainPerHour, 1) + "°C/h (" +
+                    String(model.gainSamples) + ")";
+      if (isScheduled(i)) {
+        line += " - warm in " + String(getWarmInMs(i, now) / 60000) + " min, start in " + String(getStartInMs(i, now) / 60000) + " min";
+      }
+      Serial.println(line);
+    }
+  }
+}
@@ -4,6 +4,7 @@
 #include "LevelingSensor.h"
 #include <Arduino.h>
 #include <ArduinoJson.h>
+#include "ClockSync.h"
 
 LevelingSensor::LevelingSensor(MQTTManager* mqtt) 
   : mpu(Wire), mqttManager(mqtt), lastReadTime(0), timeoutExpiresAt(0), initialized(false), isActive(false),
@@ -130,6 +131,7 @@ void LevelingSensor::readAndPublishSensor() {
     StaticJsonDocument<128> doc;
     doc["pitch"] = roundedPitch;
     doc["roll"] = roundedRoll;
+    ClockSync::addTimestamp(doc);  // Epoch ms once synced
     
     String payload;
     serializeJson(doc, payload);
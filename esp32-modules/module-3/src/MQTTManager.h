@@ -8,6 +8,10 @@
 #include <WiFi.h>
 #include "Config.h"
 
+// Forward declaration
+class CommandTracker;
+class ClockSync;
+
 class MQTTManager {
 private:
   WiFiClient wifiClient;
@@ -19,6 +23,14 @@ private:
   bool isConnected;
   int failedAttempts;  // Counter for failed attempts
   unsigned long lastWiFiWarningTime;  // Last time of WiFi warning
+  
+  // Command dispatch (module callback wrapped by CommandTracker hooks)
+  void (*userCallback)(char* topic, byte* payload, unsigned int length);
+  CommandTracker* commandTracker;  // Not owned, may be nullptr
+  ClockSync* clockSync;            // Not owned, may be nullptr
+  static MQTTManager* currentInstance;
+  static void dispatchStatic(char* topic, byte* payload, unsigned int length);
+  void notifyPublished(const String& topic);
 
 public:
   MQTTManager();
@@ -38,14 +50,22 @@ public:
   bool publishSensorData(String sensorType, int value);
   
   // Publish raw topic (for heartbeat, etc.)
-  bool publishRaw(String topic, String payload);
+  bool publishRaw(String topic, String payload, bool logPublish = true);  // logPublish=false for log streaming
   
   // Subscribe to commands
   bool subscribeToCommands(String moduleType);
+  bool subscribeTopic(String topic);  // Infrastructure topics (e.g. time sync replies)
   
   // Callback for received messages
   void setCallback(void (*callback)(char* topic, byte* payload, unsigned int length));
   
+  // Command correlation (ids, acks, latency) - see CommandTracker.h
+  void setCommandTracker(CommandTracker* tracker);
+  void expectStatus(const String& topic);  // Command being executed publishes its status on this topic (prefix) later
+  
+  // Time sync replies are handled before module callbacks - see ClockSync.h
+  void setClockSync(ClockSync* sync);
+  
   void printStatus();  // Cannot be const - PubSubClient methods are not const
 };
 
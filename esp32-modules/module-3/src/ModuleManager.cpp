@@ -3,9 +3,13 @@
 
 #include "ModuleManager.h"
 #include "CommandHandler.h"
+#include "Logger.h"
 
 ModuleManager::ModuleManager() 
-  : heartbeatManager(&mqttManager, MODULE_ID) {
+  : heartbeatManager(&mqttManager, MODULE_ID),
+    logStreamer(&mqttManager, MODULE_ID),
+    commandTracker(&mqttManager, MODULE_ID),
+    clockSync(&mqttManager, MODULE_ID) {
   this->commandHandler = nullptr;
   this->initialized = false;
   this->lastConnectionState = false;  // Start as disconnected
@@ -21,6 +25,9 @@ void ModuleManager::begin(CommandHandler* cmdHandler) {
   }
   
   Serial.begin(115200);
+  
+  // Start log drain task (log calls never block on Serial after this)
+  Logger::begin();
   Serial.println("🔧 Module " + String(MODULE_ID) + " Infrastructure Starting...");
   
   // Initialize network
@@ -29,6 +36,14 @@ void ModuleManager::begin(CommandHandler* cmdHandler) {
   // Initialize MQTT
   mqttManager.begin();
   
+  // Track command ids / latency for every command dispatched by MQTTManager
+  commandTracker.begin();
+  mqttManager.setCommandTracker(&commandTracker);
+  
+  // Sync clock with the backend (timestamps in heartbeat and status payloads)
+  clockSync.begin();
+  mqttManager.setClockSync(&clockSync);
+  
   // Setup MQTT callback if command handler provided
   if (cmdHandler) {
     this->commandHandler = cmdHandler;
@@ -39,6 +54,9 @@ void ModuleManager::begin(CommandHandler* cmdHandler) {
   // Initialize Heartbeat Manager
   heartbeatManager.begin();
   
+  // Initialize log streaming (mirrors log lines to MQTT)
+  logStreamer.begin();
+  
   // Initialize command handler if provided (after MQTT is ready)
   if (cmdHandler) {
     cmdHandler->begin();
@@ -72,6 +90,15 @@ void ModuleManager::loop() {
   // Update Heartbeat Manager (must be after MQTT loop)
   heartbeatManager.loop();
   
+  // Publish pending log lines (rate-limited)
+  logStreamer.loop();
+  
+  // Send command acks and requested latency metrics
+  commandTracker.loop();
+  
+  // Subscribe to / run time sync bursts
+  clockSync.loop();
+  
   // Update Command Handler (handles subscription when MQTT connects)
   if (commandHandler) {
     commandHandler->loop();
@@ -90,5 +117,8 @@ void ModuleManager::printStatus() {
   Serial.println("  Command Handler: " + String(commandHandler != nullptr ? "Set" : "Not set"));
   mqttManager.printStatus();
   heartbeatManager.printStatus();
+  logStreamer.printStatus();
+  commandTracker.printStatus();
+  clockSync.printStatus();
 }
 
@@ -0,0 +1,195 @@
+// Relay Scheduler Implementation
+
+#include "RelayScheduler.h"
+
+bool RelayScheduler::slotPending = false;
+unsigned long RelayScheduler::slotTime = 0;
+unsigned long RelayScheduler::busyUntil = 0;
+unsigned long RelayScheduler::nextConversion = 0;
+unsigned long RelayScheduler::settleUntil = 0;
+RelaySchedulerStats RelayScheduler::stats = {0, 0, 0, 0, 0, 0};
+
+RelayScheduler::RelayScheduler() {
+  for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
+    relayPins[i] = 0;
+    outputs[i] = false;
+    pending[i] = false;
+  }
+  slotStarted = false;
+  lastSwitch = 0;
+}
+
+void RelayScheduler::begin(const uint8_t* pins) {
+  for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
+    relayPins[i] = pins[i];
+    pinMode(relayPins[i], OUTPUT);
+    digitalWrite(relayPins[i], LOW);  // Start with relay OFF
+    outputs[i] = false;
+    pending[i] = false;
+  }
+  slotPending = false;
+  busyUntil = 0;
+  nextConversion = 0;
+  settleUntil = 0;
+  stats = RelaySchedulerStats();
+
+  if (DEBUG_SERIAL) {
+#if HEATING_RELAY_SCHEDULER
+    Serial.println("   Relay slots: between sensor conversions, " + String(HEATING_RELAY_STAGGER_MS) + " ms between relays");
+#else
+    Serial.println("   Relay slots: off (relays switch at once)");
+#endif
+  }
+}
+
+bool RelayScheduler::hasPending() const {
+  for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
+    if (pending[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Quiet gap for the slot: now, after the running conversion, or after the next
+// conversion if it is due before the switching and settle window would be over
+void RelayScheduler::planSlot(unsigned long now) {
+  slotTime = now;
+#if HEATING_RELAY_SCHEDULER
+  unsigned long span = (NUM_HEATING_CIRCLES - 1) * HEATING_RELAY_STAGGER_MS + HEATING_RELAY_SETTLE_MS;
+  if ((long)(busyUntil - now) > 0) {
+    slotTime = busyUntil;
+  } else if ((long)(nextConversion - now) > 0 && nextConversion - now < span) {
+    slotTime = nextConversion + HEATING_RELAY_READ_WINDOW_MS;
+  }
+#endif
+  slotPending = true;
+  slotStarted = false;
+}
+
+void RelayScheduler::request(uint8_t circleIndex, bool state, unsigned long now) {
+  if (circleIndex >= NUM_HEATING_CIRCLES) {
+    return;
+  }
+
+  pending[circleIndex] = (state != outputs[circleIndex]);
+  if (pending[circleIndex]) {
+    if (!slotPending) {
+      planSlot(now);
+    }
+  } else if (slotPending && !hasPending()) {
+    slotPending = false;  // Taken back before its slot - nothing to switch
+  }
+}
+
+uint8_t RelayScheduler::loop(unsigned long now) {
+  if (!slotPending || (long)(now - slotTime) < 0) {
+    return 0;
+  }
+
+#if HEATING_RELAY_SCHEDULER
+  if (stats.switches > 0 && now - lastSwitch < HEATING_RELAY_STAGGER_MS) {
+    return 0;  // Next relay after the stagger gap (also across slots)
+  }
+#endif
+  if (!slotStarted) {
+    slotStarted = true;
+    stats.slots++;
+  }
+
+  uint8_t switched = 0;
+  for (uint8_t i = 0; i < NUM_HEATING_CIRCLES; i++) {
+    if (!pending[i]) {
+      continue;
+    }
+    outputs[i] = !outputs[i];
+    pending[i] = false;
+    digitalWrite(relayPins[i], outputs[i] ? HIGH : LOW);
+    stats.switches++;
+    lastSwitch = now;
+    switched++;
+
+    if (DEBUG_VERBOSE) {
+      Serial.println("🔌 Relay " + String(i) + " " + String(outputs[i] ? "ON" : "OFF") + " (Pin " + String(relayPins[i]) + ")");
+    }
+#if HEATING_RELAY_SCHEDULER
+    break;  // One relay per stagger gap
+#endif
+  }
+
+  if (!hasPending()) {
+    slotPending = false;
+  }
+  return switched;
+}
+
+bool RelayScheduler::getOutput(uint8_t circleIndex) const {
+  if (circleIndex >= NUM_HEATING_CIRCLES) {
+    return false;
+  }
+  return outputs[circleIndex];
+}
+
+bool RelayScheduler::isPending(uint8_t circleIndex) const {
+  if (circleIndex >= NUM_HEATING_CIRCLES) {
+    return false;
+  }
+  return pending[circleIndex];
+}
+
+bool RelayScheduler::canStartConversion(unsigned long now) {
+  if (isSettling(now)) {
+    return false;
+  }
+#if HEATING_RELAY_SCHEDULER
+  // Reading would not be done before the slot (or the slot is switching right now)
+  if (slotPending && (long)(slotTime - now) < (long)HEATING_RELAY_READ_WINDOW_MS) {
+    return false;
+  }
+#endif
+  return true;
+}
+
+void RelayScheduler::onConversionStarted(unsigned long now) {
+  stats.conversions++;
+  if ((long)(now + HEATING_RELAY_READ_WINDOW_MS - busyUntil) > 0) {
+    busyUntil = now + HEATING_RELAY_READ_WINDOW_MS;  // Latest of the circles' conversions
+  }
+  nextConversion = now + HEATING_TEMP_READ_INTERVAL;
+}
+
+void RelayScheduler::onConversionAborted() {
+  stats.aborted++;
+}
+
+// Relays switched inside one window extend it instead of starting a new one
+void RelayScheduler::beginSettle(unsigned long now) {
+  unsigned long until = now + HEATING_RELAY_SETTLE_MS;
+  if (isSettling(now)) {
+    stats.settleMs += until - settleUntil;
+  } else {
+    stats.settleWindows++;
+    stats.settleMs += HEATING_RELAY_SETTLE_MS;
+  }
+  settleUntil = until;
+}
+
+bool RelayScheduler::isSettling(unsigned long now) {
+  return (long)(now - settleUntil) < 0;
+}
+
+float RelayScheduler::getReadAvailability() {
+  if (stats.conversions == 0) {
+    return 100.0;
+  }
+  return 100.0f * (stats.conversions - stats.aborted) / stats.conversions;
+}
+
+void RelayScheduler::printStatus() const {
+  if (DEBUG_SERIAL) {
+    Serial.println("  Relays: " + String(stats.switches) + " switches in " + String(stats.slots) + " slots, " +
+                   String(stats.settleWindows) + " settle windows (" + String(stats.settleMs / 1000) + " s reads blanked)");
+    Serial.println("  Conversions: " + String(stats.conversions) + " started, " + String(stats.aborted) +
+                   " aborted by relays - reads available " + String(getReadAvailability(), 2) + "%");
+  }
+}
@@ -0,0 +1,92 @@
+// Host build shim for module-3 tools (not used by the firmware build)
+// Provides just enough of the Arduino core for FloorHeatingController,
+// HeatingPiController and HeatingPreheat to compile on Linux. millis() follows the simulated clock
+// (HostClock::nowMs), Serial output goes to stderr and is off by default.
+
+#ifndef HOST_ARDUINO_SHIM_H
+#define HOST_ARDUINO_SHIM_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using std::isnan;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+
+template <typename T>
+inline T constrain(T value, T low, T high) {
+  return value < low ? low : (value > high ? high : value);
+}
+
+struct HostClock {
+  static inline unsigned long nowMs = 0;
+};
+
+inline unsigned long millis() { return HostClock::nowMs; }
+
+struct HostPins {
+  static inline uint8_t level[40] = {};
+};
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t pin, uint8_t value) {
+  if (pin < 40) HostPins::level[pin] = value;
+}
+
+class String {
+ public:
+  String() {}
+  String(const char *text) : value(text != nullptr ? text : "") {}
+  String(const std::string &text) : value(text) {}
+  String(int number) : value(std::to_string(number)) {}
+  String(unsigned int number) : value(std::to_string(number)) {}
+  String(unsigned char number) : value(std::to_string(number)) {}
+  String(long number) : value(std::to_string(number)) {}
+  String(unsigned long number) : value(std::to_string(number)) {}
+  String(double number, int decimals = 2) {
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "%.*f", decimals, number);
+    value = buffer;
+  }
+  String(float number, int decimals = 2) : String((double)number, decimals) {}
+
+  const char *c_str() const { return value.c_str(); }
+  unsigned int length() const { return value.size(); }
+  bool operator==(const char *other) const { return value == other; }
+  String &operator+=(const String &other) {
+    value += other.value;
+    return *this;
+  }
+  friend String operator+(const String &a, const String &b) { return String(a.value + b.value); }
+  friend String operator+(const char *a, const String &b) { return String(std::string(a) + b.value); }
+  friend String operator+(const String &a, const char *b) { return String(a.value + b); }
+
+ private:
+  std::string value;
+};
+
+class HostSerial {
+ public:
+  void print(const String &text) {
+    if (enabled) fputs(text.c_str(), stderr);
+  }
+  void println(const String &text) {
+    if (enabled) fprintf(stderr, "%s\n", text.c_str());
+  }
+  void setEnabled(bool on) { enabled = on; }
+
+ private:
+  bool enabled = false;
+};
+
+inline HostSerial Serial;  // One instance across translation units
+
+#endif
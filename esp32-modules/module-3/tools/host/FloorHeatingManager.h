@@ -0,0 +1,17 @@
+// Host build shim: status publishing is dropped; relay switches start the sensor
+// blind period as FloorHeatingManager::onRelayChanged does on the module
+
+#ifndef FLOOR_HEATING_MANAGER_H
+#define FLOOR_HEATING_MANAGER_H
+
+#include "Config.h"
+#include "RelayScheduler.h"
+#include <Arduino.h>
+
+class FloorHeatingManager {
+ public:
+  void publishCircleStatus(uint8_t, bool = false) {}
+  void onRelayChanged() { RelayScheduler::beginSettle(millis()); }
+};
+
+#endif
@@ -0,0 +1,23 @@
+// Host build shim: the simulator plays the sensor and sets the averaged reading
+// the controller sees (FloorHeatingSensor::getLastTemperature on the module)
+
+#ifndef FLOOR_HEATING_SENSOR_H
+#define FLOOR_HEATING_SENSOR_H
+
+#include <cmath>
+
+class FloorHeatingSensor {
+ public:
+  float getLastTemperature() const { return lastTemperature; }
+  unsigned long getLastReadTime() const { return lastReadTime; }
+  void setLastTemperature(float temperature, unsigned long readTime) {
+    lastTemperature = temperature;
+    lastReadTime = readTime;
+  }
+
+ private:
+  float lastTemperature = NAN;
+  unsigned long lastReadTime = 0;
+};
+
+#endif
@@ -0,0 +1,15 @@
+// Host build shim: NVS Preferences that never hold anything (Config.h defaults apply)
+
+#ifndef HOST_PREFERENCES_SHIM_H
+#define HOST_PREFERENCES_SHIM_H
+
+#include <cstddef>
+
+class Preferences {
+ public:
+  bool begin(const char *, bool) { return true; }
+  size_t getBytes(const char *, void *, size_t) { return 0; }
+  size_t putBytes(const char *, const void *, size_t length) { return length; }
+};
+
+#endif
@@ -0,0 +1,437 @@
+/**
+ * Floor heating simulator: drives the module-3 FloorHeatingController on Linux against a
+ * thermal model of one heating circle, in fast-forward, once with the on/off hysteresis
+ * and once with the PI controller, and compares the two.
+ *
+ * Floor model (first order with dead time):
+ *   dT/dt = (ambient + rise * heat(t - dead) - T) / tau
+ * heat() is the relay output (RelayScheduler), delayed by the time the heat needs to reach the sensor.
+ * The cabin (ambient) temperature follows a daily sine. The sensor is read as on the
+ * module: a DS18B20 reading (0.0625 °C steps, small noise) every HEATING_TEMP_READ_INTERVAL,
+ * none while RelayScheduler holds conversions back or the relay settle window runs, and the controller gets the
+ * average of the last HEATING_TEMP_AVERAGE_COUNT readings every HEATING_TEMP_AVERAGE_INTERVAL.
+ *
+ * Reported per run, after warm-up (first time the floor reaches the setpoint):
+ * overshoot above the setpoint and above HEATING_TURN_OFF_TEMP, RMS error, relay ON
+ * switches per day, relay duty and heater energy per day.
+ *
+ * --preheat runs the HeatingPreheat scenario instead: the circle is on 07:00-22:00 (PI),
+ * on the first morning switched on by hand, then every evening turned off with "warm by
+ * 07:00". The cabin temperature is passed as the outdoor temperature (not with
+ * --no-outdoor). Reported per morning: preheat start, time the floor reached
+ * HEATING_TURN_ON_TEMP and how early/late that was, and the model learned so far.
+ *
+ * Usage:
+ *   floor_heating_sim [--days <n>] [--tau <min>] [--dead <min>] [--rise <°C>] [--ambient <°C>]
+ *                     [--swing <°C>] [--power <W>] [--kp <duty/°C>] [--ti <s>] [--cycle <s>]
+ *                     [--min-on <s>] [--min-off <s>] [--trace <out.csv>] [--verbose]
+ *                     [--preheat] [--no-outdoor]
+ *   Defaults: 3 days (7 with --preheat), tau 60 min, dead time 4 min, rise 25 °C at full power,
+ *   cabin 18 ± 3 °C, 500 W, PI parameters from Config.h. --trace writes one row per simulated minute.
+ *
+ * Build (Linux):
+ *   cd esp32-modules/module-3
+ *   g++ -std=gnu++17 -O2 -Itools/host -Iinclude -Isrc tools/host/floor_heating_sim.cpp \
+ *       src/FloorHeatingController.cpp src/HeatingPiController.cpp src/HeatingPreheat.cpp \
+ *       src/RelayScheduler.cpp -o /tmp/floor_heating_sim
+ */
+
+#include "FloorHeatingController.h"
+#include "FloorHeatingManager.h"
+#include "FloorHeatingSensor.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+static const unsigned long STEP_MS = 250;
+static const unsigned long DAY_MS = 86400000UL;
+
+struct FloorModel {
+  float tauMinutes = 60;
+  float deadMinutes = 4;
+  float rise = 25;       // °C above ambient with the heater on all the time
+  float ambient = 18;    // Cabin mean
+  float swing = 3;       // Cabin daily amplitude
+  float powerWatts = 500;
+};
+
+struct RunStats {
+  const char *name = "";
+  bool warm = false;
+  unsigned long warmUpMs = 0;
+  float maxTemp = -100;
+  double sumSquaredError = 0;
+  unsigned long samples = 0;
+  unsigned long relayOnMs = 0;       // After warm-up
+  unsigned long relayOnTotalMs = 0;  // Whole run
+  unsigned long cycles = 0;          // After warm-up
+  unsigned long aboveTurnOffMs = 0;
+  float meanDuty = 0;
+};
+
+struct TraceRow {
+  float ambient;
+  float floor;
+  float sensor;
+  bool relay;
+  float duty;
+};
+
+static float cabinTemperature(const FloorModel &model, unsigned long nowMs) {
+  return model.ambient + model.swing * sinf(2 * (float)M_PI * (float)(nowMs % DAY_MS) / DAY_MS);
+}
+
+// One heating circle: floor model behind the relay and the module's sensor path
+class CircleRig {
+ public:
+  CircleRig(const FloorModel &model)
+      : model(model), random(1), noise(0.0f, 0.03f),  // Same noise for every run
+        delayLine((size_t)(model.deadMinutes * 60000 / STEP_MS) + 1, 0) {
+    HostClock::nowMs = 0;
+    controller.setSensor(0, &sensor);
+    controller.setManager(&manager);
+    controller.begin();
+    floorTemp = cabinTemperature(model, 0);
+  }
+
+  FloorHeatingController controller;
+  float floorTemp;
+  float lastReading = NAN;
+
+  // Sensor side (FloorHeatingSensor + TemperaturePipeline averaging); OFF circles are not read
+  void read(unsigned long now) {
+    if (controller.getCircleMode(0) == CIRCLE_MODE_OFF) {
+      measuring = false;
+      return;
+    }
+    if (!measuring) {
+      measuring = true;  // Just turned on: first reading at once, new average
+      readingCount = 0;
+      readingIndex = 0;
+      lastRead = now - HEATING_TEMP_READ_INTERVAL;
+      lastAverage = now;
+    }
+
+    if (now - lastRead >= HEATING_TEMP_READ_INTERVAL && RelayScheduler::canStartConversion(now)) {
+      RelayScheduler::onConversionStarted(now);
+      lastRead = now;
+      float reading = roundf((floorTemp + noise(random)) * 16) / 16;  // 12-bit DS18B20
+      lastReading = reading;
+      readings[readingIndex] = reading;
+      readingIndex = (readingIndex + 1) % HEATING_TEMP_AVERAGE_COUNT;
+      if (readingCount < HEATING_TEMP_AVERAGE_COUNT) {
+        readingCount++;
+        if (readingCount == 1) {
+          sensor.setLastTemperature(reading, now);  // First reading before any average
+          controller.resetLastCheckTime(0);
+        }
+      }
+    }
+    if (readingCount > 0 && now - lastAverage >= HEATING_TEMP_AVERAGE_INTERVAL) {
+      lastAverage = now;
+      float sum = 0;
+      for (unsigned int i = 0; i < readingCount; i++) {
+        sum += readings[i];
+      }
+      sensor.setLastTemperature(sum / readingCount, lastRead);
+      controller.resetLastCheckTime(0);
+    }
+  }
+
+  // Floor side: relay state one dead time ago heats the floor
+  void heat(unsigned long now, bool relay) {
+    delayLine[delayIndex] = relay;
+    delayIndex = (delayIndex + 1) % delayLine.size();
+    bool heating = delayLine[delayIndex];  // Oldest entry
+    float ambient = cabinTemperature(model, now);
+    floorTemp += (ambient + model.rise * (heating ? 1.0f : 0.0f) - floorTemp) * (STEP_MS / 60000.0f) / model.tauMinutes;
+  }
+
+ private:
+  const FloorModel &model;
+  FloorHeatingSensor sensor;
+  FloorHeatingManager manager;
+  std::mt19937 random;
+  std::normal_distribution<float> noise;
+  std::vector<uint8_t> delayLine;
+  size_t delayIndex = 0;
+  bool measuring = false;
+  float readings[HEATING_TEMP_AVERAGE_COUNT];
+  unsigned int readingCount = 0;
+  unsigned int readingIndex = 0;
+  unsigned long lastRead = 0;
+  unsigned long lastAverage = 0;
+};
+
+static RunStats simulate(const char *name, const HeatingControlParams &params, const FloorModel &model, unsigned int days,
+                         std::vector<TraceRow> *trace) {
+  RunStats stats;
+  stats.name = name;
+
+  std::unique_ptr<CircleRig> rig(new CircleRig(model));
+  FloorHeatingController &controller = rig->controller;
+  controller.setControlParams(params);
+  controller.setCircleMode(0, CIRCLE_MODE_TEMP_CONTROL);
+
+  bool lastRelay = false;
+  double dutySum = 0;
+  unsigned long dutySamples = 0;
+
+  float setpoint = controller.getSetpoint();
+  unsigned long endMs = days * DAY_MS;
+
+  for (unsigned long now = 0; now < endMs; now += STEP_MS) {
+    HostClock::nowMs = now;
+    rig->read(now);
+    controller.loop();
+    bool relay = controller.getRelayOutput(0);
+    rig->heat(now, relay);
+    float floorTemp = rig->floorTemp;
+
+    // Statistics
+    if (relay) {
+      stats.relayOnTotalMs += STEP_MS;
+    }
+    if (!stats.warm && floorTemp >= setpoint) {
+      stats.warm = true;
+      stats.warmUpMs = now;
+    }
+    if (stats.warm) {
+      float error = floorTemp - setpoint;
+      stats.sumSquaredError += error * error;
+      stats.samples++;
+      if (floorTemp > stats.maxTemp) {
+        stats.maxTemp = floorTemp;
+      }
+      if (floorTemp > HEATING_TURN_OFF_TEMP) {
+        stats.aboveTurnOffMs += STEP_MS;
+      }
+      if (relay) {
+        stats.relayOnMs += STEP_MS;
+      }
+      if (relay && !lastRelay) {
+        stats.cycles++;
+      }
+      dutySum += controller.getCircleDuty(0);
+      dutySamples++;
+    }
+    lastRelay = relay;
+
+    if (trace != nullptr && now % 60000 == 0) {
+      trace->push_back({cabinTemperature(model, now), floorTemp, rig->lastReading, relay, controller.getCircleDuty(0)});
+    }
+  }
+
+  stats.meanDuty = dutySamples > 0 ? (float)(dutySum / dutySamples) : 0;
+  return stats;
+}
+
+static String clockTime(unsigned long ms) {
+  char text[8];
+  snprintf(text, sizeof(text), "%02lu:%02lu", (ms % DAY_MS) / 3600000UL, (ms % 3600000UL) / 60000UL);
+  return String(text);
+}
+
+// Circle used 07:00-22:00; preheated by the learned model from the second morning on
+static int simulatePreheat(const HeatingControlParams &params, const FloorModel &model, unsigned int days, bool outdoor) {
+  const unsigned long wakeMs = 7 * 3600000UL;
+  const unsigned long bedMs = 22 * 3600000UL;
+
+  std::unique_ptr<CircleRig> rig(new CircleRig(model));
+  FloorHeatingController &controller = rig->controller;
+  HeatingPreheat &preheat = controller.getPreheat();
+  controller.setControlParams(params);
+  float warmTemp = controller.getWarmTemperature();
+
+  printf("Floor: tau %.0f min, dead time %.1f min, +%.1f °C at full power, cabin %.1f ± %.1f °C, %u day(s), %s\n",
+         model.tauMinutes, model.deadMinutes, model.rise, model.ambient, model.swing, days,
+         outdoor ? "cabin as outdoor temperature" : "no outdoor temperature");
+  printf("True model: cool-down %.2f/h, warm-up %.1f °C/h; warm = %.1f °C by 07:00\n\n", 60.0f / model.tauMinutes,
+         model.rise * 60.0f / model.tauMinutes, warmTemp);
+  printf("%-3s  %5s  %5s  %6s  %15s  %15s\n", "day", "start", "warm", "early", "cool-down /h", "warm-up °C/h");
+
+  bool warmToday = false;
+  bool coolSinceBed = false;
+  unsigned long startMs = 0;
+  bool started = false;
+  int late = 0;
+  unsigned long endMs = days * DAY_MS;
+  for (unsigned long now = 0; now < endMs; now += STEP_MS) {
+    HostClock::nowMs = now;
+    unsigned long dayMs = now % DAY_MS;
+    unsigned int day = now / DAY_MS;
+
+    if (outdoor && now % 60000 == 0) {
+      preheat.setOutdoorTemperature(cabinTemperature(model, now), now);
+    }
+    if (day == 0 && dayMs == wakeMs) {
+      controller.setCircleMode(0, CIRCLE_MODE_TEMP_CONTROL);  // First morning: by hand, cold floor
+    }
+    if (dayMs == bedMs) {
+      controller.setCircleMode(0, CIRCLE_MODE_OFF);
+      preheat.schedule(0, DAY_MS - bedMs + wakeMs, now);
+      warmToday = false;
+      started = false;
+    }
+
+    CircleMode before = controller.getCircleMode(0);
+    rig->read(now);
+    controller.loop();
+    if (before == CIRCLE_MODE_OFF && controller.getCircleMode(0) == CIRCLE_MODE_TEMP_CONTROL) {
+      started = true;
+      startMs = now;
+    }
+    rig->heat(now, controller.getRelayOutput(0));
+
+    // Morning: the floor has cooled below warm since bed time and reaches it again
+    if (day > 0 && !warmToday && !coolSinceBed && rig->floorTemp < warmTemp - 1.0f) {
+      coolSinceBed = true;
+    }
+    if (coolSinceBed && rig->floorTemp >= warmTemp) {
+      warmToday = true;
+      coolSinceBed = false;
+      long earlyMin = ((long)wakeMs - (long)dayMs) / 60000L;
+      if (earlyMin < 0) {
+        late++;
+      }
+      const HeatingCircleModel &learned = preheat.getModel(0);
+      printf("%-3u  %5s  %5s  %+6ld  %7.2f (%4u)  %7.1f (%4u)\n", day, started ? clockTime(startMs).c_str() : "-",
+             clockTime(dayMs).c_str(), earlyMin, learned.lossPerHour, learned.lossSamples, learned.gainPerHour,
+             learned.gainSamples);
+    }
+  }
+  printf("\nLate mornings: %d of %u\n", late, days - 1);
+  return 0;
+}
+static void printStats(const RunStats &stats, const FloorModel &model, float setpoint, unsigned int days) {
+  if (!stats.warm) {
+    printf("%-11s  never reached the setpoint (%.1f °C) - check --rise and --ambient\n", stats.name, setpoint);
+    return;
+  }
+  float warmDays = (days * DAY_MS - stats.warmUpMs) / (float)DAY_MS;
+  float rms = sqrtf((float)(stats.sumSquaredError / stats.samples));
+  float cyclesPerDay = stats.cycles / warmDays;
+  float dutyPct = 100.0f * stats.relayOnMs / (warmDays * DAY_MS);
+  float kwhPerDay = model.powerWatts * (stats.relayOnMs / 3600000.0f) / 1000.0f / warmDays;
+  printf("%-11s  %6.1f  %+9.2f  %+9.2f  %6.2f  %8.1f  %7.1f  %6.1f  %7.2f\n", stats.name, stats.warmUpMs / 60000.0f,
+         stats.maxTemp - setpoint, stats.maxTemp - HEATING_TURN_OFF_TEMP, rms, 100.0f * stats.aboveTurnOffMs / (warmDays * DAY_MS),
+         cyclesPerDay, dutyPct, kwhPerDay);
+}
+
+static bool parseArgs(int argc, char **argv, FloorModel &model, HeatingControlParams &pi, unsigned int &days,
+                      const char *&tracePath, bool &verbose, bool &preheat, bool &outdoor) {
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    if (strcmp(arg, "--verbose") == 0) {
+      verbose = true;
+      continue;
+    }
+    if (strcmp(arg, "--preheat") == 0) {
+      preheat = true;
+      continue;
+    }
+    if (strcmp(arg, "--no-outdoor") == 0) {
+      outdoor = false;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      fprintf(stderr, "Missing value for %s\n", arg);
+      return false;
+    }
+    const char *value = argv[++i];
+    float number = strtof(value, nullptr);
+    if (strcmp(arg, "--days") == 0) days = (unsigned int)number;
+    else if (strcmp(arg, "--tau") == 0) model.tauMinutes = number;
+    else if (strcmp(arg, "--dead") == 0) model.deadMinutes = number;
+    else if (strcmp(arg, "--rise") == 0) model.rise = number;
+    else if (strcmp(arg, "--ambient") == 0) model.ambient = number;
+    else if (strcmp(arg, "--swing") == 0) model.swing = number;
+    else if (strcmp(arg, "--power") == 0) model.powerWatts = number;
+    else if (strcmp(arg, "--kp") == 0) pi.kp = number;
+    else if (strcmp(arg, "--ti") == 0) pi.tiSeconds = number;
+    else if (strcmp(arg, "--cycle") == 0) pi.cycleMs = (unsigned long)(number * 1000);
+    else if (strcmp(arg, "--min-on") == 0) pi.minOnMs = (unsigned long)(number * 1000);
+    else if (strcmp(arg, "--min-off") == 0) pi.minOffMs = (unsigned long)(number * 1000);
+    else if (strcmp(arg, "--trace") == 0) tracePath = value;
+    else {
+      fprintf(stderr, "Unknown option %s\n", arg);
+      return false;
+    }
+  }
+  if (days == 0) {
+    days = preheat ? 7 : 3;
+  }
+  if (model.tauMinutes <= 0 || model.deadMinutes < 0) {
+    fprintf(stderr, "--tau must be positive, --dead not negative\n");
+    return false;
+  }
+  return true;
+}
+
+int main(int argc, char **argv) {
+  FloorModel model;
+  unsigned int days = 0;  // Default depends on the scenario
+  const char *tracePath = nullptr;
+  bool verbose = false;
+  bool preheat = false;
+  bool outdoor = true;
+
+  HeatingControlParams pi;
+  pi.algorithm = HEATING_ALGORITHM_PI;
+  pi.kp = HEATING_PI_KP;
+  pi.tiSeconds = HEATING_PI_TI;
+  pi.cycleMs = HEATING_PI_CYCLE_MS;
+  pi.minOnMs = HEATING_PI_MIN_ON_MS;
+  pi.minOffMs = HEATING_PI_MIN_OFF_MS;
+
+  if (!parseArgs(argc, argv, model, pi, days, tracePath, verbose, preheat, outdoor)) {
+    return 1;
+  }
+  Serial.setEnabled(verbose);
+  if (preheat) {
+    return simulatePreheat(pi, model, days, outdoor);
+  }
+
+  HeatingControlParams hysteresis = pi;
+  hysteresis.algorithm = HEATING_ALGORITHM_HYSTERESIS;
+
+  std::vector<TraceRow> hysteresisTrace;
+  std::vector<TraceRow> piTrace;
+  bool wantTrace = tracePath != nullptr;
+  RunStats hysteresisStats = simulate("hysteresis", hysteresis, model, days, wantTrace ? &hysteresisTrace : nullptr);
+  RunStats piStats = simulate("pi", pi, model, days, wantTrace ? &piTrace : nullptr);
+
+  float setpoint = (HEATING_TURN_ON_TEMP + HEATING_TURN_OFF_TEMP) / 2;
+  printf("Floor: tau %.0f min, dead time %.1f min, +%.1f °C at full power, cabin %.1f ± %.1f °C, %.0f W, %u day(s)\n",
+         model.tauMinutes, model.deadMinutes, model.rise, model.ambient, model.swing, model.powerWatts, days);
+  printf("Hysteresis %.1f-%.1f °C; PI setpoint %.2f °C, Kp %.2f, Ti %.0f s, cycle %lu s, min on/off %lu/%lu s\n\n",
+         (float)HEATING_TURN_ON_TEMP, (float)HEATING_TURN_OFF_TEMP, setpoint, pi.kp, pi.tiSeconds, pi.cycleMs / 1000,
+         pi.minOnMs / 1000, pi.minOffMs / 1000);
+  printf("%-11s  %6s  %9s  %9s  %6s  %8s  %7s  %6s  %7s\n", "control", "warm", "peak-set", "peak-off", "rms", ">off %",
+         "cyc/day", "duty %", "kWh/day");
+  printf("%-11s  %6s  %9s  %9s  %6s  %8s  %7s  %6s  %7s\n", "", "min", "°C", "°C", "°C", "", "", "", "");
+  printStats(hysteresisStats, model, setpoint, days);
+  printStats(piStats, model, setpoint, days);
+
+  if (wantTrace) {
+    FILE *out = fopen(tracePath, "w");
+    if (out == nullptr) {
+      perror(tracePath);
+      return 1;
+    }
+    fprintf(out, "minute,cabin,hyst_floor,hyst_sensor,hyst_relay,pi_floor,pi_sensor,pi_relay,pi_duty\n");
+    for (size_t i = 0; i < hysteresisTrace.size() && i < piTrace.size(); i++) {
+      const TraceRow &h = hysteresisTrace[i];
+      const TraceRow &p = piTrace[i];
+      fprintf(out, "%zu,%.2f,%.3f,%.3f,%d,%.3f,%.3f,%d,%.3f\n", i, h.ambient, h.floor, h.sensor, h.relay ? 1 : 0, p.floor,
+              p.sensor, p.relay ? 1 : 0, p.duty);
+    }
+    fclose(out);
+  }
+  return 0;
+}
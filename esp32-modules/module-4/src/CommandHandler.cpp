@@ -2,6 +2,7 @@
 // Handle commands from Backend
 
 #include "CommandHandler.h"
+#include "LogStreamer.h"
 #include "SensorManager.h"
 #include <Arduino.h>
 
@@ -98,6 +99,11 @@ void CommandHandler::handleMQTTMessage(char* topic, byte* payload, unsigned int
     // Call force update function
     forceUpdate();
   }
+  
+  // Runtime log stream level (e.g. {"level":"debug"})
+  if (topicStr.endsWith("/logs/level")) {
+    LogStreamer::handleLevelCommand(message);
+  }
 }
 
 void CommandHandler::forceUpdate() {
@@ -60,6 +60,25 @@
 #define DEBUG_MQTT true     // Enable MQTT debug output
 #define DEBUG_VERBOSE false // Enable verbose debug output (set to true for detailed logging)
 
+// Logging (see Logger.h) - levels above LOG_LEVEL are compiled out
+// 0=NONE, 1=ERROR, 2=WARN, 3=INFO, 4=DEBUG, 5=VERBOSE
+#define LOG_LEVEL LOG_LEVEL_INFO
+#define LOG_QUEUE_DEPTH 32  // Ring buffer line slots (power of two)
+#define LOG_LINE_MAX 128    // Max characters per log line
+#define LOG_STREAM_LEVEL LOG_LEVEL_WARN  // Initial level mirrored to smartcamper/logs/{module} (runtime: logs/level command)
+#define LOG_STREAM_INTERVAL_MS 1000       // Min time between log batch publishes
+#define LOG_STREAM_BATCH_BYTES 768        // Max payload bytes per log batch
+#define LOG_STREAM_BUFFER_SIZE 2048       // Log bytes buffered while waiting to publish
+
+// Command tracking (see CommandTracker.h) - optional "id" in command payloads
+#define COMMAND_ACK_TIMEOUT_MS 2000  // Ack without publish time if no status publish follows
+#define COMMAND_DEDUP_SIZE 16        // Recent command ids remembered for duplicate detection
+
+// Clock sync with the backend (see ClockSync.h) - adds "ts" (epoch ms) to JSON payloads
+#define CLOCK_SYNC_INTERVAL_MS 60000  // Time between sync bursts
+#define CLOCK_SYNC_SAMPLES 4          // Requests per burst (lowest round trip is used)
+#define CLOCK_SYNC_MAX_RTT_MS 250     // Discard samples with a slower round trip
+
 // Watchdog settings (optional - for production stability)
 // #define ENABLE_WATCHDOG true
 // #define WATCHDOG_TIMEOUT 30  // seconds
@@ -4,6 +4,7 @@
 #include "DamperController.h"
 #include "DamperManager.h"
 #include "MQTTManager.h"
+#include "ClockSync.h"
 #include <ArduinoJson.h>
 #include <Arduino.h>
 
@@ -139,6 +140,7 @@ void DamperController::publishStatus() {
   // Create JSON payload
   StaticJsonDocument<128> doc;
   doc["angle"] = currentAngle;
+  ClockSync::addTimestamp(doc);  // Epoch ms once synced
   
   String payload;
   serializeJson(doc, payload);
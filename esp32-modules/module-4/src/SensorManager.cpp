@@ -102,12 +102,20 @@ void SensorManager::processMQTTMessage(char* topic, byte* payload, unsigned int
   // Check if it's a force_update command (handled by CommandHandler)
   if (topicStr.endsWith("/force_update")) {
     commandHandler.handleMQTTMessage(topic, payload, length);
+    // Forced damper angles go out from loop() - their publish closes the round trip
+    moduleManager->getMQTTManager().expectStatus(MQTT_TOPIC_SENSORS + String("module-4/damper/"));
     return;
   }
   
   // Check if it's a damper command
   // Topic format: smartcamper/commands/module-4/damper/{index}/set_angle
   if (topicStr.indexOf("/damper/") >= 0) {
+    // Status: this damper's angle topic (sensors/module-4/damper/{index}/)
+    int indexStart = topicStr.indexOf("/damper/") + 8;
+    int indexEnd = topicStr.indexOf('/', indexStart);
+    String damperIndex = indexEnd > 0 ? topicStr.substring(indexStart, indexEnd) : topicStr.substring(indexStart);
+    moduleManager->getMQTTManager().expectStatus(MQTT_TOPIC_SENSORS + String("module-4/damper/") + damperIndex + "/");
+    
     // Forward to damper manager
     damperManager.handleMQTTCommand(message);
     return;
@@ -116,6 +124,8 @@ void SensorManager::processMQTTMessage(char* topic, byte* payload, unsigned int
   // Check if it's a table command
   // Topic format: smartcamper/commands/module-4/table/{action}
   if (topicStr.indexOf("/table") >= 0) {
+    moduleManager->getMQTTManager().expectStatus(MQTT_TOPIC_SENSORS + String("module-4/table/"));
+    
     // Forward to table manager
     tableManager.handleMQTTCommand(message);
     return;
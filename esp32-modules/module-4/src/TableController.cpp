@@ -3,6 +3,7 @@
 
 #include "TableController.h"
 #include "MQTTManager.h"
+#include "ClockSync.h"
 #include <ArduinoJson.h>
 #include <Arduino.h>
 
@@ -337,6 +338,7 @@ void TableController::publishStatus() {
   StaticJsonDocument<128> doc;
   doc["direction"] = direction;
   doc["autoMoving"] = autoMoving;  // Indicate if this is auto movement
+  ClockSync::addTimestamp(doc);  // Epoch ms once synced
   
   String payload;
   serializeJson(doc, payload);
@@ -0,0 +1,124 @@
+// Command Tracker
+// Correlates MQTT commands with the status publish they cause
+// - Optional "id" field in any command payload is echoed on smartcamper/acks/{module}
+//   with timestamps (micros since boot) at receive, execute and status publish
+// - The status publish is the first one the command caused: a sensors/ publish made
+//   while it executes, or one on the topic its handler declared with expectStatus()
+//   (for status published later from loop()). Other publishes do not count.
+// - Repeated ids are not executed again (idempotent retries) - only re-acknowledged
+// - Keeps a latency histogram per command type (topic with numeric segments as "*"),
+//   published on demand via commands/{module}/metrics/commands
+// Hooked into MQTTManager (message dispatch + sensor publishes), owned by ModuleManager.
+
+#ifndef COMMAND_TRACKER_H
+#define COMMAND_TRACKER_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+// Forward declaration
+class MQTTManager;
+
+// MQTT topic prefixes
+#define COMMAND_ACK_TOPIC_PREFIX "smartcamper/acks/"
+#define COMMAND_METRICS_TOPIC_PREFIX "smartcamper/metrics/"
+
+// Defaults if a module's Config.h does not set them
+#ifndef COMMAND_ACK_TIMEOUT_MS
+#define COMMAND_ACK_TIMEOUT_MS 2000  // Ack without publish timestamp if no status publish follows
+#endif
+#ifndef COMMAND_DEDUP_SIZE
+#define COMMAND_DEDUP_SIZE 16        // Number of recent command ids remembered
+#endif
+#ifndef COMMAND_TYPE_COUNT
+#define COMMAND_TYPE_COUNT 8         // Command types with their own histogram (rest go to "other")
+#endif
+
+#define COMMAND_PENDING_MAX 4        // Commands waiting for their status publish
+#define COMMAND_ID_MAX 24            // Max id length (longer ids are truncated)
+#define COMMAND_TYPE_MAX 32          // Max command type length
+#define COMMAND_STATUS_TOPIC_MAX 48  // Max expected status topic (prefix) length
+#define COMMAND_UNTRACKED_MAX 4      // Acks queued for commands that found no free pending slot
+#define LATENCY_BUCKET_COUNT 14      // <256us, <512us, ... <1s, >=1s (powers of two)
+
+class CommandTracker {
+private:
+  struct PendingCommand {
+    bool active;
+    bool hasId;
+    bool duplicate;         // Ack only - command was not executed again
+    bool executed;
+    char id[COMMAND_ID_MAX + 1];
+    uint8_t typeIndex;
+    uint32_t recvMicros;
+    uint32_t execMicros;
+    uint32_t pubMicros;
+    bool published;
+    char statusTopic[COMMAND_STATUS_TOPIC_MAX + 1];  // Expected status topic prefix ("" = none declared)
+  };
+
+  // Command with an id but no free pending slot - acked without timestamps but recvUs
+  struct UntrackedAck {
+    char id[COMMAND_ID_MAX + 1];
+    uint8_t typeIndex;
+    bool duplicate;
+    uint32_t recvMicros;
+  };
+
+  struct LatencyHistogram {
+    char type[COMMAND_TYPE_MAX + 1];
+    uint32_t count;
+    uint32_t timeouts;      // Completed without a status publish
+    uint32_t duplicates;
+    uint32_t untracked;     // No free pending slot - not measured
+    uint32_t maxMicros;
+    uint32_t buckets[LATENCY_BUCKET_COUNT];
+  };
+
+  MQTTManager* mqttManager;  // Reference to MQTT manager (not owned)
+  String moduleId;
+
+  PendingCommand pending[COMMAND_PENDING_MAX];
+  UntrackedAck untrackedAcks[COMMAND_UNTRACKED_MAX];
+  uint8_t untrackedCount;
+  LatencyHistogram histograms[COMMAND_TYPE_COUNT + 1];  // Last slot = "other"
+  uint8_t typeCount;
+
+  uint32_t recentIds[COMMAND_DEDUP_SIZE];  // FNV-1a hashes of recent ids
+  uint8_t recentIdCount;
+  uint8_t recentIdNext;
+
+  PendingCommand* current;   // Command being executed (inside the MQTT callback)
+  bool metricsRequested;
+
+  static uint32_t hashId(const char* id);
+  bool isRecentId(uint32_t hash) const;
+  void rememberId(uint32_t hash);
+  uint8_t findOrAddType(const String& type);
+  static String normalizeType(const String& topic, const String& moduleId);
+  static uint8_t bucketFor(uint32_t micros);
+
+  void complete(PendingCommand& cmd);
+  void publishAck(const PendingCommand& cmd);
+  void publishUntrackedAck(const UntrackedAck& ack);
+  void publishMetrics();
+
+public:
+  CommandTracker(MQTTManager* mqtt, String moduleId);
+
+  void begin();
+  void loop();  // Sends acks for finished/timed-out commands and requested metrics
+
+  // MQTTManager hooks
+  bool onCommandReceived(const char* topic, const byte* payload, unsigned int length);  // false = don't execute
+  void onCommandExecuted();
+  void onStatusPublished(const String& topic);
+
+  // Called by a command handler whose status is published later (from loop()):
+  // the next publish on a topic starting with this closes the command's round trip
+  void expectStatus(const String& topic);
+
+  void printStatus() const;
+};
+
+#endif
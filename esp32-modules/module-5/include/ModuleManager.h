@@ -1,6 +1,6 @@
 // Module Manager
 // Common infrastructure manager for all ESP32 modules
-// Handles: Network, MQTT, Heartbeat, Commands
+// Handles: Network, MQTT, Heartbeat, Log streaming, Commands (incl. ack/latency tracking), Clock sync
 // This class is shared across all modules
 
 #ifndef MODULE_MANAGER_H
@@ -10,6 +10,9 @@
 #include "NetworkManager.h"
 #include "MQTTManager.h"
 #include "HeartbeatManager.h"
+#include "LogStreamer.h"
+#include "CommandTracker.h"
+#include "ClockSync.h"
 
 // Forward declaration
 class CommandHandler;
@@ -19,6 +22,9 @@ private:
   NetworkManager networkManager;
   MQTTManager mqttManager;
   HeartbeatManager heartbeatManager;
+  LogStreamer logStreamer;
+  CommandTracker commandTracker;
+  ClockSync clockSync;
   CommandHandler* commandHandler;  // Pointer - will be set by specific module logic
   
   bool initialized;
@@ -38,6 +44,9 @@ public:
   NetworkManager& getNetworkManager() { return networkManager; }
   MQTTManager& getMQTTManager() { return mqttManager; }
   HeartbeatManager& getHeartbeatManager() { return heartbeatManager; }
+  LogStreamer& getLogStreamer() { return logStreamer; }
+  CommandTracker& getCommandTracker() { return commandTracker; }
+  ClockSync& getClockSync() { return clockSync; }
   
   // Status
   bool isConnected();  // Returns true if both WiFi and MQTT are connected (cannot be const - MQTTManager methods are not const)
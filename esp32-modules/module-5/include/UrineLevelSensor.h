@@ -6,30 +6,25 @@
 
 #include "Config.h"
 #include "MQTTManager.h"
+#include "ElectrodeLevelSensor.h"
+#include "RollingMode.h"
 
 class UrineLevelSensor {
 private:
   MQTTManager* mqttManager;
 
-  int levelPins[NUM_URINE_LEVEL_PINS];
-  int levelPercentages[NUM_URINE_LEVEL_PINS];
+  ElectrodeLevelSensor<NUM_URINE_LEVEL_PINS> electrodes;
 
   unsigned long lastSensorRead;
   unsigned long lastDataSent;
 
-  int levelIndices[URINE_LEVEL_MODE_SAMPLE_COUNT];
-  int measurementIndex;
-  int measurementCount;
+  RollingMode<URINE_LEVEL_MODE_SAMPLE_COUNT, NUM_URINE_LEVEL_PINS> levelMode;
 
   float lastPublishedLevel;
   bool forceUpdateRequested;
   bool lastMQTTState;
 
-  int readWaterLevel();
-  float levelToPercent(int level);
-  void setupPins();
-  void setPinsLow();
-  int findMode(int* values, int count);
+  void processLevel(int level, unsigned long currentTime, bool isForceUpdate);
   void publishIfNeeded(float modePercent, unsigned long currentTime, bool forcePublish = false);
 
 public:
@@ -4,6 +4,7 @@
 #include "ApplianceManager.h"
 #include "Config.h"
 #include "MQTTManager.h"
+#include "ClockSync.h"
 #include <ArduinoJson.h>
 
 // Static pointer to current instance
@@ -81,14 +82,19 @@ void ApplianceManager::handleMQTTMessageStatic(char* topic, byte* payload, unsig
 
 // Process MQTT message (instance method)
 void ApplianceManager::processMQTTMessage(char* topic, byte* payload, unsigned int length) {
-  // First try force_update command (handled by CommandHandler)
+  // First try infrastructure commands: force_update, logs/level (handled by CommandHandler)
   String topicStr = String(topic);
-  if (topicStr.endsWith("/force_update")) {
+  String statusTopic = String(MQTT_TOPIC_SENSORS) + MODULE_ID + "/status";
+  if (topicStr.endsWith("/force_update") || topicStr.endsWith("/logs/level")) {
     commandHandler.handleMQTTMessage(topic, payload, length);
+    if (topicStr.endsWith("/force_update")) {
+      moduleManager->getMQTTManager().expectStatus(statusTopic);
+    }
     return;
   }
   
-  // Handle appliance-specific commands
+  // Handle appliance-specific commands (their status publish closes the round trip)
+  moduleManager->getMQTTManager().expectStatus(statusTopic);
   processApplianceCommand(topic, payload, length);
 }
 
@@ -181,6 +187,9 @@ void ApplianceManager::publishFullStatus() {
     relay["state"] = relayController.getRelayState(i) ? "ON" : "OFF";
   }
   
+  // Wall-clock time (epoch ms) once synced
+  ClockSync::addTimestamp(doc);
+  
   // Serialize JSON
   String jsonString;
   serializeJson(doc, jsonString);
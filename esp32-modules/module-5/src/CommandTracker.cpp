@@ -0,0 +1,340 @@
+// Command Tracker Implementation
+// Command ids, acks, dedup and per-type latency histograms
+
+#include "CommandTracker.h"
+#include "MQTTManager.h"
+#include "ClockSync.h"
+#include "Logger.h"
+#include <ArduinoJson.h>
+
+CommandTracker::CommandTracker(MQTTManager* mqtt, String moduleId) {
+  this->mqttManager = mqtt;
+  this->moduleId = moduleId;
+  this->typeCount = 0;
+  this->recentIdCount = 0;
+  this->recentIdNext = 0;
+  this->current = nullptr;
+  this->metricsRequested = false;
+  this->untrackedCount = 0;
+
+  memset(pending, 0, sizeof(pending));
+  memset(histograms, 0, sizeof(histograms));
+  strncpy(histograms[COMMAND_TYPE_COUNT].type, "other", COMMAND_TYPE_MAX);
+}
+
+void CommandTracker::begin() {
+  LOG_INFO("🧾 Command tracker: acks on %s%s", COMMAND_ACK_TOPIC_PREFIX, moduleId.c_str());
+}
+
+void CommandTracker::loop() {
+  uint32_t now = micros();
+
+  for (int i = 0; i < COMMAND_PENDING_MAX; i++) {
+    PendingCommand& cmd = pending[i];
+    if (!cmd.active || &cmd == current) {
+      continue;
+    }
+
+    bool timedOut = (now - cmd.recvMicros) >= (uint32_t)COMMAND_ACK_TIMEOUT_MS * 1000UL;
+    if (cmd.duplicate || (cmd.executed && (cmd.published || timedOut))) {
+      complete(cmd);
+    }
+  }
+
+  for (int i = 0; i < untrackedCount; i++) {
+    publishUntrackedAck(untrackedAcks[i]);
+  }
+  untrackedCount = 0;
+
+  if (metricsRequested) {
+    metricsRequested = false;
+    publishMetrics();
+  }
+}
+
+bool CommandTracker::onCommandReceived(const char* topic, const byte* payload, unsigned int length) {
+  uint32_t recvMicros = micros();
+  String topicStr = String(topic);
+
+  // Metrics request is handled here, not by the module
+  if (topicStr.endsWith("/metrics/commands")) {
+    metricsRequested = true;  // Published from loop(), not inside the MQTT callback
+    return false;
+  }
+
+  // Extract optional "id" (filter keeps the document small for large payloads)
+  char id[COMMAND_ID_MAX + 1] = "";
+  StaticJsonDocument<16> filter;
+  filter["id"] = true;
+  StaticJsonDocument<96> doc;
+  if (deserializeJson(doc, payload, length, DeserializationOption::Filter(filter)) == DeserializationError::Ok) {
+    JsonVariant idValue = doc["id"];
+    if (idValue.is<const char*>()) {
+      strncpy(id, idValue.as<const char*>(), COMMAND_ID_MAX);
+      id[COMMAND_ID_MAX] = '\0';
+    } else if (idValue.is<long>()) {
+      snprintf(id, sizeof(id), "%ld", idValue.as<long>());
+    }
+  }
+  bool hasId = id[0] != '\0';
+
+  uint8_t typeIndex = findOrAddType(normalizeType(topicStr, moduleId));
+
+  // Find a free slot (if all are busy the command still runs, just untracked)
+  PendingCommand* slot = nullptr;
+  for (int i = 0; i < COMMAND_PENDING_MAX; i++) {
+    if (!pending[i].active) {
+      slot = &pending[i];
+      break;
+    }
+  }
+
+  bool duplicate = false;
+  if (hasId) {
+    uint32_t hash = hashId(id);
+    if (isRecentId(hash)) {
+      duplicate = true;
+      histograms[typeIndex].duplicates++;
+      LOG_INFO("🧾 Duplicate command id %s - not executed again", id);
+    } else {
+      rememberId(hash);
+    }
+  }
+
+  if (slot != nullptr) {
+    memset(slot, 0, sizeof(PendingCommand));
+    slot->active = true;
+    slot->hasId = hasId;
+    slot->duplicate = duplicate;
+    slot->executed = duplicate;
+    strncpy(slot->id, id, COMMAND_ID_MAX);
+    slot->typeIndex = typeIndex;
+    slot->recvMicros = recvMicros;
+  } else if (hasId) {
+    // All pending slots busy: still ack (from loop()), just without latency tracking
+    if (!duplicate) {
+      histograms[typeIndex].untracked++;
+    }
+    if (untrackedCount < COMMAND_UNTRACKED_MAX) {
+      UntrackedAck& ack = untrackedAcks[untrackedCount++];
+      strncpy(ack.id, id, COMMAND_ID_MAX);
+      ack.id[COMMAND_ID_MAX] = '\0';
+      ack.typeIndex = typeIndex;
+      ack.duplicate = duplicate;
+      ack.recvMicros = recvMicros;
+    } else {
+      LOG_WARN("🧾 Command id %s not acknowledged - ack queue full", id);
+    }
+  }
+
+  current = duplicate ? nullptr : slot;
+  return !duplicate;
+}
+
+void CommandTracker::onCommandExecuted() {
+  if (current != nullptr) {
+    current->execMicros = micros();
+    current->executed = true;
+    current = nullptr;
+  }
+}
+
+void CommandTracker::expectStatus(const String& topic) {
+  if (current != nullptr) {
+    strncpy(current->statusTopic, topic.c_str(), COMMAND_STATUS_TOPIC_MAX);
+    current->statusTopic[COMMAND_STATUS_TOPIC_MAX] = '\0';
+  }
+}
+
+void CommandTracker::onStatusPublished(const String& topic) {
+  // First status publish the command caused closes its round trip: any sensors/
+  // publish while it executes, later only the topic its handler expects
+  uint32_t now = micros();
+  for (int i = 0; i < COMMAND_PENDING_MAX; i++) {
+    PendingCommand& cmd = pending[i];
+    if (!cmd.active || cmd.duplicate || cmd.published) {
+      continue;
+    }
+    bool caused = (&cmd == current) ? topic.startsWith(MQTT_TOPIC_SENSORS)
+                                    : (cmd.statusTopic[0] != '\0' && topic.startsWith(cmd.statusTopic));
+    if (caused) {
+      cmd.pubMicros = now;
+      cmd.published = true;
+    }
+  }
+}
+
+void CommandTracker::complete(PendingCommand& cmd) {
+  if (!cmd.duplicate) {
+    LatencyHistogram& hist = histograms[cmd.typeIndex];
+    uint32_t latency = cmd.published ? (cmd.pubMicros - cmd.recvMicros) : (cmd.execMicros - cmd.recvMicros);
+    hist.count++;
+    hist.buckets[bucketFor(latency)]++;
+    if (latency > hist.maxMicros) {
+      hist.maxMicros = latency;
+    }
+    if (!cmd.published) {
+      hist.timeouts++;
+    }
+  }
+
+  if (cmd.hasId) {
+    publishAck(cmd);
+  }
+  cmd.active = false;
+}
+
+void CommandTracker::publishAck(const PendingCommand& cmd) {
+  StaticJsonDocument<256> doc;
+  doc["id"] = cmd.id;
+  doc["command"] = histograms[cmd.typeIndex].type;
+  doc["status"] = cmd.duplicate ? "duplicate" : "ok";
+  doc["recvUs"] = cmd.recvMicros;
+  if (!cmd.duplicate) {
+    doc["execUs"] = cmd.execMicros;
+    if (cmd.published) {
+      doc["pubUs"] = cmd.pubMicros;
+    } else {
+      doc["pubUs"] = nullptr;  // No status publish within COMMAND_ACK_TIMEOUT_MS
+    }
+  }
+  ClockSync::addTimestamp(doc);  // Epoch ms at ack time once synced
+
+  String payload;
+  serializeJson(doc, payload);
+  mqttManager->publishRaw(String(COMMAND_ACK_TOPIC_PREFIX) + moduleId, payload);
+}
+
+void CommandTracker::publishUntrackedAck(const UntrackedAck& ack) {
+  StaticJsonDocument<192> doc;
+  doc["id"] = ack.id;
+  doc["command"] = histograms[ack.typeIndex].type;
+  doc["status"] = ack.duplicate ? "duplicate" : "untracked";  // Executed, latency not measured
+  doc["recvUs"] = ack.recvMicros;
+  ClockSync::addTimestamp(doc);
+
+  String payload;
+  serializeJson(doc, payload);
+  mqttManager->publishRaw(String(COMMAND_ACK_TOPIC_PREFIX) + moduleId, payload);
+}
+
+void CommandTracker::publishMetrics() {
+  // One message per command type keeps each payload well under the MQTT buffer
+  String topic = String(COMMAND_METRICS_TOPIC_PREFIX) + moduleId + "/commands";
+  for (int t = 0; t <= COMMAND_TYPE_COUNT; t++) {
+    const LatencyHistogram& hist = histograms[t];
+    if (hist.count == 0 && hist.duplicates == 0 && hist.untracked == 0) {
+      continue;
+    }
+
+    StaticJsonDocument<512> doc;
+    doc["command"] = hist.type;
+    doc["count"] = hist.count;
+    doc["timeouts"] = hist.timeouts;
+    doc["duplicates"] = hist.duplicates;
+    doc["untracked"] = hist.untracked;
+    doc["maxUs"] = hist.maxMicros;
+    doc["bucketBaseUs"] = 256;  // hist[i] = latencies below 256us << i, last = the rest
+    JsonArray buckets = doc.createNestedArray("hist");
+    for (int b = 0; b < LATENCY_BUCKET_COUNT; b++) {
+      buckets.add(hist.buckets[b]);
+    }
+
+    String payload;
+    serializeJson(doc, payload);
+    mqttManager->publishRaw(topic, payload);
+  }
+}
+
+uint32_t CommandTracker::hashId(const char* id) {
+  // FNV-1a
+  uint32_t hash = 2166136261UL;
+  while (*id) {
+    hash ^= (uint8_t)*id++;
+    hash *= 16777619UL;
+  }
+  return hash;
+}
+
+bool CommandTracker::isRecentId(uint32_t hash) const {
+  for (int i = 0; i < recentIdCount; i++) {
+    if (recentIds[i] == hash) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void CommandTracker::rememberId(uint32_t hash) {
+  recentIds[recentIdNext] = hash;
+  recentIdNext = (recentIdNext + 1) % COMMAND_DEDUP_SIZE;
+  if (recentIdCount < COMMAND_DEDUP_SIZE) {
+    recentIdCount++;
+  }
+}
+
+uint8_t CommandTracker::findOrAddType(const String& type) {
+  for (int i = 0; i < typeCount; i++) {
+    if (type == histograms[i].type) {
+      return i;
+    }
+  }
+  if (typeCount >= COMMAND_TYPE_COUNT) {
+    return COMMAND_TYPE_COUNT;  // "other"
+  }
+  strncpy(histograms[typeCount].type, type.c_str(), COMMAND_TYPE_MAX);
+  histograms[typeCount].type[COMMAND_TYPE_MAX] = '\0';
+  return typeCount++;
+}
+
+String CommandTracker::normalizeType(const String& topic, const String& moduleId) {
+  // smartcamper/commands/module-2/strip/1/brightness -> strip/*/brightness
+  String prefix = String(MQTT_TOPIC_COMMANDS) + moduleId + "/";
+  String rest = topic.startsWith(prefix) ? topic.substring(prefix.length()) : topic;
+
+  String type = "";
+  int start = 0;
+  while (start <= (int)rest.length()) {
+    int slash = rest.indexOf('/', start);
+    String segment = slash >= 0 ? rest.substring(start, slash) : rest.substring(start);
+
+    bool numeric = segment.length() > 0;
+    for (unsigned int i = 0; i < segment.length(); i++) {
+      if (!isDigit(segment[i])) {
+        numeric = false;
+        break;
+      }
+    }
+    type += numeric ? String("*") : segment;
+
+    if (slash < 0) {
+      break;
+    }
+    type += "/";
+    start = slash + 1;
+  }
+  return type;
+}
+
+uint8_t CommandTracker::bucketFor(uint32_t micros) {
+  if (micros < 256) {
+    return 0;
+  }
+  uint8_t log2 = 31 - __builtin_clz(micros);  // >= 8
+  uint8_t bucket = log2 - 7;
+  return bucket < LATENCY_BUCKET_COUNT ? bucket : LATENCY_BUCKET_COUNT - 1;
+}
+
+void CommandTracker::printStatus() const {
+  if (DEBUG_SERIAL) {
+    Serial.println("🧾 Command Tracker Status:");
+    for (int t = 0; t <= COMMAND_TYPE_COUNT; t++) {
+      const LatencyHistogram& hist = histograms[t];
+      if (hist.count == 0) {
+        continue;
+      }
+      Serial.println("  " + String(hist.type) + ": " + String(hist.count) + " cmds, max " +
+                     String(hist.maxMicros) + "us, " + String(hist.timeouts) + " without publish");
+    }
+  }
+}
@@ -61,6 +61,10 @@
 #define URINE_LEVEL_MODE_SAMPLE_COUNT 10  // mode over ~5 minutes
 #define URINE_LEVEL_THRESHOLD 1.0         // publish on ≥1% change (0 / 50 / 100)
 
+// Electrode scan (ElectrodeLevelSensor) - non-blocking, one step per loop()
+#define ELECTRODE_SETTLE_US 5000       // Pull-up settle time before an electrode is read
+#define ELECTRODE_PARALLEL_SCAN false  // true = all electrodes pulled up and read at once (one settle time)
+
 // Appliance names (for identification)
 // Relay 0: Audio System
 // Relay 1: Water Pump
@@ -74,6 +78,25 @@
 #define DEBUG_MQTT true     // Enable MQTT debug output
 #define DEBUG_VERBOSE false // Enable verbose debug output (set to true for detailed logging)
 
+// Logging (see Logger.h) - levels above LOG_LEVEL are compiled out
+// 0=NONE, 1=ERROR, 2=WARN, 3=INFO, 4=DEBUG, 5=VERBOSE
+#define LOG_LEVEL LOG_LEVEL_INFO
+#define LOG_QUEUE_DEPTH 32  // Ring buffer line slots (power of two)
+#define LOG_LINE_MAX 128    // Max characters per log line
+#define LOG_STREAM_LEVEL LOG_LEVEL_WARN  // Initial level mirrored to smartcamper/logs/{module} (runtime: logs/level command)
+#define LOG_STREAM_INTERVAL_MS 1000       // Min time between log batch publishes
+#define LOG_STREAM_BATCH_BYTES 768        // Max payload bytes per log batch
+#define LOG_STREAM_BUFFER_SIZE 2048       // Log bytes buffered while waiting to publish
+
+// Command tracking (see CommandTracker.h) - optional "id" in command payloads
+#define COMMAND_ACK_TIMEOUT_MS 2000  // Ack without publish time if no status publish follows
+#define COMMAND_DEDUP_SIZE 16        // Recent command ids remembered for duplicate detection
+
+// Clock sync with the backend (see ClockSync.h) - adds "ts" (epoch ms) to JSON payloads
+#define CLOCK_SYNC_INTERVAL_MS 60000  // Time between sync bursts
+#define CLOCK_SYNC_SAMPLES 4          // Requests per burst (lowest round trip is used)
+#define CLOCK_SYNC_MAX_RTT_MS 250     // Discard samples with a slower round trip
+
 // Watchdog settings (optional - for production stability)
 // #define ENABLE_WATCHDOG true
 // #define WATCHDOG_TIMEOUT 30  // seconds
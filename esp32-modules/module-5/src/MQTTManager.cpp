@@ -2,6 +2,12 @@
 // Universal MQTT manager for ESP32 modules
 
 #include "MQTTManager.h"
+#include "Logger.h"
+#include "CommandTracker.h"
+#include "ClockSync.h"
+
+// Static pointer for MQTT callback
+MQTTManager* MQTTManager::currentInstance = nullptr;
 
 MQTTManager::MQTTManager() {
   this->clientId = MQTT_CLIENT_ID_PREFIX + String(random(0xffff), HEX);
@@ -11,6 +17,9 @@ MQTTManager::MQTTManager() {
   this->isConnected = false;
   this->failedAttempts = 0;
   this->lastWiFiWarningTime = 0;
+  this->userCallback = nullptr;
+  this->commandTracker = nullptr;
+  this->clockSync = nullptr;
   
   mqttClient.setClient(wifiClient);
 }
@@ -23,6 +32,9 @@ MQTTManager::MQTTManager(String clientId, String brokerIP, int brokerPort) {
   this->isConnected = false;
   this->failedAttempts = 0;
   this->lastWiFiWarningTime = 0;
+  this->userCallback = nullptr;
+  this->commandTracker = nullptr;
+  this->clockSync = nullptr;
   
   mqttClient.setClient(wifiClient);
 }
@@ -129,21 +141,18 @@ bool MQTTManager::isMQTTConnected() {
 
 bool MQTTManager::publishSensorData(String sensorType, String value) {
   if (!isMQTTConnected()) {
-    if (DEBUG_SERIAL) {
-      Serial.println("❌ Cannot publish - MQTT not connected");
-    }
+    LOG_WARN("❌ Cannot publish - MQTT not connected");
     return false;
   }
   
   String topic = MQTT_TOPIC_SENSORS + sensorType;
   bool result = mqttClient.publish(topic.c_str(), value.c_str());
   
-  if (DEBUG_MQTT) {
-    if (result) {
-      Serial.println("📤 Published: " + topic + " = " + value);
-    } else {
-      Serial.println("❌ Failed to publish: " + topic + " = " + value);
-    }
+  if (result) {
+    notifyPublished(topic);
+    LOG_DEBUG("📤 Published: %s = %s", topic.c_str(), value.c_str());
+  } else {
+    LOG_WARN("❌ Failed to publish: %s = %s", topic.c_str(), value.c_str());
   }
   
   return result;
@@ -157,20 +166,16 @@ bool MQTTManager::publishSensorData(String sensorType, int value) {
   return publishSensorData(sensorType, String(value));
 }
 
-bool MQTTManager::publishRaw(String topic, String payload) {
+bool MQTTManager::publishRaw(String topic, String payload, bool logPublish) {
   if (!isMQTTConnected()) {
-    if (DEBUG_SERIAL) {
-      Serial.println("❌ Cannot publish - MQTT not connected");
-    }
+    LOG_WARN("❌ Cannot publish - MQTT not connected");
     return false;
   }
   
   // Check payload size
   unsigned int payloadLen = payload.length();
   if (payloadLen > 1024) {
-    if (DEBUG_SERIAL) {
-      Serial.println("❌ Payload too large: " + String(payloadLen) + " bytes (max 1024)");
-    }
+    LOG_WARN("❌ Payload too large: %u bytes (max 1024)", payloadLen);
     return false;
   }
   
@@ -181,20 +186,14 @@ bool MQTTManager::publishRaw(String topic, String payload) {
   
   bool result = mqttClient.publish(topic.c_str(), payload.c_str());
   
-  if (DEBUG_MQTT || !result) {
-    if (result) {
-      Serial.println("📤 Published: " + topic + " = " + payload);
-    } else {
-      Serial.println("❌ Failed to publish: " + topic);
-      Serial.println("   Payload length: " + String(payloadLen) + " bytes");
-      Serial.println("   MQTT state: " + String(mqttClient.state()));
-      Serial.println("   MQTT connected: " + String(mqttClient.connected() ? "yes" : "no"));
-      
-      // Try to get more info about why it failed
-      if (!mqttClient.connected()) {
-        Serial.println("   ⚠️  MQTT client reports not connected");
-      }
+  if (result) {
+    notifyPublished(topic);
+    if (logPublish) {
+      LOG_DEBUG("📤 Published: %s = %s", topic.c_str(), payload.c_str());
     }
+  } else {
+    LOG_WARN("❌ Failed to publish: %s (%u bytes, state %d, connected %s)",
+             topic.c_str(), payloadLen, mqttClient.state(), mqttClient.connected() ? "yes" : "no");
   }
   
   return result;
@@ -202,28 +201,91 @@ bool MQTTManager::publishRaw(String topic, String payload) {
 
 bool MQTTManager::subscribeToCommands(String moduleType) {
   if (!isMQTTConnected()) {
-    if (DEBUG_SERIAL) {
-      Serial.println("❌ Cannot subscribe - MQTT not connected");
-    }
+    LOG_WARN("❌ Cannot subscribe - MQTT not connected");
     return false;
   }
   
   String topic = MQTT_TOPIC_COMMANDS + moduleType + "/#";
   bool result = mqttClient.subscribe(topic.c_str());
   
-  if (DEBUG_MQTT) {
-    if (result) {
-      Serial.println("📥 Subscribed to: " + topic);
-    } else {
-      Serial.println("❌ Failed to subscribe to: " + topic);
-    }
+  if (result) {
+    LOG_INFO("📥 Subscribed to: %s", topic.c_str());
+  } else {
+    LOG_WARN("❌ Failed to subscribe to: %s", topic.c_str());
+  }
+  
+  return result;
+}
+
+bool MQTTManager::subscribeTopic(String topic) {
+  if (!isMQTTConnected()) {
+    return false;
+  }
+  
+  bool result = mqttClient.subscribe(topic.c_str());
+  if (result) {
+    LOG_INFO("📥 Subscribed to: %s", topic.c_str());
+  } else {
+    LOG_WARN("❌ Failed to subscribe to: %s", topic.c_str());
   }
   
   return result;
 }
 
 void MQTTManager::setCallback(void (*callback)(char* topic, byte* payload, unsigned int length)) {
-  mqttClient.setCallback(callback);
+  userCallback = callback;
+  currentInstance = this;
+  mqttClient.setCallback(MQTTManager::dispatchStatic);
+}
+
+void MQTTManager::setCommandTracker(CommandTracker* tracker) {
+  commandTracker = tracker;
+}
+
+void MQTTManager::setClockSync(ClockSync* sync) {
+  clockSync = sync;
+  currentInstance = this;
+  mqttClient.setCallback(MQTTManager::dispatchStatic);
+}
+
+void MQTTManager::dispatchStatic(char* topic, byte* payload, unsigned int length) {
+  MQTTManager* self = currentInstance;
+  if (self == nullptr) {
+    return;
+  }
+  
+  // Time sync replies are infrastructure, not commands
+  if (self->clockSync != nullptr && self->clockSync->handleMessage(topic, payload, length)) {
+    return;
+  }
+  
+  if (self->userCallback == nullptr) {
+    return;
+  }
+  
+  // Tracker may swallow the message (duplicate id, metrics request)
+  if (self->commandTracker != nullptr && !self->commandTracker->onCommandReceived(topic, payload, length)) {
+    return;
+  }
+  
+  self->userCallback(topic, payload, length);
+  
+  if (self->commandTracker != nullptr) {
+    self->commandTracker->onCommandExecuted();
+  }
+}
+
+void MQTTManager::notifyPublished(const String& topic) {
+  // Status publishes close the round trips of the commands that caused them
+  if (commandTracker != nullptr) {
+    commandTracker->onStatusPublished(topic);
+  }
+}
+
+void MQTTManager::expectStatus(const String& topic) {
+  if (commandTracker != nullptr) {
+    commandTracker->expectStatus(topic);
+  }
 }
 
 int MQTTManager::getFailedAttempts() const {
@@ -4,35 +4,28 @@
 #include "UrineLevelSensor.h"
 #include <Arduino.h>
 
-UrineLevelSensor::UrineLevelSensor(MQTTManager* mqtt) {
+// Electrodes from bottom to top
+static constexpr uint8_t URINE_LEVEL_PINS[NUM_URINE_LEVEL_PINS] = { URINE_LEVEL_PIN_1, URINE_LEVEL_PIN_2 };
+static constexpr uint8_t URINE_LEVEL_PERCENTS[NUM_URINE_LEVEL_PINS] = { URINE_LEVEL_PERCENT_1, URINE_LEVEL_PERCENT_2 };
+
+UrineLevelSensor::UrineLevelSensor(MQTTManager* mqtt)
+  : electrodes(URINE_LEVEL_PINS, URINE_LEVEL_PERCENTS, ELECTRODE_SETTLE_US, ELECTRODE_PARALLEL_SCAN) {
   if (mqtt == nullptr && DEBUG_SERIAL) {
     Serial.println("❌ ERROR: UrineLevelSensor: mqttManager cannot be nullptr!");
   }
 
   this->mqttManager = mqtt;
 
-  levelPins[0] = URINE_LEVEL_PIN_1;
-  levelPins[1] = URINE_LEVEL_PIN_2;
-
-  levelPercentages[0] = URINE_LEVEL_PERCENT_1;
-  levelPercentages[1] = URINE_LEVEL_PERCENT_2;
-
   lastSensorRead = 0;
   lastDataSent = 0;
 
-  measurementIndex = 0;
-  measurementCount = 0;
-  for (int i = 0; i < URINE_LEVEL_MODE_SAMPLE_COUNT; i++) {
-    levelIndices[i] = -1;
-  }
-
   lastPublishedLevel = -1.0;
   forceUpdateRequested = false;
   lastMQTTState = false;
 }
 
 void UrineLevelSensor::begin() {
-  setupPins();
+  electrodes.begin();
 
   if (DEBUG_SERIAL) {
     Serial.println("🚽 Urine Level Sensor initialized");
@@ -41,20 +34,6 @@ void UrineLevelSensor::begin() {
   }
 }
 
-void UrineLevelSensor::setupPins() {
-  for (int i = 0; i < NUM_URINE_LEVEL_PINS; i++) {
-    pinMode(levelPins[i], INPUT);
-    digitalWrite(levelPins[i], LOW);
-  }
-}
-
-void UrineLevelSensor::setPinsLow() {
-  for (int i = 0; i < NUM_URINE_LEVEL_PINS; i++) {
-    pinMode(levelPins[i], INPUT);
-    digitalWrite(levelPins[i], LOW);
-  }
-}
-
 void UrineLevelSensor::loop() {
   if (mqttManager == nullptr) {
     return;
@@ -72,87 +51,36 @@ void UrineLevelSensor::loop() {
   lastMQTTState = mqttConnected;
 
   if (!mqttConnected) {
+    electrodes.cancel();
     return;
   }
 
   unsigned long currentTime = millis();
   bool isForceUpdate = forceUpdateRequested;
-  if (currentTime - lastSensorRead > URINE_LEVEL_READ_INTERVAL || isForceUpdate) {
-    lastSensorRead = currentTime;
-
-    setupPins();
-    int level = readWaterLevel();
-    setPinsLow();
-
-    float percent = levelToPercent(level);
-
-    levelIndices[measurementIndex] = level;
-    measurementIndex = (measurementIndex + 1) % URINE_LEVEL_MODE_SAMPLE_COUNT;
-    if (measurementCount < URINE_LEVEL_MODE_SAMPLE_COUNT) {
-      measurementCount++;
-    }
-
-    if (measurementCount >= URINE_LEVEL_MODE_SAMPLE_COUNT) {
-      int modeLevelIndex = findMode(levelIndices, URINE_LEVEL_MODE_SAMPLE_COUNT);
-      float modePercent = levelToPercent(modeLevelIndex);
-      float publishPercent = isForceUpdate ? percent : modePercent;
-      publishIfNeeded(publishPercent, currentTime, isForceUpdate);
-      forceUpdateRequested = false;
-    } else if (isForceUpdate) {
-      publishIfNeeded(percent, currentTime, true);
-      forceUpdateRequested = false;
-    }
-  }
-}
-
-int UrineLevelSensor::readWaterLevel() {
-  for (int i = NUM_URINE_LEVEL_PINS - 1; i >= 0; i--) {
-    pinMode(levelPins[i], INPUT_PULLUP);
-    delay(5);
-
-    int pinState = digitalRead(levelPins[i]);
-
-    if (pinState == LOW) {
-      pinMode(levelPins[i], INPUT);
-      digitalWrite(levelPins[i], LOW);
-      return i;
-    }
-
-    pinMode(levelPins[i], INPUT);
-    digitalWrite(levelPins[i], LOW);
+  if (electrodes.isIdle() && (currentTime - lastSensorRead > URINE_LEVEL_READ_INTERVAL || isForceUpdate)) {
+    electrodes.start(micros());
   }
-
-  return -1;
-}
-
-float UrineLevelSensor::levelToPercent(int level) {
-  if (level < 0 || level >= NUM_URINE_LEVEL_PINS) {
-    return 0.0;
+  if (electrodes.poll(micros())) {
+    lastSensorRead = currentTime;
+    processLevel(electrodes.getLevel(), currentTime, isForceUpdate);
   }
-  return (float)levelPercentages[level];
 }
 
-int UrineLevelSensor::findMode(int* values, int count) {
-  int maxCount = 0;
-  int modeValue = values[0];
+void UrineLevelSensor::processLevel(int level, unsigned long currentTime, bool isForceUpdate) {
+  float percent = electrodes.levelToPercent(level);
 
-  for (int i = 0; i < count; i++) {
-    int currentValue = values[i];
-    int currentCount = 0;
+  levelMode.add(level);
 
-    for (int j = 0; j < count; j++) {
-      if (values[j] == currentValue) {
-        currentCount++;
-      }
-    }
-
-    if (currentCount > maxCount || (currentCount == maxCount && currentValue > modeValue)) {
-      maxCount = currentCount;
-      modeValue = currentValue;
-    }
+  if (levelMode.isFull()) {
+    int modeLevelIndex = levelMode.getMode();
+    float modePercent = electrodes.levelToPercent(modeLevelIndex);
+    float publishPercent = isForceUpdate ? percent : modePercent;
+    publishIfNeeded(publishPercent, currentTime, isForceUpdate);
+    forceUpdateRequested = false;
+  } else if (isForceUpdate) {
+    publishIfNeeded(percent, currentTime, true);
+    forceUpdateRequested = false;
   }
-
-  return modeValue;
 }
 
 void UrineLevelSensor::publishIfNeeded(float averagePercent, unsigned long currentTime, bool forcePublish) {
@@ -202,6 +130,6 @@ void UrineLevelSensor::printStatus() const {
   if (DEBUG_SERIAL) {
     Serial.println("📊 Urine Level Sensor Status:");
     Serial.println("  Last Level: " + String(lastPublishedLevel >= 0 ? String(lastPublishedLevel, 1) + "%" : "N/A"));
-    Serial.println("  Measurement Count: " + String(measurementCount) + "/" + String(URINE_LEVEL_MODE_SAMPLE_COUNT));
+    Serial.println("  Measurement Count: " + String(levelMode.getCount()) + "/" + String(URINE_LEVEL_MODE_SAMPLE_COUNT));
   }
 }
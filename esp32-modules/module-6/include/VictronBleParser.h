@@ -5,8 +5,10 @@
 #define VICTRON_BLE_PARSER_H
 
 #include <Arduino.h>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include "mbedtls/aes.h"
 
 static const uint16_t VICTRON_VENDOR_ID = 0x02E1;
 static const uint8_t VICTRON_BEACON_TYPE = 0x10;
@@ -68,6 +70,9 @@ struct AcChargerReading {
   float acCurrent;
 };
 
+// LSB-first bit reader over a little-endian record.
+// Fields (up to 32 bits) are extracted from a 64-bit window with one shift and mask.
+// Bits past the end of the data read as zero; the cursor still advances.
 class BitReader {
  public:
   BitReader(const uint8_t *data, size_t dataLen);
@@ -75,24 +80,185 @@ class BitReader {
   bool readBit();
   uint32_t readUnsigned(uint8_t bitCount);
   int32_t readSigned(uint8_t bitCount);
-  void skip(uint8_t bitCount);
+  void skip(uint8_t bitCount) { cursor += bitCount; }
 
  private:
   const uint8_t *data;
   size_t dataLen;
   size_t cursor;
+
+  uint64_t loadWindow(size_t byteIndex) const;
+};
+
+// AES-128-CTR decryption with the key schedule expanded once (setKey at boot).
+// Payloads are at most one block, so each decrypt is a single block encryption
+// of the nonce (data counter) XORed into the ciphertext.
+class VictronCipher {
+ public:
+  VictronCipher();
+  ~VictronCipher();
+
+  bool setKey(const uint8_t *key);
+  bool isReady() const { return ready; }
+  bool decrypt(const uint8_t *cipher, size_t cipherLen, uint8_t counterLsb, uint8_t counterMsb,
+               uint8_t *plainOut);
+
+ private:
+  mbedtls_aes_context aes;
+  bool ready;
+
+  VictronCipher(const VictronCipher &) = delete;
+  VictronCipher &operator=(const VictronCipher &) = delete;
 };
 
 bool parseHexKey(const char *hexKey, uint8_t *outKey);
+bool parseMacAddress(const char *mac, uint8_t *outMac);
 bool isSupportedRecordType(uint8_t recordType);
-bool decryptVictronPayload(const uint8_t *key, const uint8_t *cipher, size_t cipherLen,
-                           uint8_t counterLsb, uint8_t counterMsb, uint8_t *plainOut);
 bool parseBatteryMonitor(const uint8_t *payload, size_t payloadLen, SmartShuntReading &out);
 bool parseSolarCharger(const uint8_t *payload, size_t payloadLen, MpptReading &out);
 bool parseOrionXs(const uint8_t *payload, size_t payloadLen, OrionReading &out);
 bool parseAcCharger(const uint8_t *payload, size_t payloadLen, AcChargerReading &out);
+// Orion-Tr Smart and other DC-DC converters (0x04): voltages and off reason, no currents
+bool parseDcdcConverter(const uint8_t *payload, size_t payloadLen, OrionReading &out);
 
 float roundTo1Decimal(float value);
 float roundTo2Decimals(float value);
 
+// ---------------------------------------------------------------------------
+// Table-driven record layouts
+// Each record type is a constexpr table of VictronField<Reading> entries in bit
+// order (width, signedness, invalid sentinel, scale, rounding, destination
+// member). decodeVictronRecord<Reading, Layout, Count> unrolls the table at
+// compile time, so every field becomes straight-line extract/compare/store code
+// with the constants folded in. A new record type is a new table.
+// ---------------------------------------------------------------------------
+
+enum VictronFieldKind : uint8_t { FIELD_SKIP, FIELD_UNSIGNED, FIELD_SIGNED };
+
+enum VictronFieldRounding : uint8_t {
+  ROUND_NONE,
+  ROUND_1_DECIMAL,   // roundTo1Decimal
+  ROUND_2_DECIMALS,  // roundTo2Decimals
+  ROUND_TO_INT       // lroundf, for integer destinations with a scale
+};
+
+// Destination member of a reading struct (one of the member types readings use)
+template <typename Reading>
+struct VictronFieldTarget {
+  enum Type : uint8_t { NONE, FLOAT, INT, U8, U16, U32 } type;
+  union {
+    float Reading::*f;
+    int Reading::*i;
+    uint8_t Reading::*u8;
+    uint16_t Reading::*u16;
+    uint32_t Reading::*u32;
+  };
+
+  constexpr VictronFieldTarget() : type(NONE), f(nullptr) {}
+  constexpr VictronFieldTarget(float Reading::*m) : type(FLOAT), f(m) {}
+  constexpr VictronFieldTarget(int Reading::*m) : type(INT), i(m) {}
+  constexpr VictronFieldTarget(uint8_t Reading::*m) : type(U8), u8(m) {}
+  constexpr VictronFieldTarget(uint16_t Reading::*m) : type(U16), u16(m) {}
+  constexpr VictronFieldTarget(uint32_t Reading::*m) : type(U32), u32(m) {}
+};
+
+template <typename Reading>
+struct VictronField {
+  VictronFieldKind kind;
+  uint8_t bits;
+  bool hasInvalid;
+  uint32_t invalid;                 // Raw field bits meaning "not available"
+  float scale;                      // Applied after sign extension
+  VictronFieldRounding rounding;
+  VictronFieldTarget<Reading> target;
+  bool Reading::*valid;             // Set to (raw != invalid); nullptr = no flag
+
+  // Bits that are not decoded (reserved, unused outputs, ...)
+  static constexpr VictronField skip(uint8_t bits) {
+    return VictronField{FIELD_SKIP, bits, false, 0, 1.0f, ROUND_NONE, VictronFieldTarget<Reading>(),
+                        nullptr};
+  }
+
+  // Raw integer without availability flag (state, error code, bitmasks)
+  static constexpr VictronField raw(uint8_t bits, VictronFieldTarget<Reading> target) {
+    return VictronField{FIELD_UNSIGNED, bits, false, 0, 1.0f, ROUND_NONE, target, nullptr};
+  }
+
+  // Measured value with an invalid sentinel and availability flag
+  static constexpr VictronField value(VictronFieldKind kind, uint8_t bits, uint32_t invalid, float scale,
+                                      VictronFieldRounding rounding, VictronFieldTarget<Reading> target,
+                                      bool Reading::*valid) {
+    return VictronField{kind, bits, true, invalid, scale, rounding, target, valid};
+  }
+};
+
+template <typename Reading>
+inline __attribute__((always_inline)) void decodeVictronField(const VictronField<Reading> &field,
+                                                              BitReader &reader, Reading &out) {
+  if (field.kind == FIELD_SKIP) {
+    reader.skip(field.bits);
+    return;
+  }
+
+  uint32_t raw = reader.readUnsigned(field.bits);
+  if (field.valid != nullptr) {
+    out.*field.valid = !field.hasInvalid || raw != field.invalid;
+  }
+
+  int32_t value = (int32_t)raw;
+  if (field.kind == FIELD_SIGNED && field.bits < 32) {
+    uint8_t shift = 32 - field.bits;
+    value = (int32_t)(raw << shift) >> shift;
+  }
+
+  switch (field.target.type) {
+    case VictronFieldTarget<Reading>::FLOAT: {
+      float scaled = field.kind == FIELD_SIGNED ? value * field.scale : raw * field.scale;
+      if (field.rounding == ROUND_1_DECIMAL) {
+        scaled = roundTo1Decimal(scaled);
+      } else if (field.rounding == ROUND_2_DECIMALS) {
+        scaled = roundTo2Decimals(scaled);
+      }
+      out.*field.target.f = scaled;
+      break;
+    }
+    case VictronFieldTarget<Reading>::INT:
+      out.*field.target.i = field.rounding == ROUND_TO_INT ? (int)lroundf(raw * field.scale) : value;
+      break;
+    case VictronFieldTarget<Reading>::U8:
+      out.*field.target.u8 = (uint8_t)raw;
+      break;
+    case VictronFieldTarget<Reading>::U16:
+      out.*field.target.u16 = (uint16_t)raw;
+      break;
+    case VictronFieldTarget<Reading>::U32:
+      out.*field.target.u32 = raw;
+      break;
+    default:
+      break;
+  }
+}
+
+// Compile-time walk over Layout[Index..Count)
+template <typename Reading, const VictronField<Reading> *Layout, size_t Index, size_t Count>
+struct VictronLayoutDecoder {
+  static inline __attribute__((always_inline)) void run(BitReader &reader, Reading &out) {
+    decodeVictronField(Layout[Index], reader, out);
+    VictronLayoutDecoder<Reading, Layout, Index + 1, Count>::run(reader, out);
+  }
+};
+
+template <typename Reading, const VictronField<Reading> *Layout, size_t Count>
+struct VictronLayoutDecoder<Reading, Layout, Count, Count> {
+  static inline __attribute__((always_inline)) void run(BitReader &, Reading &) {}
+};
+
+template <typename Reading, const VictronField<Reading> *Layout, size_t Count>
+bool decodeVictronRecord(const uint8_t *payload, size_t payloadLen, Reading &out) {
+  BitReader reader(payload, payloadLen);
+  out = Reading();  // Fields without a table entry read as not available
+  VictronLayoutDecoder<Reading, Layout, 0, Count>::run(reader, out);
+  return true;
+}
+
 #endif
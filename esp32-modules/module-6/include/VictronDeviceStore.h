@@ -0,0 +1,107 @@
+// Victron Device Store
+// Configured Victron devices (MAC, key, role) and the last reading of each.
+// No BLE or MQTT code in here, so the firmware and the host replay tool
+// (tools/host/victron_replay.cpp) run exactly the same record pipeline:
+// - findDevice(): binary MAC lookup, safe from the BLE scan callback (read-only after begin())
+// - handleRecord(): validate, de-duplicate, decrypt, parse and cache one advertisement (loop() only)
+// - appendStatusJson(): device objects of the module-6 status payload
+
+#ifndef VICTRON_DEVICE_STORE_H
+#define VICTRON_DEVICE_STORE_H
+
+#include <ArduinoJson.h>
+#include "Config.h"
+#include "VictronBleParser.h"
+#include "VictronRecordQueue.h"
+
+enum VictronDeviceRole {
+  ROLE_SMARTSHUNT = 0,
+  ROLE_ORION = 1,
+  ROLE_MPPT1 = 2,
+  ROLE_MPPT2 = 3,
+  ROLE_AC_CHARGER = 4
+};
+
+enum VictronRecordResult {
+  VICTRON_RECORD_UPDATED,    // New data counter, decoded into the cache
+  VICTRON_RECORD_DUPLICATE,  // Same data counter re-advertised, cache only touched
+  VICTRON_RECORD_REJECTED    // Not an Instant Readout record for this device, or undecodable
+};
+
+// Why handleRecord() rejected a record (reception diagnostics)
+enum VictronRejectReason {
+  VICTRON_REJECT_NONE = 0,
+  VICTRON_REJECT_FORMAT,       // Not a Victron Instant Readout frame (vendor id, beacon type, length)
+  VICTRON_REJECT_KEY,          // Key check byte does not match the configured key
+  VICTRON_REJECT_RECORD_TYPE,  // Record type this device's role does not use
+  VICTRON_REJECT_DECRYPT,      // Bad ciphertext length or AES failure
+  VICTRON_REJECT_PARSE         // Decrypted payload did not parse
+};
+
+// Open-addressing MAC -> device index table (power of two, at least 2x the device count)
+static const size_t VICTRON_MAC_TABLE_SIZE = 16;
+
+class VictronDeviceStore {
+ public:
+  VictronDeviceStore();
+
+  // Parse MACs and keys from Config.h; false if any entry is invalid
+  bool begin();
+
+  // Device index for a native (BLEAddress::getNative() order) MAC, or -1
+  int findDevice(const uint8_t *mac) const;
+
+  VictronRecordResult handleRecord(const VictronRawRecord &raw, VictronRejectReason *reason = nullptr);
+  void appendStatusJson(JsonDocument &doc) const;
+
+  bool hasData(VictronDeviceRole role) const;
+  unsigned long getUpdatedAt(VictronDeviceRole role) const;  // Last advertisement (new or repeated)
+  const char *getDeviceName(uint8_t index) const { return devices[index].name; }
+  VictronDeviceRole getDeviceRole(uint8_t index) const { return devices[index].role; }
+  uint16_t getDataCounter(uint8_t index) const { return devices[index].lastDataCounter; }
+
+  // Last reading per role, nullptr until the first one arrived
+  const SmartShuntReading *getSmartShunt() const;
+  const MpptReading *getMppt(uint8_t index) const;  // 0 = MPPT1, 1 = MPPT2
+  const OrionReading *getOrion() const;
+  const AcChargerReading *getAcCharger() const;
+
+ private:
+  struct DeviceConfig {
+    const char *name;
+    const char *mac;
+    uint8_t macBytes[6];   // Parsed once at boot, compared against BLEAddress::getNative()
+    uint8_t key[16];
+    VictronCipher cipher;  // Key schedule expanded once in begin()
+    VictronDeviceRole role;
+    uint16_t lastDataCounter;
+    bool configured;
+  };
+
+  template <typename Reading>
+  struct Cached {
+    bool hasData;
+    Reading reading;
+    unsigned long updatedAt;
+  };
+
+  DeviceConfig devices[VICTRON_DEVICE_COUNT];
+  uint8_t macTable[VICTRON_MAC_TABLE_SIZE];
+  Cached<SmartShuntReading> smartShuntCache;
+  Cached<MpptReading> mppt1Cache;
+  Cached<MpptReading> mppt2Cache;
+  Cached<OrionReading> orionCache;
+  Cached<AcChargerReading> acChargerCache;
+
+  bool insertMac(uint8_t deviceIndex);
+  void touchDeviceCache(VictronDeviceRole role, unsigned long nowMs);
+  bool handleParsedPayload(DeviceConfig &device, uint8_t recordType, const uint8_t *plain,
+                           size_t plainLen, unsigned long nowMs);
+
+  void appendSmartShuntJson(JsonDocument &doc) const;
+  void appendMpptJson(JsonDocument &doc, const char *key, const Cached<MpptReading> &cache) const;
+  void appendOrionJson(JsonDocument &doc) const;
+  void appendAcChargerJson(JsonDocument &doc) const;
+};
+
+#endif
@@ -0,0 +1,133 @@
+// Victron Energy Tracker
+// On-device energy accounting from the readings in VictronDeviceStore, so the
+// backend gets totals and a forecast without replaying raw 2 s samples.
+// No BLE or MQTT code in here (also runs in tools/host/victron_replay.cpp).
+// - onReading(): integrate the device that just updated (trapezoid, O(1))
+// - appendAnalyticsJson(): battery Wh in/out, solar Wh per MPPT, consumption per
+//   hour / last 24 h, and time-to-empty / time-to-full from a rolling regression
+//
+// Consumption is the energy balance: charging sources (MPPT battery side, Orion
+// output, AC charger output) minus the net energy into the battery (SmartShunt).
+
+#ifndef VICTRON_ENERGY_TRACKER_H
+#define VICTRON_ENERGY_TRACKER_H
+
+#include <ArduinoJson.h>
+#include "Config.h"
+#include "VictronDeviceStore.h"
+
+// Defaults if Config.h does not set them
+#ifndef BATTERY_CAPACITY_AH
+#define BATTERY_CAPACITY_AH 200        // Nominal house battery capacity (forecast only)
+#endif
+#ifndef VICTRON_ENERGY_MAX_GAP_MS
+#define VICTRON_ENERGY_MAX_GAP_MS 30000  // Longer gaps between readings are not integrated
+#endif
+#ifndef VICTRON_FORECAST_SAMPLE_MS
+#define VICTRON_FORECAST_SAMPLE_MS 10000  // Charge counter sample interval for the regression
+#endif
+#ifndef VICTRON_FORECAST_WINDOW
+#define VICTRON_FORECAST_WINDOW 60        // Samples in the regression window (10 min at 10 s)
+#endif
+#ifndef VICTRON_FORECAST_IDLE_A
+#define VICTRON_FORECAST_IDLE_A 0.2f      // Below this trend the battery counts as idle
+#endif
+
+static const uint8_t VICTRON_ENERGY_HOURS = 24;
+
+// Trapezoidal integrator, value x ms (W -> mJ, mA -> mA x ms).
+// Integer accumulation keeps months of totals exact where a float would stall.
+class VictronIntegrator {
+ public:
+  VictronIntegrator() : hasLast(false), lastValue(0), lastMs(0) {}
+
+  // Returns the increment since the previous sample (0 on the first sample or after a gap)
+  int64_t add(float value, unsigned long nowMs);
+  void reset() { hasLast = false; }
+
+ private:
+  bool hasLast;
+  float lastValue;
+  unsigned long lastMs;
+};
+
+// Least-squares slope over the last VICTRON_FORECAST_WINDOW (t, y) points.
+// Running integer sums: each add() is O(1) and exact, so no drift over long uptimes.
+class VictronRollingRegression {
+ public:
+  VictronRollingRegression();
+
+  void add(int64_t t, int64_t y);
+  void reset();
+  uint8_t getCount() const { return count; }
+  int32_t getSpan() const;            // Newest t - oldest t
+  bool getSlope(float &slope) const;  // dy/dt; false with fewer than 2 distinct t
+
+ private:
+  int32_t ts[VICTRON_FORECAST_WINDOW];  // Relative to originT / originY
+  int32_t ys[VICTRON_FORECAST_WINDOW];
+  uint8_t head;   // Oldest point
+  uint8_t count;
+  int64_t originT;
+  int64_t originY;
+  int64_t sumT;
+  int64_t sumY;
+  int64_t sumTT;
+  int64_t sumTY;
+
+  void rebase();
+};
+
+class VictronEnergyTracker {
+ public:
+  VictronEnergyTracker();
+
+  // Call after the store accepted a new reading from a device in this role
+  void onReading(const VictronDeviceStore &store, VictronDeviceRole role, unsigned long nowMs);
+
+  // Roll the hour buckets forward (also done by onReading)
+  void advance(unsigned long nowMs);
+
+  void appendAnalyticsJson(JsonDocument &doc) const;
+
+ private:
+  struct HourBucket {
+    int64_t consumptionMj;
+    int64_t solarMj;
+  };
+
+  bool clockStarted;
+  unsigned long lastAdvanceMs;
+  uint64_t clockMs;  // Tracker uptime, wrap-free (millis() wraps after 49 days)
+
+  VictronIntegrator batteryPower;
+  VictronIntegrator batteryCurrent;
+  VictronIntegrator mpptPv[2];
+  VictronIntegrator mpptOutput[2];
+  VictronIntegrator orionOutput;
+  VictronIntegrator acChargerOutput;
+
+  int64_t batteryInMj;
+  int64_t batteryOutMj;
+  int64_t batteryNetMams;  // Net charge, mA x ms
+  int64_t solarMj[2];
+
+  HourBucket hours[VICTRON_ENERGY_HOURS];  // Completed hours, oldest at hourHead
+  uint8_t hourHead;
+  uint8_t completedHours;
+  uint64_t hourStartMs;
+  HourBucket currentHour;
+  HourBucket lastDay;  // Sum of the completed buckets
+
+  unsigned long lastShuntMs;
+  bool hasShuntSample;
+  VictronRollingRegression forecast;
+  uint64_t lastForecastSampleMs;
+  bool socValid;
+  int soc;
+
+  void addSource(int64_t mj) { currentHour.consumptionMj += mj; }
+  void closeHour();
+};
+
+#endif
@@ -0,0 +1,144 @@
+// Victron History
+// Battery / solar history kept on the module at three resolutions, so the
+// dashboard has data again right after a Pi restart:
+// - 1 s samples for the last 5 minutes
+// - 1 min means for the last 24 hours
+// - 1 h means for the last 30 days
+// Each resolution is a ring of fixed-size blocks (all memory static, sized in
+// Config.h). Points are compressed Gorilla-style: timestamps as delta-of-delta,
+// values as XOR against the previous value of the same metric.
+// No BLE or MQTT code in here (also runs in tools/host/victron_replay.cpp).
+
+#ifndef VICTRON_HISTORY_H
+#define VICTRON_HISTORY_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "VictronDeviceStore.h"
+
+// Defaults if Config.h does not set them
+#ifndef VICTRON_HISTORY_BLOCK_BYTES
+#define VICTRON_HISTORY_BLOCK_BYTES 256  // Compressed bytes per block
+#endif
+#ifndef VICTRON_HISTORY_1S_BLOCKS
+#define VICTRON_HISTORY_1S_BLOCKS 10
+#endif
+#ifndef VICTRON_HISTORY_1M_BLOCKS
+#define VICTRON_HISTORY_1M_BLOCKS 56
+#endif
+#ifndef VICTRON_HISTORY_1H_BLOCKS
+#define VICTRON_HISTORY_1H_BLOCKS 40
+#endif
+#ifndef VICTRON_HISTORY_MAX_AGE_MS
+#define VICTRON_HISTORY_MAX_AGE_MS 30000  // Older SmartShunt readings are not recorded
+#endif
+
+enum VictronHistoryResolution {
+  HISTORY_1S = 0,
+  HISTORY_1M = 1,
+  HISTORY_1H = 2,
+  HISTORY_RESOLUTIONS = 3
+};
+
+enum VictronHistoryMetric {
+  HISTORY_VOLTAGE = 0,  // SmartShunt V
+  HISTORY_CURRENT = 1,  // SmartShunt A (+ = charging)
+  HISTORY_SOC = 2,      // SmartShunt %
+  HISTORY_SOLAR = 3,    // PV W, both MPPTs
+  HISTORY_METRICS = 4
+};
+
+struct VictronHistoryPoint {
+  uint32_t t;  // Module uptime, seconds
+  float values[HISTORY_METRICS];
+};
+
+struct VictronHistoryBlock {
+  uint32_t firstT;
+  uint32_t lastT;
+  uint16_t count;
+  uint16_t bitLen;
+  uint8_t bits[VICTRON_HISTORY_BLOCK_BYTES];
+};
+
+// Gorilla encoder / decoder state, carried from point to point inside a block
+struct VictronHistoryCodecState {
+  uint32_t prevT;
+  int32_t prevDelta;
+  uint32_t prevBits[HISTORY_METRICS];
+  uint8_t prevLeading[HISTORY_METRICS];
+  uint8_t prevTrailing[HISTORY_METRICS];
+};
+
+// Read position of a running query; survives blocks being appended (and evicted) between reads
+struct VictronHistoryCursor {
+  uint8_t resolution;
+  uint32_t toT;
+  uint32_t blockSeq;
+  uint16_t pointIndex;  // Points already decoded from blockSeq
+  uint16_t bitPos;
+  VictronHistoryCodecState state;
+  bool truncated;       // Data was evicted while the query was running
+};
+
+struct VictronHistoryTierStats {
+  uint32_t points;
+  uint32_t bytes;      // Compressed bytes in use
+  uint32_t capacity;   // Bytes reserved
+  uint32_t oldestT;
+};
+
+class VictronHistory {
+ public:
+  VictronHistory();
+  VictronHistory(const VictronHistory &) = delete;  // Tiers point into the block arrays
+  VictronHistory &operator=(const VictronHistory &) = delete;
+
+  // Record one 1 s sample from the store's current readings (call once per second)
+  void sample(const VictronDeviceStore &store, uint32_t nowS, unsigned long nowMs);
+  void addPoint(const VictronHistoryPoint &point);  // 1 s tier input; minute/hour means follow
+
+  // Query [fromT, toT] at one resolution; points come out in time order
+  void beginQuery(VictronHistoryResolution resolution, uint32_t fromT, uint32_t toT,
+                  VictronHistoryCursor &cursor) const;
+  size_t read(VictronHistoryCursor &cursor, VictronHistoryPoint *out, size_t maxPoints) const;
+
+  VictronHistoryTierStats getStats(VictronHistoryResolution resolution) const;
+  static uint32_t getStepSeconds(VictronHistoryResolution resolution);
+  static const char *getResolutionName(VictronHistoryResolution resolution);
+  static bool parseResolution(const char *name, VictronHistoryResolution &resolution);
+
+ private:
+  struct Tier {
+    VictronHistoryBlock *blocks;
+    uint8_t blockCount;
+    uint32_t retentionS;
+    uint32_t nextSeq;  // Block sequence numbers; slot = seq % blockCount
+    uint8_t used;
+    VictronHistoryCodecState writer;
+  };
+
+  struct Mean {
+    uint32_t startT;
+    uint16_t count;                   // Samples in the bucket
+    uint16_t valid[HISTORY_METRICS];  // Non-NaN samples per metric (SOC can be missing)
+    float sums[HISTORY_METRICS];
+  };
+
+  VictronHistoryBlock secondBlocks[VICTRON_HISTORY_1S_BLOCKS];
+  VictronHistoryBlock minuteBlocks[VICTRON_HISTORY_1M_BLOCKS];
+  VictronHistoryBlock hourBlocks[VICTRON_HISTORY_1H_BLOCKS];
+  Tier tiers[HISTORY_RESOLUTIONS];
+  Mean minuteMean;
+  Mean hourMean;
+
+  void append(Tier &tier, const VictronHistoryPoint &point);
+  void addToMean(Mean &mean, uint32_t stepS, VictronHistoryResolution resolution,
+                 const VictronHistoryPoint &point);
+  static float meanOf(const Mean &mean, uint8_t metric);
+  VictronHistoryBlock &blockAt(const Tier &tier, uint32_t seq) const {
+    return tier.blocks[seq % tier.blockCount];
+  }
+};
+
+#endif
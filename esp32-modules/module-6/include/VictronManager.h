@@ -7,27 +7,53 @@
 #include "Config.h"
 #include "ModuleManager.h"
 #include "CommandHandler.h"
-#include "VictronBleParser.h"
-
-enum VictronDeviceRole {
-  ROLE_SMARTSHUNT = 0,
-  ROLE_ORION = 1,
-  ROLE_MPPT1 = 2,
-  ROLE_MPPT2 = 3,
-  ROLE_AC_CHARGER = 4
-};
+#include "VictronDeviceStore.h"
+#include "VictronEnergyTracker.h"
+#include "VictronHistory.h"
+#include "VictronReceptionStats.h"
+#include "VictronRecordQueue.h"
+#include "VictronScanScheduler.h"
 
 class VictronManager {
  private:
   ModuleManager *moduleManager;
   CommandHandler commandHandler;
+  VictronDeviceStore deviceStore;   // Devices + last readings (loop() side)
+  VictronRecordQueue recordQueue;   // BLE callback -> loop()
+  VictronEnergyTracker energyTracker;  // Wh totals and battery forecast
+  VictronHistory history;              // 1 s / 1 min / 1 h compressed history
+  VictronScanScheduler scanScheduler;  // When the radio needs to listen for BLE
+  VictronReceptionStats receptionStats;  // Per-device reception counters (diagnostics topic)
 
   unsigned long lastPublishMs;
+  unsigned long lastAnalyticsPublishMs;
+  unsigned long lastHistorySampleMs;
+  unsigned long lastDiagnosticsPublishMs;
+  unsigned long diagnosticsWindowStartMs;  // receptionStats counts since
+
+  // MQTT publish time (radio shared with BLE), since the previous status publish
+  uint32_t publishUsMax;
+  uint32_t publishUsSum;
+  uint16_t publishCount;
+
+  // Running history query, streamed one chunk per loop()
+  VictronHistoryCursor historyCursor;
+  bool historyStreaming;
+  uint16_t historyChunkSeq;
+  uint8_t historyChunkFailures;  // Failed publishes of the current chunk
+  unsigned long lastHistoryChunkMs;
+  char historyRequestId[24];
   bool devicesConfigured;
   bool bleInitialized;
   bool bleScanActive;
 
   void startBle();
+  void updateBleScan(unsigned long nowMs);
+  void processQueuedRecords();
+  bool publishTimed(const String &topic, const String &payload, bool logPublish = true);
+  void publishHistoryChunk();
+  void beginHistoryChunk(JsonDocument &doc, VictronHistoryResolution resolution);
+  void endHistoryStream(const char *error);
 
  public:
   VictronManager(ModuleManager *moduleMgr);
@@ -35,10 +61,13 @@ class VictronManager {
   void begin();
   void loop();
   void handleForceUpdate();
+  void handleHistoryQuery(const String &message);
 
   CommandHandler &getCommandHandler() { return commandHandler; }
 
   void publishFullStatus();
+  void publishAnalytics();
+  void publishDiagnostics();
   void printStatus() const;
 };
 
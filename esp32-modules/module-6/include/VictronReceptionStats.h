@@ -0,0 +1,65 @@
+// Victron Reception Stats
+// Per-device BLE reception counters behind smartcamper/sensors/module-6/diagnostics,
+// so a stale reading can be traced to its cause: device silent (nothing seen), wrong
+// key (key-check rejects), decrypt/parse failures, only repeats (duplicates) or
+// missed updates (counter gaps). RSSI and the inter-arrival histogram help placing
+// the antenna and tuning the scan parameters.
+// Counts cover the window since the previous diagnostics publish (reset()).
+// No BLE or MQTT code in here (also runs in tools/host/victron_replay.cpp).
+
+#ifndef VICTRON_RECEPTION_STATS_H
+#define VICTRON_RECEPTION_STATS_H
+
+#include <ArduinoJson.h>
+#include "Config.h"
+#include "VictronDeviceStore.h"
+#include "VictronRecordQueue.h"
+
+// Inter-arrival buckets (upper bounds in ms; the last bucket is open-ended)
+static const uint8_t VICTRON_ARRIVAL_BUCKETS = 7;
+static const uint16_t VICTRON_ARRIVAL_BOUNDS_MS[VICTRON_ARRIVAL_BUCKETS - 1] = {250, 500, 1000, 2000, 5000, 10000};
+
+struct VictronDeviceReception {
+  uint32_t seen;             // Advertisements handed to loop(), any result
+  uint32_t duplicates;       // Same data counter as the last accepted record
+  uint32_t keyRejects;       // Key check byte mismatch (wrong key in Config.h?)
+  uint32_t decryptFailures;  // Bad ciphertext length, AES error or undecodable payload
+  uint32_t otherRejects;     // Not Instant Readout, or a record type the role does not use
+  uint32_t counterGaps;      // Data counter steps skipped while the radio was listening
+  int8_t rssiMin;
+  int8_t rssiMax;
+  int32_t rssiSum;
+  uint32_t arrivals[VICTRON_ARRIVAL_BUCKETS];  // Time between consecutive advertisements
+};
+
+class VictronReceptionStats {
+ public:
+  VictronReceptionStats();
+
+  // Feed every record of a configured device after VictronDeviceStore::handleRecord().
+  // Counter gaps only count when the previous update arrived after listeningSinceMs
+  // (the radio was on in between; adaptive scanning skips steps on purpose).
+  void onRecord(const VictronRawRecord &raw, VictronRecordResult result, VictronRejectReason reason,
+                uint16_t dataCounter, unsigned long listeningSinceMs);
+
+  // One object per device name; call reset() after publishing
+  void appendDiagnosticsJson(JsonDocument &doc, const VictronDeviceStore &store) const;
+  void reset();
+
+  const VictronDeviceReception &get(uint8_t deviceIndex) const { return windows[deviceIndex]; }
+
+ private:
+  // Survive reset(): needed to measure across the window boundary
+  struct DeviceHistory {
+    bool hasAdvertisement;
+    unsigned long lastAdvertisementMs;
+    bool hasCounter;
+    uint16_t lastCounter;
+    unsigned long lastUpdateMs;
+  };
+
+  VictronDeviceReception windows[VICTRON_DEVICE_COUNT];
+  DeviceHistory history[VICTRON_DEVICE_COUNT];
+};
+
+#endif
@@ -0,0 +1,56 @@
+// Victron Record Queue
+// Lock-free single-producer/single-consumer ring of raw Victron advertisements.
+// Producer: BLE scan callback (BLE host task) - filters by MAC and copies the
+// manufacturer data straight into a reserved slot.
+// Consumer: VictronManager::loop() - decrypts, parses and updates the caches, so
+// the caches are only ever touched from the main loop.
+
+#ifndef VICTRON_RECORD_QUEUE_H
+#define VICTRON_RECORD_QUEUE_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "Config.h"
+
+#ifndef VICTRON_RECORD_QUEUE_DEPTH
+#define VICTRON_RECORD_QUEUE_DEPTH 16  // Slots (power of two); 5 devices at ~5 adv/s each
+#endif
+
+static const size_t VICTRON_MANUFACTURER_DATA_MAX = 31;
+
+struct VictronRawRecord {
+  uint8_t deviceIndex;        // Index into the configured device table
+  uint8_t len;                // Manufacturer data length
+  int8_t rssi;                // dBm
+  unsigned long receivedAt;   // millis() in the scan callback
+  uint8_t data[VICTRON_MANUFACTURER_DATA_MAX];
+};
+
+class VictronRecordQueue {
+ public:
+  VictronRecordQueue();
+
+  // Producer: reserve the next free slot, fill it, then commit. Returns nullptr
+  // (and counts a drop) when the ring is full. A reserved slot that is not
+  // committed is simply reused by the next reserve().
+  VictronRawRecord *reserve();
+  void commit();
+
+  // Consumer: oldest record or nullptr, then release() once done with it
+  const VictronRawRecord *front();
+  void release();
+
+  uint32_t getPushedCount() const { return pushed.load(std::memory_order_relaxed); }
+  uint32_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+  uint32_t getHighWater() const { return highWater.load(std::memory_order_relaxed); }
+
+ private:
+  VictronRawRecord slots[VICTRON_RECORD_QUEUE_DEPTH];
+  std::atomic<uint32_t> head;  // Next slot to write (producer only)
+  std::atomic<uint32_t> tail;  // Next slot to read (consumer only)
+  std::atomic<uint32_t> pushed;
+  std::atomic<uint32_t> dropped;
+  std::atomic<uint32_t> highWater;  // Max records waiting at once
+};
+
+#endif
@@ -0,0 +1,89 @@
+// Victron Scan Scheduler
+// Decides when module-6 needs the BLE radio, so WiFi gets it the rest of the time
+// (ESP32 WiFi and BLE share one radio; a 100 % scan window starves MQTT).
+// No BLE or MQTT code in here (also runs in tools/host/victron_replay.cpp).
+// Per device it learns:
+// - the data counter cadence: receive-time gap / counter steps between new records,
+//   so missed steps while the radio was off do not skew it
+// - the advertisement period: gap between repeats heard within one scan session
+// and opens a scan window just before the last new counter a device can produce
+// while its reading is still younger than VICTRON_SCAN_TARGET_AGE_MS.
+// The window closes once every due device delivered. Devices that stay silent
+// for VICTRON_SCAN_LOST_MS are only probed every VICTRON_SCAN_PROBE_INTERVAL_MS.
+
+#ifndef VICTRON_SCAN_SCHEDULER_H
+#define VICTRON_SCAN_SCHEDULER_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "VictronDeviceStore.h"
+
+// Defaults if Config.h does not set them
+#ifndef VICTRON_SCAN_TARGET_AGE_MS
+#define VICTRON_SCAN_TARGET_AGE_MS 4000  // Keep each reading younger than this
+#endif
+#ifndef VICTRON_SCAN_LEAD_MS
+#define VICTRON_SCAN_LEAD_MS 300  // Open the window this early (at least one advertisement period)
+#endif
+#ifndef VICTRON_SCAN_MIN_ON_MS
+#define VICTRON_SCAN_MIN_ON_MS 500  // Shortest scan session (start/stop is not free)
+#endif
+#ifndef VICTRON_SCAN_LOST_MS
+#define VICTRON_SCAN_LOST_MS 30000  // No new data for this long -> probe only
+#endif
+#ifndef VICTRON_SCAN_PROBE_INTERVAL_MS
+#define VICTRON_SCAN_PROBE_INTERVAL_MS 30000
+#endif
+#ifndef VICTRON_SCAN_PROBE_MS
+#define VICTRON_SCAN_PROBE_MS 5000  // Probe window length for lost devices
+#endif
+
+class VictronScanScheduler {
+ public:
+  VictronScanScheduler();
+
+  // Start learning; every device is searched for until it is found or lost
+  void begin(unsigned long nowMs);
+
+  // Feed every record of a configured device after VictronDeviceStore::handleRecord()
+  void onRecord(uint8_t deviceIndex, VictronRecordResult result, uint16_t dataCounter,
+                unsigned long receivedAt);
+
+  // Whether the radio should be scanning now; report what it actually does via setScanning()
+  bool wantsScan(unsigned long nowMs);
+  void setScanning(bool scanning, unsigned long nowMs);
+  bool isScanning() const { return scanning; }
+  unsigned long getSessionStartMs() const { return sessionStartMs; }  // Current (or last) scan session
+
+  // Scan time in % since the previous call (or begin())
+  uint8_t takeDutyPercent(unsigned long nowMs);
+
+  // Time since the device's last new data counter; false if never received
+  bool getDataAge(uint8_t deviceIndex, unsigned long nowMs, uint32_t &ageMs) const;
+  uint32_t getCadenceMs(uint8_t deviceIndex) const { return devices[deviceIndex].cadenceMs; }
+  uint32_t getAdvPeriodMs(uint8_t deviceIndex) const { return devices[deviceIndex].advPeriodMs; }
+
+ private:
+  struct DeviceTiming {
+    bool seen;                  // At least one new data counter received
+    uint16_t lastCounter;
+    unsigned long lastNewMs;    // Receive time of the last new counter (begin() until seen)
+    unsigned long lastAdvMs;    // Last advertisement of any kind
+    uint32_t cadenceMs;         // EWMA of ms per counter step
+    uint32_t advPeriodMs;       // EWMA of ms between advertisements
+  };
+
+  DeviceTiming devices[VICTRON_DEVICE_COUNT];
+  bool scanning;
+  unsigned long sessionStartMs;
+  unsigned long probeStartMs;
+  bool probed;
+  unsigned long dutyStartMs;
+  unsigned long dutyOnMs;     // Scan time since dutyStartMs, up to the last state change
+  unsigned long dutyMarkMs;   // Last state change (or duty reset)
+
+  bool isLost(const DeviceTiming &device, unsigned long nowMs) const;
+  unsigned long wakeAt(const DeviceTiming &device) const;
+};
+
+#endif
@@ -1,6 +1,7 @@
 // Command Handler Implementation
 
 #include "CommandHandler.h"
+#include "LogStreamer.h"
 #include "VictronManager.h"
 #include <Arduino.h>
 
@@ -67,6 +68,18 @@ void CommandHandler::handleMQTTMessage(char *topic, byte *payload, unsigned int
       Serial.println("Force update command received");
     }
     forceUpdate();
+    mqttManager->expectStatus(String(MQTT_TOPIC_SENSORS) + MODULE_ID + "/status");  // Forced status closes the round trip
+  }
+
+  // History request/response: chunks follow on smartcamper/sensors/module-6/history
+  if (topicStr.endsWith("/history/query") && victronManager != nullptr) {
+    victronManager->handleHistoryQuery(message);
+    mqttManager->expectStatus(String(MQTT_TOPIC_SENSORS) + MODULE_ID + "/history");  // First chunk closes the round trip
+  }
+
+  // Runtime log stream level (e.g. {"level":"debug"})
+  if (topicStr.endsWith("/logs/level")) {
+    LogStreamer::handleLevelCommand(message);
   }
 }
 
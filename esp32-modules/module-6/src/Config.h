@@ -33,6 +33,24 @@
 #define BLE_SCAN_INTERVAL_MS 100
 #define BLE_SCAN_WINDOW_MS 100 // Full window = best capture; BLE starts after WiFi connect
 #define BLE_SCAN_BURST_SEC 5   // Non-blocking scan burst, restarted from loop when idle
+#define VICTRON_ADAPTIVE_SCAN true      // Scan only when new data is due (false = scan continuously)
+#define VICTRON_SCAN_TARGET_AGE_MS 4000 // Adaptive scan keeps each reading younger than this
+#define VICTRON_DIAGNOSTICS_PUBLISH_INTERVAL_MS 60000 // Per-device reception stats (diagnostics topic)
+#define VICTRON_RECORD_QUEUE_DEPTH 16 // BLE callback -> loop() ring (power of two)
+
+// Energy analytics (see VictronEnergyTracker.h) - smartcamper/sensors/module-6/analytics
+#define VICTRON_ANALYTICS_PUBLISH_INTERVAL_MS 10000 // Totals, hourly consumption and forecast
+#define BATTERY_CAPACITY_AH 200                     // House battery nominal capacity (time-to-empty/full)
+
+// History (see VictronHistory.h) - static RAM = blocks x (VICTRON_HISTORY_BLOCK_BYTES + 12)
+#define VICTRON_HISTORY_BLOCK_BYTES 256
+#define VICTRON_HISTORY_1S_BLOCKS 10      // 1 s samples, last 5 min (~6 B/point, one block of slack)
+#define VICTRON_HISTORY_1M_BLOCKS 56      // 1 min means, last 24 h (~9 B/point)
+#define VICTRON_HISTORY_1H_BLOCKS 40      // 1 h means, last 30 days (~13 B/point)
+#define VICTRON_HISTORY_CHUNK_POINTS 20   // Points per history/query response message (at most)
+#define VICTRON_HISTORY_CHUNK_MAX_BYTES 900  // JSON per chunk - 1024 B MQTT buffer minus topic and header
+#define VICTRON_HISTORY_CHUNK_INTERVAL_MS 50
+#define VICTRON_HISTORY_CHUNK_RETRIES 20  // Failed publishes of one chunk before the query is ended
 
 // AC charger (Blue Smart / Phoenix)
 #define AC_CHARGER_ENABLED true
@@ -68,4 +86,23 @@
 #define DEBUG_MQTT false
 #define DEBUG_VERBOSE false
 
+// Logging (see Logger.h) - levels above LOG_LEVEL are compiled out
+// 0=NONE, 1=ERROR, 2=WARN, 3=INFO, 4=DEBUG, 5=VERBOSE
+#define LOG_LEVEL LOG_LEVEL_INFO
+#define LOG_QUEUE_DEPTH 32  // Ring buffer line slots (power of two)
+#define LOG_LINE_MAX 128    // Max characters per log line
+#define LOG_STREAM_LEVEL LOG_LEVEL_WARN  // Initial level mirrored to smartcamper/logs/{module} (runtime: logs/level command)
+#define LOG_STREAM_INTERVAL_MS 1000       // Min time between log batch publishes
+#define LOG_STREAM_BATCH_BYTES 768        // Max payload bytes per log batch
+#define LOG_STREAM_BUFFER_SIZE 2048       // Log bytes buffered while waiting to publish
+
+// Command tracking (see CommandTracker.h) - optional "id" in command payloads
+#define COMMAND_ACK_TIMEOUT_MS 2000  // Ack without publish time if no status publish follows
+#define COMMAND_DEDUP_SIZE 16        // Recent command ids remembered for duplicate detection
+
+// Clock sync with the backend (see ClockSync.h) - adds "ts" (epoch ms) to JSON payloads
+#define CLOCK_SYNC_INTERVAL_MS 60000  // Time between sync bursts
+#define CLOCK_SYNC_SAMPLES 4          // Requests per burst (lowest round trip is used)
+#define CLOCK_SYNC_MAX_RTT_MS 250     // Discard samples with a slower round trip
+
 #endif
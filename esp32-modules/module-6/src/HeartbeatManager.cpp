@@ -3,6 +3,7 @@
 
 #include "HeartbeatManager.h"
 #include "MQTTManager.h"
+#include "ClockSync.h"
 #include <ArduinoJson.h>
 #include <WiFi.h>
 
@@ -85,11 +86,14 @@ void HeartbeatManager::sendHeartbeat() {
 
 String HeartbeatManager::buildHeartbeatPayload() {
   // Create JSON payload
-  StaticJsonDocument<256> doc;
+  StaticJsonDocument<384> doc;
   
   // Timestamp (milliseconds since boot, converted to seconds for consistency)
   doc["timestamp"] = millis() / 1000;
   
+  // Wall-clock time (epoch ms) once synced with the backend
+  ClockSync::addTimestamp(doc);
+  
   // Module identifier
   doc["moduleId"] = moduleId;
   
@@ -103,6 +107,16 @@ String HeartbeatManager::buildHeartbeatPayload() {
     doc["wifiRSSI"] = -999;  // Invalid value to indicate no WiFi
   }
   
+  // Clock sync quality
+  JsonObject clock = doc.createNestedObject("clock");
+  clock["synced"] = ClockSync::isSynced();
+  if (ClockSync::isSynced()) {
+    clock["rttUs"] = ClockSync::getLastRttMicros();
+    clock["errorUs"] = ClockSync::getLastErrorMicros();
+    clock["driftPpm"] = ClockSync::getDriftPpm();
+    clock["sinceSync"] = ClockSync::getSecondsSinceSync();
+  }
+  
   // Serialize to string
   String payload;
   serializeJson(doc, payload);
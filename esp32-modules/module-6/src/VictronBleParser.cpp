@@ -2,50 +2,64 @@
 
 #include "VictronBleParser.h"
 #include "mbedtls/aes.h"
+#include <cctype>
 #include <cmath>
 #include <cstring>
 
 BitReader::BitReader(const uint8_t *data, size_t dataLen)
     : data(data), dataLen(dataLen), cursor(0) {}
 
-bool BitReader::readBit() {
-  if (cursor >= dataLen * 8) {
-    return false;
+uint64_t BitReader::loadWindow(size_t byteIndex) const {
+  if (byteIndex + 8 <= dataLen) {
+    uint64_t window;
+    memcpy(&window, data + byteIndex, sizeof(window));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    window = __builtin_bswap64(window);
+#endif
+    return window;
   }
-  size_t byteIndex = cursor / 8;
-  uint8_t bitIndex = cursor % 8;
-  bool value = (data[byteIndex] >> bitIndex) & 0x01;
-  cursor++;
-  return value;
+
+  // Tail of the record: missing bytes read as zero
+  uint64_t window = 0;
+  for (size_t i = 0; byteIndex + i < dataLen && i < 8; i++) {
+    window |= (uint64_t)data[byteIndex + i] << (8 * i);
+  }
+  return window;
+}
+
+bool BitReader::readBit() {
+  return readUnsigned(1) != 0;
 }
 
 uint32_t BitReader::readUnsigned(uint8_t bitCount) {
-  uint32_t value = 0;
-  for (uint8_t i = 0; i < bitCount; i++) {
-    if (readBit()) {
-      value |= (1U << i);
-    }
+  if (bitCount == 0) {
+    return 0;
   }
-  return value;
+  if (bitCount > 32) {
+    bitCount = 32;
+  }
+
+  size_t byteIndex = cursor / 8;
+  uint8_t bitIndex = cursor % 8;
+  cursor += bitCount;
+
+  // bitIndex + bitCount <= 39, always inside the 64-bit window
+  uint64_t window = byteIndex < dataLen ? loadWindow(byteIndex) : 0;
+  uint32_t mask = bitCount == 32 ? 0xFFFFFFFFU : ((1U << bitCount) - 1);
+  return (uint32_t)(window >> bitIndex) & mask;
 }
 
 int32_t BitReader::readSigned(uint8_t bitCount) {
-  int32_t value = 0;
-  for (uint8_t i = 0; i < bitCount - 1; i++) {
-    if (readBit()) {
-      value |= (1 << i);
-    }
+  if (bitCount == 0) {
+    return 0;
   }
-  if (readBit()) {
-    value -= (1 << (bitCount - 1));
+  if (bitCount > 32) {
+    bitCount = 32;
   }
-  return value;
-}
 
-void BitReader::skip(uint8_t bitCount) {
-  for (uint8_t i = 0; i < bitCount; i++) {
-    readBit();
-  }
+  // Two's complement: move the sign bit to bit 31, then arithmetic shift back
+  uint8_t shift = 32 - bitCount;
+  return (int32_t)(readUnsigned(bitCount) << shift) >> shift;
 }
 
 bool parseHexKey(const char *hexKey, uint8_t *outKey) {
@@ -60,154 +74,160 @@ bool parseHexKey(const char *hexKey, uint8_t *outKey) {
   return true;
 }
 
+bool parseMacAddress(const char *mac, uint8_t *outMac) {
+  // "AA:BB:CC:DD:EE:FF" -> {0xAA, ..., 0xFF} (same byte order as BLEAddress::getNative())
+  if (mac == nullptr || strlen(mac) != 17) {
+    return false;
+  }
+
+  for (size_t i = 0; i < 6; i++) {
+    const char *octet = mac + i * 3;
+    if (!isxdigit((unsigned char)octet[0]) || !isxdigit((unsigned char)octet[1]) ||
+        (i < 5 && octet[2] != ':')) {
+      return false;
+    }
+    char byteStr[3] = {octet[0], octet[1], '\0'};
+    outMac[i] = (uint8_t)strtoul(byteStr, nullptr, 16);
+  }
+  return true;
+}
+
 bool isSupportedRecordType(uint8_t recordType) {
   return recordType == RECORD_BATTERY_MONITOR || recordType == RECORD_SOLAR_CHARGER ||
          recordType == RECORD_DCDC_CONVERTER || recordType == RECORD_ORION_XS ||
          recordType == RECORD_AC_CHARGER;
 }
 
-bool decryptVictronPayload(const uint8_t *key, const uint8_t *cipher, size_t cipherLen,
-                           uint8_t counterLsb, uint8_t counterMsb, uint8_t *plainOut) {
-  if (cipherLen == 0 || cipherLen > 16) {
-    return false;
-  }
-
-  mbedtls_aes_context aes;
+VictronCipher::VictronCipher() : ready(false) {
   mbedtls_aes_init(&aes);
+}
 
-  if (mbedtls_aes_setkey_enc(&aes, key, 128) != 0) {
-    mbedtls_aes_free(&aes);
-    return false;
-  }
-
-  uint8_t nonce[16] = {counterLsb, counterMsb, 0};
-  size_t ncOffset = 0;
-  uint8_t streamBlock[16];
-
-  int result = mbedtls_aes_crypt_ctr(&aes, cipherLen, &ncOffset, nonce, streamBlock, cipher,
-                                     plainOut);
+VictronCipher::~VictronCipher() {
   mbedtls_aes_free(&aes);
-  return result == 0;
 }
 
-bool parseBatteryMonitor(const uint8_t *payload, size_t payloadLen, SmartShuntReading &out) {
-  BitReader reader(payload, payloadLen);
-
-  uint16_t timeToGo = (uint16_t)reader.readUnsigned(16);
-  int16_t voltageRaw = (int16_t)reader.readSigned(16);
-  uint16_t alarmReason = (uint16_t)reader.readUnsigned(16);
-
-  reader.skip(16);
-
-  reader.readUnsigned(2);
-  uint32_t currentRawU = reader.readUnsigned(22);
-  uint32_t consumedRaw = reader.readUnsigned(20);
-  uint16_t socRaw = (uint16_t)reader.readUnsigned(10);
-
-  out.timeToGoValid = timeToGo != 0xFFFF;
-  out.timeToGoMin = timeToGo;
-
-  out.voltageValid = voltageRaw != 0x7FFF;
-  out.voltage = roundTo1Decimal(voltageRaw * 0.01f);
-
-  out.alarmReason = alarmReason;
+bool VictronCipher::setKey(const uint8_t *key) {
+  ready = mbedtls_aes_setkey_enc(&aes, key, 128) == 0;
+  return ready;
+}
 
-  out.currentValid = currentRawU != 0x3FFFFF;
-  if (out.currentValid) {
-    int32_t currentRaw = (int32_t)currentRawU;
-    if (currentRawU & (1U << 21)) {
-      currentRaw = (int32_t)(currentRawU | (~0U << 22));
-    }
-    out.current = roundTo2Decimals(currentRaw * 0.001f);
+bool VictronCipher::decrypt(const uint8_t *cipher, size_t cipherLen, uint8_t counterLsb,
+                            uint8_t counterMsb, uint8_t *plainOut) {
+  if (!ready || cipherLen == 0 || cipherLen > 16) {
+    return false;
   }
 
-  out.socValid = socRaw != 0x3FF;
-  out.soc = (int)lroundf(socRaw * 0.1f);
-
-  out.consumedAhValid = consumedRaw != 0xFFFFF;
-  out.consumedAh = roundTo1Decimal(consumedRaw * -0.1f);
+  // CTR keystream for the first (only) block: AES(nonce), nonce = counter LE + zeros
+  uint8_t nonce[16] = {counterLsb, counterMsb, 0};
+  uint8_t streamBlock[16];
+  if (mbedtls_aes_crypt_ecb(&aes, MBEDTLS_AES_ENCRYPT, nonce, streamBlock) != 0) {
+    return false;
+  }
 
+  for (size_t i = 0; i < cipherLen; i++) {
+    plainOut[i] = cipher[i] ^ streamBlock[i];
+  }
   return true;
 }
 
-bool parseSolarCharger(const uint8_t *payload, size_t payloadLen, MpptReading &out) {
-  BitReader reader(payload, payloadLen);
-
-  out.deviceState = (uint8_t)reader.readUnsigned(8);
-  out.errorCode = (uint8_t)reader.readUnsigned(8);
-
-  int16_t batteryVoltageRaw = (int16_t)reader.readSigned(16);
-  int16_t batteryCurrentRaw = (int16_t)reader.readSigned(16);
-  uint16_t yieldTodayRaw = (uint16_t)reader.readUnsigned(16);
-  uint16_t pvPowerRaw = (uint16_t)reader.readUnsigned(16);
+// Record layouts (Victron "extra manufacturer data" specification), in bit order
+
+typedef VictronField<SmartShuntReading> ShuntField;
+static constexpr ShuntField BATTERY_MONITOR_LAYOUT[] = {
+    ShuntField::value(FIELD_UNSIGNED, 16, 0xFFFF, 1.0f, ROUND_NONE, &SmartShuntReading::timeToGoMin,
+                      &SmartShuntReading::timeToGoValid),
+    ShuntField::value(FIELD_SIGNED, 16, 0x7FFF, 0.01f, ROUND_1_DECIMAL, &SmartShuntReading::voltage,
+                      &SmartShuntReading::voltageValid),
+    ShuntField::raw(16, &SmartShuntReading::alarmReason),
+    ShuntField::skip(16),  // Aux input value (meaning depends on the aux type below)
+    ShuntField::skip(2),   // Aux input type
+    ShuntField::value(FIELD_SIGNED, 22, 0x3FFFFF, 0.001f, ROUND_2_DECIMALS, &SmartShuntReading::current,
+                      &SmartShuntReading::currentValid),
+    ShuntField::value(FIELD_UNSIGNED, 20, 0xFFFFF, -0.1f, ROUND_1_DECIMAL, &SmartShuntReading::consumedAh,
+                      &SmartShuntReading::consumedAhValid),
+    ShuntField::value(FIELD_UNSIGNED, 10, 0x3FF, 0.1f, ROUND_TO_INT, &SmartShuntReading::soc,
+                      &SmartShuntReading::socValid),
+};
+
+typedef VictronField<MpptReading> MpptField;
+static constexpr MpptField SOLAR_CHARGER_LAYOUT[] = {
+    MpptField::raw(8, &MpptReading::deviceState),
+    MpptField::raw(8, &MpptReading::errorCode),
+    MpptField::value(FIELD_SIGNED, 16, 0x7FFF, 0.01f, ROUND_1_DECIMAL, &MpptReading::batteryVoltage,
+                     &MpptReading::batteryVoltageValid),
+    MpptField::value(FIELD_SIGNED, 16, 0x7FFF, 0.1f, ROUND_2_DECIMALS, &MpptReading::batteryCurrent,
+                     &MpptReading::batteryCurrentValid),
+    MpptField::value(FIELD_UNSIGNED, 16, 0xFFFF, 0.01f, ROUND_2_DECIMALS, &MpptReading::yieldTodayKwh,
+                     &MpptReading::yieldTodayValid),
+    MpptField::value(FIELD_UNSIGNED, 16, 0xFFFF, 1.0f, ROUND_NONE, &MpptReading::pvPower,
+                     &MpptReading::pvPowerValid),
+    MpptField::skip(9),  // Load current
+};
+
+typedef VictronField<OrionReading> OrionField;
+static constexpr OrionField ORION_XS_LAYOUT[] = {
+    OrionField::raw(8, &OrionReading::deviceState),
+    OrionField::raw(8, &OrionReading::errorCode),
+    OrionField::value(FIELD_SIGNED, 16, 0x7FFF, 0.01f, ROUND_1_DECIMAL, &OrionReading::outputVoltage,
+                      &OrionReading::outputVoltageValid),
+    OrionField::value(FIELD_SIGNED, 16, 0x7FFF, 0.1f, ROUND_2_DECIMALS, &OrionReading::outputCurrent,
+                      &OrionReading::outputCurrentValid),
+    OrionField::value(FIELD_UNSIGNED, 16, 0xFFFF, 0.01f, ROUND_1_DECIMAL, &OrionReading::inputVoltage,
+                      &OrionReading::inputVoltageValid),
+    OrionField::value(FIELD_UNSIGNED, 16, 0xFFFF, 0.1f, ROUND_2_DECIMALS, &OrionReading::inputCurrent,
+                      &OrionReading::inputCurrentValid),
+    OrionField::raw(32, &OrionReading::offReason),
+};
+
+// Same reading struct as the Orion XS; currents are not in this record
+static constexpr OrionField DCDC_CONVERTER_LAYOUT[] = {
+    OrionField::raw(8, &OrionReading::deviceState),
+    OrionField::raw(8, &OrionReading::errorCode),
+    OrionField::value(FIELD_UNSIGNED, 16, 0xFFFF, 0.01f, ROUND_1_DECIMAL, &OrionReading::inputVoltage,
+                      &OrionReading::inputVoltageValid),
+    OrionField::value(FIELD_SIGNED, 16, 0x7FFF, 0.01f, ROUND_1_DECIMAL, &OrionReading::outputVoltage,
+                      &OrionReading::outputVoltageValid),
+    OrionField::raw(32, &OrionReading::offReason),
+};
+
+typedef VictronField<AcChargerReading> AcField;
+static constexpr AcField AC_CHARGER_LAYOUT[] = {
+    AcField::raw(8, &AcChargerReading::deviceState),
+    AcField::raw(8, &AcChargerReading::errorCode),
+    AcField::value(FIELD_UNSIGNED, 13, 0x1FFF, 0.01f, ROUND_1_DECIMAL, &AcChargerReading::voltage,
+                   &AcChargerReading::voltageValid),
+    AcField::value(FIELD_UNSIGNED, 11, 0x7FF, 0.1f, ROUND_2_DECIMALS, &AcChargerReading::current,
+                   &AcChargerReading::currentValid),
+    AcField::skip(13 + 11 + 13 + 11 + 13 + 11 + 7),  // Further outputs and temperature
+    AcField::value(FIELD_UNSIGNED, 9, 0x1FF, 0.1f, ROUND_2_DECIMALS, &AcChargerReading::acCurrent,
+                   &AcChargerReading::acCurrentValid),
+};
+
+#define LAYOUT_COUNT(layout) (sizeof(layout) / sizeof((layout)[0]))
 
-  reader.readUnsigned(9);
-
-  out.batteryVoltageValid = batteryVoltageRaw != 0x7FFF;
-  out.batteryVoltage = roundTo1Decimal(batteryVoltageRaw * 0.01f);
-
-  out.batteryCurrentValid = batteryCurrentRaw != 0x7FFF;
-  out.batteryCurrent = roundTo2Decimals(batteryCurrentRaw * 0.1f);
-
-  out.yieldTodayValid = yieldTodayRaw != 0xFFFF;
-  out.yieldTodayKwh = roundTo2Decimals(yieldTodayRaw * 0.01f);
-
-  out.pvPowerValid = pvPowerRaw != 0xFFFF;
-  out.pvPower = pvPowerRaw;
+bool parseBatteryMonitor(const uint8_t *payload, size_t payloadLen, SmartShuntReading &out) {
+  return decodeVictronRecord<SmartShuntReading, BATTERY_MONITOR_LAYOUT, LAYOUT_COUNT(BATTERY_MONITOR_LAYOUT)>(
+      payload, payloadLen, out);
+}
 
-  return true;
+bool parseSolarCharger(const uint8_t *payload, size_t payloadLen, MpptReading &out) {
+  return decodeVictronRecord<MpptReading, SOLAR_CHARGER_LAYOUT, LAYOUT_COUNT(SOLAR_CHARGER_LAYOUT)>(
+      payload, payloadLen, out);
 }
 
 bool parseOrionXs(const uint8_t *payload, size_t payloadLen, OrionReading &out) {
-  BitReader reader(payload, payloadLen);
-
-  out.deviceState = (uint8_t)reader.readUnsigned(8);
-  out.errorCode = (uint8_t)reader.readUnsigned(8);
-
-  int16_t outputVoltageRaw = (int16_t)reader.readSigned(16);
-  int16_t outputCurrentRaw = (int16_t)reader.readSigned(16);
-  uint16_t inputVoltageRaw = (uint16_t)reader.readUnsigned(16);
-  uint16_t inputCurrentRaw = (uint16_t)reader.readUnsigned(16);
-  out.offReason = reader.readUnsigned(32);
-
-  out.outputVoltageValid = outputVoltageRaw != 0x7FFF;
-  out.outputVoltage = roundTo1Decimal(outputVoltageRaw * 0.01f);
-
-  out.outputCurrentValid = outputCurrentRaw != 0x7FFF;
-  out.outputCurrent = roundTo2Decimals(outputCurrentRaw * 0.1f);
-
-  out.inputVoltageValid = inputVoltageRaw != 0xFFFF;
-  out.inputVoltage = roundTo1Decimal(inputVoltageRaw * 0.01f);
-
-  out.inputCurrentValid = inputCurrentRaw != 0xFFFF;
-  out.inputCurrent = roundTo2Decimals(inputCurrentRaw * 0.1f);
+  return decodeVictronRecord<OrionReading, ORION_XS_LAYOUT, LAYOUT_COUNT(ORION_XS_LAYOUT)>(payload, payloadLen,
+                                                                                           out);
+}
 
-  return true;
+bool parseDcdcConverter(const uint8_t *payload, size_t payloadLen, OrionReading &out) {
+  return decodeVictronRecord<OrionReading, DCDC_CONVERTER_LAYOUT, LAYOUT_COUNT(DCDC_CONVERTER_LAYOUT)>(
+      payload, payloadLen, out);
 }
 
 bool parseAcCharger(const uint8_t *payload, size_t payloadLen, AcChargerReading &out) {
-  BitReader reader(payload, payloadLen);
-
-  out.deviceState = (uint8_t)reader.readUnsigned(8);
-  out.errorCode = (uint8_t)reader.readUnsigned(8);
-
-  uint32_t voltageRaw = reader.readUnsigned(13);
-  uint32_t currentRaw = reader.readUnsigned(11);
-
-  reader.skip(13 + 11 + 13 + 11 + 13 + 11 + 7);
-
-  uint32_t acCurrentRaw = reader.readUnsigned(9);
-
-  out.voltageValid = voltageRaw != 0x1FFF;
-  out.voltage = roundTo1Decimal(voltageRaw * 0.01f);
-
-  out.currentValid = currentRaw != 0x7FF;
-  out.current = roundTo2Decimals(currentRaw * 0.1f);
-
-  out.acCurrentValid = acCurrentRaw != 0x1FF;
-  out.acCurrent = roundTo2Decimals(acCurrentRaw * 0.1f);
-
-  return true;
+  return decodeVictronRecord<AcChargerReading, AC_CHARGER_LAYOUT, LAYOUT_COUNT(AC_CHARGER_LAYOUT)>(
+      payload, payloadLen, out);
 }
 
 float roundTo1Decimal(float value) {
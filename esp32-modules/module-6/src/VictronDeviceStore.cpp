@@ -0,0 +1,461 @@
+// Victron Device Store Implementation
+
+#include "VictronDeviceStore.h"
+#include <cstring>
+
+static const uint8_t VICTRON_MAC_SLOT_EMPTY = 0xFF;
+static_assert(VICTRON_MAC_TABLE_SIZE >= 2 * VICTRON_DEVICE_COUNT, "MAC table too small");
+
+static VictronRecordResult reject(VictronRejectReason *reason, VictronRejectReason why) {
+  if (reason != nullptr) {
+    *reason = why;
+  }
+  return VICTRON_RECORD_REJECTED;
+}
+
+// Record types the parser for each role accepts (see handleParsedPayload)
+static bool roleAcceptsRecord(VictronDeviceRole role, uint8_t recordType) {
+  switch (role) {
+    case ROLE_SMARTSHUNT:
+      return recordType == RECORD_BATTERY_MONITOR;
+    case ROLE_MPPT1:
+    case ROLE_MPPT2:
+      return recordType == RECORD_SOLAR_CHARGER;
+    case ROLE_ORION:
+      return recordType == RECORD_ORION_XS || recordType == RECORD_DCDC_CONVERTER;
+    case ROLE_AC_CHARGER:
+      return recordType == RECORD_AC_CHARGER;
+    default:
+      return false;
+  }
+}
+
+static size_t macSlot(const uint8_t *mac) {
+  // Low octets carry the per-device randomness; mix them into a slot index
+  uint32_t hash = ((uint32_t)mac[3] << 16) ^ ((uint32_t)mac[4] << 8) ^ mac[5];
+  hash *= 2654435761u;
+  return (hash >> 16) & (VICTRON_MAC_TABLE_SIZE - 1);
+}
+
+VictronDeviceStore::VictronDeviceStore()
+    : smartShuntCache{false, {}, 0},
+      mppt1Cache{false, {}, 0},
+      mppt2Cache{false, {}, 0},
+      orionCache{false, {}, 0},
+      acChargerCache{false, {}, 0} {
+  memset(macTable, VICTRON_MAC_SLOT_EMPTY, sizeof(macTable));
+}
+
+bool VictronDeviceStore::begin() {
+  struct DeviceEntry {
+    const char *name;
+    const char *mac;
+    const char *key;
+    VictronDeviceRole role;
+  };
+
+  const DeviceEntry entries[VICTRON_DEVICE_COUNT] = {
+      {VICTRON_DEVICE_0_NAME, VICTRON_DEVICE_0_MAC, VICTRON_DEVICE_0_KEY, ROLE_SMARTSHUNT},
+      {VICTRON_DEVICE_1_NAME, VICTRON_DEVICE_1_MAC, VICTRON_DEVICE_1_KEY, ROLE_ORION},
+      {VICTRON_DEVICE_2_NAME, VICTRON_DEVICE_2_MAC, VICTRON_DEVICE_2_KEY, ROLE_MPPT1},
+      {VICTRON_DEVICE_3_NAME, VICTRON_DEVICE_3_MAC, VICTRON_DEVICE_3_KEY, ROLE_MPPT2},
+#if AC_CHARGER_ENABLED
+      {"ACCharger", AC_CHARGER_MAC, AC_CHARGER_KEY, ROLE_AC_CHARGER},
+#endif
+  };
+
+  memset(macTable, VICTRON_MAC_SLOT_EMPTY, sizeof(macTable));
+
+  for (size_t i = 0; i < VICTRON_DEVICE_COUNT; i++) {
+    devices[i].name = entries[i].name;
+    devices[i].mac = entries[i].mac;
+    devices[i].role = entries[i].role;
+    devices[i].lastDataCounter = 0xFFFF;
+    devices[i].configured =
+        parseHexKey(entries[i].key, devices[i].key) && devices[i].cipher.setKey(devices[i].key);
+
+    if (!parseMacAddress(entries[i].mac, devices[i].macBytes) || !insertMac((uint8_t)i)) {
+      if (DEBUG_SERIAL) {
+        Serial.print("ERROR: Invalid MAC for ");
+        Serial.println(entries[i].name);
+      }
+      return false;
+    }
+
+    if (!devices[i].configured) {
+      if (DEBUG_SERIAL) {
+        Serial.print("ERROR: Invalid key for ");
+        Serial.println(entries[i].name);
+      }
+      return false;
+    }
+
+    if (DEBUG_SERIAL) {
+      Serial.print("Configured Victron device: ");
+      Serial.print(entries[i].name);
+      Serial.print(" (");
+      Serial.print(entries[i].mac);
+      Serial.println(")");
+    }
+  }
+
+  return true;
+}
+
+bool VictronDeviceStore::insertMac(uint8_t deviceIndex) {
+  size_t slot = macSlot(devices[deviceIndex].macBytes);
+  for (size_t probe = 0; probe < VICTRON_MAC_TABLE_SIZE; probe++) {
+    if (macTable[slot] == VICTRON_MAC_SLOT_EMPTY) {
+      macTable[slot] = deviceIndex;
+      return true;
+    }
+    slot = (slot + 1) & (VICTRON_MAC_TABLE_SIZE - 1);
+  }
+  return false;
+}
+
+// Called for every advertisement seen (including unrelated devices), so no
+// allocation or string parsing here: hash the native address and probe
+int VictronDeviceStore::findDevice(const uint8_t *mac) const {
+  size_t slot = macSlot(mac);
+  for (size_t probe = 0; probe < VICTRON_MAC_TABLE_SIZE; probe++) {
+    uint8_t index = macTable[slot];
+    if (index == VICTRON_MAC_SLOT_EMPTY) {
+      return -1;
+    }
+    if (memcmp(devices[index].macBytes, mac, 6) == 0) {
+      return devices[index].configured ? index : -1;
+    }
+    slot = (slot + 1) & (VICTRON_MAC_TABLE_SIZE - 1);
+  }
+  return -1;
+}
+
+void VictronDeviceStore::touchDeviceCache(VictronDeviceRole role, unsigned long nowMs) {
+  switch (role) {
+    case ROLE_SMARTSHUNT:
+      if (smartShuntCache.hasData) {
+        smartShuntCache.updatedAt = nowMs;
+      }
+      break;
+    case ROLE_MPPT1:
+      if (mppt1Cache.hasData) {
+        mppt1Cache.updatedAt = nowMs;
+      }
+      break;
+    case ROLE_MPPT2:
+      if (mppt2Cache.hasData) {
+        mppt2Cache.updatedAt = nowMs;
+      }
+      break;
+    case ROLE_ORION:
+      if (orionCache.hasData) {
+        orionCache.updatedAt = nowMs;
+      }
+      break;
+    case ROLE_AC_CHARGER:
+      if (acChargerCache.hasData) {
+        acChargerCache.updatedAt = nowMs;
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+bool VictronDeviceStore::handleParsedPayload(DeviceConfig &device, uint8_t recordType,
+                                             const uint8_t *plain, size_t plainLen,
+                                             unsigned long nowMs) {
+  switch (device.role) {
+    case ROLE_SMARTSHUNT:
+      if (recordType != RECORD_BATTERY_MONITOR) {
+        return false;
+      }
+      {
+        SmartShuntReading reading;
+        if (!parseBatteryMonitor(plain, plainLen, reading)) {
+          return false;
+        }
+        smartShuntCache = {true, reading, nowMs};
+      }
+      return true;
+
+    case ROLE_MPPT1:
+    case ROLE_MPPT2:
+      if (recordType != RECORD_SOLAR_CHARGER) {
+        return false;
+      }
+      {
+        MpptReading reading;
+        if (!parseSolarCharger(plain, plainLen, reading)) {
+          return false;
+        }
+        Cached<MpptReading> &cache = device.role == ROLE_MPPT1 ? mppt1Cache : mppt2Cache;
+        cache = {true, reading, nowMs};
+      }
+      return true;
+
+    case ROLE_ORION:
+      if (recordType != RECORD_ORION_XS && recordType != RECORD_DCDC_CONVERTER) {
+        return false;
+      }
+      {
+        // Older Orion Smart units advertise the generic DC/DC converter record
+        OrionReading reading;
+        bool parsed = recordType == RECORD_ORION_XS ? parseOrionXs(plain, plainLen, reading)
+                                                    : parseDcdcConverter(plain, plainLen, reading);
+        if (!parsed) {
+          return false;
+        }
+        orionCache = {true, reading, nowMs};
+      }
+      return true;
+
+    case ROLE_AC_CHARGER:
+      if (recordType != RECORD_AC_CHARGER) {
+        return false;
+      }
+      {
+        AcChargerReading reading;
+        if (!parseAcCharger(plain, plainLen, reading)) {
+          return false;
+        }
+        acChargerCache = {true, reading, nowMs};
+      }
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+VictronRecordResult VictronDeviceStore::handleRecord(const VictronRawRecord &raw, VictronRejectReason *reason) {
+  if (reason != nullptr) {
+    *reason = VICTRON_REJECT_NONE;
+  }
+  if (raw.deviceIndex >= VICTRON_DEVICE_COUNT || raw.len < 10) {
+    return reject(reason, VICTRON_REJECT_FORMAT);
+  }
+  DeviceConfig &device = devices[raw.deviceIndex];
+
+  uint16_t vendorId = raw.data[0] | ((uint16_t)raw.data[1] << 8);
+  if (vendorId != VICTRON_VENDOR_ID) {
+    return reject(reason, VICTRON_REJECT_FORMAT);
+  }
+
+  const uint8_t *record = raw.data + 2;
+  size_t recordLen = raw.len - 2;
+
+  if (recordLen < 8 || record[0] != VICTRON_BEACON_TYPE) {
+    return reject(reason, VICTRON_REJECT_FORMAT);
+  }
+
+  if (record[7] != device.key[0]) {
+    return reject(reason, VICTRON_REJECT_KEY);
+  }
+
+  uint8_t recordType = record[4];
+  if (!roleAcceptsRecord(device.role, recordType)) {
+    return reject(reason, VICTRON_REJECT_RECORD_TYPE);
+  }
+
+  uint16_t dataCounter = record[5] | ((uint16_t)record[6] << 8);
+  if (dataCounter == device.lastDataCounter) {
+    touchDeviceCache(device.role, raw.receivedAt);
+    return VICTRON_RECORD_DUPLICATE;
+  }
+
+  const uint8_t *cipher = record + 8;
+  size_t cipherLen = recordLen - 8;
+  if (cipherLen == 0 || cipherLen > 16) {
+    return reject(reason, VICTRON_REJECT_DECRYPT);
+  }
+
+  uint8_t plain[16] = {0};
+  if (!device.cipher.decrypt(cipher, cipherLen, record[5], record[6], plain)) {
+    return reject(reason, VICTRON_REJECT_DECRYPT);
+  }
+
+  if (!handleParsedPayload(device, recordType, plain, cipherLen, raw.receivedAt)) {
+    return reject(reason, VICTRON_REJECT_PARSE);
+  }
+
+  device.lastDataCounter = dataCounter;
+
+  if (DEBUG_VERBOSE && DEBUG_SERIAL) {
+    Serial.print("Updated ");
+    Serial.println(device.name);
+  }
+  return VICTRON_RECORD_UPDATED;
+}
+
+bool VictronDeviceStore::hasData(VictronDeviceRole role) const {
+  switch (role) {
+    case ROLE_SMARTSHUNT:
+      return smartShuntCache.hasData;
+    case ROLE_MPPT1:
+      return mppt1Cache.hasData;
+    case ROLE_MPPT2:
+      return mppt2Cache.hasData;
+    case ROLE_ORION:
+      return orionCache.hasData;
+    case ROLE_AC_CHARGER:
+      return acChargerCache.hasData;
+    default:
+      return false;
+  }
+}
+
+unsigned long VictronDeviceStore::getUpdatedAt(VictronDeviceRole role) const {
+  switch (role) {
+    case ROLE_SMARTSHUNT:
+      return smartShuntCache.updatedAt;
+    case ROLE_MPPT1:
+      return mppt1Cache.updatedAt;
+    case ROLE_MPPT2:
+      return mppt2Cache.updatedAt;
+    case ROLE_ORION:
+      return orionCache.updatedAt;
+    case ROLE_AC_CHARGER:
+      return acChargerCache.updatedAt;
+    default:
+      return 0;
+  }
+}
+
+const SmartShuntReading *VictronDeviceStore::getSmartShunt() const {
+  return smartShuntCache.hasData ? &smartShuntCache.reading : nullptr;
+}
+
+const MpptReading *VictronDeviceStore::getMppt(uint8_t index) const {
+  const Cached<MpptReading> &cache = index == 0 ? mppt1Cache : mppt2Cache;
+  return cache.hasData ? &cache.reading : nullptr;
+}
+
+const OrionReading *VictronDeviceStore::getOrion() const {
+  return orionCache.hasData ? &orionCache.reading : nullptr;
+}
+
+const AcChargerReading *VictronDeviceStore::getAcCharger() const {
+  return acChargerCache.hasData ? &acChargerCache.reading : nullptr;
+}
+
+void VictronDeviceStore::appendStatusJson(JsonDocument &doc) const {
+  appendSmartShuntJson(doc);
+  appendMpptJson(doc, "mppt1", mppt1Cache);
+  appendMpptJson(doc, "mppt2", mppt2Cache);
+  appendOrionJson(doc);
+  appendAcChargerJson(doc);
+}
+
+void VictronDeviceStore::appendSmartShuntJson(JsonDocument &doc) const {
+  if (!smartShuntCache.hasData) {
+    doc["smartshunt"] = nullptr;
+    return;
+  }
+
+  JsonObject obj = doc.createNestedObject("smartshunt");
+  const SmartShuntReading &r = smartShuntCache.reading;
+
+  if (r.voltageValid) {
+    obj["voltage"] = roundTo1Decimal(r.voltage);
+  }
+  if (r.currentValid) {
+    obj["current"] = roundTo2Decimals(r.current);
+  }
+  if (r.socValid) {
+    obj["soc"] = r.soc;
+  }
+  if (r.consumedAhValid) {
+    obj["consumedAh"] = roundTo1Decimal(r.consumedAh);
+  }
+  if (r.timeToGoValid) {
+    obj["timeToGoMin"] = r.timeToGoMin;
+  } else {
+    obj["timeToGoMin"] = nullptr;
+  }
+  obj["alarmReason"] = r.alarmReason;
+  obj["updatedAt"] = smartShuntCache.updatedAt;
+}
+
+void VictronDeviceStore::appendMpptJson(JsonDocument &doc, const char *key,
+                                        const Cached<MpptReading> &cache) const {
+  if (!cache.hasData) {
+    doc[key] = nullptr;
+    return;
+  }
+
+  JsonObject obj = doc.createNestedObject(key);
+  const MpptReading &r = cache.reading;
+
+  obj["deviceState"] = r.deviceState;
+  obj["errorCode"] = r.errorCode;
+  if (r.batteryVoltageValid) {
+    obj["batteryVoltage"] = roundTo1Decimal(r.batteryVoltage);
+  }
+  if (r.batteryCurrentValid) {
+    obj["batteryCurrent"] = roundTo2Decimals(r.batteryCurrent);
+  }
+  if (r.pvPowerValid) {
+    obj["pvPower"] = r.pvPower;
+  }
+  if (r.yieldTodayValid) {
+    obj["yieldTodayKwh"] = roundTo2Decimals(r.yieldTodayKwh);
+  }
+  obj["updatedAt"] = cache.updatedAt;
+}
+
+void VictronDeviceStore::appendOrionJson(JsonDocument &doc) const {
+  if (!orionCache.hasData) {
+    doc["orion"] = nullptr;
+    return;
+  }
+
+  JsonObject obj = doc.createNestedObject("orion");
+  const OrionReading &r = orionCache.reading;
+
+  obj["deviceState"] = r.deviceState;
+  obj["errorCode"] = r.errorCode;
+  if (r.outputVoltageValid) {
+    obj["outputVoltage"] = roundTo1Decimal(r.outputVoltage);
+  }
+  if (r.outputCurrentValid) {
+    obj["outputCurrent"] = roundTo2Decimals(r.outputCurrent);
+  }
+  if (r.inputVoltageValid) {
+    obj["inputVoltage"] = roundTo1Decimal(r.inputVoltage);
+  }
+  if (r.inputCurrentValid) {
+    obj["inputCurrent"] = roundTo2Decimals(r.inputCurrent);
+  }
+  obj["offReason"] = r.offReason;
+  obj["updatedAt"] = orionCache.updatedAt;
+}
+
+void VictronDeviceStore::appendAcChargerJson(JsonDocument &doc) const {
+#if !AC_CHARGER_ENABLED
+  doc["acCharger"] = nullptr;
+  return;
+#else
+  if (!acChargerCache.hasData) {
+    doc["acCharger"] = nullptr;
+    return;
+  }
+
+  JsonObject obj = doc.createNestedObject("acCharger");
+  const AcChargerReading &r = acChargerCache.reading;
+
+  obj["deviceState"] = r.deviceState;
+  obj["errorCode"] = r.errorCode;
+  if (r.voltageValid) {
+    obj["voltage"] = roundTo1Decimal(r.voltage);
+  }
+  if (r.currentValid) {
+    obj["current"] = roundTo2Decimals(r.current);
+  }
+  if (r.acCurrentValid) {
+    obj["acCurrent"] = roundTo2Decimals(r.acCurrent);
+  }
+  obj["updatedAt"] = acChargerCache.updatedAt;
+#endif
+}
@@ -0,0 +1,290 @@
+// Victron Energy Tracker Implementation
+
+#include "VictronEnergyTracker.h"
+#include <cstring>
+
+static const uint64_t HOUR_MS = 3600000ULL;
+static const float MJ_PER_WH = 3600000.0f;
+static const float MAMS_PER_AH = 3600000000.0f;  // mA x ms
+
+// Keep regression coordinates small enough for exact int64 sums
+static const int64_t REGRESSION_REBASE_LIMIT = 1L << 20;
+
+static float mjToWh(int64_t mj) { return roundTo1Decimal((float)mj / MJ_PER_WH); }
+
+int64_t VictronIntegrator::add(float value, unsigned long nowMs) {
+  int64_t increment = 0;
+  if (hasLast && nowMs - lastMs <= VICTRON_ENERGY_MAX_GAP_MS) {
+    increment = (int64_t)lroundf((lastValue + value) * 0.5f * (float)(nowMs - lastMs));
+  }
+  hasLast = true;
+  lastValue = value;
+  lastMs = nowMs;
+  return increment;
+}
+
+VictronRollingRegression::VictronRollingRegression() { reset(); }
+
+void VictronRollingRegression::reset() {
+  head = 0;
+  count = 0;
+  originT = 0;
+  originY = 0;
+  sumT = sumY = sumTT = sumTY = 0;
+}
+
+void VictronRollingRegression::add(int64_t t, int64_t y) {
+  if (count == 0) {
+    originT = t;
+    originY = y;
+  }
+
+  int64_t relT = t - originT;
+  int64_t relY = y - originY;
+  if (relT > REGRESSION_REBASE_LIMIT || relY > REGRESSION_REBASE_LIMIT || relY < -REGRESSION_REBASE_LIMIT) {
+    rebase();
+    relT = t - originT;
+    relY = y - originY;
+  }
+
+  size_t slot;
+  if (count == VICTRON_FORECAST_WINDOW) {
+    int64_t oldT = ts[head];
+    int64_t oldY = ys[head];
+    sumT -= oldT;
+    sumY -= oldY;
+    sumTT -= oldT * oldT;
+    sumTY -= oldT * oldY;
+    slot = head;
+    head = (uint8_t)((head + 1) % VICTRON_FORECAST_WINDOW);
+  } else {
+    slot = (head + count) % VICTRON_FORECAST_WINDOW;
+    count++;
+  }
+
+  ts[slot] = (int32_t)relT;
+  ys[slot] = (int32_t)relY;
+  sumT += relT;
+  sumY += relY;
+  sumTT += relT * relT;
+  sumTY += relT * relY;
+}
+
+// Move the origin to the oldest point (rare: every ~12 days of samples)
+void VictronRollingRegression::rebase() {
+  int32_t dt = ts[head];
+  int32_t dy = ys[head];
+  originT += dt;
+  originY += dy;
+
+  sumT = sumY = sumTT = sumTY = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    size_t slot = (head + i) % VICTRON_FORECAST_WINDOW;
+    ts[slot] -= dt;
+    ys[slot] -= dy;
+    sumT += ts[slot];
+    sumY += ys[slot];
+    sumTT += (int64_t)ts[slot] * ts[slot];
+    sumTY += (int64_t)ts[slot] * ys[slot];
+  }
+}
+
+int32_t VictronRollingRegression::getSpan() const {
+  if (count < 2) {
+    return 0;
+  }
+  return ts[(head + count - 1) % VICTRON_FORECAST_WINDOW] - ts[head];
+}
+
+bool VictronRollingRegression::getSlope(float &slope) const {
+  int64_t denominator = (int64_t)count * sumTT - sumT * sumT;
+  if (count < 2 || denominator == 0) {
+    return false;
+  }
+  int64_t numerator = (int64_t)count * sumTY - sumT * sumY;
+  slope = (float)numerator / (float)denominator;
+  return true;
+}
+
+VictronEnergyTracker::VictronEnergyTracker()
+    : clockStarted(false),
+      lastAdvanceMs(0),
+      clockMs(0),
+      batteryInMj(0),
+      batteryOutMj(0),
+      batteryNetMams(0),
+      hourHead(0),
+      completedHours(0),
+      hourStartMs(0),
+      currentHour{0, 0},
+      lastDay{0, 0},
+      lastShuntMs(0),
+      hasShuntSample(false),
+      lastForecastSampleMs(0),
+      socValid(false),
+      soc(0) {
+  solarMj[0] = solarMj[1] = 0;
+  memset(hours, 0, sizeof(hours));
+}
+
+void VictronEnergyTracker::advance(unsigned long nowMs) {
+  if (!clockStarted) {
+    clockStarted = true;
+    lastAdvanceMs = nowMs;  // Tracker time starts at the first call
+  }
+  // Records carry their receive time, which can be older than the last publish
+  if ((long)(nowMs - lastAdvanceMs) < 0) {
+    return;
+  }
+  clockMs += nowMs - lastAdvanceMs;
+  lastAdvanceMs = nowMs;
+
+  // A long stall closes at most a day of (empty) hours
+  uint8_t closed = 0;
+  while (clockMs - hourStartMs >= HOUR_MS) {
+    hourStartMs += HOUR_MS;
+    if (closed < VICTRON_ENERGY_HOURS) {
+      closeHour();
+      closed++;
+    }
+  }
+}
+
+void VictronEnergyTracker::closeHour() {
+  if (completedHours == VICTRON_ENERGY_HOURS) {
+    lastDay.consumptionMj -= hours[hourHead].consumptionMj;
+    lastDay.solarMj -= hours[hourHead].solarMj;
+    hours[hourHead] = currentHour;
+    hourHead = (uint8_t)((hourHead + 1) % VICTRON_ENERGY_HOURS);
+  } else {
+    hours[(hourHead + completedHours) % VICTRON_ENERGY_HOURS] = currentHour;
+    completedHours++;
+  }
+
+  lastDay.consumptionMj += currentHour.consumptionMj;
+  lastDay.solarMj += currentHour.solarMj;
+  currentHour.consumptionMj = 0;
+  currentHour.solarMj = 0;
+}
+
+void VictronEnergyTracker::onReading(const VictronDeviceStore &store, VictronDeviceRole role,
+                                     unsigned long nowMs) {
+  advance(nowMs);
+
+  switch (role) {
+    case ROLE_SMARTSHUNT: {
+      const SmartShuntReading *shunt = store.getSmartShunt();
+      if (shunt == nullptr || !shunt->voltageValid || !shunt->currentValid) {
+        return;
+      }
+
+      // After a gap the counter did not move while the battery did - restart the trend
+      if (hasShuntSample && nowMs - lastShuntMs > VICTRON_ENERGY_MAX_GAP_MS) {
+        forecast.reset();
+      }
+      hasShuntSample = true;
+      lastShuntMs = nowMs;
+
+      int64_t energy = batteryPower.add(shunt->voltage * shunt->current, nowMs);
+      if (energy >= 0) {
+        batteryInMj += energy;
+      } else {
+        batteryOutMj -= energy;
+      }
+      currentHour.consumptionMj -= energy;  // Energy that stayed in the battery was not consumed
+      batteryNetMams += batteryCurrent.add(shunt->current * 1000.0f, nowMs);
+
+      socValid = shunt->socValid;
+      soc = shunt->soc;
+
+      if (forecast.getCount() == 0 || clockMs - lastForecastSampleMs >= VICTRON_FORECAST_SAMPLE_MS) {
+        forecast.add((int64_t)(clockMs / 1000), batteryNetMams / 3600000);  // s, mAh
+        lastForecastSampleMs = clockMs;
+      }
+      break;
+    }
+
+    case ROLE_MPPT1:
+    case ROLE_MPPT2: {
+      uint8_t index = role == ROLE_MPPT1 ? 0 : 1;
+      const MpptReading *mppt = store.getMppt(index);
+      if (mppt == nullptr) {
+        return;
+      }
+      if (mppt->pvPowerValid) {
+        int64_t pv = mpptPv[index].add((float)mppt->pvPower, nowMs);
+        solarMj[index] += pv;
+        currentHour.solarMj += pv;
+      }
+      if (mppt->batteryVoltageValid && mppt->batteryCurrentValid) {
+        addSource(mpptOutput[index].add(mppt->batteryVoltage * mppt->batteryCurrent, nowMs));
+      }
+      break;
+    }
+
+    case ROLE_ORION: {
+      // The DC/DC converter record has no output current; that charge shows up as
+      // (negative) consumption until an Orion XS record is available
+      const OrionReading *orion = store.getOrion();
+      if (orion != nullptr && orion->outputVoltageValid && orion->outputCurrentValid) {
+        addSource(orionOutput.add(orion->outputVoltage * orion->outputCurrent, nowMs));
+      }
+      break;
+    }
+
+    case ROLE_AC_CHARGER: {
+      const AcChargerReading *charger = store.getAcCharger();
+      if (charger != nullptr && charger->voltageValid && charger->currentValid) {
+        addSource(acChargerOutput.add(charger->voltage * charger->current, nowMs));
+      }
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+void VictronEnergyTracker::appendAnalyticsJson(JsonDocument &doc) const {
+  doc["uptimeS"] = (uint32_t)(clockMs / 1000);
+
+  JsonObject battery = doc.createNestedObject("battery");
+  battery["whIn"] = mjToWh(batteryInMj);
+  battery["whOut"] = mjToWh(batteryOutMj);
+  battery["ahNet"] = roundTo2Decimals((float)batteryNetMams / MAMS_PER_AH);
+
+  JsonObject solar = doc.createNestedObject("solar");
+  solar["mppt1Wh"] = mjToWh(solarMj[0]);
+  solar["mppt2Wh"] = mjToWh(solarMj[1]);
+  solar["dayWh"] = mjToWh(lastDay.solarMj + currentHour.solarMj);
+
+  // Hour buckets run on module uptime; dayWh covers the completed hours plus the current one
+  JsonObject consumption = doc.createNestedObject("consumption");
+  consumption["hourWh"] = mjToWh(currentHour.consumptionMj);
+  if (completedHours > 0) {
+    uint8_t last = (uint8_t)((hourHead + completedHours - 1) % VICTRON_ENERGY_HOURS);
+    consumption["lastHourWh"] = mjToWh(hours[last].consumptionMj);
+  }
+  consumption["dayWh"] = mjToWh(lastDay.consumptionMj + currentHour.consumptionMj);
+  consumption["hours"] = completedHours;
+
+  // Trend needs a few samples over at least a minute
+  float slope;
+  if (forecast.getCount() < 6 || forecast.getSpan() < 60 || !forecast.getSlope(slope)) {
+    return;
+  }
+
+  float trendA = slope * 3.6f;  // mAh/s -> A
+  JsonObject trend = doc.createNestedObject("forecast");
+  trend["trendA"] = roundTo2Decimals(trendA);
+  if (!socValid || (trendA > -VICTRON_FORECAST_IDLE_A && trendA < VICTRON_FORECAST_IDLE_A)) {
+    return;
+  }
+
+  float remainingAh = BATTERY_CAPACITY_AH * soc / 100.0f;
+  if (trendA < 0) {
+    trend["hoursToEmpty"] = roundTo1Decimal(remainingAh / -trendA);
+  } else {
+    trend["hoursToFull"] = roundTo1Decimal((BATTERY_CAPACITY_AH - remainingAh) / trendA);
+  }
+}
@@ -0,0 +1,413 @@
+// Victron History Implementation
+
+#include "VictronHistory.h"
+#include <cmath>
+#include <cstring>
+
+// Worst-case encoded point: 4 + 32 bit timestamp, 2 + 5 + 5 + 32 bits per value
+static const uint16_t MAX_POINT_BITS = 36 + HISTORY_METRICS * 44;
+static const uint16_t BLOCK_BITS = VICTRON_HISTORY_BLOCK_BYTES * 8;
+static_assert(BLOCK_BITS >= 32 + HISTORY_METRICS * 32 + MAX_POINT_BITS, "History block too small");
+static_assert(BLOCK_BITS <= 65535, "History block too large for 16-bit bit positions");
+
+static const char *const RESOLUTION_NAMES[HISTORY_RESOLUTIONS] = {"1s", "1m", "1h"};
+static const uint32_t STEP_SECONDS[HISTORY_RESOLUTIONS] = {1, 60, 3600};
+static const uint32_t RETENTION_SECONDS[HISTORY_RESOLUTIONS] = {5 * 60, 24 * 3600, 30 * 24 * 3600};
+
+// ---------------------------------------------------------------------------
+// Bit stream (MSB first)
+// ---------------------------------------------------------------------------
+
+static void writeBits(VictronHistoryBlock &block, uint32_t value, uint8_t bitCount) {
+  for (int8_t i = bitCount - 1; i >= 0; i--) {
+    uint16_t pos = block.bitLen++;
+    if ((value >> i) & 1U) {
+      block.bits[pos >> 3] |= (uint8_t)(0x80 >> (pos & 7));
+    }
+  }
+}
+
+static uint32_t readBits(const VictronHistoryBlock &block, uint16_t &pos, uint8_t bitCount) {
+  uint32_t value = 0;
+  for (uint8_t i = 0; i < bitCount; i++, pos++) {
+    value = (value << 1) | ((block.bits[pos >> 3] >> (7 - (pos & 7))) & 1U);
+  }
+  return value;
+}
+
+static int32_t signExtend(uint32_t value, uint8_t bitCount) {
+  uint8_t shift = 32 - bitCount;
+  return (int32_t)(value << shift) >> shift;
+}
+
+static uint32_t floatBits(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static float bitsFloat(uint32_t bits) {
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+// ---------------------------------------------------------------------------
+// Point codec
+// ---------------------------------------------------------------------------
+
+// Delta-of-delta: '0' | '10' 7 bits | '110' 9 bits | '1110' 12 bits | '1111' 32 bits
+static void writeTimestamp(VictronHistoryBlock &block, VictronHistoryCodecState &state, uint32_t t) {
+  int32_t delta = (int32_t)(t - state.prevT);
+  int32_t dod = delta - state.prevDelta;
+  if (dod == 0) {
+    writeBits(block, 0, 1);
+  } else if (dod >= -64 && dod <= 63) {
+    writeBits(block, 0x2, 2);
+    writeBits(block, (uint32_t)dod & 0x7F, 7);
+  } else if (dod >= -256 && dod <= 255) {
+    writeBits(block, 0x6, 3);
+    writeBits(block, (uint32_t)dod & 0x1FF, 9);
+  } else if (dod >= -2048 && dod <= 2047) {
+    writeBits(block, 0xE, 4);
+    writeBits(block, (uint32_t)dod & 0xFFF, 12);
+  } else {
+    writeBits(block, 0xF, 4);
+    writeBits(block, (uint32_t)dod, 32);
+  }
+  state.prevDelta = delta;
+  state.prevT = t;
+}
+
+static uint32_t readTimestamp(const VictronHistoryBlock &block, uint16_t &pos, VictronHistoryCodecState &state) {
+  int32_t dod = 0;
+  if (readBits(block, pos, 1) != 0) {
+    if (readBits(block, pos, 1) == 0) {
+      dod = signExtend(readBits(block, pos, 7), 7);
+    } else if (readBits(block, pos, 1) == 0) {
+      dod = signExtend(readBits(block, pos, 9), 9);
+    } else if (readBits(block, pos, 1) == 0) {
+      dod = signExtend(readBits(block, pos, 12), 12);
+    } else {
+      dod = (int32_t)readBits(block, pos, 32);
+    }
+  }
+  state.prevDelta += dod;
+  state.prevT += (uint32_t)state.prevDelta;
+  return state.prevT;
+}
+
+// XOR with the previous value: '0' same | '10' bits inside the previous window
+// | '11' 5-bit leading zeros, 5-bit (length - 1), meaningful bits
+static void writeValue(VictronHistoryBlock &block, VictronHistoryCodecState &state, uint8_t metric, float value) {
+  uint32_t bits = floatBits(value);
+  uint32_t xorBits = bits ^ state.prevBits[metric];
+  state.prevBits[metric] = bits;
+
+  if (xorBits == 0) {
+    writeBits(block, 0, 1);
+    return;
+  }
+
+  uint8_t leading = (uint8_t)__builtin_clz(xorBits);
+  uint8_t trailing = (uint8_t)__builtin_ctz(xorBits);
+  uint8_t prevLeading = state.prevLeading[metric];
+  uint8_t prevTrailing = state.prevTrailing[metric];
+
+  if (prevLeading + prevTrailing < 32 && leading >= prevLeading && trailing >= prevTrailing) {
+    writeBits(block, 0x2, 2);
+    writeBits(block, xorBits >> prevTrailing, 32 - prevLeading - prevTrailing);
+    return;
+  }
+
+  uint8_t length = 32 - leading - trailing;
+  writeBits(block, 0x3, 2);
+  writeBits(block, leading, 5);
+  writeBits(block, length - 1, 5);
+  writeBits(block, xorBits >> trailing, length);
+  state.prevLeading[metric] = leading;
+  state.prevTrailing[metric] = trailing;
+}
+
+static float readValue(const VictronHistoryBlock &block, uint16_t &pos, VictronHistoryCodecState &state,
+                       uint8_t metric) {
+  if (readBits(block, pos, 1) != 0) {
+    if (readBits(block, pos, 1) == 0) {
+      uint8_t length = 32 - state.prevLeading[metric] - state.prevTrailing[metric];
+      state.prevBits[metric] ^= readBits(block, pos, length) << state.prevTrailing[metric];
+    } else {
+      uint8_t leading = (uint8_t)readBits(block, pos, 5);
+      uint8_t length = (uint8_t)readBits(block, pos, 5) + 1;
+      uint8_t trailing = 32 - leading - length;
+      state.prevBits[metric] ^= readBits(block, pos, length) << trailing;
+      state.prevLeading[metric] = leading;
+      state.prevTrailing[metric] = trailing;
+    }
+  }
+  return bitsFloat(state.prevBits[metric]);
+}
+
+// First point of a block is stored raw; the window starts "unset" (leading + trailing = 32)
+static void writeFirstPoint(VictronHistoryBlock &block, VictronHistoryCodecState &state,
+                            const VictronHistoryPoint &point) {
+  writeBits(block, point.t, 32);
+  state.prevT = point.t;
+  state.prevDelta = 0;
+  for (uint8_t m = 0; m < HISTORY_METRICS; m++) {
+    state.prevBits[m] = floatBits(point.values[m]);
+    state.prevLeading[m] = 32;
+    state.prevTrailing[m] = 0;
+    writeBits(block, state.prevBits[m], 32);
+  }
+}
+
+static void readFirstPoint(const VictronHistoryBlock &block, uint16_t &pos, VictronHistoryCodecState &state,
+                           VictronHistoryPoint &point) {
+  state.prevT = readBits(block, pos, 32);
+  state.prevDelta = 0;
+  point.t = state.prevT;
+  for (uint8_t m = 0; m < HISTORY_METRICS; m++) {
+    state.prevBits[m] = readBits(block, pos, 32);
+    state.prevLeading[m] = 32;
+    state.prevTrailing[m] = 0;
+    point.values[m] = bitsFloat(state.prevBits[m]);
+  }
+}
+
+static void readPoint(const VictronHistoryBlock &block, uint16_t index, uint16_t &pos,
+                      VictronHistoryCodecState &state, VictronHistoryPoint &point) {
+  if (index == 0) {
+    readFirstPoint(block, pos, state, point);
+    return;
+  }
+  point.t = readTimestamp(block, pos, state);
+  for (uint8_t m = 0; m < HISTORY_METRICS; m++) {
+    point.values[m] = readValue(block, pos, state, m);
+  }
+}
+
+// ---------------------------------------------------------------------------
+// History
+// ---------------------------------------------------------------------------
+
+VictronHistory::VictronHistory() {
+  VictronHistoryBlock *blocks[HISTORY_RESOLUTIONS] = {secondBlocks, minuteBlocks, hourBlocks};
+  const uint8_t counts[HISTORY_RESOLUTIONS] = {VICTRON_HISTORY_1S_BLOCKS, VICTRON_HISTORY_1M_BLOCKS,
+                                               VICTRON_HISTORY_1H_BLOCKS};
+  for (uint8_t r = 0; r < HISTORY_RESOLUTIONS; r++) {
+    tiers[r].blocks = blocks[r];
+    tiers[r].blockCount = counts[r];
+    tiers[r].retentionS = RETENTION_SECONDS[r];
+    tiers[r].nextSeq = 0;
+    tiers[r].used = 0;
+  }
+  minuteMean.count = 0;
+  hourMean.count = 0;
+}
+
+uint32_t VictronHistory::getStepSeconds(VictronHistoryResolution resolution) {
+  return STEP_SECONDS[resolution];
+}
+
+const char *VictronHistory::getResolutionName(VictronHistoryResolution resolution) {
+  return RESOLUTION_NAMES[resolution];
+}
+
+bool VictronHistory::parseResolution(const char *name, VictronHistoryResolution &resolution) {
+  for (uint8_t r = 0; r < HISTORY_RESOLUTIONS; r++) {
+    if (name != nullptr && strcmp(name, RESOLUTION_NAMES[r]) == 0) {
+      resolution = (VictronHistoryResolution)r;
+      return true;
+    }
+  }
+  return false;
+}
+
+void VictronHistory::sample(const VictronDeviceStore &store, uint32_t nowS, unsigned long nowMs) {
+  const SmartShuntReading *shunt = store.getSmartShunt();
+  if (shunt == nullptr || nowMs - store.getUpdatedAt(ROLE_SMARTSHUNT) > VICTRON_HISTORY_MAX_AGE_MS ||
+      !shunt->voltageValid || !shunt->currentValid) {
+    return;  // Gap in the history rather than a repeated stale reading
+  }
+
+  VictronHistoryPoint point;
+  point.t = nowS;
+  point.values[HISTORY_VOLTAGE] = shunt->voltage;
+  point.values[HISTORY_CURRENT] = shunt->current;
+  point.values[HISTORY_SOC] = shunt->socValid ? (float)shunt->soc : NAN;
+  point.values[HISTORY_SOLAR] = 0;
+  for (uint8_t i = 0; i < 2; i++) {
+    const MpptReading *mppt = store.getMppt(i);
+    if (mppt != nullptr && mppt->pvPowerValid) {
+      point.values[HISTORY_SOLAR] += mppt->pvPower;
+    }
+  }
+  addPoint(point);
+}
+
+void VictronHistory::addPoint(const VictronHistoryPoint &point) {
+  append(tiers[HISTORY_1S], point);
+  addToMean(minuteMean, STEP_SECONDS[HISTORY_1M], HISTORY_1M, point);
+  addToMean(hourMean, STEP_SECONDS[HISTORY_1H], HISTORY_1H, point);
+}
+
+void VictronHistory::addToMean(Mean &mean, uint32_t stepS, VictronHistoryResolution resolution,
+                               const VictronHistoryPoint &point) {
+  uint32_t startT = point.t - point.t % stepS;
+  if (mean.count > 0 && startT != mean.startT) {
+    // Means rounded to the status payload precision, so steady values repeat exactly (1-bit XOR)
+    VictronHistoryPoint averaged;
+    averaged.t = mean.startT;
+    averaged.values[HISTORY_VOLTAGE] = roundTo2Decimals(meanOf(mean, HISTORY_VOLTAGE));
+    averaged.values[HISTORY_CURRENT] = roundTo2Decimals(meanOf(mean, HISTORY_CURRENT));
+    averaged.values[HISTORY_SOC] = roundTo1Decimal(meanOf(mean, HISTORY_SOC));
+    averaged.values[HISTORY_SOLAR] = roundf(meanOf(mean, HISTORY_SOLAR));
+    append(tiers[resolution], averaged);
+    mean.count = 0;
+  }
+
+  if (mean.count == 0) {
+    mean.startT = startT;
+    memset(mean.sums, 0, sizeof(mean.sums));
+    memset(mean.valid, 0, sizeof(mean.valid));
+  }
+  for (uint8_t m = 0; m < HISTORY_METRICS; m++) {
+    if (std::isnan(point.values[m])) {
+      continue;  // Missing sample (no valid SOC) - mean of the ones that were there
+    }
+    mean.sums[m] += point.values[m];
+    mean.valid[m]++;
+  }
+  mean.count++;
+}
+
+// NaN only if the metric was missing for the whole bucket
+float VictronHistory::meanOf(const Mean &mean, uint8_t metric) {
+  if (mean.valid[metric] == 0) {
+    return NAN;
+  }
+  return mean.sums[metric] / mean.valid[metric];
+}
+
+void VictronHistory::append(Tier &tier, const VictronHistoryPoint &point) {
+  // Age out whole blocks past the retention window
+  while (tier.used > 0) {
+    const VictronHistoryBlock &oldest = blockAt(tier, tier.nextSeq - tier.used);
+    if (point.t - oldest.lastT <= tier.retentionS) {
+      break;
+    }
+    tier.used--;
+  }
+
+  VictronHistoryBlock *block = tier.used > 0 ? &blockAt(tier, tier.nextSeq - 1) : nullptr;
+  if (block == nullptr || block->bitLen + MAX_POINT_BITS > BLOCK_BITS || block->count == 0xFFFF) {
+    if (tier.used == tier.blockCount) {
+      tier.used--;  // Evict the oldest block
+    }
+    block = &blockAt(tier, tier.nextSeq);
+    tier.nextSeq++;
+    tier.used++;
+
+    memset(block, 0, sizeof(*block));
+    block->firstT = point.t;
+    writeFirstPoint(*block, tier.writer, point);
+  } else {
+    writeTimestamp(*block, tier.writer, point.t);
+    for (uint8_t m = 0; m < HISTORY_METRICS; m++) {
+      writeValue(*block, tier.writer, m, point.values[m]);
+    }
+  }
+
+  block->lastT = point.t;
+  block->count++;
+}
+
+void VictronHistory::beginQuery(VictronHistoryResolution resolution, uint32_t fromT, uint32_t toT,
+                                VictronHistoryCursor &cursor) const {
+  const Tier &tier = tiers[resolution];
+  cursor.resolution = (uint8_t)resolution;
+  cursor.toT = toT;
+  cursor.truncated = false;
+  cursor.pointIndex = 0;
+  cursor.bitPos = 0;
+  memset(&cursor.state, 0, sizeof(cursor.state));
+
+  // Skip whole blocks that end before the range (points inside one are skipped while reading)
+  cursor.blockSeq = tier.nextSeq - tier.used;
+  while (cursor.blockSeq + 1 < tier.nextSeq && blockAt(tier, cursor.blockSeq).lastT < fromT) {
+    cursor.blockSeq++;
+  }
+
+  // Decode up to the first point at or after fromT
+  VictronHistoryPoint point;
+  while (cursor.blockSeq < tier.nextSeq) {
+    const VictronHistoryBlock &block = blockAt(tier, cursor.blockSeq);
+    if (cursor.pointIndex >= block.count) {
+      break;
+    }
+    VictronHistoryCodecState state = cursor.state;
+    uint16_t pos = cursor.bitPos;
+    readPoint(block, cursor.pointIndex, pos, state, point);
+    if (point.t >= fromT) {
+      break;  // Not consumed - read() decodes it again
+    }
+    cursor.state = state;
+    cursor.bitPos = pos;
+    cursor.pointIndex++;
+  }
+}
+
+size_t VictronHistory::read(VictronHistoryCursor &cursor, VictronHistoryPoint *out, size_t maxPoints) const {
+  const Tier &tier = tiers[cursor.resolution];
+  size_t produced = 0;
+
+  while (produced < maxPoints) {
+    uint32_t oldestSeq = tier.nextSeq - tier.used;
+    if (cursor.blockSeq < oldestSeq) {
+      // Overwritten since the last read - continue with the oldest data still there
+      cursor.truncated = true;
+      cursor.blockSeq = oldestSeq;
+      cursor.pointIndex = 0;
+      cursor.bitPos = 0;
+    }
+    if (cursor.blockSeq >= tier.nextSeq) {
+      break;
+    }
+
+    const VictronHistoryBlock &block = blockAt(tier, cursor.blockSeq);
+    if (cursor.pointIndex >= block.count) {
+      if (cursor.blockSeq + 1 >= tier.nextSeq) {
+        break;  // Caught up with the block being written
+      }
+      cursor.blockSeq++;
+      cursor.pointIndex = 0;
+      cursor.bitPos = 0;
+      continue;
+    }
+
+    VictronHistoryPoint &point = out[produced];
+    readPoint(block, cursor.pointIndex, cursor.bitPos, cursor.state, point);
+    cursor.pointIndex++;
+    if (point.t > cursor.toT) {
+      cursor.blockSeq = tier.nextSeq;  // Done
+      break;
+    }
+    produced++;
+  }
+
+  return produced;
+}
+
+VictronHistoryTierStats VictronHistory::getStats(VictronHistoryResolution resolution) const {
+  const Tier &tier = tiers[resolution];
+  VictronHistoryTierStats stats = {0, 0, (uint32_t)tier.blockCount * VICTRON_HISTORY_BLOCK_BYTES, 0};
+  for (uint32_t seq = tier.nextSeq - tier.used; seq < tier.nextSeq; seq++) {
+    const VictronHistoryBlock &block = blockAt(tier, seq);
+    stats.points += block.count;
+    stats.bytes += (block.bitLen + 7) / 8;
+  }
+  if (tier.used > 0) {
+    stats.oldestT = blockAt(tier, tier.nextSeq - tier.used).firstT;
+  }
+  return stats;
+}
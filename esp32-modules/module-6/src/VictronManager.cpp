@@ -1,6 +1,8 @@
 // Victron Manager Implementation
 
 #include "VictronManager.h"
+#include "ClockSync.h"
+#include "Logger.h"
 #include <BLEDevice.h>
 #include <BLEScan.h>
 #include <BLEAdvertisedDevice.h>
@@ -11,49 +13,10 @@
 #define USE_String
 #endif
 
-static const size_t VICTRON_MANUFACTURER_DATA_MAX = 31;
-
-struct VictronDeviceConfig {
-  const char *name;
-  const char *mac;
-  uint8_t key[16];
-  VictronDeviceRole role;
-  uint8_t expectedRecordType;
-  uint16_t lastDataCounter;
-  bool configured;
-};
-
-struct CachedSmartShunt {
-  bool hasData;
-  SmartShuntReading reading;
-  unsigned long updatedAt;
-};
-
-struct CachedMppt {
-  bool hasData;
-  MpptReading reading;
-  unsigned long updatedAt;
-};
-
-struct CachedOrion {
-  bool hasData;
-  OrionReading reading;
-  unsigned long updatedAt;
-};
-
-struct CachedAcCharger {
-  bool hasData;
-  AcChargerReading reading;
-  unsigned long updatedAt;
-};
-
-static VictronDeviceConfig devices[VICTRON_DEVICE_COUNT];
-static CachedSmartShunt smartShuntCache = {false, {}, 0};
-static CachedMppt mppt1Cache = {false, {}, 0};
-static CachedMppt mppt2Cache = {false, {}, 0};
-static CachedOrion orionCache = {false, {}, 0};
-static CachedAcCharger acChargerCache = {false, {}, 0};
 static BLEScan *bleScan = nullptr;
+
+// History time base: seconds since boot from the 64-bit clock (millis() wraps after 49 days)
+static uint32_t historyNowSeconds() { return (uint32_t)(ClockSync::monotonicMicros() / 1000000ULL); }
 static unsigned long lastBleScanStartMs = 0;
 
 static bool copyManufacturerData(BLEAdvertisedDevice &device, uint8_t *out, size_t *outLen,
@@ -76,367 +39,66 @@ static bool copyManufacturerData(BLEAdvertisedDevice &device, uint8_t *out, size
   return true;
 }
 
-static VictronDeviceConfig *findDevice(const BLEAddress &address) {
-  for (size_t i = 0; i < VICTRON_DEVICE_COUNT; i++) {
-    if (devices[i].configured && address == BLEAddress(devices[i].mac)) {
-      return &devices[i];
-    }
-  }
-  return nullptr;
-}
-
-static void updateSmartShuntCache(const SmartShuntReading &reading, unsigned long nowMs) {
-  smartShuntCache.hasData = true;
-  smartShuntCache.reading = reading;
-  smartShuntCache.updatedAt = nowMs;
-}
-
-static void updateMpptCache(VictronDeviceRole role, const MpptReading &reading, unsigned long nowMs) {
-  CachedMppt *cache = role == ROLE_MPPT1 ? &mppt1Cache : &mppt2Cache;
-  cache->hasData = true;
-  cache->reading = reading;
-  cache->updatedAt = nowMs;
-}
-
-static void updateOrionCache(const OrionReading &reading, unsigned long nowMs) {
-  orionCache.hasData = true;
-  orionCache.reading = reading;
-  orionCache.updatedAt = nowMs;
-}
-
-static void touchDeviceCache(VictronDeviceRole role, unsigned long nowMs) {
-  switch (role) {
-    case ROLE_SMARTSHUNT:
-      if (smartShuntCache.hasData) {
-        smartShuntCache.updatedAt = nowMs;
-      }
-      break;
-    case ROLE_MPPT1:
-      if (mppt1Cache.hasData) {
-        mppt1Cache.updatedAt = nowMs;
-      }
-      break;
-    case ROLE_MPPT2:
-      if (mppt2Cache.hasData) {
-        mppt2Cache.updatedAt = nowMs;
-      }
-      break;
-    case ROLE_ORION:
-      if (orionCache.hasData) {
-        orionCache.updatedAt = nowMs;
-      }
-      break;
-    case ROLE_AC_CHARGER:
-      if (acChargerCache.hasData) {
-        acChargerCache.updatedAt = nowMs;
-      }
-      break;
-    default:
-      break;
-  }
-}
-
-static bool handleParsedPayload(VictronDeviceConfig *device, uint8_t recordType,
-                                const uint8_t *plain, size_t plainLen, unsigned long nowMs) {
-  switch (device->role) {
-    case ROLE_SMARTSHUNT:
-      if (recordType != RECORD_BATTERY_MONITOR) {
-        return false;
-      }
-      {
-        SmartShuntReading reading;
-        if (!parseBatteryMonitor(plain, plainLen, reading)) {
-          return false;
-        }
-        updateSmartShuntCache(reading, nowMs);
-      }
-      return true;
-
-    case ROLE_MPPT1:
-    case ROLE_MPPT2:
-      if (recordType != RECORD_SOLAR_CHARGER) {
-        return false;
-      }
-      {
-        MpptReading reading;
-        if (!parseSolarCharger(plain, plainLen, reading)) {
-          return false;
-        }
-        updateMpptCache(device->role, reading, nowMs);
-      }
-      return true;
-
-    case ROLE_ORION:
-      if (recordType != RECORD_ORION_XS) {
-        return false;
-      }
-      {
-        OrionReading reading;
-        if (!parseOrionXs(plain, plainLen, reading)) {
-          return false;
-        }
-        updateOrionCache(reading, nowMs);
-      }
-      return true;
-
-    case ROLE_AC_CHARGER:
-      if (recordType != RECORD_AC_CHARGER) {
-        return false;
-      }
-      {
-        AcChargerReading reading;
-        if (!parseAcCharger(plain, plainLen, reading)) {
-          return false;
-        }
-        acChargerCache.hasData = true;
-        acChargerCache.reading = reading;
-        acChargerCache.updatedAt = nowMs;
-      }
-      return true;
-
-    default:
-      return false;
-  }
-}
-
+// Runs in the BLE host task: filter and hand the raw data to loop(), nothing else.
+// The device store is read-only here (MAC table is fixed once BLE is started).
 class VictronScanCallbacks : public BLEAdvertisedDeviceCallbacks {
-  void onResult(BLEAdvertisedDevice advertisedDevice) override {
-    VictronDeviceConfig *device = findDevice(advertisedDevice.getAddress());
-    if (device == nullptr) {
-      return;
-    }
-
-    uint8_t manufacturerData[VICTRON_MANUFACTURER_DATA_MAX];
-    size_t manufacturerLen = 0;
-    if (!copyManufacturerData(advertisedDevice, manufacturerData, &manufacturerLen,
-                            sizeof(manufacturerData))) {
-      return;
-    }
-
-    if (manufacturerLen < 10) {
-      return;
-    }
-
-    uint16_t vendorId = manufacturerData[0] | ((uint16_t)manufacturerData[1] << 8);
-    if (vendorId != VICTRON_VENDOR_ID) {
-      return;
-    }
-
-    const uint8_t *record = manufacturerData + 2;
-    size_t recordLen = manufacturerLen - 2;
-
-    if (recordLen < 8 || record[0] != VICTRON_BEACON_TYPE) {
-      return;
-    }
-
-    if (record[7] != device->key[0]) {
-      return;
-    }
-
-    uint8_t recordType = record[4];
-    if (!isSupportedRecordType(recordType)) {
-      return;
-    }
+ public:
+  VictronScanCallbacks(const VictronDeviceStore *store, VictronRecordQueue *queue)
+      : store(store), queue(queue) {}
 
-    uint16_t dataCounter = record[5] | ((uint16_t)record[6] << 8);
-    if (dataCounter == device->lastDataCounter) {
-      touchDeviceCache(device->role, millis());
-      return;
-    }
-
-    const uint8_t *cipher = record + 8;
-    size_t cipherLen = recordLen - 8;
-    if (cipherLen == 0 || cipherLen > 16) {
-      return;
-    }
-
-    uint8_t plain[16] = {0};
-    if (!decryptVictronPayload(device->key, cipher, cipherLen, record[5], record[6], plain)) {
-      return;
-    }
-
-    unsigned long nowMs = millis();
-    if (!handleParsedPayload(device, recordType, plain, cipherLen, nowMs)) {
+  void onResult(BLEAdvertisedDevice advertisedDevice) override {
+    // Reject foreign advertisements before touching the manufacturer data
+    BLEAddress address = advertisedDevice.getAddress();
+    int deviceIndex = store->findDevice(*address.getNative());
+    if (deviceIndex < 0 || !advertisedDevice.haveManufacturerData()) {
       return;
     }
 
-    device->lastDataCounter = dataCounter;
-
-    if (DEBUG_VERBOSE && DEBUG_SERIAL) {
-      Serial.print("Updated ");
-      Serial.println(device->name);
-    }
-  }
-};
-
-static bool initDevices() {
-  struct DeviceEntry {
-    const char *name;
-    const char *mac;
-    const char *key;
-    VictronDeviceRole role;
-  };
-
-  const DeviceEntry entries[VICTRON_DEVICE_COUNT] = {
-      {VICTRON_DEVICE_0_NAME, VICTRON_DEVICE_0_MAC, VICTRON_DEVICE_0_KEY, ROLE_SMARTSHUNT},
-      {VICTRON_DEVICE_1_NAME, VICTRON_DEVICE_1_MAC, VICTRON_DEVICE_1_KEY, ROLE_ORION},
-      {VICTRON_DEVICE_2_NAME, VICTRON_DEVICE_2_MAC, VICTRON_DEVICE_2_KEY, ROLE_MPPT1},
-      {VICTRON_DEVICE_3_NAME, VICTRON_DEVICE_3_MAC, VICTRON_DEVICE_3_KEY, ROLE_MPPT2},
-#if AC_CHARGER_ENABLED
-      {"ACCharger", AC_CHARGER_MAC, AC_CHARGER_KEY, ROLE_AC_CHARGER},
-#endif
-  };
-
-  for (size_t i = 0; i < VICTRON_DEVICE_COUNT; i++) {
-    devices[i].name = entries[i].name;
-    devices[i].mac = entries[i].mac;
-    devices[i].role = entries[i].role;
-    devices[i].expectedRecordType = 0;
-    devices[i].lastDataCounter = 0xFFFF;
-    devices[i].configured = parseHexKey(entries[i].key, devices[i].key);
-
-    if (!devices[i].configured) {
-      if (DEBUG_SERIAL) {
-        Serial.print("ERROR: Invalid key for ");
-        Serial.println(entries[i].name);
-      }
-      return false;
+    VictronRawRecord *slot = queue->reserve();
+    if (slot == nullptr) {
+      return;  // Ring full - counted as dropped
     }
 
-    if (DEBUG_SERIAL) {
-      Serial.print("Configured Victron device: ");
-      Serial.print(entries[i].name);
-      Serial.print(" (");
-      Serial.print(entries[i].mac);
-      Serial.println(")");
+    size_t manufacturerLen = 0;
+    if (!copyManufacturerData(advertisedDevice, slot->data, &manufacturerLen, sizeof(slot->data))) {
+      return;  // Slot not committed, reused by the next advertisement
     }
-  }
-
-  return true;
-}
-
-static void appendSmartShuntJson(JsonDocument &doc) {
-  if (!smartShuntCache.hasData) {
-    doc["smartshunt"] = nullptr;
-    return;
-  }
-
-  JsonObject obj = doc.createNestedObject("smartshunt");
-  const SmartShuntReading &r = smartShuntCache.reading;
-
-  if (r.voltageValid) {
-    obj["voltage"] = roundTo1Decimal(r.voltage);
-  }
-  if (r.currentValid) {
-    obj["current"] = roundTo2Decimals(r.current);
-  }
-  if (r.socValid) {
-    obj["soc"] = r.soc;
-  }
-  if (r.consumedAhValid) {
-    obj["consumedAh"] = roundTo1Decimal(r.consumedAh);
-  }
-  if (r.timeToGoValid) {
-    obj["timeToGoMin"] = r.timeToGoMin;
-  } else {
-    obj["timeToGoMin"] = nullptr;
-  }
-  obj["alarmReason"] = r.alarmReason;
-  obj["updatedAt"] = smartShuntCache.updatedAt;
-}
-
-static void appendMpptJson(JsonDocument &doc, const char *key, const CachedMppt &cache) {
-  if (!cache.hasData) {
-    doc[key] = nullptr;
-    return;
-  }
-
-  JsonObject obj = doc.createNestedObject(key);
-  const MpptReading &r = cache.reading;
-
-  obj["deviceState"] = r.deviceState;
-  obj["errorCode"] = r.errorCode;
-  if (r.batteryVoltageValid) {
-    obj["batteryVoltage"] = roundTo1Decimal(r.batteryVoltage);
-  }
-  if (r.batteryCurrentValid) {
-    obj["batteryCurrent"] = roundTo2Decimals(r.batteryCurrent);
-  }
-  if (r.pvPowerValid) {
-    obj["pvPower"] = r.pvPower;
-  }
-  if (r.yieldTodayValid) {
-    obj["yieldTodayKwh"] = roundTo2Decimals(r.yieldTodayKwh);
-  }
-  obj["updatedAt"] = cache.updatedAt;
-}
-
-static void appendOrionJson(JsonDocument &doc) {
-  if (!orionCache.hasData) {
-    doc["orion"] = nullptr;
-    return;
-  }
-
-  JsonObject obj = doc.createNestedObject("orion");
-  const OrionReading &r = orionCache.reading;
-
-  obj["deviceState"] = r.deviceState;
-  obj["errorCode"] = r.errorCode;
-  if (r.outputVoltageValid) {
-    obj["outputVoltage"] = roundTo1Decimal(r.outputVoltage);
-  }
-  if (r.outputCurrentValid) {
-    obj["outputCurrent"] = roundTo2Decimals(r.outputCurrent);
-  }
-  if (r.inputVoltageValid) {
-    obj["inputVoltage"] = roundTo1Decimal(r.inputVoltage);
-  }
-  if (r.inputCurrentValid) {
-    obj["inputCurrent"] = roundTo2Decimals(r.inputCurrent);
-  }
-  obj["offReason"] = r.offReason;
-  obj["updatedAt"] = orionCache.updatedAt;
-}
 
-static void appendAcChargerJson(JsonDocument &doc) {
-#if !AC_CHARGER_ENABLED
-  doc["acCharger"] = nullptr;
-  return;
-#else
-  if (!acChargerCache.hasData) {
-    doc["acCharger"] = nullptr;
-    return;
+    slot->deviceIndex = (uint8_t)deviceIndex;
+    slot->len = (uint8_t)manufacturerLen;
+    slot->rssi = (int8_t)advertisedDevice.getRSSI();
+    slot->receivedAt = millis();
+    queue->commit();
   }
 
-  JsonObject obj = doc.createNestedObject("acCharger");
-  const AcChargerReading &r = acChargerCache.reading;
-
-  obj["deviceState"] = r.deviceState;
-  obj["errorCode"] = r.errorCode;
-  if (r.voltageValid) {
-    obj["voltage"] = roundTo1Decimal(r.voltage);
-  }
-  if (r.currentValid) {
-    obj["current"] = roundTo2Decimals(r.current);
-  }
-  if (r.acCurrentValid) {
-    obj["acCurrent"] = roundTo2Decimals(r.acCurrent);
-  }
-  obj["updatedAt"] = acChargerCache.updatedAt;
-#endif
-}
+ private:
+  const VictronDeviceStore *store;
+  VictronRecordQueue *queue;
+};
 
 VictronManager::VictronManager(ModuleManager *moduleMgr)
     : commandHandler(&moduleMgr->getMQTTManager(), this, MODULE_ID),
       lastPublishMs(0),
+      lastAnalyticsPublishMs(0),
+      lastHistorySampleMs(0),
+      lastDiagnosticsPublishMs(0),
+      diagnosticsWindowStartMs(0),
+      publishUsMax(0),
+      publishUsSum(0),
+      publishCount(0),
+      historyStreaming(false),
+      historyChunkSeq(0),
+      historyChunkFailures(0),
+      lastHistoryChunkMs(0),
       devicesConfigured(false),
       bleInitialized(false),
       bleScanActive(false) {
   moduleManager = moduleMgr;
+  historyRequestId[0] = '\0';
 }
 
 void VictronManager::begin() {
-  if (!initDevices()) {
+  if (!deviceStore.begin()) {
     if (DEBUG_SERIAL) {
       Serial.println("ERROR: Victron device initialization failed");
     }
@@ -463,21 +125,38 @@ void VictronManager::startBle() {
   BLEDevice::init("");
   bleScan = BLEDevice::getScan();
   // wantDuplicates=true: Victron re-advertises same counter every ~200ms
-  bleScan->setAdvertisedDeviceCallbacks(new VictronScanCallbacks(), true, true);
+  bleScan->setAdvertisedDeviceCallbacks(new VictronScanCallbacks(&deviceStore, &recordQueue), true,
+                                        true);
   bleScan->setActiveScan(true);
   bleScan->setInterval(BLE_SCAN_INTERVAL_MS);
   bleScan->setWindow(BLE_SCAN_WINDOW_MS);
 
   bleInitialized = true;
+  scanScheduler.begin(millis());
+  updateBleScan(millis());
 
-  if (bleScan->start(BLE_SCAN_BURST_SEC, nullptr, false)) {
-    bleScanActive = true;
-    lastBleScanStartMs = millis();
+  if (DEBUG_SERIAL) {
+    Serial.println(VICTRON_ADAPTIVE_SCAN ? "Victron BLE adaptive scan started" : "Victron BLE continuous scan started");
   }
+}
 
-  if (DEBUG_SERIAL) {
-    Serial.println("Victron BLE continuous scan started");
+// Scan in async bursts while the scheduler (or continuous mode) wants the radio,
+// stop early otherwise so WiFi gets it back
+void VictronManager::updateBleScan(unsigned long nowMs) {
+  bool wanted = scanScheduler.wantsScan(nowMs) || !VICTRON_ADAPTIVE_SCAN;
+
+  if (wanted) {
+    if (!bleScanActive || nowMs - lastBleScanStartMs >= (BLE_SCAN_BURST_SEC * 1000UL)) {
+      // Async burst — start(0, false) blocks forever on ESP32 Arduino BLE 2.x
+      bleScanActive = bleScan->start(BLE_SCAN_BURST_SEC, nullptr, false);
+      lastBleScanStartMs = nowMs;
+    }
+  } else if (bleScanActive) {
+    bleScan->stop();
+    bleScanActive = false;
   }
+
+  scanScheduler.setScanning(bleScanActive, nowMs);
 }
 
 void VictronManager::loop() {
@@ -491,19 +170,55 @@ void VictronManager::loop() {
     startBle();
   }
 
-  if (bleInitialized && bleScan != nullptr &&
-      nowMs - lastBleScanStartMs >= (BLE_SCAN_BURST_SEC * 1000UL)) {
-    // Async burst — start(0, false) blocks forever on ESP32 Arduino BLE 2.x
-    if (bleScan->start(BLE_SCAN_BURST_SEC, nullptr, false)) {
-      bleScanActive = true;
-      lastBleScanStartMs = nowMs;
-    }
+  processQueuedRecords();
+
+  if (bleInitialized && bleScan != nullptr) {
+    updateBleScan(nowMs);
   }
 
   if (nowMs - lastPublishMs >= VICTRON_STATUS_PUBLISH_INTERVAL_MS) {
     publishFullStatus();
     lastPublishMs = nowMs;
   }
+
+  if (nowMs - lastAnalyticsPublishMs >= VICTRON_ANALYTICS_PUBLISH_INTERVAL_MS) {
+    publishAnalytics();
+    lastAnalyticsPublishMs = nowMs;
+  }
+
+  if (nowMs - lastDiagnosticsPublishMs >= VICTRON_DIAGNOSTICS_PUBLISH_INTERVAL_MS) {
+    publishDiagnostics();
+    lastDiagnosticsPublishMs = nowMs;
+  }
+
+  if (nowMs - lastHistorySampleMs >= 1000) {
+    lastHistorySampleMs = nowMs;
+    history.sample(deviceStore, historyNowSeconds(), nowMs);
+  }
+
+  if (historyStreaming && nowMs - lastHistoryChunkMs >= VICTRON_HISTORY_CHUNK_INTERVAL_MS) {
+    lastHistoryChunkMs = nowMs;
+    publishHistoryChunk();
+  }
+}
+
+void VictronManager::processQueuedRecords() {
+  // Bounded by the ring depth - the callback can refill it while we drain
+  for (int i = 0; i < VICTRON_RECORD_QUEUE_DEPTH; i++) {
+    const VictronRawRecord *raw = recordQueue.front();
+    if (raw == nullptr) {
+      break;
+    }
+    VictronRejectReason reason;
+    VictronRecordResult result = deviceStore.handleRecord(*raw, &reason);
+    if (result == VICTRON_RECORD_UPDATED) {
+      energyTracker.onReading(deviceStore, deviceStore.getDeviceRole(raw->deviceIndex), raw->receivedAt);
+    }
+    uint16_t dataCounter = deviceStore.getDataCounter(raw->deviceIndex);
+    receptionStats.onRecord(*raw, result, reason, dataCounter, scanScheduler.getSessionStartMs());
+    scanScheduler.onRecord(raw->deviceIndex, result, dataCounter, raw->receivedAt);
+    recordQueue.release();
+  }
 }
 
 void VictronManager::handleForceUpdate() {
@@ -516,26 +231,268 @@ void VictronManager::publishFullStatus() {
     return;
   }
 
+  unsigned long nowMs = millis();
   StaticJsonDocument<1280> doc;
-  doc["publishedAt"] = millis();
-
-  appendSmartShuntJson(doc);
-  appendMpptJson(doc, "mppt1", mppt1Cache);
-  appendMpptJson(doc, "mppt2", mppt2Cache);
-  appendOrionJson(doc);
-  appendAcChargerJson(doc);
+  doc["publishedAt"] = nowMs;
+  ClockSync::addTimestamp(doc);  // Epoch ms once synced
+
+  deviceStore.appendStatusJson(doc);
+
+  JsonObject ble = doc.createNestedObject("ble");
+  ble["received"] = recordQueue.getPushedCount();
+  ble["dropped"] = recordQueue.getDroppedCount();
+  ble["scanPct"] = scanScheduler.takeDutyPercent(nowMs);
+  JsonArray age = ble.createNestedArray("ageMs");  // Config.h device order
+  for (uint8_t i = 0; i < VICTRON_DEVICE_COUNT; i++) {
+    uint32_t ageMs;
+    if (scanScheduler.getDataAge(i, nowMs, ageMs)) {
+      age.add(ageMs);
+    } else {
+      age.add(nullptr);
+    }
+  }
+  // Publishes since the previous status (this one is measured into the next)
+  if (publishCount > 0) {
+    ble["publishUs"] = publishUsSum / publishCount;
+    ble["publishUsMax"] = publishUsMax;
+  }
+  publishUsMax = 0;
+  publishUsSum = 0;
+  publishCount = 0;
 
   String jsonString;
   serializeJson(doc, jsonString);
 
   String topic = String(MQTT_TOPIC_SENSORS) + MODULE_ID + "/status";
-  moduleManager->getMQTTManager().publishRaw(topic, jsonString);
+  publishTimed(topic, jsonString);
 
   if (DEBUG_VERBOSE && DEBUG_MQTT) {
     Serial.println("Published Victron status: " + jsonString);
   }
 }
 
+void VictronManager::publishAnalytics() {
+  if (!moduleManager || !moduleManager->isConnected()) {
+    return;
+  }
+
+  unsigned long nowMs = millis();
+  energyTracker.advance(nowMs);
+
+  StaticJsonDocument<512> doc;
+  doc["publishedAt"] = nowMs;
+  ClockSync::addTimestamp(doc);
+  energyTracker.appendAnalyticsJson(doc);
+
+  String jsonString;
+  serializeJson(doc, jsonString);
+
+  String topic = String(MQTT_TOPIC_SENSORS) + MODULE_ID + "/analytics";
+  publishTimed(topic, jsonString);
+
+  if (DEBUG_VERBOSE && DEBUG_MQTT) {
+    Serial.println("Published Victron analytics: " + jsonString);
+  }
+}
+
+// Low rate: counts cover the window since the last successful publish
+void VictronManager::publishDiagnostics() {
+  if (!moduleManager || !moduleManager->isConnected()) {
+    return;
+  }
+
+  unsigned long nowMs = millis();
+  StaticJsonDocument<2048> doc;
+  doc["publishedAt"] = nowMs;
+  ClockSync::addTimestamp(doc);
+  doc["windowMs"] = nowMs - diagnosticsWindowStartMs;
+  doc["queueDropped"] = recordQueue.getDroppedCount();  // Since boot, all devices
+  receptionStats.appendDiagnosticsJson(doc, deviceStore);
+
+  String jsonString;
+  serializeJson(doc, jsonString);
+
+  String topic = String(MQTT_TOPIC_SENSORS) + MODULE_ID + "/diagnostics";
+  if (!publishTimed(topic, jsonString)) {
+    return;  // Counters keep running - the next publish covers this window too
+  }
+
+  receptionStats.reset();
+  diagnosticsWindowStartMs = nowMs;
+
+  if (DEBUG_VERBOSE && DEBUG_MQTT) {
+    Serial.println("Published Victron diagnostics: " + jsonString);
+  }
+}
+
+// Time each publish: with BLE scanning the WiFi side only gets the radio between scan windows
+bool VictronManager::publishTimed(const String &topic, const String &payload, bool logPublish) {
+  unsigned long startUs = micros();
+  bool published = moduleManager->getMQTTManager().publishRaw(topic, payload, logPublish);
+  uint32_t elapsedUs = micros() - startUs;
+
+  publishUsSum += elapsedUs;
+  if (elapsedUs > publishUsMax) {
+    publishUsMax = elapsedUs;
+  }
+  publishCount++;
+  return published;
+}
+
+// Payload: {"res": "1s"|"1m"|"1h", "from": s, "to": s} in module uptime seconds,
+// or {"res": ..., "last": s} for the most recent span. Optional "id" is echoed as "req".
+void VictronManager::handleHistoryQuery(const String &message) {
+  StaticJsonDocument<192> doc;
+  if (deserializeJson(doc, message) != DeserializationError::Ok) {
+    LOG_WARN("⚠️ History query: invalid JSON");
+    return;
+  }
+
+  VictronHistoryResolution resolution = HISTORY_1M;
+  if (doc.containsKey("res") && !VictronHistory::parseResolution(doc["res"].as<const char *>(), resolution)) {
+    LOG_WARN("⚠️ History query: unknown resolution");
+    return;
+  }
+
+  uint32_t nowS = historyNowSeconds();
+  uint32_t fromS = doc["from"] | 0UL;
+  uint32_t toS = doc["to"] | nowS;
+  if (doc.containsKey("last")) {
+    uint32_t lastS = doc["last"];
+    fromS = lastS < nowS ? nowS - lastS : 0;
+  }
+
+  const char *id = doc["id"] | "";
+  strncpy(historyRequestId, id, sizeof(historyRequestId) - 1);
+  historyRequestId[sizeof(historyRequestId) - 1] = '\0';
+
+  // A new query replaces one still streaming
+  history.beginQuery(resolution, fromS, toS, historyCursor);
+  historyStreaming = true;
+  historyChunkSeq = 0;
+  historyChunkFailures = 0;
+  lastHistoryChunkMs = 0;
+}
+
+// Rounded in double, so ArduinoJson prints the short decimal (13.2, not 13.19999981)
+static double fixedDecimals(float value, float scale) {
+  return lroundf(value * scale) / (double)scale;
+}
+
+void VictronManager::beginHistoryChunk(JsonDocument &doc, VictronHistoryResolution resolution) {
+  if (historyRequestId[0] != '\0') {
+    doc["req"] = historyRequestId;
+  }
+  doc["res"] = VictronHistory::getResolutionName(resolution);
+  doc["step"] = VictronHistory::getStepSeconds(resolution);
+  doc["seq"] = historyChunkSeq;
+  doc["nowS"] = historyNowSeconds();
+  ClockSync::addTimestamp(doc);  // Epoch of nowS, to place t on the wall clock
+}
+
+void VictronManager::publishHistoryChunk() {
+  if (!moduleManager || !moduleManager->isConnected()) {
+    return;  // Resumes from the cursor after reconnect
+  }
+
+  // Read from a copy - the cursor only moves on once the chunk is out, so a failed publish is resent
+  VictronHistoryCursor cursor = historyCursor;
+  VictronHistoryPoint points[VICTRON_HISTORY_CHUNK_POINTS];
+  size_t count = history.read(cursor, points, VICTRON_HISTORY_CHUNK_POINTS);
+  bool last = count < VICTRON_HISTORY_CHUNK_POINTS;
+  VictronHistoryResolution resolution = (VictronHistoryResolution)cursor.resolution;
+
+  StaticJsonDocument<2048> doc;
+  beginHistoryChunk(doc, resolution);
+  if (cursor.truncated) {
+    doc["truncated"] = true;  // Part of the range was overwritten while streaming
+  }
+  doc["last"] = false;  // Longest value while measuring
+
+  // Columnar arrays; points stop at the byte budget so the chunk fits the MQTT buffer
+  JsonArray t = doc.createNestedArray("t");
+  JsonArray voltage = doc.createNestedArray("v");
+  JsonArray current = doc.createNestedArray("i");
+  JsonArray soc = doc.createNestedArray("soc");
+  JsonArray solar = doc.createNestedArray("pv");
+  size_t bytes = measureJson(doc);  // Header and empty arrays; each point adds its values and commas
+  size_t fitted = 0;
+  for (; fitted < count; fitted++) {
+    const VictronHistoryPoint &point = points[fitted];
+    t.add(point.t);
+    voltage.add(fixedDecimals(point.values[HISTORY_VOLTAGE], 100.0f));
+    current.add(fixedDecimals(point.values[HISTORY_CURRENT], 100.0f));
+    if (isnan(point.values[HISTORY_SOC])) {
+      soc.add(nullptr);
+    } else {
+      soc.add(fixedDecimals(point.values[HISTORY_SOC], 10.0f));
+    }
+    solar.add(lroundf(point.values[HISTORY_SOLAR]));
+
+    bytes += measureJson(t[fitted]) + measureJson(voltage[fitted]) + measureJson(current[fitted]) +
+             measureJson(soc[fitted]) + measureJson(solar[fitted]) + (fitted > 0 ? 5 : 0);
+    if (doc.overflowed() || bytes > VICTRON_HISTORY_CHUNK_MAX_BYTES) {
+      t.remove(fitted);
+      voltage.remove(fitted);
+      current.remove(fitted);
+      soc.remove(fitted);
+      solar.remove(fitted);
+      break;
+    }
+  }
+
+  if (fitted < count) {
+    if (fitted == 0) {
+      endHistoryStream("chunk too large");
+      return;
+    }
+    // Rest goes in the next chunk: move the copy only past the points that fit
+    cursor = historyCursor;
+    history.read(cursor, points, fitted);
+    if (!cursor.truncated) {
+      doc.remove("truncated");
+    }
+    last = false;
+  }
+  doc["last"] = last;
+
+  String jsonString;
+  serializeJson(doc, jsonString);
+  String topic = String(MQTT_TOPIC_SENSORS) + MODULE_ID + "/history";
+  if (!publishTimed(topic, jsonString, false)) {
+    // Same chunk and seq again on the next interval, up to the retry limit
+    if (++historyChunkFailures >= VICTRON_HISTORY_CHUNK_RETRIES) {
+      endHistoryStream("publish failed");
+    }
+    return;
+  }
+
+  historyCursor = cursor;
+  historyChunkSeq++;
+  historyChunkFailures = 0;
+  historyStreaming = !last;
+}
+
+// Stop a query that cannot go on: an empty last chunk with the reason, so the client is not left waiting
+void VictronManager::endHistoryStream(const char *error) {
+  LOG_WARN("⚠️ History query ended at chunk %u: %s", historyChunkSeq, error);
+  historyStreaming = false;
+
+  StaticJsonDocument<384> doc;
+  beginHistoryChunk(doc, (VictronHistoryResolution)historyCursor.resolution);
+  doc["error"] = error;
+  doc["last"] = true;
+  doc.createNestedArray("t");
+  doc.createNestedArray("v");
+  doc.createNestedArray("i");
+  doc.createNestedArray("soc");
+  doc.createNestedArray("pv");
+
+  String jsonString;
+  serializeJson(doc, jsonString);
+  publishTimed(String(MQTT_TOPIC_SENSORS) + MODULE_ID + "/history", jsonString, false);
+}
+
 void VictronManager::printStatus() const {
   if (!DEBUG_SERIAL) {
     return;
@@ -543,10 +500,34 @@ void VictronManager::printStatus() const {
 
   Serial.println("Victron Manager Status:");
   Serial.println("  BLE initialized: " + String(bleInitialized ? "Yes" : "No"));
-  Serial.println("  BLE scan active: " + String(bleScanActive ? "Yes" : "No"));
-  Serial.println("  SmartShunt data: " + String(smartShuntCache.hasData ? "Yes" : "No"));
-  Serial.println("  MPPT1 data: " + String(mppt1Cache.hasData ? "Yes" : "No"));
-  Serial.println("  MPPT2 data: " + String(mppt2Cache.hasData ? "Yes" : "No"));
-  Serial.println("  Orion data: " + String(orionCache.hasData ? "Yes" : "No"));
-  Serial.println("  AC Charger data: " + String(acChargerCache.hasData ? "Yes" : "No"));
+  Serial.println("  BLE scan active: " + String(bleScanActive ? "Yes" : "No") +
+                 (VICTRON_ADAPTIVE_SCAN ? " (adaptive)" : " (continuous)"));
+  Serial.println("  BLE records: " + String(recordQueue.getPushedCount()) + " queued, " +
+                 String(recordQueue.getDroppedCount()) + " dropped (queue full), max waiting " +
+                 String(recordQueue.getHighWater()) + "/" + String(VICTRON_RECORD_QUEUE_DEPTH));
+  unsigned long nowMs = millis();
+  for (uint8_t i = 0; i < VICTRON_DEVICE_COUNT; i++) {
+    uint32_t ageMs;
+    String age = scanScheduler.getDataAge(i, nowMs, ageMs) ? String(ageMs) + " ms" : String("-");
+    Serial.println("  " + String(deviceStore.getDeviceName(i)) + " age " + age + ", new data every ~" +
+                   String(scanScheduler.getCadenceMs(i)) + " ms, advertises every ~" +
+                   String(scanScheduler.getAdvPeriodMs(i)) + " ms");
+    const VictronDeviceReception &rx = receptionStats.get(i);
+    Serial.println("    seen " + String(rx.seen) + ", duplicates " + String(rx.duplicates) + ", key rejects " +
+                   String(rx.keyRejects) + ", decrypt failures " + String(rx.decryptFailures) + ", counter gaps " +
+                   String(rx.counterGaps) + " (this diagnostics window)");
+  }
+  Serial.println("  SmartShunt data: " + String(deviceStore.hasData(ROLE_SMARTSHUNT) ? "Yes" : "No"));
+  Serial.println("  MPPT1 data: " + String(deviceStore.hasData(ROLE_MPPT1) ? "Yes" : "No"));
+  Serial.println("  MPPT2 data: " + String(deviceStore.hasData(ROLE_MPPT2) ? "Yes" : "No"));
+  Serial.println("  Orion data: " + String(deviceStore.hasData(ROLE_ORION) ? "Yes" : "No"));
+  Serial.println("  AC Charger data: " + String(deviceStore.hasData(ROLE_AC_CHARGER) ? "Yes" : "No"));
+
+  const VictronHistoryResolution resolutions[] = {HISTORY_1S, HISTORY_1M, HISTORY_1H};
+  for (VictronHistoryResolution resolution : resolutions) {
+    VictronHistoryTierStats stats = history.getStats(resolution);
+    Serial.println("  History " + String(VictronHistory::getResolutionName(resolution)) + ": " +
+                   String(stats.points) + " points, " + String(stats.bytes) + "/" + String(stats.capacity) +
+                   " bytes");
+  }
 }
@@ -0,0 +1,115 @@
+// Victron Reception Stats Implementation
+
+#include "VictronReceptionStats.h"
+#include <cstring>
+
+static const uint16_t MAX_COUNTER_STEPS = 64;  // More = device restarted, counter jumped
+
+static uint8_t arrivalBucket(unsigned long gapMs) {
+  uint8_t bucket = 0;
+  while (bucket < VICTRON_ARRIVAL_BUCKETS - 1 && gapMs >= VICTRON_ARRIVAL_BOUNDS_MS[bucket]) {
+    bucket++;
+  }
+  return bucket;
+}
+
+VictronReceptionStats::VictronReceptionStats() {
+  memset(history, 0, sizeof(history));
+  reset();
+}
+
+void VictronReceptionStats::reset() {
+  memset(windows, 0, sizeof(windows));
+  for (size_t i = 0; i < VICTRON_DEVICE_COUNT; i++) {
+    windows[i].rssiMin = INT8_MAX;
+    windows[i].rssiMax = INT8_MIN;
+  }
+}
+
+void VictronReceptionStats::onRecord(const VictronRawRecord &raw, VictronRecordResult result,
+                                     VictronRejectReason reason, uint16_t dataCounter,
+                                     unsigned long listeningSinceMs) {
+  if (raw.deviceIndex >= VICTRON_DEVICE_COUNT) {
+    return;
+  }
+  VictronDeviceReception &window = windows[raw.deviceIndex];
+  DeviceHistory &device = history[raw.deviceIndex];
+
+  window.seen++;
+  window.rssiSum += raw.rssi;
+  if (raw.rssi < window.rssiMin) {
+    window.rssiMin = raw.rssi;
+  }
+  if (raw.rssi > window.rssiMax) {
+    window.rssiMax = raw.rssi;
+  }
+
+  if (device.hasAdvertisement && (long)(raw.receivedAt - device.lastAdvertisementMs) >= 0) {
+    window.arrivals[arrivalBucket(raw.receivedAt - device.lastAdvertisementMs)]++;
+  }
+  device.hasAdvertisement = true;
+  device.lastAdvertisementMs = raw.receivedAt;
+
+  switch (result) {
+    case VICTRON_RECORD_DUPLICATE:
+      window.duplicates++;
+      break;
+
+    case VICTRON_RECORD_UPDATED:
+      if (device.hasCounter && (long)(device.lastUpdateMs - listeningSinceMs) >= 0) {
+        uint16_t steps = (uint16_t)(dataCounter - device.lastCounter);
+        if (steps > 1 && steps <= MAX_COUNTER_STEPS) {
+          window.counterGaps += steps - 1;
+        }
+      }
+      device.hasCounter = true;
+      device.lastCounter = dataCounter;
+      device.lastUpdateMs = raw.receivedAt;
+      break;
+
+    default:
+      switch (reason) {
+        case VICTRON_REJECT_KEY:
+          window.keyRejects++;
+          break;
+        case VICTRON_REJECT_DECRYPT:
+        case VICTRON_REJECT_PARSE:
+          window.decryptFailures++;
+          break;
+        default:
+          window.otherRejects++;
+          break;
+      }
+      break;
+  }
+}
+
+void VictronReceptionStats::appendDiagnosticsJson(JsonDocument &doc, const VictronDeviceStore &store) const {
+  JsonObject devices = doc.createNestedObject("devices");
+  for (uint8_t i = 0; i < VICTRON_DEVICE_COUNT; i++) {
+    const VictronDeviceReception &window = windows[i];
+    JsonObject obj = devices.createNestedObject(store.getDeviceName(i));
+
+    obj["seen"] = window.seen;
+    obj["dup"] = window.duplicates;
+    obj["keyRej"] = window.keyRejects;
+    obj["decFail"] = window.decryptFailures;
+    obj["rej"] = window.otherRejects;
+    obj["gaps"] = window.counterGaps;
+
+    // [min, avg, max] dBm
+    if (window.seen > 0) {
+      JsonArray rssi = obj.createNestedArray("rssi");
+      rssi.add(window.rssiMin);
+      rssi.add((int)(window.rssiSum / (int32_t)window.seen));
+      rssi.add(window.rssiMax);
+    } else {
+      obj["rssi"] = nullptr;
+    }
+
+    JsonArray arrivals = obj.createNestedArray("arrivals");
+    for (uint8_t bucket = 0; bucket < VICTRON_ARRIVAL_BUCKETS; bucket++) {
+      arrivals.add(window.arrivals[bucket]);
+    }
+  }
+}
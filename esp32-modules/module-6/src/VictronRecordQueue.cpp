@@ -0,0 +1,44 @@
+// Victron Record Queue Implementation
+// head/tail are free-running counters; each side only writes its own index and
+// reads the other with acquire ordering, so no locks or CAS are needed.
+
+#include "VictronRecordQueue.h"
+
+static_assert((VICTRON_RECORD_QUEUE_DEPTH & (VICTRON_RECORD_QUEUE_DEPTH - 1)) == 0,
+              "VICTRON_RECORD_QUEUE_DEPTH must be a power of two");
+
+VictronRecordQueue::VictronRecordQueue()
+    : head(0), tail(0), pushed(0), dropped(0), highWater(0) {}
+
+VictronRawRecord *VictronRecordQueue::reserve() {
+  uint32_t h = head.load(std::memory_order_relaxed);
+  if (h - tail.load(std::memory_order_acquire) >= VICTRON_RECORD_QUEUE_DEPTH) {
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  return &slots[h & (VICTRON_RECORD_QUEUE_DEPTH - 1)];
+}
+
+void VictronRecordQueue::commit() {
+  uint32_t h = head.load(std::memory_order_relaxed) + 1;
+  head.store(h, std::memory_order_release);  // Slot contents visible before the index
+  pushed.fetch_add(1, std::memory_order_relaxed);
+
+  uint32_t waiting = h - tail.load(std::memory_order_relaxed);
+  if (waiting > highWater.load(std::memory_order_relaxed)) {
+    highWater.store(waiting, std::memory_order_relaxed);
+  }
+}
+
+const VictronRawRecord *VictronRecordQueue::front() {
+  uint32_t t = tail.load(std::memory_order_relaxed);
+  if (t == head.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  return &slots[t & (VICTRON_RECORD_QUEUE_DEPTH - 1)];
+}
+
+void VictronRecordQueue::release() {
+  // Slot reads done before the producer may reuse it
+  tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
@@ -0,0 +1,166 @@
+// Victron Scan Scheduler Implementation
+
+#include "VictronScanScheduler.h"
+
+static const uint32_t INITIAL_CADENCE_MS = 1000;   // Until learned; Victron changes data about once a second
+static const uint32_t INITIAL_ADV_PERIOD_MS = 200;
+static const uint32_t MIN_CADENCE_MS = 100;
+static const uint16_t MAX_COUNTER_STEPS = 64;      // More = device restarted, counter jumped
+
+// Integer EWMA with weight 1/2^shift for the new sample
+static uint32_t smooth(uint32_t average, uint32_t sample, uint8_t shift) {
+  return (uint32_t)((int32_t)average + (((int32_t)sample - (int32_t)average) >> shift));
+}
+
+static bool notBefore(unsigned long t, unsigned long reference) { return (long)(t - reference) >= 0; }
+
+VictronScanScheduler::VictronScanScheduler()
+    : scanning(false),
+      sessionStartMs(0),
+      probeStartMs(0),
+      probed(false),
+      dutyStartMs(0),
+      dutyOnMs(0),
+      dutyMarkMs(0) {
+  begin(0);
+}
+
+void VictronScanScheduler::begin(unsigned long nowMs) {
+  for (size_t i = 0; i < VICTRON_DEVICE_COUNT; i++) {
+    devices[i].seen = false;
+    devices[i].lastCounter = 0;
+    devices[i].lastNewMs = nowMs;  // Lost after VICTRON_SCAN_LOST_MS without data
+    devices[i].lastAdvMs = nowMs;
+    devices[i].cadenceMs = INITIAL_CADENCE_MS;
+    devices[i].advPeriodMs = INITIAL_ADV_PERIOD_MS;
+  }
+  scanning = false;
+  sessionStartMs = nowMs;
+  probed = false;
+  dutyStartMs = nowMs;
+  dutyOnMs = 0;
+  dutyMarkMs = nowMs;
+}
+
+void VictronScanScheduler::onRecord(uint8_t deviceIndex, VictronRecordResult result, uint16_t dataCounter,
+                                    unsigned long receivedAt) {
+  if (deviceIndex >= VICTRON_DEVICE_COUNT || result == VICTRON_RECORD_REJECTED) {
+    return;
+  }
+  DeviceTiming &device = devices[deviceIndex];
+
+  // Repeats are only back to back when both fell into the same scan session
+  if (notBefore(device.lastAdvMs, sessionStartMs) && notBefore(receivedAt, sessionStartMs) &&
+      receivedAt - device.lastAdvMs > 0 && receivedAt - device.lastAdvMs < VICTRON_SCAN_LOST_MS) {
+    device.advPeriodMs = smooth(device.advPeriodMs, receivedAt - device.lastAdvMs, 3);
+  }
+  device.lastAdvMs = receivedAt;
+
+  if (result != VICTRON_RECORD_UPDATED) {
+    return;
+  }
+
+  if (device.seen) {
+    uint16_t steps = (uint16_t)(dataCounter - device.lastCounter);
+    long gapMs = (long)(receivedAt - device.lastNewMs);
+    if (steps > 0 && steps <= MAX_COUNTER_STEPS && gapMs > 0 && gapMs < VICTRON_SCAN_LOST_MS) {
+      device.cadenceMs = smooth(device.cadenceMs, (uint32_t)gapMs / steps, 2);
+      if (device.cadenceMs < MIN_CADENCE_MS) {
+        device.cadenceMs = MIN_CADENCE_MS;
+      }
+    }
+  }
+  device.seen = true;
+  device.lastCounter = dataCounter;
+  device.lastNewMs = receivedAt;
+}
+
+bool VictronScanScheduler::isLost(const DeviceTiming &device, unsigned long nowMs) const {
+  return (long)(nowMs - device.lastNewMs) >= (long)VICTRON_SCAN_LOST_MS;
+}
+
+// Last counter step (on the learned cadence) that still arrives before the target age,
+// minus the lead for the advertisement carrying it
+unsigned long VictronScanScheduler::wakeAt(const DeviceTiming &device) const {
+  uint32_t leadMs = device.advPeriodMs > VICTRON_SCAN_LEAD_MS ? device.advPeriodMs : VICTRON_SCAN_LEAD_MS;
+  uint32_t steps = VICTRON_SCAN_TARGET_AGE_MS > leadMs ? (VICTRON_SCAN_TARGET_AGE_MS - leadMs) / device.cadenceMs : 0;
+  if (steps == 0) {
+    steps = 1;  // Cadence longer than the target: just catch the next step
+  }
+  return device.lastNewMs + steps * device.cadenceMs - leadMs;
+}
+
+bool VictronScanScheduler::wantsScan(unsigned long nowMs) {
+  bool want = false;
+  bool anyLost = false;
+
+  for (size_t i = 0; i < VICTRON_DEVICE_COUNT; i++) {
+    const DeviceTiming &device = devices[i];
+    if (isLost(device, nowMs)) {
+      anyLost = true;
+      continue;
+    }
+    if (!device.seen) {
+      want = true;  // Still searching after begin()
+      continue;
+    }
+
+    long untilWakeMs = (long)(wakeAt(device) - nowMs);
+    if (untilWakeMs <= 0) {
+      want = true;
+    } else if (scanning && untilWakeMs <= (long)device.cadenceMs && !notBefore(device.lastNewMs, sessionStartMs)) {
+      // Radio is on anyway: catch devices that are nearly due, so their windows line up
+      want = true;
+    }
+  }
+
+  if (anyLost) {
+    if (!probed || nowMs - probeStartMs >= VICTRON_SCAN_PROBE_INTERVAL_MS) {
+      probed = true;
+      probeStartMs = nowMs;
+    }
+    if (nowMs - probeStartMs < VICTRON_SCAN_PROBE_MS) {
+      want = true;
+    }
+  }
+
+  if (scanning && nowMs - sessionStartMs < VICTRON_SCAN_MIN_ON_MS) {
+    want = true;
+  }
+  return want;
+}
+
+void VictronScanScheduler::setScanning(bool on, unsigned long nowMs) {
+  if (on == scanning) {
+    return;
+  }
+  if (on) {
+    sessionStartMs = nowMs;
+  } else {
+    dutyOnMs += nowMs - dutyMarkMs;
+  }
+  dutyMarkMs = nowMs;
+  scanning = on;
+}
+
+uint8_t VictronScanScheduler::takeDutyPercent(unsigned long nowMs) {
+  unsigned long onMs = dutyOnMs + (scanning ? nowMs - dutyMarkMs : 0);
+  unsigned long totalMs = nowMs - dutyStartMs;
+  dutyStartMs = nowMs;
+  dutyMarkMs = nowMs;
+  dutyOnMs = 0;
+
+  if (totalMs == 0) {
+    return scanning ? 100 : 0;
+  }
+  return (uint8_t)((uint64_t)onMs * 100 / totalMs);
+}
+
+bool VictronScanScheduler::getDataAge(uint8_t deviceIndex, unsigned long nowMs, uint32_t &ageMs) const {
+  if (deviceIndex >= VICTRON_DEVICE_COUNT || !devices[deviceIndex].seen) {
+    return false;
+  }
+  long age = (long)(nowMs - devices[deviceIndex].lastNewMs);
+  ageMs = age > 0 ? (uint32_t)age : 0;
+  return true;
+}
@@ -0,0 +1,31 @@
+// Host build shim for module-6 parser tools (not used by the firmware build)
+// Provides just enough of the Arduino headers for VictronBleParser and
+// VictronDeviceStore to compile on Linux. Serial output goes to stderr.
+
+#ifndef HOST_ARDUINO_SHIM_H
+#define HOST_ARDUINO_SHIM_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+class HostSerial {
+ public:
+  void print(const char *text) {
+    if (enabled) fputs(text, stderr);
+  }
+  void println(const char *text) {
+    if (enabled) fprintf(stderr, "%s\n", text);
+  }
+  void setEnabled(bool on) { enabled = on; }
+
+ private:
+  bool enabled = true;
+};
+
+inline HostSerial Serial;  // One instance across translation units
+
+#endif
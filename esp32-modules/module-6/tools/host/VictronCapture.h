@@ -0,0 +1,147 @@
+// Victron advertisement capture file (.vcap) - host tools only
+//
+// Written by the test firmware's capture mode (esp32-modules/test, CAPTURE_MODE)
+// as "VCAP:<hex>" serial lines, one record per line, and converted to the binary
+// file with `victron_replay --import`. All integers little-endian.
+//
+//   file header   "VCAP" | u8 version (1) | u8[3] reserved
+//   record        u32 timeMs (since capture start) | u8 mac[6] (BLEAddress::getNative() order)
+//                 | i8 rssi | u8 len | u8 data[len] (raw manufacturer data, vendor id first)
+
+#ifndef VICTRON_CAPTURE_H
+#define VICTRON_CAPTURE_H
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+static const uint8_t VCAP_VERSION = 1;
+static const size_t VCAP_RECORD_HEADER_LEN = 12;
+static const size_t VCAP_DATA_MAX = 31;
+
+struct CaptureRecord {
+  uint32_t timeMs;
+  uint8_t mac[6];
+  int8_t rssi;
+  uint8_t len;
+  uint8_t data[VCAP_DATA_MAX];
+};
+
+// Serialize one record (as sent after "VCAP:" by the firmware, and as stored in the file)
+inline size_t encodeCaptureRecord(const CaptureRecord &record, uint8_t *out) {
+  out[0] = (uint8_t)record.timeMs;
+  out[1] = (uint8_t)(record.timeMs >> 8);
+  out[2] = (uint8_t)(record.timeMs >> 16);
+  out[3] = (uint8_t)(record.timeMs >> 24);
+  memcpy(out + 4, record.mac, 6);
+  out[10] = (uint8_t)record.rssi;
+  out[11] = record.len;
+  memcpy(out + VCAP_RECORD_HEADER_LEN, record.data, record.len);
+  return VCAP_RECORD_HEADER_LEN + record.len;
+}
+
+// Parse one record from a buffer; returns bytes consumed or 0 if truncated/invalid
+inline size_t decodeCaptureRecord(const uint8_t *in, size_t inLen, CaptureRecord &record) {
+  if (inLen < VCAP_RECORD_HEADER_LEN) {
+    return 0;
+  }
+  record.timeMs = in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+  memcpy(record.mac, in + 4, 6);
+  record.rssi = (int8_t)in[10];
+  record.len = in[11];
+  if (record.len > VCAP_DATA_MAX || inLen < VCAP_RECORD_HEADER_LEN + record.len) {
+    return 0;
+  }
+  memcpy(record.data, in + VCAP_RECORD_HEADER_LEN, record.len);
+  return VCAP_RECORD_HEADER_LEN + record.len;
+}
+
+inline bool writeCaptureFile(const char *path, const std::vector<CaptureRecord> &records) {
+  FILE *file = fopen(path, "wb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  const uint8_t header[8] = {'V', 'C', 'A', 'P', VCAP_VERSION, 0, 0, 0};
+  bool ok = fwrite(header, 1, sizeof(header), file) == sizeof(header);
+  uint8_t buffer[VCAP_RECORD_HEADER_LEN + VCAP_DATA_MAX];
+  for (size_t i = 0; ok && i < records.size(); i++) {
+    size_t len = encodeCaptureRecord(records[i], buffer);
+    ok = fwrite(buffer, 1, len, file) == len;
+  }
+
+  return fclose(file) == 0 && ok;
+}
+
+inline bool readCaptureFile(const char *path, std::vector<CaptureRecord> &records) {
+  FILE *file = fopen(path, "rb");
+  if (file == nullptr) {
+    return false;
+  }
+
+  std::vector<uint8_t> bytes;
+  uint8_t chunk[4096];
+  size_t n;
+  while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+    bytes.insert(bytes.end(), chunk, chunk + n);
+  }
+  fclose(file);
+
+  if (bytes.size() < 8 || memcmp(bytes.data(), "VCAP", 4) != 0 || bytes[4] != VCAP_VERSION) {
+    return false;
+  }
+
+  size_t offset = 8;
+  while (offset < bytes.size()) {
+    CaptureRecord record;
+    size_t used = decodeCaptureRecord(bytes.data() + offset, bytes.size() - offset, record);
+    if (used == 0) {
+      return false;
+    }
+    records.push_back(record);
+    offset += used;
+  }
+  return true;
+}
+
+// Collect "VCAP:<hex>" lines from a serial log (monitor prefixes such as timestamps are ignored)
+inline bool importSerialLog(const char *path, std::vector<CaptureRecord> &records, size_t &badLines) {
+  FILE *file = fopen(path, "r");
+  if (file == nullptr) {
+    return false;
+  }
+
+  badLines = 0;
+  char line[512];
+  while (fgets(line, sizeof(line), file) != nullptr) {
+    const char *hex = strstr(line, "VCAP:");
+    if (hex == nullptr) {
+      continue;
+    }
+    hex += 5;
+
+    uint8_t bytes[VCAP_RECORD_HEADER_LEN + VCAP_DATA_MAX];
+    size_t len = 0;
+    while (len < sizeof(bytes) && isxdigit((unsigned char)hex[0]) && isxdigit((unsigned char)hex[1])) {
+      char byteStr[3] = {hex[0], hex[1], '\0'};
+      bytes[len++] = (uint8_t)strtoul(byteStr, nullptr, 16);
+      hex += 2;
+    }
+
+    CaptureRecord record;
+    size_t used = decodeCaptureRecord(bytes, len, record);
+    if (used == 0 || used != len) {
+      badLines++;
+      continue;
+    }
+    records.push_back(record);
+  }
+
+  fclose(file);
+  return true;
+}
+
+#endif
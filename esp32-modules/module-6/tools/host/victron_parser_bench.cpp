@@ -0,0 +1,626 @@
+/**
+ * Host benchmark for the Victron record parsers (VictronBleParser).
+ *
+ * - Checks BitReader against a bit-by-bit reference (every field width/offset,
+ *   including reads past the end of the record).
+ * - Checks the table-driven parse* functions against the previous hand-written parsers
+ *   (corpus plus random payloads; valid flags, and values where valid).
+ * - Times each parse* function over a corpus of records per type and reports ns/record,
+ *   next to the hand-written parser and the bare field walk done with BitReader and
+ *   with the bit-by-bit reference.
+ * - Checks VictronCipher against the previous per-call AES-CTR decrypt and times both.
+ *
+ * Build and run (Linux, needs libmbedtls-dev for mbedtls/aes.h):
+ *   cd esp32-modules/module-6
+ *   g++ -std=gnu++17 -O2 -Itools/host -Iinclude -Isrc \
+ *       tools/host/victron_parser_bench.cpp src/VictronBleParser.cpp \
+ *       -lmbedcrypto -o /tmp/victron_parser_bench
+ *   /tmp/victron_parser_bench
+ *
+ * The built-in corpus encodes typical readings from the camper devices (plus
+ * invalid/sentinel values) with the documented Victron record layouts.
+ */
+
+#include "VictronBleParser.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Reference reader (previous bit-by-bit implementation)
+// ---------------------------------------------------------------------------
+
+class ReferenceBitReader {
+ public:
+  ReferenceBitReader(const uint8_t *data, size_t dataLen) : data(data), dataLen(dataLen), cursor(0) {}
+
+  bool readBit() {
+    if (cursor >= dataLen * 8) {
+      return false;
+    }
+    bool value = (data[cursor / 8] >> (cursor % 8)) & 0x01;
+    cursor++;
+    return value;
+  }
+
+  uint32_t readUnsigned(uint8_t bitCount) {
+    uint32_t value = 0;
+    for (uint8_t i = 0; i < bitCount; i++) {
+      if (readBit()) {
+        value |= (1U << i);
+      }
+    }
+    return value;
+  }
+
+  int32_t readSigned(uint8_t bitCount) {
+    uint32_t raw = readUnsigned(bitCount);
+    if (bitCount < 32 && (raw & (1U << (bitCount - 1)))) {
+      raw |= ~0U << bitCount;
+    }
+    return (int32_t)raw;
+  }
+
+  void skip(uint8_t bitCount) {
+    for (uint8_t i = 0; i < bitCount; i++) {
+      readBit();
+    }
+  }
+
+ private:
+  const uint8_t *data;
+  size_t dataLen;
+  size_t cursor;
+};
+
+// Previous decrypt: key schedule expanded on every advertisement
+static bool referenceDecrypt(const uint8_t *key, const uint8_t *cipher, size_t cipherLen,
+                             uint8_t counterLsb, uint8_t counterMsb, uint8_t *plainOut) {
+  mbedtls_aes_context aes;
+  mbedtls_aes_init(&aes);
+  if (mbedtls_aes_setkey_enc(&aes, key, 128) != 0) {
+    mbedtls_aes_free(&aes);
+    return false;
+  }
+
+  uint8_t nonce[16] = {counterLsb, counterMsb, 0};
+  size_t ncOffset = 0;
+  uint8_t streamBlock[16];
+  int result = mbedtls_aes_crypt_ctr(&aes, cipherLen, &ncOffset, nonce, streamBlock, cipher, plainOut);
+  mbedtls_aes_free(&aes);
+  return result == 0;
+}
+
+// ---------------------------------------------------------------------------
+// Reference parsers (previous hand-written versions, before the layout tables)
+// ---------------------------------------------------------------------------
+
+__attribute__((noinline)) static bool referenceBatteryMonitor(const uint8_t *payload, size_t payloadLen, SmartShuntReading &out) {
+  BitReader reader(payload, payloadLen);
+
+  uint16_t timeToGo = (uint16_t)reader.readUnsigned(16);
+  int16_t voltageRaw = (int16_t)reader.readSigned(16);
+  uint16_t alarmReason = (uint16_t)reader.readUnsigned(16);
+
+  reader.skip(16);
+
+  reader.readUnsigned(2);
+  uint32_t currentRawU = reader.readUnsigned(22);
+  uint32_t consumedRaw = reader.readUnsigned(20);
+  uint16_t socRaw = (uint16_t)reader.readUnsigned(10);
+
+  out.timeToGoValid = timeToGo != 0xFFFF;
+  out.timeToGoMin = timeToGo;
+
+  out.voltageValid = voltageRaw != 0x7FFF;
+  out.voltage = roundTo1Decimal(voltageRaw * 0.01f);
+
+  out.alarmReason = alarmReason;
+
+  out.currentValid = currentRawU != 0x3FFFFF;
+  if (out.currentValid) {
+    int32_t currentRaw = (int32_t)currentRawU;
+    if (currentRawU & (1U << 21)) {
+      currentRaw = (int32_t)(currentRawU | (~0U << 22));
+    }
+    out.current = roundTo2Decimals(currentRaw * 0.001f);
+  }
+
+  out.socValid = socRaw != 0x3FF;
+  out.soc = (int)lroundf(socRaw * 0.1f);
+
+  out.consumedAhValid = consumedRaw != 0xFFFFF;
+  out.consumedAh = roundTo1Decimal(consumedRaw * -0.1f);
+
+  return true;
+}
+
+__attribute__((noinline)) static bool referenceSolarCharger(const uint8_t *payload, size_t payloadLen, MpptReading &out) {
+  BitReader reader(payload, payloadLen);
+
+  out.deviceState = (uint8_t)reader.readUnsigned(8);
+  out.errorCode = (uint8_t)reader.readUnsigned(8);
+
+  int16_t batteryVoltageRaw = (int16_t)reader.readSigned(16);
+  int16_t batteryCurrentRaw = (int16_t)reader.readSigned(16);
+  uint16_t yieldTodayRaw = (uint16_t)reader.readUnsigned(16);
+  uint16_t pvPowerRaw = (uint16_t)reader.readUnsigned(16);
+
+  reader.readUnsigned(9);
+
+  out.batteryVoltageValid = batteryVoltageRaw != 0x7FFF;
+  out.batteryVoltage = roundTo1Decimal(batteryVoltageRaw * 0.01f);
+
+  out.batteryCurrentValid = batteryCurrentRaw != 0x7FFF;
+  out.batteryCurrent = roundTo2Decimals(batteryCurrentRaw * 0.1f);
+
+  out.yieldTodayValid = yieldTodayRaw != 0xFFFF;
+  out.yieldTodayKwh = roundTo2Decimals(yieldTodayRaw * 0.01f);
+
+  out.pvPowerValid = pvPowerRaw != 0xFFFF;
+  out.pvPower = pvPowerRaw;
+
+  return true;
+}
+
+__attribute__((noinline)) static bool referenceOrionXs(const uint8_t *payload, size_t payloadLen, OrionReading &out) {
+  BitReader reader(payload, payloadLen);
+
+  out.deviceState = (uint8_t)reader.readUnsigned(8);
+  out.errorCode = (uint8_t)reader.readUnsigned(8);
+
+  int16_t outputVoltageRaw = (int16_t)reader.readSigned(16);
+  int16_t outputCurrentRaw = (int16_t)reader.readSigned(16);
+  uint16_t inputVoltageRaw = (uint16_t)reader.readUnsigned(16);
+  uint16_t inputCurrentRaw = (uint16_t)reader.readUnsigned(16);
+  out.offReason = reader.readUnsigned(32);
+
+  out.outputVoltageValid = outputVoltageRaw != 0x7FFF;
+  out.outputVoltage = roundTo1Decimal(outputVoltageRaw * 0.01f);
+
+  out.outputCurrentValid = outputCurrentRaw != 0x7FFF;
+  out.outputCurrent = roundTo2Decimals(outputCurrentRaw * 0.1f);
+
+  out.inputVoltageValid = inputVoltageRaw != 0xFFFF;
+  out.inputVoltage = roundTo1Decimal(inputVoltageRaw * 0.01f);
+
+  out.inputCurrentValid = inputCurrentRaw != 0xFFFF;
+  out.inputCurrent = roundTo2Decimals(inputCurrentRaw * 0.1f);
+
+  return true;
+}
+
+__attribute__((noinline)) static bool referenceAcCharger(const uint8_t *payload, size_t payloadLen, AcChargerReading &out) {
+  BitReader reader(payload, payloadLen);
+
+  out.deviceState = (uint8_t)reader.readUnsigned(8);
+  out.errorCode = (uint8_t)reader.readUnsigned(8);
+
+  uint32_t voltageRaw = reader.readUnsigned(13);
+  uint32_t currentRaw = reader.readUnsigned(11);
+
+  reader.skip(13 + 11 + 13 + 11 + 13 + 11 + 7);
+
+  uint32_t acCurrentRaw = reader.readUnsigned(9);
+
+  out.voltageValid = voltageRaw != 0x1FFF;
+  out.voltage = roundTo1Decimal(voltageRaw * 0.01f);
+
+  out.currentValid = currentRaw != 0x7FF;
+  out.current = roundTo2Decimals(currentRaw * 0.1f);
+
+  out.acCurrentValid = acCurrentRaw != 0x1FF;
+  out.acCurrent = roundTo2Decimals(acCurrentRaw * 0.1f);
+
+  return true;
+}
+
+// Not in the previous parser set; written the same way for the comparison
+__attribute__((noinline)) static bool referenceDcdcConverter(const uint8_t *payload, size_t payloadLen,
+                                                             OrionReading &out) {
+  BitReader reader(payload, payloadLen);
+  out = OrionReading();
+
+  out.deviceState = (uint8_t)reader.readUnsigned(8);
+  out.errorCode = (uint8_t)reader.readUnsigned(8);
+
+  uint16_t inputVoltageRaw = (uint16_t)reader.readUnsigned(16);
+  int16_t outputVoltageRaw = (int16_t)reader.readSigned(16);
+  out.offReason = reader.readUnsigned(32);
+
+  out.inputVoltageValid = inputVoltageRaw != 0xFFFF;
+  out.inputVoltage = roundTo1Decimal(inputVoltageRaw * 0.01f);
+
+  out.outputVoltageValid = outputVoltageRaw != 0x7FFF;
+  out.outputVoltage = roundTo1Decimal(outputVoltageRaw * 0.01f);
+
+  return true;
+}
+
+// ---------------------------------------------------------------------------
+// Corpus
+// ---------------------------------------------------------------------------
+
+class BitWriter {
+ public:
+  explicit BitWriter(size_t len) : bytes(len, 0), cursor(0) {}
+
+  void write(uint32_t value, uint8_t bitCount) {
+    for (uint8_t i = 0; i < bitCount; i++, cursor++) {
+      if ((value >> i) & 1U) {
+        bytes[cursor / 8] |= (uint8_t)(1U << (cursor % 8));
+      }
+    }
+  }
+
+  std::vector<uint8_t> bytes;
+
+ private:
+  size_t cursor;
+};
+
+struct CorpusRecord {
+  uint8_t recordType;
+  std::vector<uint8_t> payload;
+};
+
+// Field widths per record type, in parse order (negative = skipped bits)
+static const std::vector<int> BATTERY_MONITOR_FIELDS = {16, 16, 16, -16, 2, 22, 20, 10};
+static const std::vector<int> SOLAR_CHARGER_FIELDS = {8, 8, 16, 16, 16, 16, 9};
+static const std::vector<int> ORION_XS_FIELDS = {8, 8, 16, 16, 16, 16, 32};
+static const std::vector<int> DCDC_CONVERTER_FIELDS = {8, 8, 16, 16, 32};
+static const std::vector<int> AC_CHARGER_FIELDS = {8, 8, 13, 11, -79, 9};
+
+static std::vector<uint8_t> encode(const std::vector<int> &widths, const std::vector<uint32_t> &values,
+                                   size_t len) {
+  BitWriter writer(len);
+  size_t valueIndex = 0;
+  for (int width : widths) {
+    if (width < 0) {
+      writer.write(0, (uint8_t)-width);
+    } else {
+      writer.write(values[valueIndex++], (uint8_t)width);
+    }
+  }
+  return writer.bytes;
+}
+
+static std::vector<CorpusRecord> buildCorpus() {
+  std::vector<CorpusRecord> corpus;
+  std::mt19937 rng(6);
+  auto pick = [&rng](uint32_t range) { return (uint32_t)(rng() % range); };
+
+  for (int i = 0; i < 64; i++) {
+    // SmartShunt: TTG min, 13.2 V, no alarm, -4.2..+30 A, consumed Ah, SOC
+    uint32_t current = (uint32_t)((int32_t)pick(34000) - 4200) & 0x3FFFFF;
+    corpus.push_back({RECORD_BATTERY_MONITOR,
+                      encode(BATTERY_MONITOR_FIELDS,
+                             {i % 8 == 0 ? 0xFFFFu : 600 + pick(3000), 1290 + pick(60), 0, 0,
+                              i % 16 == 0 ? 0x3FFFFFu : current, pick(800), 700 + pick(300)},
+                             15)});
+
+    // MPPT: bulk/absorption, 13.4 V, 0..25 A (0.1 A), yield, PV power
+    corpus.push_back({RECORD_SOLAR_CHARGER,
+                      encode(SOLAR_CHARGER_FIELDS,
+                             {3 + pick(2), 0, 1300 + pick(150), pick(250), pick(300),
+                              i % 8 == 0 ? 0xFFFFu : pick(400), 0},
+                             13)});
+
+    // Orion XS: 13.6 V out, 0..30 A, 12.8 V in, input current, off reason
+    corpus.push_back({RECORD_ORION_XS,
+                      encode(ORION_XS_FIELDS,
+                             {3, 0, 1340 + pick(40), pick(300), 1250 + pick(80), pick(320),
+                              i % 4 == 0 ? 0x00000001u : 0},
+                             16)});
+
+    // Orion-Tr Smart (DC/DC record): 12.8 V in, 13.6 V out, off reason
+    corpus.push_back({RECORD_DCDC_CONVERTER,
+                      encode(DCDC_CONVERTER_FIELDS,
+                             {3, 0, i % 8 == 0 ? 0xFFFFu : 1250 + pick(80), 1340 + pick(40),
+                              i % 4 == 0 ? 0x00000001u : 0},
+                             10)});
+
+    // AC charger: 14.1 V, 0..30 A, output 2/3 unused, AC current
+    corpus.push_back({RECORD_AC_CHARGER,
+                      encode(AC_CHARGER_FIELDS,
+                             {4, 0, 1380 + pick(60), pick(300), i % 8 == 0 ? 0x1FFu : pick(80)}, 16)});
+  }
+
+  return corpus;
+}
+
+// ---------------------------------------------------------------------------
+// Checks
+// ---------------------------------------------------------------------------
+
+static int checkReaderAgainstReference() {
+  std::mt19937 rng(31);
+  int mismatches = 0;
+
+  for (int iteration = 0; iteration < 200000; iteration++) {
+    uint8_t data[16];
+    size_t len = 1 + rng() % 16;
+    for (size_t i = 0; i < len; i++) {
+      data[i] = (uint8_t)rng();
+    }
+
+    BitReader reader(data, len);
+    ReferenceBitReader reference(data, len);
+
+    // Random field sequence that can run past the end of the record
+    for (int field = 0; field < 8; field++) {
+      uint8_t width = 1 + rng() % 32;
+      switch (rng() % 3) {
+        case 0:
+          mismatches += reader.readUnsigned(width) != reference.readUnsigned(width);
+          break;
+        case 1:
+          mismatches += reader.readSigned(width) != reference.readSigned(width);
+          break;
+        default:
+          reader.skip(width);
+          reference.skip(width);
+          break;
+      }
+    }
+  }
+
+  return mismatches;
+}
+
+// Float fields only matter when their valid flag is set (the firmware never reports them otherwise)
+#define SAME_VALID(a, b, flag, field) ((a).flag == (b).flag && (!(a).flag || (a).field == (b).field))
+
+static bool sameReading(const SmartShuntReading &a, const SmartShuntReading &b) {
+  return SAME_VALID(a, b, voltageValid, voltage) && SAME_VALID(a, b, currentValid, current) &&
+         SAME_VALID(a, b, socValid, soc) && SAME_VALID(a, b, consumedAhValid, consumedAh) &&
+         SAME_VALID(a, b, timeToGoValid, timeToGoMin) && a.alarmReason == b.alarmReason;
+}
+
+static bool sameReading(const MpptReading &a, const MpptReading &b) {
+  return a.deviceState == b.deviceState && a.errorCode == b.errorCode &&
+         SAME_VALID(a, b, batteryVoltageValid, batteryVoltage) &&
+         SAME_VALID(a, b, batteryCurrentValid, batteryCurrent) && SAME_VALID(a, b, pvPowerValid, pvPower) &&
+         SAME_VALID(a, b, yieldTodayValid, yieldTodayKwh);
+}
+
+static bool sameReading(const OrionReading &a, const OrionReading &b) {
+  return a.deviceState == b.deviceState && a.errorCode == b.errorCode &&
+         SAME_VALID(a, b, outputVoltageValid, outputVoltage) &&
+         SAME_VALID(a, b, outputCurrentValid, outputCurrent) &&
+         SAME_VALID(a, b, inputVoltageValid, inputVoltage) && SAME_VALID(a, b, inputCurrentValid, inputCurrent) &&
+         a.offReason == b.offReason;
+}
+
+static bool sameReading(const AcChargerReading &a, const AcChargerReading &b) {
+  return a.deviceState == b.deviceState && a.errorCode == b.errorCode &&
+         SAME_VALID(a, b, voltageValid, voltage) && SAME_VALID(a, b, currentValid, current) &&
+         SAME_VALID(a, b, acCurrentValid, acCurrent);
+}
+
+template <typename Reading>
+static int compareParsers(bool (*parse)(const uint8_t *, size_t, Reading &),
+                          bool (*reference)(const uint8_t *, size_t, Reading &), const uint8_t *payload,
+                          size_t payloadLen) {
+  Reading actual = Reading();
+  Reading expected = Reading();
+  bool ok = parse(payload, payloadLen, actual);
+  bool expectedOk = reference(payload, payloadLen, expected);
+  return ok != expectedOk || !sameReading(actual, expected);
+}
+
+static int compareRecord(uint8_t recordType, const uint8_t *payload, size_t payloadLen) {
+  switch (recordType) {
+    case RECORD_BATTERY_MONITOR:
+      return compareParsers(parseBatteryMonitor, referenceBatteryMonitor, payload, payloadLen);
+    case RECORD_SOLAR_CHARGER:
+      return compareParsers(parseSolarCharger, referenceSolarCharger, payload, payloadLen);
+    case RECORD_ORION_XS:
+      return compareParsers(parseOrionXs, referenceOrionXs, payload, payloadLen);
+    case RECORD_DCDC_CONVERTER:
+      return compareParsers(parseDcdcConverter, referenceDcdcConverter, payload, payloadLen);
+    case RECORD_AC_CHARGER:
+      return compareParsers(parseAcCharger, referenceAcCharger, payload, payloadLen);
+  }
+  return 0;
+}
+
+static int checkParsersAgainstReference(const std::vector<CorpusRecord> &corpus) {
+  int mismatches = 0;
+  for (const CorpusRecord &record : corpus) {
+    mismatches += compareRecord(record.recordType, record.payload.data(), record.payload.size());
+  }
+
+  // Random payloads of every length hit the sentinels and sign bits the corpus does not
+  std::mt19937 rng(36);
+  const uint8_t recordTypes[] = {RECORD_BATTERY_MONITOR, RECORD_SOLAR_CHARGER, RECORD_ORION_XS,
+                                 RECORD_DCDC_CONVERTER, RECORD_AC_CHARGER};
+  for (int iteration = 0; iteration < 200000; iteration++) {
+    uint8_t data[16];
+    size_t len = 1 + rng() % 16;
+    for (size_t i = 0; i < len; i++) {
+      // Bias towards all-ones bytes so the "not available" values show up
+      data[i] = rng() % 4 == 0 ? 0xFF : (uint8_t)rng();
+    }
+    mismatches += compareRecord(recordTypes[iteration % 5], data, len);
+  }
+
+  return mismatches;
+}
+
+static int checkCipherAgainstReference(const uint8_t *key, VictronCipher &cipher) {
+  std::mt19937 rng(32);
+  int mismatches = 0;
+
+  for (int iteration = 0; iteration < 20000; iteration++) {
+    uint8_t data[16];
+    size_t len = 1 + rng() % 16;
+    for (size_t i = 0; i < len; i++) {
+      data[i] = (uint8_t)rng();
+    }
+    uint8_t counterLsb = (uint8_t)rng();
+    uint8_t counterMsb = (uint8_t)rng();
+
+    uint8_t plain[16] = {0};
+    uint8_t expected[16] = {0};
+    bool ok = cipher.decrypt(data, len, counterLsb, counterMsb, plain);
+    bool expectedOk = referenceDecrypt(key, data, len, counterLsb, counterMsb, expected);
+    mismatches += ok != expectedOk || memcmp(plain, expected, len) != 0;
+  }
+
+  return mismatches;
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark
+// ---------------------------------------------------------------------------
+
+static volatile uint32_t benchSink;
+
+template <typename Fn>
+static double nsPerRecord(const std::vector<const CorpusRecord *> &records, Fn fn) {
+  const int rounds = 20000;
+  auto start = std::chrono::steady_clock::now();
+  for (int round = 0; round < rounds; round++) {
+    for (const CorpusRecord *record : records) {
+      fn(*record);
+    }
+  }
+  auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+  return elapsed.count() / ((double)rounds * records.size());
+}
+
+template <typename Reader>
+static uint32_t fieldWalk(const CorpusRecord &record, const std::vector<int> &widths) {
+  Reader reader(record.payload.data(), record.payload.size());
+  uint32_t sum = 0;
+  for (int width : widths) {
+    if (width < 0) {
+      reader.skip((uint8_t)-width);
+    } else {
+      sum += reader.readUnsigned((uint8_t)width);
+    }
+  }
+  return sum;
+}
+
+template <bool Reference>
+static uint32_t parseRecord(const CorpusRecord &record) {
+  const uint8_t *p = record.payload.data();
+  size_t n = record.payload.size();
+  switch (record.recordType) {
+    case RECORD_BATTERY_MONITOR: {
+      SmartShuntReading r;
+      Reference ? referenceBatteryMonitor(p, n, r) : parseBatteryMonitor(p, n, r);
+      return (uint32_t)r.soc;
+    }
+    case RECORD_SOLAR_CHARGER: {
+      MpptReading r;
+      Reference ? referenceSolarCharger(p, n, r) : parseSolarCharger(p, n, r);
+      return (uint32_t)r.pvPower;
+    }
+    case RECORD_ORION_XS: {
+      OrionReading r;
+      Reference ? referenceOrionXs(p, n, r) : parseOrionXs(p, n, r);
+      return r.offReason;
+    }
+    case RECORD_DCDC_CONVERTER: {
+      OrionReading r;
+      Reference ? referenceDcdcConverter(p, n, r) : parseDcdcConverter(p, n, r);
+      return r.offReason;
+    }
+    case RECORD_AC_CHARGER: {
+      AcChargerReading r;
+      Reference ? referenceAcCharger(p, n, r) : parseAcCharger(p, n, r);
+      return r.deviceState;
+    }
+  }
+  return 0;
+}
+
+int main() {
+  int mismatches = checkReaderAgainstReference();
+  printf("BitReader vs reference: %s (%d mismatches)\n", mismatches == 0 ? "OK" : "FAIL", mismatches);
+
+  std::vector<CorpusRecord> corpus = buildCorpus();
+  int parserMismatches = checkParsersAgainstReference(corpus);
+  printf("Layout tables vs hand-written parsers: %s (%d mismatches)\n", parserMismatches == 0 ? "OK" : "FAIL",
+         parserMismatches);
+
+  struct TypeBench {
+    const char *name;
+    uint8_t recordType;
+    const std::vector<int> *fields;
+  };
+  const TypeBench types[] = {
+      {"battery monitor (0x02)", RECORD_BATTERY_MONITOR, &BATTERY_MONITOR_FIELDS},
+      {"solar charger   (0x01)", RECORD_SOLAR_CHARGER, &SOLAR_CHARGER_FIELDS},
+      {"orion xs        (0x0F)", RECORD_ORION_XS, &ORION_XS_FIELDS},
+      {"dc/dc converter (0x04)", RECORD_DCDC_CONVERTER, &DCDC_CONVERTER_FIELDS},
+      {"ac charger      (0x08)", RECORD_AC_CHARGER, &AC_CHARGER_FIELDS},
+  };
+
+  printf("\n%-24s %8s %12s %12s %12s %12s\n", "record type", "records", "parse", "hand", "fields",
+         "bitwise");
+  for (const TypeBench &type : types) {
+    std::vector<const CorpusRecord *> records;
+    for (const CorpusRecord &record : corpus) {
+      if (record.recordType == type.recordType) {
+        records.push_back(&record);
+      }
+    }
+
+    double parseNs = nsPerRecord(records, [](const CorpusRecord &record) {
+      benchSink = benchSink + parseRecord<false>(record);
+    });
+    double handNs = nsPerRecord(records, [](const CorpusRecord &record) {
+      benchSink = benchSink + parseRecord<true>(record);
+    });
+
+    const std::vector<int> &fields = *type.fields;
+    double walkNs = nsPerRecord(records, [&fields](const CorpusRecord &record) {
+      benchSink = benchSink + fieldWalk<BitReader>(record, fields);
+    });
+    double referenceNs = nsPerRecord(records, [&fields](const CorpusRecord &record) {
+      benchSink = benchSink + fieldWalk<ReferenceBitReader>(record, fields);
+    });
+
+    printf("%-24s %8zu %12.1f %12.1f %12.1f %12.1f\n", type.name, records.size(), parseNs, handNs, walkNs,
+           referenceNs);
+  }
+
+  printf("\nns per record. parse = full parse* call incl. scaling/rounding (layout tables),\n"
+         "hand = previous hand-written parser, fields = field extraction only with BitReader,\n"
+         "bitwise = same with the previous bit-by-bit reader\n");
+
+  // Decrypt: cached key schedule vs expanding the key per advertisement
+  uint8_t key[16];
+  parseHexKey("0123456789abcdef0123456789abcdef", key);
+  VictronCipher cipher;
+  cipher.setKey(key);
+
+  int cipherMismatches = checkCipherAgainstReference(key, cipher);
+  printf("\nVictronCipher vs per-call AES-CTR: %s (%d mismatches)\n",
+         cipherMismatches == 0 ? "OK" : "FAIL", cipherMismatches);
+
+  std::vector<const CorpusRecord *> allRecords;
+  for (const CorpusRecord &record : corpus) {
+    allRecords.push_back(&record);
+  }
+  double cachedNs = nsPerRecord(allRecords, [&cipher](const CorpusRecord &record) {
+    uint8_t plain[16];
+    cipher.decrypt(record.payload.data(), record.payload.size(), 0x34, 0x12, plain);
+    benchSink = benchSink + plain[0];
+  });
+  double perCallNs = nsPerRecord(allRecords, [&key](const CorpusRecord &record) {
+    uint8_t plain[16];
+    referenceDecrypt(key, record.payload.data(), record.payload.size(), 0x34, 0x12, plain);
+    benchSink = benchSink + plain[0];
+  });
+  printf("decrypt ns/record: cached key %.1f, per-call key expansion %.1f\n", cachedNs, perCallNs);
+
+  return mismatches == 0 && parserMismatches == 0 && cipherMismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,550 @@
+/**
+ * Replay Victron advertisement captures through the module-6 record pipeline on Linux.
+ *
+ * Each captured advertisement goes the same way as on the ESP32:
+ *   VictronDeviceStore::findDevice (MAC filter, as in the scan callback)
+ *   -> VictronRecordQueue -> VictronDeviceStore::handleRecord (decrypt, parse, cache)
+ * and every VICTRON_STATUS_PUBLISH_INTERVAL_MS of capture time the status payload is
+ * built as in VictronManager::publishFullStatus (minus MQTT and the epoch "ts").
+ * Updated readings also feed VictronEnergyTracker, and VictronHistory samples the store
+ * once per capture second; the final analytics payload and history usage are printed
+ * with the summary.
+ * VictronReceptionStats counts per-device reception over the whole capture (the module
+ * resets it every diagnostics publish) and is printed as a table.
+ * VictronScanScheduler follows every record as on the module. With --adaptive-scan its
+ * decisions gate the capture (advertisements while the radio is off are not heard), so
+ * scan duty and per-device data age can be compared against continuous scanning.
+ * Timestamps come from the capture, so the JSON output is deterministic and can be
+ * diffed against a known-good run as a regression test.
+ *
+ * Usage:
+ *   victron_replay <capture.vcap> [--realtime] [--json <out.jsonl>] [--repeat <n>] [--adaptive-scan]
+ *   victron_replay --import <serial.log> <out.vcap>   (test firmware CAPTURE_MODE output)
+ *   victron_replay --synth <out.vcap> [seconds]       (synthetic capture for every record type)
+ *
+ * Build (Linux, needs libmbedtls-dev; ArduinoJson from a previous `pio run`):
+ *   cd esp32-modules/module-6
+ *   g++ -std=gnu++17 -O2 -Itools/host -Iinclude -Isrc -I.pio/libdeps/esp32dev/ArduinoJson/src \
+ *       tools/host/victron_replay.cpp src/VictronDeviceStore.cpp src/VictronRecordQueue.cpp \
+ *       src/VictronEnergyTracker.cpp src/VictronHistory.cpp src/VictronScanScheduler.cpp \
+ *       src/VictronReceptionStats.cpp src/VictronBleParser.cpp -lmbedcrypto -o /tmp/victron_replay
+ */
+
+#include "VictronCapture.h"
+#include "VictronDeviceStore.h"
+#include "VictronEnergyTracker.h"
+#include "VictronHistory.h"
+#include "VictronReceptionStats.h"
+#include "VictronScanScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Replay
+// ---------------------------------------------------------------------------
+
+struct TypeStats {
+  uint32_t updated = 0;
+  uint32_t duplicate = 0;
+  uint32_t rejected = 0;
+};
+
+// Data age of one device, sampled at every status publish
+struct FreshnessStats {
+  const char *name = "";
+  uint32_t cadenceMs = 0;  // Learned by the scheduler (at the end of the replay)
+  uint32_t advPeriodMs = 0;
+  uint32_t samples = 0;
+  uint64_t sumMs = 0;
+  uint32_t maxMs = 0;
+  uint32_t overTarget = 0;  // Publishes with age > VICTRON_SCAN_TARGET_AGE_MS
+  uint32_t missing = 0;     // Publishes before the first reading
+};
+
+struct ReplayStats {
+  uint32_t records = 0;
+  uint32_t foreign = 0;     // MAC not configured (dropped in the scan callback)
+  uint32_t unheard = 0;     // Sent while the radio was not scanning (--adaptive-scan)
+  uint64_t scanOnMs = 0;
+  uint32_t publishes = 0;
+  uint64_t jsonBytes = 0;
+  std::string analytics;  // Final VictronEnergyTracker payload
+  VictronHistoryTierStats history[HISTORY_RESOLUTIONS];
+  std::map<uint8_t, TypeStats> types;  // By record type byte (0xFF = too short to tell)
+  FreshnessStats freshness[VICTRON_DEVICE_COUNT];
+  VictronDeviceReception reception[VICTRON_DEVICE_COUNT];
+  size_t diagnosticsBytes = 0;  // Diagnostics payload for the whole capture
+};
+
+static const char *recordTypeName(uint8_t recordType) {
+  switch (recordType) {
+    case RECORD_SOLAR_CHARGER: return "solar charger";
+    case RECORD_BATTERY_MONITOR: return "battery monitor";
+    case RECORD_DCDC_CONVERTER: return "dc-dc converter";
+    case RECORD_AC_CHARGER: return "ac charger";
+    case RECORD_ORION_XS: return "orion xs";
+    default: return "other";
+  }
+}
+
+static void publishStatus(VictronDeviceStore &store, const VictronRecordQueue &queue,
+                          VictronScanScheduler &scheduler, uint32_t nowMs, FILE *jsonOut, ReplayStats &stats) {
+  StaticJsonDocument<1280> doc;
+  doc["publishedAt"] = nowMs;
+  store.appendStatusJson(doc);
+
+  JsonObject ble = doc.createNestedObject("ble");
+  ble["received"] = queue.getPushedCount();
+  ble["dropped"] = queue.getDroppedCount();
+  ble["scanPct"] = scheduler.takeDutyPercent(nowMs);
+  JsonArray age = ble.createNestedArray("ageMs");  // Config.h device order
+  for (uint8_t i = 0; i < VICTRON_DEVICE_COUNT; i++) {
+    FreshnessStats &freshness = stats.freshness[i];
+    freshness.name = store.getDeviceName(i);
+    uint32_t ageMs;
+    if (!scheduler.getDataAge(i, nowMs, ageMs)) {
+      age.add(nullptr);
+      freshness.missing++;
+      continue;
+    }
+    age.add(ageMs);
+    freshness.samples++;
+    freshness.sumMs += ageMs;
+    freshness.maxMs = std::max(freshness.maxMs, ageMs);
+    if (ageMs > VICTRON_SCAN_TARGET_AGE_MS) {
+      freshness.overTarget++;
+    }
+  }
+
+  char payload[1280];
+  size_t len = serializeJson(doc, payload, sizeof(payload));
+  stats.publishes++;
+  stats.jsonBytes += len;
+
+  if (jsonOut != nullptr) {
+    fwrite(payload, 1, len, jsonOut);
+    fputc('\n', jsonOut);
+  }
+}
+
+static void replay(const std::vector<CaptureRecord> &records, bool realtime, bool adaptiveScan, FILE *jsonOut,
+                   ReplayStats &stats) {
+  VictronDeviceStore store;
+  VictronRecordQueue queue;
+  VictronEnergyTracker tracker;
+  VictronScanScheduler scheduler;
+  VictronReceptionStats reception;
+  std::unique_ptr<VictronHistory> history(new VictronHistory());  // ~26 KB, off the stack
+  store.begin();
+  scheduler.begin(0);
+  uint32_t lastScanChangeMs = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  uint32_t lastPublishMs = 0;
+  uint32_t lastHistorySampleMs = 0;
+
+  for (const CaptureRecord &captured : records) {
+    if (realtime) {
+      std::this_thread::sleep_until(start + std::chrono::milliseconds(captured.timeMs));
+    }
+
+    // Status publish timer runs on capture time, as loop() does on millis()
+    while (captured.timeMs - lastPublishMs >= VICTRON_STATUS_PUBLISH_INTERVAL_MS) {
+      lastPublishMs += VICTRON_STATUS_PUBLISH_INTERVAL_MS;
+      publishStatus(store, queue, scheduler, lastPublishMs, jsonOut, stats);
+    }
+    while (captured.timeMs - lastHistorySampleMs >= 1000) {
+      lastHistorySampleMs += 1000;
+      history->sample(store, lastHistorySampleMs / 1000, lastHistorySampleMs);
+    }
+
+    stats.records++;
+
+    // Radio side: loop() runs far more often than advertisements arrive, so deciding
+    // at each record time matches the firmware closely enough
+    bool scan = scheduler.wantsScan(captured.timeMs) || !adaptiveScan;
+    if (scan != scheduler.isScanning()) {
+      if (!scan) {
+        stats.scanOnMs += captured.timeMs - lastScanChangeMs;
+      }
+      lastScanChangeMs = captured.timeMs;
+      scheduler.setScanning(scan, captured.timeMs);
+    }
+    if (!scan) {
+      stats.unheard++;
+      continue;
+    }
+
+    // Scan callback side
+    int deviceIndex = store.findDevice(captured.mac);
+    if (deviceIndex < 0) {
+      stats.foreign++;
+      continue;
+    }
+
+    VictronRawRecord *slot = queue.reserve();
+    if (slot == nullptr) {
+      continue;
+    }
+    size_t len = captured.len < sizeof(slot->data) ? captured.len : sizeof(slot->data);
+    memcpy(slot->data, captured.data, len);
+    slot->deviceIndex = (uint8_t)deviceIndex;
+    slot->len = (uint8_t)len;
+    slot->rssi = captured.rssi;
+    slot->receivedAt = captured.timeMs;
+    queue.commit();
+
+    // loop() side
+    const VictronRawRecord *raw;
+    while ((raw = queue.front()) != nullptr) {
+      uint8_t recordType = raw->len > 6 ? raw->data[6] : 0xFF;
+      TypeStats &type = stats.types[recordType];
+      VictronRejectReason reason;
+      VictronRecordResult result = store.handleRecord(*raw, &reason);
+      switch (result) {
+        case VICTRON_RECORD_UPDATED:
+          type.updated++;
+          tracker.onReading(store, store.getDeviceRole(raw->deviceIndex), raw->receivedAt);
+          break;
+        case VICTRON_RECORD_DUPLICATE: type.duplicate++; break;
+        default: type.rejected++; break;
+      }
+      uint16_t dataCounter = store.getDataCounter(raw->deviceIndex);
+      reception.onRecord(*raw, result, reason, dataCounter, scheduler.getSessionStartMs());
+      scheduler.onRecord(raw->deviceIndex, result, dataCounter, raw->receivedAt);
+      queue.release();
+    }
+  }
+
+  if (!records.empty()) {
+    if (scheduler.isScanning()) {
+      stats.scanOnMs += records.back().timeMs - lastScanChangeMs;
+    }
+    publishStatus(store, queue, scheduler, records.back().timeMs, jsonOut, stats);
+    StaticJsonDocument<2048> diagnostics;
+    diagnostics["publishedAt"] = records.back().timeMs;
+    diagnostics["windowMs"] = records.back().timeMs;
+    diagnostics["queueDropped"] = queue.getDroppedCount();
+    reception.appendDiagnosticsJson(diagnostics, store);
+    char diagnosticsPayload[2048];
+    stats.diagnosticsBytes = serializeJson(diagnostics, diagnosticsPayload, sizeof(diagnosticsPayload));
+
+    for (uint8_t i = 0; i < VICTRON_DEVICE_COUNT; i++) {
+      stats.reception[i] = reception.get(i);
+      stats.freshness[i].cadenceMs = scheduler.getCadenceMs(i);
+      stats.freshness[i].advPeriodMs = scheduler.getAdvPeriodMs(i);
+    }
+
+    StaticJsonDocument<512> doc;
+    tracker.advance(records.back().timeMs);
+    tracker.appendAnalyticsJson(doc);
+    char payload[512];
+    serializeJson(doc, payload, sizeof(payload));
+    stats.analytics = payload;
+  }
+  for (uint8_t r = 0; r < HISTORY_RESOLUTIONS; r++) {
+    stats.history[r] = history->getStats((VictronHistoryResolution)r);
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Synthetic capture
+// ---------------------------------------------------------------------------
+
+class BitWriter {
+ public:
+  explicit BitWriter(uint8_t *out) : bytes(out), cursor(0) {}
+
+  void write(uint32_t value, uint8_t bitCount) {
+    for (uint8_t i = 0; i < bitCount; i++, cursor++) {
+      if ((value >> i) & 1U) {
+        bytes[cursor / 8] |= (uint8_t)(1U << (cursor % 8));
+      }
+    }
+  }
+
+ private:
+  uint8_t *bytes;
+  size_t cursor;
+};
+
+struct SynthDevice {
+  const char *mac;
+  const char *key;
+  uint8_t recordType;
+  uint8_t payloadLen;
+};
+
+// Plain payload for one advertisement; values wander slowly with t (seconds)
+static void synthPayload(uint8_t recordType, uint32_t t, std::mt19937 &rng, uint8_t *plain) {
+  memset(plain, 0, 16);
+  BitWriter w(plain);
+  uint32_t wobble = rng() % 20;
+
+  switch (recordType) {
+    case RECORD_BATTERY_MONITOR: {
+      int32_t currentMa = (int32_t)((t * 37) % 30000) - 8000;
+      w.write(t % 97 == 0 ? 0xFFFF : 600 + t % 3000, 16);  // TTG, some invalid
+      w.write(1300 + wobble, 16);                           // 13.xx V
+      w.write(0, 16);                                       // alarm
+      w.write(0, 16);                                       // aux
+      w.write(0, 2);
+      w.write((uint32_t)currentMa & 0x3FFFFF, 22);
+      w.write((t / 10) % 2000, 20);                         // consumed Ah * 10
+      w.write(950 - (t / 30) % 400, 10);                    // SOC * 10
+      break;
+    }
+    case RECORD_SOLAR_CHARGER:
+      w.write(3 + (t / 60) % 3, 8);                         // bulk/absorption/float
+      w.write(0, 8);
+      w.write(1340 + wobble, 16);
+      w.write((t * 7) % 250, 16);                           // 0.1 A
+      w.write(t / 36, 16);                                  // yield 0.01 kWh
+      w.write(t % 53 == 0 ? 0xFFFF : (t * 11) % 400, 16);   // PV W, some invalid
+      w.write(0x1FF, 9);
+      break;
+    case RECORD_ORION_XS:
+      w.write(t % 120 < 60 ? 3 : 0, 8);
+      w.write(0, 8);
+      w.write(1360 + wobble, 16);
+      w.write((t * 3) % 300, 16);
+      w.write(1280 + wobble, 16);
+      w.write((t * 3) % 320, 16);
+      w.write(t % 120 < 60 ? 0 : 0x81, 32);                 // engine off
+      break;
+    case RECORD_AC_CHARGER:
+      w.write(4, 8);
+      w.write(0, 8);
+      w.write(1410 + wobble, 13);
+      w.write((t * 5) % 300, 11);
+      w.write(0x1FFF, 13); w.write(0x7FF, 11);              // outputs 2, 3 unused
+      w.write(0x1FFF, 13); w.write(0x7FF, 11);
+      w.write(0x7F, 7);
+      w.write(t % 71 == 0 ? 0x1FF : (t % 80), 9);
+      break;
+  }
+}
+
+static std::vector<CaptureRecord> synthesizeCapture(uint32_t seconds) {
+  const SynthDevice configured[] = {
+      {VICTRON_DEVICE_0_MAC, VICTRON_DEVICE_0_KEY, RECORD_BATTERY_MONITOR, 15},
+      {VICTRON_DEVICE_1_MAC, VICTRON_DEVICE_1_KEY, RECORD_ORION_XS, 16},
+      {VICTRON_DEVICE_2_MAC, VICTRON_DEVICE_2_KEY, RECORD_SOLAR_CHARGER, 13},
+      {VICTRON_DEVICE_3_MAC, VICTRON_DEVICE_3_KEY, RECORD_SOLAR_CHARGER, 13},
+#if AC_CHARGER_ENABLED
+      {AC_CHARGER_MAC, AC_CHARGER_KEY, RECORD_AC_CHARGER, 16},
+#endif
+      // Neighbour's Victron devices (unknown MAC/key) - must be filtered out
+      {"C4:11:22:33:44:55", "00112233445566778899aabbccddeeff", RECORD_SOLAR_CHARGER, 13},
+      {"F0:66:77:88:99:AA", "ffeeddccbbaa99887766554433221100", RECORD_BATTERY_MONITOR, 15},
+  };
+
+  std::mt19937 rng(35);
+  std::vector<CaptureRecord> records;
+
+  for (size_t d = 0; d < sizeof(configured) / sizeof(configured[0]); d++) {
+    const SynthDevice &device = configured[d];
+    uint8_t key[16];
+    VictronCipher cipher;
+    parseHexKey(device.key, key);
+    cipher.setKey(key);
+
+    // ~5 advertisements per second, data counter (and payload) changes about once per second
+    uint16_t counter = (uint16_t)rng();
+    uint8_t plain[16];
+    synthPayload(device.recordType, 0, rng, plain);
+    for (uint32_t ms = rng() % 200; ms < seconds * 1000; ms += 180 + rng() % 40) {
+      if (rng() % 5 == 0) {
+        counter++;
+        synthPayload(device.recordType, ms / 1000, rng, plain);
+      }
+
+      CaptureRecord record;
+      record.timeMs = ms;
+      parseMacAddress(device.mac, record.mac);
+      record.rssi = (int8_t)(-60 - (int)(rng() % 30));
+
+      uint8_t *m = record.data;
+      m[0] = 0xE1;  // Victron vendor id 0x02E1
+      m[1] = 0x02;
+      m[2] = VICTRON_BEACON_TYPE;
+      m[3] = 0xA0;  // model id (not checked)
+      m[4] = 0x01;
+      m[5] = 0x00;  // readout type
+      m[6] = device.recordType;
+      m[7] = (uint8_t)counter;
+      m[8] = (uint8_t)(counter >> 8);
+      m[9] = key[0];
+      // CTR: encrypting is the same operation as decrypting
+      cipher.decrypt(plain, device.payloadLen, m[7], m[8], m + 10);
+      record.len = (uint8_t)(10 + device.payloadLen);
+
+      records.push_back(record);
+    }
+  }
+
+  std::stable_sort(records.begin(), records.end(),
+                   [](const CaptureRecord &a, const CaptureRecord &b) { return a.timeMs < b.timeMs; });
+  return records;
+}
+
+// ---------------------------------------------------------------------------
+// Main
+// ---------------------------------------------------------------------------
+
+static int usage() {
+  fprintf(stderr,
+          "usage: victron_replay <capture.vcap> [--realtime] [--json <out.jsonl>] [--repeat <n>] [--adaptive-scan]\n"
+          "       victron_replay --import <serial.log> <out.vcap>\n"
+          "       victron_replay --synth <out.vcap> [seconds]\n");
+  return 2;
+}
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    return usage();
+  }
+
+  if (strcmp(argv[1], "--import") == 0) {
+    if (argc != 4) {
+      return usage();
+    }
+    std::vector<CaptureRecord> records;
+    size_t badLines = 0;
+    if (!importSerialLog(argv[2], records, badLines) || !writeCaptureFile(argv[3], records)) {
+      fprintf(stderr, "import failed\n");
+      return 1;
+    }
+    printf("imported %zu records (%zu malformed lines skipped) -> %s\n", records.size(), badLines, argv[3]);
+    return 0;
+  }
+
+  if (strcmp(argv[1], "--synth") == 0) {
+    if (argc < 3) {
+      return usage();
+    }
+    uint32_t seconds = argc > 3 ? (uint32_t)atoi(argv[3]) : 600;
+    std::vector<CaptureRecord> records = synthesizeCapture(seconds);
+    if (!writeCaptureFile(argv[2], records)) {
+      fprintf(stderr, "cannot write %s\n", argv[2]);
+      return 1;
+    }
+    printf("synthesized %zu records (%u s) -> %s\n", records.size(), seconds, argv[2]);
+    return 0;
+  }
+
+  const char *capturePath = argv[1];
+  bool realtime = false;
+  bool adaptiveScan = false;
+  const char *jsonPath = nullptr;
+  int repeat = 1;
+  for (int i = 2; i < argc; i++) {
+    if (strcmp(argv[i], "--realtime") == 0) {
+      realtime = true;
+    } else if (strcmp(argv[i], "--adaptive-scan") == 0) {
+      adaptiveScan = true;
+    } else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+      jsonPath = argv[++i];
+    } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+      repeat = atoi(argv[++i]);
+    } else {
+      return usage();
+    }
+  }
+  if (repeat < 1 || (realtime && repeat != 1)) {
+    return usage();
+  }
+
+  std::vector<CaptureRecord> records;
+  if (!readCaptureFile(capturePath, records)) {
+    fprintf(stderr, "cannot read capture %s\n", capturePath);
+    return 1;
+  }
+
+  FILE *jsonOut = nullptr;
+  if (jsonPath != nullptr && (jsonOut = fopen(jsonPath, "w")) == nullptr) {
+    fprintf(stderr, "cannot write %s\n", jsonPath);
+    return 1;
+  }
+
+  ReplayStats stats;
+  auto start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < repeat; pass++) {
+    Serial.setEnabled(pass == 0);  // Device config printout once
+    ReplayStats passStats;
+    replay(records, realtime, adaptiveScan, pass == 0 ? jsonOut : nullptr, passStats);
+    if (pass == 0) {
+      stats = passStats;
+    }
+  }
+  double elapsedNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+  if (jsonOut != nullptr) {
+    fclose(jsonOut);
+  }
+
+  uint32_t durationMs = records.empty() ? 0 : records.back().timeMs;
+  printf("\n%s: %u records over %.1f s, %u foreign (MAC filter), %u status publishes\n", capturePath,
+         stats.records, durationMs / 1000.0, stats.foreign, stats.publishes);
+  printf("\n%-18s %10s %10s %10s\n", "record type", "updated", "duplicate", "rejected");
+  for (const auto &entry : stats.types) {
+    printf("0x%02X %-13s %10u %10u %10u\n", entry.first, recordTypeName(entry.first), entry.second.updated,
+           entry.second.duplicate, entry.second.rejected);
+  }
+
+  // Scan schedule: radio time and how old each reading was at the status publishes
+  printf("\nscan (%s): radio on %.1f%% of the time, %u advertisements sent while off\n",
+         adaptiveScan ? "adaptive" : "continuous", durationMs ? stats.scanOnMs * 100.0 / durationMs : 0.0,
+         stats.unheard);
+  printf("%-12s %10s %10s %10s %10s %10s %10s\n", "device", "avg age", "max age", "> target", "no data", "cadence",
+         "adv");
+  for (uint8_t i = 0; i < VICTRON_DEVICE_COUNT; i++) {
+    const FreshnessStats &freshness = stats.freshness[i];
+    printf("%-12s %8.0fms %8ums %9.1f%% %10u %8ums %8ums\n", freshness.name,
+           freshness.samples ? (double)freshness.sumMs / freshness.samples : 0.0, freshness.maxMs,
+           freshness.samples ? freshness.overTarget * 100.0 / freshness.samples : 0.0, freshness.missing,
+           freshness.cadenceMs, freshness.advPeriodMs);
+  }
+
+  printf("\n%-12s %9s %9s %9s %9s %9s %9s %15s  %s\n", "reception", "seen", "dup", "key rej", "dec fail",
+         "other rej", "gaps", "rssi min/avg/max", "arrivals <250/500/1k/2k/5k/10k/more ms");
+  for (uint8_t i = 0; i < VICTRON_DEVICE_COUNT; i++) {
+    const VictronDeviceReception &rx = stats.reception[i];
+    char rssi[24] = "-";
+    if (rx.seen > 0) {
+      snprintf(rssi, sizeof(rssi), "%d/%d/%d", rx.rssiMin, (int)(rx.rssiSum / (int32_t)rx.seen), rx.rssiMax);
+    }
+    printf("%-12s %9u %9u %9u %9u %9u %9u %15s ", stats.freshness[i].name, rx.seen, rx.duplicates, rx.keyRejects,
+           rx.decryptFailures, rx.otherRejects, rx.counterGaps, rssi);
+    for (uint8_t bucket = 0; bucket < VICTRON_ARRIVAL_BUCKETS; bucket++) {
+      printf(" %u", rx.arrivals[bucket]);
+    }
+    printf("\n");
+  }
+  printf("diagnostics payload: %zu bytes\n", stats.diagnosticsBytes);
+
+  printf("\nanalytics: %s\n", stats.analytics.c_str());
+  for (uint8_t r = 0; r < HISTORY_RESOLUTIONS; r++) {
+    const VictronHistoryTierStats &tier = stats.history[r];
+    printf("history %s: %u points, %u/%u bytes (%.1f bits/point)\n",
+           VictronHistory::getResolutionName((VictronHistoryResolution)r), tier.points, tier.bytes, tier.capacity,
+           tier.points ? tier.bytes * 8.0 / tier.points : 0.0);
+  }
+
+  if (!realtime) {
+    double perPass = elapsedNs / repeat;
+    printf("\npipeline: %.0f ns/record, %.2f M records/s (incl. %u status builds, avg %.0f bytes)\n",
+           perPass / stats.records, stats.records / perPass * 1e3, stats.publishes,
+           stats.publishes ? (double)stats.jsonBytes / stats.publishes : 0.0);
+  }
+  return 0;
+}
@@ -0,0 +1,70 @@
+// Rolling Mode
+// Most frequent level index (-1 = no electrode covered .. LEVELS-1) over the last
+// WINDOW samples. A histogram is updated as a sample enters and the oldest leaves
+// the ring, so add() is O(1) and getMode() is O(LEVELS) whatever the window size.
+// Ties go to the higher level (more conservative), as the old findMode() did.
+
+#ifndef ROLLING_MODE_H
+#define ROLLING_MODE_H
+
+#include <Arduino.h>
+
+template <uint16_t WINDOW, uint8_t LEVELS>
+class RollingMode {
+private:
+  int8_t samples[WINDOW];
+  uint16_t counts[LEVELS + 1];  // counts[level + 1]
+  uint16_t index;  // Next slot to write
+  uint16_t count;
+
+public:
+  RollingMode() { reset(); }
+
+  void reset() {
+    for (uint16_t i = 0; i < WINDOW; i++) {
+      samples[i] = -1;
+    }
+    for (uint8_t i = 0; i <= LEVELS; i++) {
+      counts[i] = 0;
+    }
+    index = 0;
+    count = 0;
+  }
+
+  void add(int level) {
+    if (level < -1 || level >= LEVELS) {
+      level = -1;  // Same as levelToPercent(): out of range = 0%
+    }
+    if (count < WINDOW) {
+      count++;
+    } else {
+      counts[samples[index] + 1]--;  // Oldest sample leaves the window
+    }
+    samples[index] = (int8_t)level;
+    counts[level + 1]++;
+
+    index++;
+    if (index >= WINDOW) {
+      index = 0;
+    }
+  }
+
+  // -1 while empty
+  int getMode() const {
+    int mode = -1;
+    uint16_t maxCount = 0;
+    for (int level = LEVELS - 1; level >= -1; level--) {
+      if (counts[level + 1] > maxCount) {  // Strictly more: the higher level keeps a tie
+        maxCount = counts[level + 1];
+        mode = level;
+      }
+    }
+    return mode;
+  }
+
+  uint16_t getCount() const { return count; }
+  bool isFull() const { return count >= WINDOW; }
+  static uint16_t capacity() { return WINDOW; }
+};
+
+#endif
@@ -4,45 +4,34 @@
 #include "CleanWaterLevelSensor.h"
 #include <Arduino.h>
 
-CleanWaterLevelSensor::CleanWaterLevelSensor(MQTTManager* mqtt) {
+// Electrodes from bottom to top
+static constexpr uint8_t CLEAN_WATER_LEVEL_PINS[NUM_CLEAN_WATER_LEVEL_PINS] = {
+  CLEAN_WATER_LEVEL_PIN_1, CLEAN_WATER_LEVEL_PIN_2, CLEAN_WATER_LEVEL_PIN_3, CLEAN_WATER_LEVEL_PIN_4,
+  CLEAN_WATER_LEVEL_PIN_5, CLEAN_WATER_LEVEL_PIN_6, CLEAN_WATER_LEVEL_PIN_7
+};
+static constexpr uint8_t CLEAN_WATER_LEVEL_PERCENTS[NUM_CLEAN_WATER_LEVEL_PINS] = {
+  CLEAN_WATER_LEVEL_PERCENT_1, CLEAN_WATER_LEVEL_PERCENT_2, CLEAN_WATER_LEVEL_PERCENT_3, CLEAN_WATER_LEVEL_PERCENT_4,
+  CLEAN_WATER_LEVEL_PERCENT_5, CLEAN_WATER_LEVEL_PERCENT_6, CLEAN_WATER_LEVEL_PERCENT_7
+};
+
+CleanWaterLevelSensor::CleanWaterLevelSensor(MQTTManager* mqtt)
+  : electrodes(CLEAN_WATER_LEVEL_PINS, CLEAN_WATER_LEVEL_PERCENTS, ELECTRODE_SETTLE_US, ELECTRODE_PARALLEL_SCAN) {
   if (mqtt == nullptr && DEBUG_SERIAL) {
     Serial.println("ERROR: CleanWaterLevelSensor: mqttManager cannot be nullptr!");
   }
 
   this->mqttManager = mqtt;
 
-  levelPins[0] = CLEAN_WATER_LEVEL_PIN_1;
-  levelPins[1] = CLEAN_WATER_LEVEL_PIN_2;
-  levelPins[2] = CLEAN_WATER_LEVEL_PIN_3;
-  levelPins[3] = CLEAN_WATER_LEVEL_PIN_4;
-  levelPins[4] = CLEAN_WATER_LEVEL_PIN_5;
-  levelPins[5] = CLEAN_WATER_LEVEL_PIN_6;
-  levelPins[6] = CLEAN_WATER_LEVEL_PIN_7;
-
-  levelPercentages[0] = CLEAN_WATER_LEVEL_PERCENT_1;
-  levelPercentages[1] = CLEAN_WATER_LEVEL_PERCENT_2;
-  levelPercentages[2] = CLEAN_WATER_LEVEL_PERCENT_3;
-  levelPercentages[3] = CLEAN_WATER_LEVEL_PERCENT_4;
-  levelPercentages[4] = CLEAN_WATER_LEVEL_PERCENT_5;
-  levelPercentages[5] = CLEAN_WATER_LEVEL_PERCENT_6;
-  levelPercentages[6] = CLEAN_WATER_LEVEL_PERCENT_7;
-
   lastSensorRead = 0;
   lastDataSent = 0;
 
-  measurementIndex = 0;
-  measurementCount = 0;
-  for (int i = 0; i < CLEAN_WATER_LEVEL_MODE_SAMPLE_COUNT; i++) {
-    levelIndices[i] = -1;
-  }
-
   lastPublishedLevel = -1.0;
   forceUpdateRequested = false;
   lastMQTTState = false;
 }
 
 void CleanWaterLevelSensor::begin() {
-  setupPins();
+  electrodes.begin();
 
   if (DEBUG_SERIAL) {
     Serial.println("Clean Water Level Sensor initialized");
@@ -53,20 +42,6 @@ void CleanWaterLevelSensor::begin() {
   }
 }
 
-void CleanWaterLevelSensor::setupPins() {
-  for (int i = 0; i < NUM_CLEAN_WATER_LEVEL_PINS; i++) {
-    pinMode(levelPins[i], INPUT);
-    digitalWrite(levelPins[i], LOW);
-  }
-}
-
-void CleanWaterLevelSensor::setPinsLow() {
-  for (int i = 0; i < NUM_CLEAN_WATER_LEVEL_PINS; i++) {
-    pinMode(levelPins[i], INPUT);
-    digitalWrite(levelPins[i], LOW);
-  }
-}
-
 void CleanWaterLevelSensor::loop() {
   if (mqttManager == nullptr) {
     return;
@@ -84,88 +59,36 @@ void CleanWaterLevelSensor::loop() {
   lastMQTTState = mqttConnected;
 
   if (!mqttConnected) {
+    electrodes.cancel();
     return;
   }
 
   unsigned long currentTime = millis();
   bool isForceUpdate = forceUpdateRequested;
-  if (currentTime - lastSensorRead > CLEAN_WATER_LEVEL_READ_INTERVAL || isForceUpdate) {
-    lastSensorRead = currentTime;
-
-    setupPins();
-    int level = readWaterLevel();
-    setPinsLow();
-
-    float percent = levelToPercent(level);
-
-    levelIndices[measurementIndex] = level;
-    measurementIndex = (measurementIndex + 1) % CLEAN_WATER_LEVEL_MODE_SAMPLE_COUNT;
-    if (measurementCount < CLEAN_WATER_LEVEL_MODE_SAMPLE_COUNT) {
-      measurementCount++;
-    }
-
-    if (measurementCount >= CLEAN_WATER_LEVEL_MODE_SAMPLE_COUNT) {
-      int modeLevelIndex = findMode(levelIndices, CLEAN_WATER_LEVEL_MODE_SAMPLE_COUNT);
-      float modePercent = levelToPercent(modeLevelIndex);
-      float publishPercent = isForceUpdate ? percent : modePercent;
-      publishIfNeeded(publishPercent, currentTime, isForceUpdate);
-      forceUpdateRequested = false;
-    } else if (isForceUpdate) {
-      publishIfNeeded(percent, currentTime, true);
-      forceUpdateRequested = false;
-    }
+  if (electrodes.isIdle() && (currentTime - lastSensorRead > CLEAN_WATER_LEVEL_READ_INTERVAL || isForceUpdate)) {
+    electrodes.start(micros());
   }
-}
-
-int CleanWaterLevelSensor::readWaterLevel() {
-  // Measure one pin at a time from top to bottom (prevents all pins PULLUP at once)
-  for (int i = NUM_CLEAN_WATER_LEVEL_PINS - 1; i >= 0; i--) {
-    pinMode(levelPins[i], INPUT_PULLUP);
-    delay(5);
-
-    int pinState = digitalRead(levelPins[i]);
-
-    if (pinState == LOW) {
-      pinMode(levelPins[i], INPUT);
-      digitalWrite(levelPins[i], LOW);
-      return i;
-    }
-
-    pinMode(levelPins[i], INPUT);
-    digitalWrite(levelPins[i], LOW);
-  }
-
-  return -1;
-}
-
-float CleanWaterLevelSensor::levelToPercent(int level) {
-  if (level < 0 || level >= NUM_CLEAN_WATER_LEVEL_PINS) {
-    return 0.0;
+  if (electrodes.poll(micros())) {
+    lastSensorRead = currentTime;
+    processLevel(electrodes.getLevel(), currentTime, isForceUpdate);
   }
-  return (float)levelPercentages[level];
 }
 
-int CleanWaterLevelSensor::findMode(int* values, int count) {
-  int maxCount = 0;
-  int modeValue = values[0];
+void CleanWaterLevelSensor::processLevel(int level, unsigned long currentTime, bool isForceUpdate) {
+  float percent = electrodes.levelToPercent(level);
 
-  for (int i = 0; i < count; i++) {
-    int currentValue = values[i];
-    int currentCount = 0;
+  levelMode.add(level);
 
-    for (int j = 0; j < count; j++) {
-      if (values[j] == currentValue) {
-        currentCount++;
-      }
-    }
-
-    if (currentCount > maxCount || (currentCount == maxCount && currentValue > modeValue)) {
-      maxCount = currentCount;
-      modeValue = currentValue;
-    }
+  if (levelMode.isFull()) {
+    int modeLevelIndex = levelMode.getMode();
+    float modePercent = electrodes.levelToPercent(modeLevelIndex);
+    float publishPercent = isForceUpdate ? percent : modePercent;
+    publishIfNeeded(publishPercent, currentTime, isForceUpdate);
+    forceUpdateRequested = false;
+  } else if (isForceUpdate) {
+    publishIfNeeded(percent, currentTime, true);
+    forceUpdateRequested = false;
   }
-
-  return modeValue;
 }
 
 void CleanWaterLevelSensor::publishIfNeeded(float averagePercent, unsigned long currentTime, bool forcePublish) {
@@ -215,7 +138,7 @@ void CleanWaterLevelSensor::printStatus() const {
   if (DEBUG_SERIAL) {
     Serial.println("Clean Water Level Sensor Status:");
     Serial.println("  Last Level: " + String(lastPublishedLevel >= 0 ? String(lastPublishedLevel, 1) + "%" : "N/A"));
-    Serial.println("  Measurement Count: " + String(measurementCount) + "/" + String(CLEAN_WATER_LEVEL_MODE_SAMPLE_COUNT));
+    Serial.println("  Measurement Count: " + String(levelMode.getCount()) + "/" + String(CLEAN_WATER_LEVEL_MODE_SAMPLE_COUNT));
     Serial.println("  Last Data Sent: " + String((millis() - lastDataSent) / 1000) + " seconds ago");
   }
 }
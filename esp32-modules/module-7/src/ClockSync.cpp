@@ -0,0 +1,216 @@
+// Clock Sync Implementation
+// Broker time beacon with RTT compensation and drift estimation
+
+#include "ClockSync.h"
+#include "MQTTManager.h"
+#include "Logger.h"
+#include <esp_timer.h>
+
+#define CLOCK_SYNC_MAX_DRIFT_PPM 1000.0f   // Larger estimates are treated as a server clock step
+#define CLOCK_SYNC_STEP_MICROS 1000000LL   // Error above 1s resets the drift estimate
+#define CLOCK_SYNC_RETRY_MS 5000           // Burst interval until the first successful sync
+
+bool ClockSync::synced = false;
+int64_t ClockSync::offsetMicros = 0;
+uint64_t ClockSync::syncMonoMicros = 0;
+float ClockSync::driftPpm = 0.0f;
+int32_t ClockSync::lastErrorMicros = 0;
+uint32_t ClockSync::lastRttMicros = 0;
+uint32_t ClockSync::syncCount = 0;
+
+ClockSync::ClockSync(MQTTManager* mqtt, String moduleId) {
+  this->mqttManager = mqtt;
+  this->moduleId = moduleId;
+  this->responseTopic = String(CLOCK_SYNC_RESPONSE_TOPIC_PREFIX) + moduleId;
+  this->isSubscribed = false;
+  this->lastBurstTime = 0;
+  this->burstActive = false;
+  this->samplesRemaining = 0;
+  this->requestInFlight = false;
+  this->requestSeq = 0;
+  this->requestSentMicros = 0;
+  this->burstHasSample = false;
+  this->burstBestOffset = 0;
+  this->burstBestMono = 0;
+  this->burstBestRtt = 0;
+}
+
+void ClockSync::begin() {
+  LOG_INFO("🕒 Clock sync via %s (reply on %s)", CLOCK_SYNC_REQUEST_TOPIC, responseTopic.c_str());
+}
+
+void ClockSync::loop() {
+  if (mqttManager == nullptr || !mqttManager->isMQTTConnected()) {
+    // Resubscribe and resync after reconnect
+    isSubscribed = false;
+    requestInFlight = false;
+    burstActive = false;
+    return;
+  }
+
+  if (!isSubscribed) {
+    isSubscribed = mqttManager->subscribeTopic(responseTopic);
+    if (isSubscribed) {
+      requestSync();
+    }
+    return;
+  }
+
+  // Periodic burst (retry sooner while we have never synced)
+  unsigned long interval = synced ? CLOCK_SYNC_INTERVAL_MS : CLOCK_SYNC_RETRY_MS;
+  if (!burstActive && millis() - lastBurstTime >= interval) {
+    requestSync();
+  }
+
+  if (!burstActive) {
+    return;
+  }
+
+  // Drop a request that never got an answer
+  if (requestInFlight && monotonicMicros() - requestSentMicros > (uint64_t)CLOCK_SYNC_TIMEOUT_MS * 1000ULL) {
+    requestInFlight = false;
+  }
+
+  if (!requestInFlight) {
+    if (samplesRemaining > 0) {
+      sendRequest();
+    } else {
+      finishBurst();
+    }
+  }
+}
+
+void ClockSync::requestSync() {
+  burstActive = true;
+  samplesRemaining = CLOCK_SYNC_SAMPLES;
+  requestInFlight = false;
+  burstHasSample = false;
+}
+
+void ClockSync::sendRequest() {
+  requestSeq++;
+  samplesRemaining--;
+
+  StaticJsonDocument<96> doc;
+  doc["module"] = moduleId;
+  doc["seq"] = requestSeq;
+  String payload;
+  serializeJson(doc, payload);
+
+  requestSentMicros = monotonicMicros();
+  requestInFlight = mqttManager->publishRaw(CLOCK_SYNC_REQUEST_TOPIC, payload, false);
+}
+
+bool ClockSync::handleMessage(const char* topic, const byte* payload, unsigned int length) {
+  if (responseTopic != topic) {
+    return false;
+  }
+
+  uint64_t receivedMicros = monotonicMicros();
+
+  StaticJsonDocument<128> doc;
+  if (deserializeJson(doc, payload, length) != DeserializationError::Ok) {
+    return true;
+  }
+
+  // Ignore late answers to a request we already gave up on
+  if (!requestInFlight || doc["seq"].as<uint16_t>() != requestSeq) {
+    return true;
+  }
+  requestInFlight = false;
+
+  uint32_t rtt = (uint32_t)(receivedMicros - requestSentMicros);
+  if (rtt > (uint32_t)CLOCK_SYNC_MAX_RTT_MS * 1000UL) {
+    return true;
+  }
+
+  // Server time split in seconds + microseconds to stay exact in JSON
+  int64_t serverMicros = (int64_t)doc["sec"].as<uint32_t>() * 1000000LL + doc["us"].as<uint32_t>();
+  uint64_t midpoint = requestSentMicros + rtt / 2;
+  int64_t offset = serverMicros - (int64_t)midpoint;
+
+  if (!burstHasSample || rtt < burstBestRtt) {
+    burstHasSample = true;
+    burstBestOffset = offset;
+    burstBestMono = midpoint;
+    burstBestRtt = rtt;
+  }
+  return true;
+}
+
+void ClockSync::finishBurst() {
+  burstActive = false;
+  lastBurstTime = millis();
+
+  if (!burstHasSample) {
+    LOG_WARN("⚠️ Clock sync: no usable response (timeout or RTT > %dms)", CLOCK_SYNC_MAX_RTT_MS);
+    return;
+  }
+
+  applySample(burstBestOffset, burstBestMono, burstBestRtt);
+}
+
+void ClockSync::applySample(int64_t measuredOffset, uint64_t mono, uint32_t rtt) {
+  if (synced && mono > syncMonoMicros) {
+    uint64_t elapsed = mono - syncMonoMicros;
+    int64_t predicted = offsetMicros + (int64_t)((double)driftPpm * (double)elapsed / 1e6);
+    int64_t error = measuredOffset - predicted;
+    float sampleDrift = (float)((double)(measuredOffset - offsetMicros) * 1e6 / (double)elapsed);
+
+    if (error > CLOCK_SYNC_STEP_MICROS || error < -CLOCK_SYNC_STEP_MICROS ||
+        sampleDrift > CLOCK_SYNC_MAX_DRIFT_PPM || sampleDrift < -CLOCK_SYNC_MAX_DRIFT_PPM) {
+      // Server clock stepped (e.g. Pi got NTP) - start the drift estimate over
+      driftPpm = 0.0f;
+      LOG_WARN("⚠️ Clock sync: step of %ld ms, drift estimate reset", (long)(error / 1000));
+    } else {
+      driftPpm = (syncCount <= 1) ? sampleDrift : 0.7f * driftPpm + 0.3f * sampleDrift;
+    }
+    lastErrorMicros = (int32_t)constrain(error, (int64_t)INT32_MIN, (int64_t)INT32_MAX);
+  } else {
+    lastErrorMicros = 0;
+  }
+
+  offsetMicros = measuredOffset;
+  syncMonoMicros = mono;
+  lastRttMicros = rtt;
+  synced = true;
+  syncCount++;
+
+  LOG_INFO("🕒 Clock synced: rtt %lu us, error %ld us, drift %.1f ppm",
+           (unsigned long)rtt, (long)lastErrorMicros, driftPpm);
+}
+
+uint64_t ClockSync::monotonicMicros() {
+  return (uint64_t)esp_timer_get_time();
+}
+
+uint64_t ClockSync::epochMicros() {
+  if (!synced) {
+    return 0;
+  }
+  uint64_t mono = monotonicMicros();
+  int64_t driftCorrection = (int64_t)((double)driftPpm * (double)(mono - syncMonoMicros) / 1e6);
+  return (uint64_t)((int64_t)mono + offsetMicros + driftCorrection);
+}
+
+void ClockSync::addTimestamp(JsonDocument& doc) {
+  if (synced) {
+    doc["ts"] = epochMillis();
+  }
+}
+
+uint32_t ClockSync::getSecondsSinceSync() {
+  return synced ? (uint32_t)((monotonicMicros() - syncMonoMicros) / 1000000ULL) : 0;
+}
+
+void ClockSync::printStatus() const {
+  if (DEBUG_SERIAL) {
+    Serial.println("🕒 Clock Sync Status:");
+    Serial.println("  Synced: " + String(synced ? "Yes" : "No") + " (" + String(syncCount) + " syncs)");
+    if (synced) {
+      Serial.println("  Last sync: " + String(getSecondsSinceSync()) + " seconds ago");
+      Serial.println("  RTT: " + String(lastRttMicros) + " us, error: " + String(lastErrorMicros) + " us");
+      Serial.println("  Drift: " + String(driftPpm, 1) + " ppm");
+    }
+  }
+}
@@ -1,6 +1,7 @@
 // Command Handler Implementation
 
 #include "CommandHandler.h"
+#include "LogStreamer.h"
 #include "CleanWaterLevelManager.h"
 #include <Arduino.h>
 
@@ -67,6 +68,12 @@ void CommandHandler::handleMQTTMessage(char* topic, byte* payload, unsigned int
       Serial.println("Force update command received");
     }
     forceUpdate();
+    mqttManager->expectStatus(String(MQTT_TOPIC_SENSORS) + "clean-water/level");  // Forced level closes the round trip
+  }
+
+  // Runtime log stream level (e.g. {"level":"debug"})
+  if (topicStr.endsWith("/logs/level")) {
+    LogStreamer::handleLevelCommand(message);
   }
 }
 
@@ -0,0 +1,164 @@
+// Log Streamer Implementation
+// Batched, rate-limited MQTT mirror of the log ring
+
+#include "LogStreamer.h"
+#include <ArduinoJson.h>
+
+char LogStreamer::buffer[LOG_STREAM_BUFFER_SIZE];
+std::atomic<uint32_t> LogStreamer::head(0);
+std::atomic<uint32_t> LogStreamer::tail(0);
+std::atomic<uint8_t> LogStreamer::level(LOG_STREAM_LEVEL);
+std::atomic<uint32_t> LogStreamer::droppedLines(0);
+uint32_t LogStreamer::streamSeq = 0;
+
+LogStreamer::LogStreamer(MQTTManager* mqtt, String moduleId) {
+  this->mqttManager = mqtt;
+  this->topic = String(LOG_STREAM_TOPIC_PREFIX) + moduleId;
+  this->lastPublishTime = 0;
+}
+
+void LogStreamer::begin() {
+  setLevel(LOG_STREAM_LEVEL);
+  Logger::setSink(onLogLine);
+  LOG_INFO("📜 Log streaming to %s (level %s)", topic.c_str(), Logger::levelName(getLevel()));
+}
+
+void LogStreamer::loop() {
+  if (mqttManager == nullptr || !mqttManager->isMQTTConnected()) {
+    return;  // Keep buffering; oldest lines survive, newest are dropped when full
+  }
+
+  unsigned long currentTime = millis();
+  if (currentTime - lastPublishTime < LOG_STREAM_INTERVAL_MS) {
+    return;
+  }
+
+  // Drop totals lead every batch, so losses show even when no gap is visible
+  char batch[LOG_STREAM_BATCH_BYTES + 1];
+  int headerLen = snprintf(batch, sizeof(batch), "# dropped ring=%lu stream=%lu\n",
+                           (unsigned long)Logger::getDroppedCount(), (unsigned long)getDroppedLines());
+  size_t len = readBatch(batch + headerLen, LOG_STREAM_BATCH_BYTES - headerLen);
+  if (len == 0) {
+    return;
+  }
+  batch[headerLen + len] = '\0';
+
+  lastPublishTime = currentTime;
+
+  // Don't log our own publish - it would feed back into the stream
+  if (mqttManager->publishRaw(topic, String(batch), false)) {
+    tail.store(tail.load(std::memory_order_relaxed) + len, std::memory_order_release);
+  }
+}
+
+void LogStreamer::onLogLine(const LogLine& line) {
+  if (line.level > level.load(std::memory_order_relaxed)) {
+    return;  // Filtered lines take no sequence number
+  }
+
+  // Taken before the buffer check so a full buffer leaves a gap
+  uint32_t seq = streamSeq++;
+
+  char text[LOG_LINE_MAX + 32];
+  int len = snprintf(text, sizeof(text), "%lu %lu %s %s\n",
+                     (unsigned long)seq, (unsigned long)line.timestamp,
+                     Logger::levelName(line.level), line.text);
+  if (len <= 0) {
+    return;
+  }
+  if (len >= (int)sizeof(text)) {
+    len = sizeof(text) - 1;
+    text[len - 1] = '\n';
+  }
+  // Keep one entry per payload line
+  for (int i = 0; i < len - 1; i++) {
+    if (text[i] == '\n' || text[i] == '\r') {
+      text[i] = ' ';
+    }
+  }
+
+  uint32_t h = head.load(std::memory_order_relaxed);
+  uint32_t t = tail.load(std::memory_order_acquire);
+  if ((uint32_t)len > LOG_STREAM_BUFFER_SIZE - (h - t)) {
+    droppedLines.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  for (int i = 0; i < len; i++) {
+    buffer[(h + i) % LOG_STREAM_BUFFER_SIZE] = text[i];
+  }
+  head.store(h + len, std::memory_order_release);
+}
+
+size_t LogStreamer::readBatch(char* out, size_t maxLen) {
+  uint32_t h = head.load(std::memory_order_acquire);
+  uint32_t t = tail.load(std::memory_order_relaxed);
+  size_t available = h - t;
+  size_t n = available < maxLen ? available : maxLen;
+
+  size_t lastLineEnd = 0;
+  for (size_t i = 0; i < n; i++) {
+    out[i] = buffer[(t + i) % LOG_STREAM_BUFFER_SIZE];
+    if (out[i] == '\n') {
+      lastLineEnd = i + 1;
+    }
+  }
+
+  // Only whole lines go out; the rest waits for the next batch
+  return lastLineEnd;
+}
+
+void LogStreamer::setLevel(uint8_t newLevel) {
+  // Levels above the compile-time level have no call sites left to stream
+  if (newLevel > LOG_LEVEL) {
+    newLevel = LOG_LEVEL;
+  }
+  level.store(newLevel, std::memory_order_relaxed);
+}
+
+int LogStreamer::parseLevel(String value) {
+  value.trim();
+  value.toLowerCase();
+
+  if (value.length() == 1 && isDigit(value[0])) {
+    int numeric = value.toInt();
+    return numeric <= LOG_LEVEL_VERBOSE ? numeric : -1;
+  }
+  if (value == "off" || value == "none") return LOG_LEVEL_NONE;
+  if (value == "error") return LOG_LEVEL_ERROR;
+  if (value == "warn" || value == "warning") return LOG_LEVEL_WARN;
+  if (value == "info") return LOG_LEVEL_INFO;
+  if (value == "debug") return LOG_LEVEL_DEBUG;
+  if (value == "verbose") return LOG_LEVEL_VERBOSE;
+  return -1;
+}
+
+bool LogStreamer::handleLevelCommand(String message) {
+  // Accept {"level":"debug"}, {"level":4} or a bare value
+  String value = message;
+  StaticJsonDocument<64> doc;
+  if (deserializeJson(doc, message) == DeserializationError::Ok && doc.containsKey("level")) {
+    value = doc["level"].as<String>();
+  }
+
+  int parsed = parseLevel(value);
+  if (parsed < 0) {
+    LOG_WARN("⚠️ Invalid log level: %s", message.c_str());
+    return false;
+  }
+
+  setLevel((uint8_t)parsed);
+  LOG_INFO("📜 Log stream level set to %s", getLevel() == LOG_LEVEL_NONE ? "off" : Logger::levelName(getLevel()));
+  return true;
+}
+
+void LogStreamer::printStatus() const {
+  if (DEBUG_SERIAL) {
+    Serial.println("📜 Log Streamer Status:");
+    Serial.println("  Topic: " + topic);
+    Serial.println("  Level: " + String(getLevel()));
+    Serial.println("  Pending bytes: " + String(head.load() - tail.load()));
+    Serial.println("  Dropped lines (stream): " + String(getDroppedLines()));
+    Serial.println("  Dropped lines (ring): " + String(Logger::getDroppedCount()));
+  }
+}
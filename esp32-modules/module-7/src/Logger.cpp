@@ -0,0 +1,139 @@
+// Logger Implementation
+// Bounded multi-producer ring drained by a single low-priority task on the other core
+
+#include "Logger.h"
+#include <stdarg.h>
+
+// Drain task settings
+#define LOG_DRAIN_TASK_STACK 3072
+#define LOG_DRAIN_TASK_PRIORITY 1   // Just above idle, below the WiFi/lwIP tasks
+#define LOG_DRAIN_IDLE_MS 10        // Sleep when the ring is empty
+
+// Arduino's loopTask also runs at priority 1 and never blocks, so on its core the
+// drain task would share time slices with loop(). Pinned to the other core it
+// only fills the gaps left by the WiFi stack there.
+#ifndef CONFIG_ARDUINO_RUNNING_CORE
+#define CONFIG_ARDUINO_RUNNING_CORE 1
+#endif
+#define LOG_DRAIN_TASK_CORE (CONFIG_ARDUINO_RUNNING_CORE == 0 ? 1 : 0)
+
+static_assert((LOG_QUEUE_DEPTH & (LOG_QUEUE_DEPTH - 1)) == 0, "LOG_QUEUE_DEPTH must be a power of two");
+
+Logger::Slot Logger::slots[LOG_QUEUE_DEPTH];
+std::atomic<uint32_t> Logger::writePos(0);
+uint32_t Logger::readPos = 0;
+std::atomic<uint32_t> Logger::nextSeq(0);
+std::atomic<uint32_t> Logger::dropped(0);
+TaskHandle_t Logger::drainTask = nullptr;
+void (*Logger::sink)(const LogLine& line) = nullptr;
+
+// Slot turn encoding: 2*lap = free for lap, 2*lap+1 = holds a line of lap.
+// Zero-initialised slots are therefore free for the first lap, so logging
+// works even before begin() (e.g. from static constructors).
+static inline uint32_t freeTurn(uint32_t pos) {
+  return (pos / LOG_QUEUE_DEPTH) * 2;
+}
+
+void Logger::begin() {
+  if (drainTask != nullptr) {
+    return;  // Already running
+  }
+
+  // Lines logged before begin() are already queued and get printed now
+  xTaskCreatePinnedToCore(drainTaskFn, "log_drain", LOG_DRAIN_TASK_STACK, nullptr, LOG_DRAIN_TASK_PRIORITY,
+                          &drainTask, LOG_DRAIN_TASK_CORE);
+}
+
+void Logger::write(uint8_t level, const char* format, ...) {
+  // Sequence is taken before the slot so dropped lines leave a visible gap
+  uint32_t seq = nextSeq.fetch_add(1, std::memory_order_relaxed);
+
+  // Claim a slot (lock-free; fails instead of waiting when the ring is full)
+  uint32_t pos = writePos.load(std::memory_order_relaxed);
+  Slot* slot;
+  while (true) {
+    slot = &slots[pos & (LOG_QUEUE_DEPTH - 1)];
+    int32_t diff = (int32_t)(slot->turn.load(std::memory_order_acquire) - freeTurn(pos));
+    if (diff == 0) {
+      if (writePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (diff < 0) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    } else {
+      pos = writePos.load(std::memory_order_relaxed);
+    }
+  }
+
+  slot->line.seq = seq;
+  slot->line.timestamp = millis();
+  slot->line.level = level;
+
+  va_list args;
+  va_start(args, format);
+  vsnprintf(slot->line.text, LOG_LINE_MAX, format, args);
+  va_end(args);
+
+  // Publish the slot to the drain task
+  slot->turn.store(freeTurn(pos) + 1, std::memory_order_release);
+}
+
+bool Logger::pop(LogLine& out) {
+  Slot* slot = &slots[readPos & (LOG_QUEUE_DEPTH - 1)];
+  if (slot->turn.load(std::memory_order_acquire) != freeTurn(readPos) + 1) {
+    return false;  // Empty (or next line still being formatted)
+  }
+
+  out = slot->line;
+
+  // Hand the slot back to producers for the next lap
+  slot->turn.store(freeTurn(readPos) + 2, std::memory_order_release);
+  readPos++;
+  return true;
+}
+
+void Logger::drainTaskFn(void* arg) {
+  LogLine line;
+  while (true) {
+    bool any = false;
+    while (pop(line)) {
+      writeToSerial(line);
+      if (sink != nullptr) {
+        sink(line);
+      }
+      any = true;
+    }
+    if (!any) {
+      vTaskDelay(pdMS_TO_TICKS(LOG_DRAIN_IDLE_MS));
+    }
+  }
+}
+
+// One write per line: the UART driver locks per call, so direct Serial.print
+// output from other code cannot land between prefix and text
+void Logger::writeToSerial(const LogLine& line) {
+  char out[32 + LOG_LINE_MAX + 2];
+  int length = snprintf(out, sizeof(out), "[%lu] %s %s\r\n", (unsigned long)line.timestamp,
+                        levelName(line.level), line.text);
+  if (length < 0) {
+    return;
+  }
+  if ((size_t)length >= sizeof(out)) {
+    length = sizeof(out) - 1;  // Truncated - still end the line
+    out[length - 2] = '\r';
+    out[length - 1] = '\n';
+  }
+  Serial.write((const uint8_t*)out, length);
+}
+
+const char* Logger::levelName(uint8_t level) {
+  switch (level) {
+    case LOG_LEVEL_ERROR: return "E";
+    case LOG_LEVEL_WARN: return "W";
+    case LOG_LEVEL_INFO: return "I";
+    case LOG_LEVEL_DEBUG: return "D";
+    case LOG_LEVEL_VERBOSE: return "V";
+    default: return "?";
+  }
+}
@@ -6,6 +6,12 @@
 
 #define BLE_SCAN_SECONDS 3
 
+// Capture mode: instead of the decoded printout, every advertisement with Victron
+// manufacturer data (any MAC, duplicates included) is written as one "VCAP:<hex>"
+// line for the module-6 replay tool (esp32-modules/module-6/tools/host/victron_replay.cpp).
+// Record layout: u32 ms since capture start | mac[6] | i8 rssi | u8 len | data[len]
+#define CAPTURE_MODE false
+
 #define VICTRON_DEVICE_COUNT 4
 
 #define VICTRON_DEVICE_0_NAME "SmartShunt"
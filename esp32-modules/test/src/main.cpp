@@ -1,5 +1,6 @@
 /**
  * Test module - read Victron BLE advertisements and print to Serial.
+ * With CAPTURE_MODE (Config.h) it logs raw advertisements for host replay instead.
  */
 
 #include <Arduino.h>
@@ -31,6 +32,8 @@ struct VictronDevice {
 
 static VictronDevice devices[VICTRON_DEVICE_COUNT];
 static BLEScan *bleScan = nullptr;
+static unsigned long captureStartMs = 0;
+static uint32_t capturedCount = 0;
 
 static void printHex(const uint8_t *data, size_t len) {
   for (size_t i = 0; i < len; i++) {
@@ -314,8 +317,49 @@ static VictronDevice *findDevice(const BLEAddress &address) {
   return nullptr;
 }
 
+// One capture record as a single hex line (one Serial write, so lines never interleave)
+static void captureAdvertisement(BLEAdvertisedDevice &advertisedDevice) {
+  uint8_t record[12 + VICTRON_MANUFACTURER_DATA_MAX];
+  size_t manufacturerLen = 0;
+  if (!copyManufacturerData(advertisedDevice, record + 12, &manufacturerLen,
+                            VICTRON_MANUFACTURER_DATA_MAX)) {
+    return;
+  }
+
+  uint16_t vendorId = record[12] | ((uint16_t)record[13] << 8);
+  if (manufacturerLen < 2 || vendorId != VICTRON_VENDOR_ID) {
+    return;
+  }
+
+  uint32_t timeMs = millis() - captureStartMs;
+  BLEAddress address = advertisedDevice.getAddress();
+  record[0] = (uint8_t)timeMs;
+  record[1] = (uint8_t)(timeMs >> 8);
+  record[2] = (uint8_t)(timeMs >> 16);
+  record[3] = (uint8_t)(timeMs >> 24);
+  memcpy(record + 4, *address.getNative(), 6);
+  record[10] = (uint8_t)(int8_t)advertisedDevice.getRSSI();
+  record[11] = (uint8_t)manufacturerLen;
+
+  static const char HEX_DIGITS[] = "0123456789ABCDEF";
+  char line[5 + sizeof(record) * 2 + 1] = "VCAP:";
+  size_t pos = 5;
+  for (size_t i = 0; i < 12 + manufacturerLen; i++) {
+    line[pos++] = HEX_DIGITS[record[i] >> 4];
+    line[pos++] = HEX_DIGITS[record[i] & 0x0F];
+  }
+  line[pos] = '\0';
+  Serial.println(line);
+  capturedCount++;
+}
+
 class VictronScanCallbacks : public BLEAdvertisedDeviceCallbacks {
   void onResult(BLEAdvertisedDevice advertisedDevice) override {
+    if (CAPTURE_MODE) {
+      captureAdvertisement(advertisedDevice);
+      return;
+    }
+
     VictronDevice *device = findDevice(advertisedDevice.getAddress());
     if (device == nullptr) {
       return;
@@ -446,11 +490,18 @@ void setup() {
 
   BLEDevice::init("");
   bleScan = BLEDevice::getScan();
-  bleScan->setAdvertisedDeviceCallbacks(new VictronScanCallbacks());
+  // Capture keeps duplicates: the replay should see the real advertisement rate
+  bleScan->setAdvertisedDeviceCallbacks(new VictronScanCallbacks(), CAPTURE_MODE);
   bleScan->setActiveScan(true);
   bleScan->setInterval(100);
   bleScan->setWindow(99);
 
+  if (CAPTURE_MODE) {
+    captureStartMs = millis();
+    Serial.println("VCAP-BEGIN v1 (save this log, then: victron_replay --import <log> <out.vcap>)");
+    return;
+  }
+
   Serial.println();
   Serial.println("BLE scan started. Keep ESP32 close to the Victron devices.");
   Serial.println("Instant Readout via Bluetooth must be enabled on each device.");
@@ -464,5 +515,11 @@ void loop() {
   }
 
   bleScan->start(BLE_SCAN_SECONDS, false);
+  if (CAPTURE_MODE) {
+    bleScan->clearResults();  // Duplicates are kept, so don't let the result list grow
+    Serial.print("VCAP-STATUS records=");
+    Serial.println(capturedCount);
+    return;  // No pause: keep the capture gap-free
+  }
   delay(200);
 }